@@ -0,0 +1,109 @@
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+// Builds a synthetic input with many code sections full of forward jumps over
+// padding, and a table of label differences into every section in .text, so
+// that .text depends on the layout of all of them. Only the jumps of the last
+// section, which all go to its end, need relaxation; the other sections only
+// have short jumps and need not be laid out again once they fit.
+static std::string makeInput(unsigned NumSections, unsigned JumpsPerSection) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  OS << "\t.text\n";
+  for (unsigned S = 0; S != NumSections; ++S)
+    OS << "\t.uleb128 end" << S << " - start" << S << "\n";
+  for (unsigned S = 0; S != NumSections; ++S) {
+    bool Relaxes = S + 1 == NumSections;
+    OS << "\t.section .text." << S << ",\"ax\",@progbits\n"
+       << "start" << S << ":\n";
+    for (unsigned J = 0; J != JumpsPerSection; ++J) {
+      if (Relaxes)
+        OS << "\tjmp end" << S << "\n";
+      else
+        OS << "\tjmp l" << S << '_' << J << "\n";
+      OS << "\t.fill 8, 1, 0x90\n"
+         << "l" << S << '_' << J << ":\n";
+    }
+    OS << "end" << S << ":\n\tret\n";
+  }
+  return OS.str();
+}
+
+static void BM_MCRelaxation(benchmark::State &State) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+
+  const std::string TripleName = "x86_64-pc-linux-gnu";
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T) {
+    State.SkipWithError("X86 target not available");
+    return;
+  }
+
+  std::string Input = makeInput(State.range(0), State.range(1));
+  MCTargetOptions Options;
+  for (auto _ : State) {
+    SourceMgr SrcMgr;
+    SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Input), SMLoc());
+    std::unique_ptr<MCRegisterInfo> MRI(T->createMCRegInfo(TripleName));
+    std::unique_ptr<MCAsmInfo> MAI(T->createMCAsmInfo(*MRI, TripleName));
+    std::unique_ptr<MCInstrInfo> MCII(T->createMCInstrInfo());
+    std::unique_ptr<MCSubtargetInfo> STI(
+        T->createMCSubtargetInfo(TripleName, "", ""));
+    MCObjectFileInfo MOFI;
+    MCContext Ctx(MAI.get(), MRI.get(), &MOFI, &SrcMgr);
+    MOFI.InitMCObjectFileInfo(Triple(TripleName), /*PIC=*/false, Ctx);
+
+    SmallString<0> Out;
+    raw_svector_ostream OS(Out);
+    std::unique_ptr<MCAsmBackend> MAB(
+        T->createMCAsmBackend(*STI, *MRI, Options));
+    std::unique_ptr<MCObjectWriter> OW = MAB->createObjectWriter(OS);
+    std::unique_ptr<MCStreamer> Str(T->createMCObjectStreamer(
+        Triple(TripleName), Ctx, std::move(MAB), std::move(OW),
+        std::unique_ptr<MCCodeEmitter>(
+            T->createMCCodeEmitter(*MCII, *MRI, Ctx)),
+        *STI, /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+        /*DWARFMustBeAtTheEnd=*/false));
+    std::unique_ptr<MCAsmParser> Parser(
+        createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+    std::unique_ptr<MCTargetAsmParser> TAP(
+        T->createMCAsmParser(*STI, *Parser, *MCII, Options));
+    Parser->setTargetParser(*TAP);
+    if (Parser->Run(/*NoInitialTextSection=*/false)) {
+      State.SkipWithError("failed to assemble the input");
+      return;
+    }
+    benchmark::DoNotOptimize(Out.data());
+  }
+}
+BENCHMARK(BM_MCRelaxation)
+    ->Args({16, 256})
+    ->Args({256, 64})
+    ->Args({1024, 16})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
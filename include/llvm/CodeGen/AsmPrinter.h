@@ -35,6 +35,7 @@ namespace llvm {
 
 class BasicBlock;
 class BlockAddress;
+class CodeSizeReport;
 class Constant;
 class ConstantArray;
 class DataLayout;
@@ -156,6 +157,10 @@ protected:
   /// maintains ownership of the emitters.
   SmallVector<HandlerInfo, 1> Handlers;
 
+  /// Attributes the emitted bytes to their origin when -mc-size-report is
+  /// given; null otherwise.
+  std::unique_ptr<CodeSizeReport> SizeReport;
+
 public:
   struct SrcMgrDiagInfo {
     SourceMgr SrcMgr;
@@ -229,6 +234,9 @@ public:
   /// Return the current section we are emitting to.
   const MCSection *getCurrentSection() const;
 
+  /// Return the size report being collected, or null if none was requested.
+  CodeSizeReport *getSizeReport() const { return SizeReport.get(); }
+
   void getNameWithPrefix(SmallVectorImpl<char> &Name,
                          const GlobalValue *GV) const;
 
@@ -0,0 +1,150 @@
+//===- llvm/CodeGen/CodeSizeReport.h - Encoded size attribution -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares CodeSizeReport, which the AsmPrinter uses to attribute
+// the bytes it emits into an object file to functions, MachineInstr opcodes,
+// source locations and the passes that inserted the instructions. It is
+// written out as JSON for -mc-size-report, and as optimization remarks.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CODEGEN_CODESIZEREPORT_H
+#define LLVM_CODEGEN_CODESIZEREPORT_H
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llvm {
+
+class DILocation;
+class Function;
+class MachineFunction;
+class MachineInstr;
+class MCFragment;
+class MCRelaxableFragment;
+class MCSection;
+class MCStreamer;
+class raw_ostream;
+
+/// Attributes the bytes an object streamer receives to the MachineInstrs
+/// they were emitted for. Sizes are measured on the fragments of the
+/// MCAssembler as instructions are emitted, and corrected for relaxation by
+/// finalize() once the assembler has laid out the object file.
+class CodeSizeReport {
+public:
+  /// Number of bytes and number of items attributed to a single key.
+  struct Entry {
+    uint64_t Size = 0;
+    uint64_t Count = 0;
+  };
+
+  /// \p Streamer must be an object streamer; nothing can be measured on the
+  /// textual assembly streamer.
+  explicit CodeSizeReport(MCStreamer &Streamer);
+  ~CodeSizeReport();
+
+  /// Called after the function header has been emitted and before its body.
+  void beginFunction(const MachineFunction &MF);
+  /// Called once the last byte of the function body has been emitted.
+  void endFunction();
+
+  /// Bracket the emission of a single MachineInstr.
+  void beginInstruction(const MachineInstr &MI);
+  void endInstruction();
+
+  /// Record target specific bytes, such as a histogram of immediate encoding
+  /// widths, under \p Category. These are reported separately and are not
+  /// added to the per-instruction totals.
+  void addTargetBytes(StringRef Category, StringRef Name, uint64_t Size,
+                      uint64_t Count = 1);
+
+  /// Account for relaxation, collect the final section sizes and emit the
+  /// per-function remarks. Must be called after the streamer has been
+  /// finished but before it is reset.
+  void finalize();
+
+  /// Print the report as JSON.
+  void print(raw_ostream &OS, StringRef SourceFileName) const;
+
+private:
+  /// A point in the fragment list of a section.
+  struct Position {
+    MCSection *Sec = nullptr;
+    MCFragment *Frag = nullptr;
+    uint64_t Offset = 0;
+  };
+
+  /// Bytes attributed to one source location of a function, and how they
+  /// split up between the passes that inserted the instructions.
+  struct LocationEntry {
+    /// Position of the location among those of the function, in the order
+    /// they were first seen.
+    unsigned Order = 0;
+    Entry Total;
+    StringMap<uint64_t> PassBytes;
+  };
+
+  struct FunctionEntry {
+    std::string Name;
+    const Function *F = nullptr;
+    uint64_t Size = 0;
+    uint64_t InstrSize = 0;
+    uint64_t NumInstrs = 0;
+    std::map<const DILocation *, LocationEntry> Locations;
+  };
+
+  struct SectionEntry {
+    std::string Name;
+    StringRef Kind;
+    uint64_t Size;
+  };
+
+  /// A relaxable fragment created for an instruction, together with its
+  /// size when it was created and the entries its bytes were added to.
+  struct PendingRelaxation {
+    const MCRelaxableFragment *Frag;
+    uint64_t Size;
+    unsigned FunctionIdx;
+    Entry *Opcode;
+    Entry *Location;
+    Entry *Pass;
+    LocationEntry *FunctionLocation;
+    uint64_t *FunctionLocationPass;
+  };
+
+  Position getPosition() const;
+  uint64_t
+  bytesSince(const Position &Start,
+             SmallVectorImpl<const MCRelaxableFragment *> *Relaxable) const;
+  void emitRemarks() const;
+
+  MCStreamer &Streamer;
+
+  const MachineFunction *CurMF = nullptr;
+  const MachineInstr *CurMI = nullptr;
+  Position FunctionStart;
+  Position InstrStart;
+
+  std::vector<FunctionEntry> Functions;
+  StringMap<Entry> Opcodes;
+  StringMap<Entry> Passes;
+  std::map<std::pair<std::string, unsigned>, Entry> Locations;
+  StringMap<StringMap<Entry>> TargetBytes;
+  std::vector<SectionEntry> Sections;
+  std::vector<PendingRelaxation> Relaxations;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_CODEGEN_CODESIZEREPORT_H
@@ -400,6 +400,10 @@ private:
   /// Map a call instruction to call site arguments forwarding info.
   CallSiteInfoMap CallSitesInfo;
 
+  /// Map an instruction to the name of the pass that inserted it. Only filled
+  /// in when MachineModuleInfo::tracksInstrProvenance() is set.
+  DenseMap<const MachineInstr *, StringRef> InstrProvenance;
+
   // Callbacks for insertion and removal.
   void handleInsertion(MachineInstr &MI);
   void handleRemoval(MachineInstr &MI);
@@ -982,6 +986,17 @@ public:
   /// call instruction with new one.
   void updateCallSiteInfo(const MachineInstr *Old,
                           const MachineInstr *New = nullptr);
+
+  /// Attribute every instruction of the function that has no provenance yet
+  /// to \p PassName. MachineFunctionPass calls this after each pass when
+  /// instruction provenance is tracked.
+  void recordInstrProvenance(StringRef PassName);
+
+  /// Return the name of the pass that inserted \p MI, or an empty string if
+  /// it is not known.
+  StringRef getInstrProvenance(const MachineInstr &MI) const {
+    return InstrProvenance.lookup(&MI);
+  }
 };
 
 //===--------------------------------------------------------------------===//
@@ -133,6 +133,10 @@ class MachineModuleInfo : public ImmutablePass {
   /// functions.
   bool HasNosplitStack;
 
+  /// True if MachineFunctionPass records which pass inserted each
+  /// MachineInstr. This is used by the AsmPrinter for -mc-size-report.
+  bool TracksInstrProvenance;
+
   /// Maps IR Functions to their corresponding MachineFunctions.
   DenseMap<const Function*, std::unique_ptr<MachineFunction>> MachineFunctions;
   /// Next unique number available for a MachineFunction.
@@ -215,6 +219,10 @@ public:
     HasNosplitStack = b;
   }
 
+  bool tracksInstrProvenance() const { return TracksInstrProvenance; }
+
+  void setTracksInstrProvenance(bool b) { TracksInstrProvenance = b; }
+
   /// Return the symbol to be used for the specified basic block when its
   /// address is taken.  This cannot be its normal LBB label because the block
   /// may be accessed outside its containing function.
@@ -139,6 +139,9 @@ namespace llvm {
   /// Basic register allocator.
   extern char &RABasicID;
 
+  /// Linear scan register allocator.
+  extern char &RALinearScanID;
+
   /// VirtRegRewriter pass. Rewrite virtual registers to physical registers as
   /// assigned in VirtRegMap.
   extern char &VirtRegRewriterID;
@@ -166,6 +169,11 @@ namespace llvm {
   ///
   FunctionPass *createBasicRegisterAllocator();
 
+  /// LinearScanRegisterAllocation Pass - This pass implements a global
+  /// register allocator that favors compile time over code quality.
+  ///
+  FunctionPass *createLinearScanRegisterAllocator();
+
   /// Greedy register allocation pass - This pass implements a global register
   /// allocator for optimized builds.
   ///
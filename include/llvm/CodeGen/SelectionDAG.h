@@ -257,7 +257,9 @@ class SelectionDAG {
   /// CSE with existing nodes when a duplicate is requested.
   FoldingSet<SDNode> CSEMap;
 
-  /// Pool allocation for machine-opcode SDNode operands.
+  /// Pool allocation for machine-opcode SDNode operands. Operand arrays are
+  /// recycled across DAGs; clear() only releases the memory once it exceeds a
+  /// retention limit.
   BumpPtrAllocator OperandAllocator;
   ArrayRecycler<SDUse> OperandRecycler;
 
@@ -159,6 +159,16 @@ public:
     return false;
   }
 
+  /// Returns true if shrink wrapping only needs to keep the stack frame around
+  /// the memory accesses that may touch it, rather than around all of them.
+  /// Accesses whose memory operands all refer to objects outside of the frame
+  /// are then ignored. This is only correct if, until the frame is laid out,
+  /// the frame is addressed only through frame indices and the stack pointer.
+  virtual bool
+  shrinkWrapIgnoresNonStackAccesses(const MachineFunction &MF) const {
+    return false;
+  }
+
   /// Returns true if the stack slot holes in the fixed and callee-save stack
   /// area should be used when allocating other stack locations to reduce stack
   /// size.
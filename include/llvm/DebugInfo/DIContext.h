@@ -177,6 +177,7 @@ struct DIDumpOptions {
   bool SummarizeTypes = false;
   bool Verbose = false;
   bool DisplayRawContents = false;
+  unsigned NumThreads = 1; // Threads to use when verifying.
 
   /// Return default option set for printing a single DIE without children.
   static DIDumpOptions getForSingleDIE() {
@@ -201,7 +202,8 @@ class DIContext {
 public:
   enum DIContextKind {
     CK_DWARF,
-    CK_PDB
+    CK_PDB,
+    CK_GSYM
   };
 
   DIContext(DIContextKind K) : Kind(K) {}
@@ -40,6 +40,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 
@@ -64,6 +65,9 @@ class DWARFContext : public DIContext {
   std::unique_ptr<DWARFDebugLoc> Loc;
   std::unique_ptr<DWARFDebugAranges> Aranges;
   std::unique_ptr<DWARFDebugLine> Line;
+  /// Guards Line, as line tables are parsed lazily and may be requested by
+  /// several threads at once, e.g. when verifying units in parallel.
+  std::mutex LineMutex;
   std::unique_ptr<DWARFDebugFrame> DebugFrame;
   std::unique_ptr<DWARFDebugFrame> EHFrame;
   std::unique_ptr<DWARFDebugMacro> Macro;
@@ -230,6 +234,12 @@ public:
   /// Get a DIE given an exact offset.
   DWARFDie getDIEForOffset(uint32_t Offset);
 
+  /// Extract the DIEs of all normal units, using up to \p NumThreads threads.
+  void extractAllDIEs(unsigned NumThreads) {
+    parseNormalUnits();
+    NormalUnits.extractDIEs(NumThreads);
+  }
+
   unsigned getMaxVersion() {
     // Ensure info units have been parsed to discover MaxVersion
     info_section_units();
@@ -142,6 +142,11 @@ public:
   /// verifier to process unit separately.
   DWARFUnit *addUnit(std::unique_ptr<DWARFUnit> Unit);
 
+  /// Extract the DIEs of all units, using up to \p NumThreads threads. Once
+  /// this returns, the DIEs of any unit may be read from several threads at
+  /// once, which is not the case while they are extracted lazily.
+  void extractDIEs(unsigned NumThreads);
+
   /// Returns number of all units held by this instance.
   unsigned getNumUnits() const { return size(); }
   /// Returns number of units from all .debug_info[.dwo] sections.
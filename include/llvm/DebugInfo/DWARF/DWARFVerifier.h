@@ -161,6 +161,11 @@ private:
   /// Verifies the unit headers and contents in a .debug_info or .debug_types
   /// section.
   ///
+  /// When DumpOpts.NumThreads is greater than one, the contents of the units
+  /// are verified in parallel. The diagnostics of each unit are buffered and
+  /// printed in the order of the units, so the output matches that of a
+  /// serial verification.
+  ///
   /// \param S           The DWARF Section to verify.
   /// \param SectionKind The object-file section kind that S comes from.
   ///
@@ -0,0 +1,95 @@
+//===- DwarfTransformer.h ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_GSYM_DWARFTRANSFORMER_H
+#define LLVM_DEBUGINFO_GSYM_DWARFTRANSFORMER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+
+class raw_ostream;
+class DWARFContext;
+class DWARFDie;
+
+namespace gsym {
+
+struct CUInfo;
+class GsymCreator;
+
+/// A DWARF transformer that can convert DWARF into suitable information that
+/// can be added to a GsymCreator.
+///
+/// A DwarfTransformer object will create FunctionInfo objects for each
+/// DW_TAG_subprogram DIE that has a name and a valid address range. The line
+/// table rows that fall within the range are converted to LineEntry objects,
+/// and DW_TAG_inlined_subroutine DIEs are converted to InlineInfo objects so
+/// that lookups can unwind inline call stacks.
+class DwarfTransformer {
+public:
+  /// Create a DWARF transformer.
+  ///
+  /// \param D The DWARF to use when converting to GSYM.
+  ///
+  /// \param OS The stream to log warnings and non fatal issues to.
+  ///
+  /// \param G The GSYM creator to populate with the function information
+  /// from the debug info.
+  DwarfTransformer(DWARFContext &D, raw_ostream &OS, GsymCreator &G)
+      : DICtx(D), Log(OS), Gsym(G) {}
+
+  /// Extract the DWARF from the supplied object file and convert it into the
+  /// GSYM format in the GsymCreator object that is passed in. Returns an
+  /// error if something fatal is encountered.
+  ///
+  /// \param NumThreads The number of threads that the conversion process can
+  /// use. The DIEs of all compile units are extracted up front, after which
+  /// each compile unit is converted on its own thread.
+  ///
+  /// \returns An error indicating any fatal issues that happen when parsing
+  /// the DWARF, or Error::success() if all goes well.
+  llvm::Error convert(uint32_t NumThreads);
+
+  /// Verify that every line table address of every function in a GSYM file
+  /// looks up to the same frames in the GSYM file and in the DWARF.
+  /// Mismatches are logged.
+  ///
+  /// \param GsymPath The GSYM file that was created from this DWARF.
+  ///
+  /// \returns An error if the GSYM file can't be read or if any lookup
+  /// didn't match.
+  llvm::Error verify(StringRef GsymPath);
+
+private:
+  /// Handle any DIE (debug info entry) from the DWARF.
+  ///
+  /// This function will find all DW_TAG_subprogram DIEs and convert them into
+  /// GSYM FunctionInfo objects.
+  ///
+  /// \param Strm The thread specific log stream for any non fatal errors and
+  /// warnings. Once a thread has finished parsing an entire compile unit, all
+  /// information in this temporary stream will be forwarded to the member
+  /// variable log. This keeps logging thread safe.
+  ///
+  /// \param CUI The compile unit specific information that contains the DWARF
+  /// line table, cached file list, and other compile unit specific
+  /// information.
+  ///
+  /// \param Die The DWARF debug info entry to parse.
+  void handleDie(raw_ostream &Strm, CUInfo &CUI, DWARFDie Die);
+
+  DWARFContext &DICtx;
+  raw_ostream &Log;
+  GsymCreator &Gsym;
+};
+
+} // namespace gsym
+} // namespace llvm
+
+#endif // #ifndef LLVM_DEBUGINFO_GSYM_DWARFTRANSFORMER_H
@@ -14,12 +14,23 @@
 #include "llvm/DebugInfo/GSYM/LineEntry.h"
 #include "llvm/DebugInfo/GSYM/Range.h"
 #include "llvm/DebugInfo/GSYM/StringTable.h"
+#include "llvm/Support/Error.h"
 #include <tuple>
 #include <vector>
 
 namespace llvm {
+class DataExtractor;
 class raw_ostream;
 namespace gsym {
+class FileWriter;
+
+/// The types of the chunks that follow the size and name of an encoded
+/// FunctionInfo.
+enum class InfoType : uint32_t {
+  EndOfList = 0u,
+  LineTableInfo = 1u,
+  InlineInfo = 2u
+};
 
 /// Function information in GSYM files encodes information for one
 /// contiguous address range. The name of the function is encoded as
@@ -69,6 +80,36 @@ struct FunctionInfo {
     Lines.clear();
     Inline.clear();
   }
+
+  /// Decode an object from a binary data stream.
+  ///
+  /// A FunctionInfo is encoded as the uint32_t size of the function and the
+  /// uint32_t string table offset of its name, followed by a list of chunks
+  /// that each start with a uint32_t InfoType and a uint32_t length. The list
+  /// is terminated by an InfoType::EndOfList chunk. Chunks with an unknown
+  /// type are skipped, so that new types can be added without breaking
+  /// readers.
+  ///
+  /// \param Data The binary stream to read the data from. This object must
+  /// have the data for the object starting at offset zero. The data
+  /// can contain more data than needed.
+  ///
+  /// \param BaseAddr The FunctionInfo's start address; only the size is
+  /// stored in the encoded data.
+  ///
+  /// \returns A FunctionInfo or an error describing the issue that was
+  /// encountered during decoding.
+  static llvm::Expected<FunctionInfo> decode(DataExtractor &Data,
+                                             uint64_t BaseAddr);
+
+  /// Encode this object into FileWriter stream.
+  ///
+  /// \param O The binary stream to write the data to at the current file
+  /// position. The object is aligned to 4 bytes before it is written.
+  ///
+  /// \returns The file offset of the encoded FunctionInfo, or an error
+  /// describing the issue that was encountered during encoding.
+  llvm::Expected<uint64_t> encode(FileWriter &O) const;
 };
 
 inline bool operator==(const FunctionInfo &LHS, const FunctionInfo &RHS) {
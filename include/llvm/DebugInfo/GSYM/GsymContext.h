@@ -0,0 +1,61 @@
+//===- GsymContext.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_GSYM_GSYMCONTEXT_H
+#define LLVM_DEBUGINFO_GSYM_GSYMCONTEXT_H
+
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace llvm {
+
+namespace gsym {
+
+/// GsymContext
+/// A DIContext that answers symbolication queries from a GSYM file. This
+/// allows clients of DIContext, like the symbolizer, to use a compact GSYM
+/// file produced by llvm-gsymutil in place of the full DWARF. GSYM files
+/// carry function names, line tables and inline call stacks only, so columns,
+/// discriminators and locals are never reported.
+class GsymContext : public DIContext {
+public:
+  GsymContext(std::unique_ptr<GsymReader> Reader);
+  GsymContext(GsymContext &) = delete;
+  GsymContext &operator=(GsymContext &) = delete;
+
+  static bool classof(const DIContext *DICtx) {
+    return DICtx->getKind() == CK_GSYM;
+  }
+
+  void dump(raw_ostream &OS, DIDumpOptions DIDumpOpts) override;
+
+  DILineInfo getLineInfoForAddress(
+      object::SectionedAddress Address,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  DILineInfoTable getLineInfoForAddressRange(
+      object::SectionedAddress Address, uint64_t Size,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+  DIInliningInfo getInliningInfoForAddress(
+      object::SectionedAddress Address,
+      DILineInfoSpecifier Specifier = DILineInfoSpecifier()) override;
+
+  std::vector<DILocal>
+  getLocalsForAddress(object::SectionedAddress Address) override;
+
+private:
+  std::unique_ptr<GsymReader> Reader;
+};
+
+} // end namespace gsym
+
+} // end namespace llvm
+
+#endif // LLVM_DEBUGINFO_GSYM_GSYMCONTEXT_H
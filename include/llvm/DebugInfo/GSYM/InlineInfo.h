@@ -12,14 +12,17 @@
 
 #include "llvm/ADT/Optional.h"
 #include "llvm/DebugInfo/GSYM/Range.h"
+#include "llvm/Support/Error.h"
 #include <stdint.h>
 #include <vector>
 
 
 namespace llvm {
+class DataExtractor;
 class raw_ostream;
 
 namespace gsym {
+class FileWriter;
 
 /// Inline information stores the name of the inline function along with
 /// an array of address ranges. It also stores the call file and call line
@@ -62,6 +65,36 @@ struct InlineInfo {
   /// \returns optional vector of InlineInfo objects that describe the
   /// inline call stack for a given address, false otherwise.
   llvm::Optional<InlineArray> getInlineStack(uint64_t Addr) const;
+
+  /// Decode an InlineInfo object from a binary data stream.
+  ///
+  /// \param Data The binary stream to read the data from.
+  ///
+  /// \param Offset The offset in \p Data of the encoded object. On success
+  /// it is advanced past the object.
+  ///
+  /// \param BaseAddr The base address to use when decoding address ranges.
+  /// The root InlineInfo of a function uses the start address of the
+  /// function, and children use the start of the first range of their
+  /// parent, which keeps the encoded offsets small.
+  ///
+  /// \returns An InlineInfo or an error describing the issue that was
+  /// encountered during decoding.
+  static llvm::Expected<InlineInfo> decode(DataExtractor &Data,
+                                           uint32_t &Offset,
+                                           uint64_t BaseAddr);
+
+  /// Encode this InlineInfo object into FileWriter stream.
+  ///
+  /// \param O The binary stream to write the data to at the current file
+  /// position.
+  ///
+  /// \param BaseAddr The base address to use when encoding address ranges,
+  /// see decode().
+  ///
+  /// \returns An error object that indicates failure or the
+  /// encoding process.
+  llvm::Error encode(FileWriter &O, uint64_t BaseAddr) const;
 };
 
 inline bool operator==(const InlineInfo &LHS, const InlineInfo &RHS) {
@@ -39,6 +39,7 @@ public:
     bool UseSymbolTable = true;
     bool Demangle = true;
     bool RelativeAddresses = false;
+    bool UseGsym = false;
     std::string DefaultArch;
     std::vector<std::string> DsymHints;
     std::string FallbackDebugPath;
@@ -64,6 +65,13 @@ public:
   Expected<std::vector<DILocal>>
   symbolizeFrame(const std::string &ModuleName,
                  object::SectionedAddress ModuleOffset);
+  /// Translate a function index and an offset into that function's body in
+  /// a WebAssembly module into an offset into the module's code section,
+  /// which is the address space of Wasm symbols and DWARF. Wasm engines
+  /// report traps and sampled PCs as function index/body offset pairs.
+  Expected<uint64_t> getWasmCodeOffset(const std::string &ModuleName,
+                                       uint32_t FuncIndex,
+                                       uint64_t BodyOffset);
   void flush();
 
   static std::string
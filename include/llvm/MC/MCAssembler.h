@@ -182,9 +182,12 @@ private:
   bool fragmentNeedsRelaxation(const MCRelaxableFragment *IF,
                                const MCAsmLayout &Layout) const;
 
-  /// Perform one layout iteration and return true if any offsets
-  /// were adjusted.
-  bool layoutOnce(MCAsmLayout &Layout);
+  /// Perform one layout iteration over the sections in \p Pending, adding the
+  /// sections that had fragments relaxed to \p Relaxed. Return true if any
+  /// offsets were adjusted.
+  bool layoutOnce(MCAsmLayout &Layout,
+                  const SmallPtrSetImpl<const MCSection *> &Pending,
+                  SmallPtrSetImpl<const MCSection *> &Relaxed);
 
   /// Perform one layout iteration of the given section and return true
   /// if any offsets were adjusted.
@@ -62,6 +62,16 @@ public:
     return Info->get(Inst.getOpcode()).isTerminator();
   }
 
+  /// Returns true if \p Inst is an instruction of a stack machine, whose
+  /// operands are implicitly taken from and pushed to an operand stack. In
+  /// that case \p Pops and \p Pushes are set to the number of values it
+  /// removes from and adds to the stack. Operands that depend on the target of
+  /// a call, or that are otherwise variadic, are not counted.
+  virtual bool getStackEffect(const MCInst &Inst, unsigned &Pops,
+                              unsigned &Pushes) const {
+    return false;
+  }
+
   /// Returns true if at least one of the register writes performed by
   /// \param Inst implicitly clears the upper portion of all super-registers.
   ///
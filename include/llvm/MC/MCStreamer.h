@@ -215,6 +215,9 @@ class MCStreamer {
   bool UseAssemblerInfoForParsing;
 
 protected:
+  /// True for streamers that write an object file through an MCAssembler.
+  bool IsObj = false;
+
   MCStreamer(MCContext &Ctx);
 
   virtual void EmitCFIStartProcImpl(MCDwarfFrameInfo &Frame);
@@ -249,6 +252,9 @@ public:
 
   MCContext &getContext() const { return Context; }
 
+  /// Return true if this is an MCObjectStreamer.
+  bool isObj() const { return IsObj; }
+
   virtual MCAssembler *getAssemblerPtr() { return nullptr; }
 
   void setUseAssemblerInfoForParsing(bool v) { UseAssemblerInfoForParsing = v; }
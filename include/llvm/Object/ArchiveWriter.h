@@ -38,10 +38,18 @@ struct NewArchiveMember {
 
 Expected<std::string> computeArchiveRelativePath(StringRef From, StringRef To);
 
+/// Write an archive containing \p NewMembers to \p ArcName.
+///
+/// \p OldArchiveBuf is the current contents of \p ArcName, if any. When
+/// \p UpdateInPlace is set and the new archive has exactly the size of the
+/// old one, only the byte ranges that changed are rewritten in the existing
+/// file instead of writing a whole new archive and renaming it over the old
+/// one. This is not atomic.
 Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
                    bool WriteSymtab, object::Archive::Kind Kind,
                    bool Deterministic, bool Thin,
-                   std::unique_ptr<MemoryBuffer> OldArchiveBuf = nullptr);
+                   std::unique_ptr<MemoryBuffer> OldArchiveBuf = nullptr,
+                   bool UpdateInPlace = false);
 }
 
 #endif
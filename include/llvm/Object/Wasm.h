@@ -167,6 +167,9 @@ public:
 
   Expected<uint64_t> getSymbolAddress(DataRefImpl Symb) const override;
   uint64_t getWasmSymbolValue(const WasmSymbol &Sym) const;
+  /// Return the number of bytes covered by a defined function or data symbol,
+  /// and 0 for any other symbol.
+  uint64_t getSymbolSize(SymbolRef Sym) const;
   uint64_t getSymbolValueImpl(DataRefImpl Symb) const override;
   uint32_t getSymbolAlignment(DataRefImpl Symb) const override;
   uint64_t getCommonSymbolSizeImpl(DataRefImpl Symb) const override;
@@ -42,6 +42,7 @@
 namespace llvm {
 
 class IndexedInstrProfReader;
+class MemoryBufferRef;
 
 namespace coverage {
 
@@ -54,7 +55,8 @@ enum class coveragemap_error {
   no_data_found,
   unsupported_version,
   truncated,
-  malformed
+  malformed,
+  index_out_of_date
 };
 
 const std::error_category &coveragemap_category();
@@ -501,6 +503,22 @@ public:
   ArrayRef<ExpansionRecord> getExpansions() const { return Expansions; }
 };
 
+/// An object file or profile that a coverage index was written for. The index
+/// records its inputs and is only loaded for the very same ones.
+struct CoverageIndexInput {
+  std::string Path;
+  uint64_t Size = 0;
+  /// The modification time in nanoseconds since the epoch.
+  uint64_t ModificationTime = 0;
+  /// The architecture selected in the object file, if any.
+  std::string Arch;
+
+  bool operator==(const CoverageIndexInput &RHS) const {
+    return Path == RHS.Path && Size == RHS.Size &&
+           ModificationTime == RHS.ModificationTime && Arch == RHS.Arch;
+  }
+};
+
 /// The mapping of profile information to coverage data.
 ///
 /// This is the main interface to get coverage information, using a profile to
@@ -531,6 +549,19 @@ public:
   load(ArrayRef<StringRef> ObjectFilenames, StringRef ProfileFilename,
        ArrayRef<StringRef> Arches = None);
 
+  /// Load the coverage mapping from an index written by writeIndex(). This
+  /// does not read any object file or profile. Fails with
+  /// coveragemap_error::index_out_of_date unless the index was written for
+  /// exactly \p Inputs.
+  static Expected<std::unique_ptr<CoverageMapping>>
+  loadFromIndex(MemoryBufferRef Index, ArrayRef<CoverageIndexInput> Inputs);
+
+  /// Write the function records and hash mismatches of this coverage mapping
+  /// to \p OS, in a format that loadFromIndex() reads back in a single pass
+  /// without evaluating any counter. \p Inputs describes the files the
+  /// mapping was loaded from.
+  void writeIndex(raw_ostream &OS, ArrayRef<CoverageIndexInput> Inputs) const;
+
   /// The number of functions that couldn't have their profiles mapped.
   ///
   /// This is a count of functions whose profile is out of date or otherwise
@@ -103,6 +103,18 @@ inline StringRef getInstrProfNamesVarName() {
   return "__llvm_prf_nm";
 }
 
+/// Return the name of the custom section that describes where the counters of
+/// a WebAssembly module live in its linear memory.
+inline StringRef getInstrProfWasmLayoutSectionName() {
+  return "__llvm_prf_layout";
+}
+
+/// Return the name of the variable holding the part of that section that
+/// describes the counters of one module.
+inline StringRef getInstrProfWasmLayoutVarName() {
+  return "__llvm_prf_layout_desc";
+}
+
 /// Return the name of a covarage mapping variable (internal linkage)
 /// for each instrumented source module. Such variables are allocated
 /// in the __llvm_covmap section.
@@ -1128,6 +1140,31 @@ struct Header {
 
 } // end namespace RawInstrProf
 
+namespace WasmInstrProf {
+
+// WebAssembly modules, such as smart contracts, can't use the profile runtime
+// to write out their counters. Their counters instead stay in linear memory,
+// and each object file adds a block describing them to the __llvm_prf_layout
+// custom section. The linker concatenates the blocks and relocates the counter
+// addresses in them, so that the counters can be read from a dump of the
+// memory of the running module.
+//
+// A block is made of the following little-endian fields, without padding:
+//   uint64_t Version;     // Version, with the variant flags of the raw format.
+//   uint32_t NumRecords;
+//   uint32_t NamesSize;
+//   NumRecords records of:
+//     uint64_t NameRef;     // MD5 hash of the PGO function name.
+//     uint64_t FuncHash;
+//     uint32_t CounterAddr; // 0 if the linker discarded the counters.
+//     uint32_t NumCounters; // Each counter is a uint64_t.
+//   NamesSize bytes of function names, encoded as in the raw format.
+//
+// Version 1: First version.
+const uint64_t Version = 1;
+
+} // end namespace WasmInstrProf
+
 // Parse MemOP Size range option.
 void getMemOPSizeRangeFromOption(StringRef Str, int64_t &RangeStart,
                                  int64_t &RangeLast);
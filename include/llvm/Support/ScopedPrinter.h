@@ -15,6 +15,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 
@@ -67,7 +68,18 @@ template <class T> const std::string to_string(const T &Value) {
 
 class ScopedPrinter {
 public:
-  ScopedPrinter(raw_ostream &OS) : OS(OS), IndentLevel(0) {}
+  enum class ScopedPrinterKind {
+    Base,
+    JSON,
+  };
+
+  ScopedPrinter(raw_ostream &OS,
+                ScopedPrinterKind Kind = ScopedPrinterKind::Base)
+      : OS(OS), IndentLevel(0), Kind(Kind) {}
+
+  virtual ~ScopedPrinter() {}
+
+  ScopedPrinterKind getKind() const { return Kind; }
 
   void flush() { OS.flush(); }
 
@@ -104,20 +116,17 @@ public:
       }
     }
 
-    if (Found) {
-      startLine() << Label << ": " << Name << " (" << hex(Value) << ")\n";
-    } else {
-      startLine() << Label << ": " << hex(Value) << "\n";
-    }
+    if (Found)
+      printHex(Label, Name, Value);
+    else
+      printHex(Label, Value);
   }
 
   template <typename T, typename TFlag>
   void printFlags(StringRef Label, T Value, ArrayRef<EnumEntry<TFlag>> Flags,
                   TFlag EnumMask1 = {}, TFlag EnumMask2 = {},
                   TFlag EnumMask3 = {}) {
-    typedef EnumEntry<TFlag> FlagEntry;
-    typedef SmallVector<FlagEntry, 10> FlagVector;
-    FlagVector SetFlags;
+    SmallVector<EnumEntry<TFlag>, 10> SetFlags;
 
     for (const auto &Flag : Flags) {
       if (Flag.Value == 0)
@@ -139,125 +148,114 @@ public:
 
     llvm::sort(SetFlags, &flagName<TFlag>);
 
-    startLine() << Label << " [ (" << hex(Value) << ")\n";
-    for (const auto &Flag : SetFlags) {
-      startLine() << "  " << Flag.Name << " (" << hex(Flag.Value) << ")\n";
-    }
-    startLine() << "]\n";
+    SmallVector<FlagEntry, 10> Entries;
+    for (const auto &Flag : SetFlags)
+      Entries.push_back({Flag.Name, hex(Flag.Value)});
+    printFlagsImpl(Label, hex(Value), Entries);
   }
 
   template <typename T> void printFlags(StringRef Label, T Value) {
-    startLine() << Label << " [ (" << hex(Value) << ")\n";
+    SmallVector<HexNumber, 10> SetFlags;
     uint64_t Flag = 1;
     uint64_t Curr = Value;
     while (Curr > 0) {
       if (Curr & 1)
-        startLine() << "  " << hex(Flag) << "\n";
+        SetFlags.push_back(hex(Flag));
       Curr >>= 1;
       Flag <<= 1;
     }
-    startLine() << "]\n";
+    printFlagsImpl(Label, hex(Value), SetFlags);
   }
 
-  void printNumber(StringRef Label, uint64_t Value) {
+  virtual void printNumber(StringRef Label, uint64_t Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printNumber(StringRef Label, uint32_t Value) {
+  virtual void printNumber(StringRef Label, uint32_t Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printNumber(StringRef Label, uint16_t Value) {
+  virtual void printNumber(StringRef Label, uint16_t Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printNumber(StringRef Label, uint8_t Value) {
+  virtual void printNumber(StringRef Label, uint8_t Value) {
     startLine() << Label << ": " << unsigned(Value) << "\n";
   }
 
-  void printNumber(StringRef Label, int64_t Value) {
+  virtual void printNumber(StringRef Label, int64_t Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printNumber(StringRef Label, int32_t Value) {
+  virtual void printNumber(StringRef Label, int32_t Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printNumber(StringRef Label, int16_t Value) {
+  virtual void printNumber(StringRef Label, int16_t Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printNumber(StringRef Label, int8_t Value) {
+  virtual void printNumber(StringRef Label, int8_t Value) {
     startLine() << Label << ": " << int(Value) << "\n";
   }
 
-  void printNumber(StringRef Label, const APSInt &Value) {
+  virtual void printNumber(StringRef Label, const APSInt &Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
-  void printBoolean(StringRef Label, bool Value) {
+  virtual void printBoolean(StringRef Label, bool Value) {
     startLine() << Label << ": " << (Value ? "Yes" : "No") << '\n';
   }
 
   template <typename... T> void printVersion(StringRef Label, T... Version) {
-    startLine() << Label << ": ";
-    printVersionInternal(Version...);
-    getOStream() << "\n";
+    std::string Str;
+    raw_string_ostream Stream(Str);
+    printVersionInternal(Stream, Version...);
+    printString(Label, Stream.str());
   }
 
   template <typename T> void printList(StringRef Label, const T &List) {
-    startLine() << Label << ": [";
-    bool Comma = false;
-    for (const auto &Item : List) {
-      if (Comma)
-        OS << ", ";
-      OS << Item;
-      Comma = true;
-    }
-    OS << "]\n";
+    SmallVector<std::string, 16> Items;
+    for (const auto &Item : List)
+      Items.push_back(llvm::to_string(Item));
+    printListImpl(Label, Items);
   }
 
   template <typename T, typename U>
   void printList(StringRef Label, const T &List, const U &Printer) {
-    startLine() << Label << ": [";
-    bool Comma = false;
+    SmallVector<std::string, 16> Items;
     for (const auto &Item : List) {
-      if (Comma)
-        OS << ", ";
-      Printer(OS, Item);
-      Comma = true;
+      std::string Str;
+      raw_string_ostream Stream(Str);
+      Printer(Stream, Item);
+      Items.push_back(Stream.str());
     }
-    OS << "]\n";
+    printListImpl(Label, Items);
   }
 
   template <typename T> void printHexList(StringRef Label, const T &List) {
-    startLine() << Label << ": [";
-    bool Comma = false;
-    for (const auto &Item : List) {
-      if (Comma)
-        OS << ", ";
-      OS << hex(Item);
-      Comma = true;
-    }
-    OS << "]\n";
+    SmallVector<HexNumber, 16> Items;
+    for (const auto &Item : List)
+      Items.push_back(hex(Item));
+    printHexListImpl(Label, Items);
   }
 
   template <typename T> void printHex(StringRef Label, T Value) {
-    startLine() << Label << ": " << hex(Value) << "\n";
+    printHexImpl(Label, hex(Value));
   }
 
   template <typename T> void printHex(StringRef Label, StringRef Str, T Value) {
-    startLine() << Label << ": " << Str << " (" << hex(Value) << ")\n";
+    printHexImpl(Label, Str, hex(Value));
   }
 
   template <typename T>
   void printSymbolOffset(StringRef Label, StringRef Symbol, T Value) {
-    startLine() << Label << ": " << Symbol << '+' << hex(Value) << '\n';
+    printSymbolOffsetImpl(Label, Symbol, hex(Value));
   }
 
-  void printString(StringRef Value) { startLine() << Value << "\n"; }
+  virtual void printString(StringRef Value) { startLine() << Value << "\n"; }
 
-  void printString(StringRef Label, StringRef Value) {
+  virtual void printString(StringRef Label, StringRef Value) {
     startLine() << Label << ": " << Value << "\n";
   }
 
@@ -271,7 +269,7 @@ public:
 
   template <typename T>
   void printNumber(StringRef Label, StringRef Str, T Value) {
-    startLine() << Label << ": " << Str << " (" << Value << ")\n";
+    printNumberImpl(Label, Str, llvm::to_string(Value));
   }
 
   void printBinary(StringRef Label, StringRef Str, ArrayRef<uint8_t> Value) {
@@ -316,9 +314,25 @@ public:
   }
 
   template <typename T> void printObject(StringRef Label, const T &Value) {
-    startLine() << Label << ": " << Value << "\n";
+    printString(Label, llvm::to_string(Value));
   }
 
+  /// Open and close the scopes of DictScope and ListScope.
+  virtual void objectBegin() { scopedBegin('{'); }
+
+  virtual void objectBegin(StringRef Label) { scopedBegin(Label, '{'); }
+
+  virtual void objectEnd() { scopedEnd('}'); }
+
+  virtual void arrayBegin() { scopedBegin('['); }
+
+  virtual void arrayBegin(StringRef Label) { scopedBegin(Label, '['); }
+
+  virtual void arrayEnd() { scopedEnd(']'); }
+
+  /// Start a line of free-form output. Printers that produce structured
+  /// output, such as JSONScopedPrinter, cannot represent it; users that
+  /// support them must stick to the printing functions above.
   raw_ostream &startLine() {
     printIndent();
     return OS;
@@ -326,15 +340,85 @@ public:
 
   raw_ostream &getOStream() { return OS; }
 
+protected:
+  struct FlagEntry {
+    StringRef Name;
+    HexNumber Value;
+  };
+
+  virtual void printFlagsImpl(StringRef Label, HexNumber Value,
+                              ArrayRef<FlagEntry> Flags) {
+    startLine() << Label << " [ (" << Value << ")\n";
+    for (const auto &Flag : Flags)
+      startLine() << "  " << Flag.Name << " (" << Flag.Value << ")\n";
+    startLine() << "]\n";
+  }
+
+  virtual void printFlagsImpl(StringRef Label, HexNumber Value,
+                              ArrayRef<HexNumber> Flags) {
+    startLine() << Label << " [ (" << Value << ")\n";
+    for (const auto &Flag : Flags)
+      startLine() << "  " << Flag << "\n";
+    startLine() << "]\n";
+  }
+
+  virtual void printListImpl(StringRef Label, ArrayRef<std::string> Items) {
+    startLine() << Label << ": [";
+    bool Comma = false;
+    for (const auto &Item : Items) {
+      if (Comma)
+        OS << ", ";
+      OS << Item;
+      Comma = true;
+    }
+    OS << "]\n";
+  }
+
+  virtual void printHexListImpl(StringRef Label, ArrayRef<HexNumber> Items) {
+    startLine() << Label << ": [";
+    bool Comma = false;
+    for (const auto &Item : Items) {
+      if (Comma)
+        OS << ", ";
+      OS << Item;
+      Comma = true;
+    }
+    OS << "]\n";
+  }
+
+  virtual void printHexImpl(StringRef Label, HexNumber Value) {
+    startLine() << Label << ": " << Value << "\n";
+  }
+
+  virtual void printHexImpl(StringRef Label, StringRef Str, HexNumber Value) {
+    startLine() << Label << ": " << Str << " (" << Value << ")\n";
+  }
+
+  virtual void printSymbolOffsetImpl(StringRef Label, StringRef Symbol,
+                                     HexNumber Value) {
+    startLine() << Label << ": " << Symbol << '+' << Value << '\n';
+  }
+
+  virtual void printNumberImpl(StringRef Label, StringRef Str,
+                               StringRef Value) {
+    startLine() << Label << ": " << Str << " (" << Value << ")\n";
+  }
+
+  virtual void printBinaryImpl(StringRef Label, StringRef Str,
+                               ArrayRef<uint8_t> Value, bool Block,
+                               uint32_t StartOffset = 0);
+
 private:
-  template <typename T> void printVersionInternal(T Value) {
-    getOStream() << Value;
+  template <typename T>
+  static void printVersionInternal(raw_ostream &Stream, T Value) {
+    Stream << Value;
   }
 
   template <typename S, typename T, typename... TArgs>
-  void printVersionInternal(S Value, T Value2, TArgs... Args) {
-    getOStream() << Value << ".";
-    printVersionInternal(Value2, Args...);
+  static void printVersionInternal(raw_ostream &Stream, S Value, T Value2,
+                                   TArgs... Args) {
+    Stream << Value << ".";
+    printVersionInternal(Stream, Value2, Args...);
   }
 
   template <typename T>
@@ -342,46 +426,133 @@ private:
     return lhs.Name < rhs.Name;
   }
 
-  void printBinaryImpl(StringRef Label, StringRef Str, ArrayRef<uint8_t> Value,
-                       bool Block, uint32_t StartOffset = 0);
+  void scopedBegin(char Symbol) {
+    startLine() << Symbol << '\n';
+    indent();
+  }
+
+  void scopedBegin(StringRef Label, char Symbol) {
+    startLine() << Label;
+    if (!Label.empty())
+      OS << ' ';
+    OS << Symbol << '\n';
+    indent();
+  }
+
+  void scopedEnd(char Symbol) {
+    unindent();
+    startLine() << Symbol << '\n';
+  }
 
   raw_ostream &OS;
   int IndentLevel;
   StringRef Prefix;
+  ScopedPrinterKind Kind;
 };
 
 template <>
 inline void
 ScopedPrinter::printHex<support::ulittle16_t>(StringRef Label,
                                               support::ulittle16_t Value) {
-  startLine() << Label << ": " << hex(Value) << "\n";
+  printHexImpl(Label, hex(Value));
 }
 
-template<char Open, char Close>
-struct DelimitedScope {
-  explicit DelimitedScope(ScopedPrinter &W) : W(W) {
-    W.startLine() << Open << '\n';
-    W.indent();
-  }
+/// Prints the same information as ScopedPrinter as a single JSON value.
+///
+/// Scopes become JSON objects and arrays, and printed fields become
+/// attributes: numbers for numeric values, strings otherwise. A value printed
+/// along with its name, as printEnum does, becomes an object with "Name" and
+/// "Value" attributes. Labeled scopes and fields inside an array are wrapped
+/// in an object with a single attribute, so that no label is lost.
+class JSONScopedPrinter : public ScopedPrinter {
+public:
+  /// \p IndentSize pretty-prints the output if nonzero.
+  JSONScopedPrinter(raw_ostream &OS, unsigned IndentSize = 2);
+
+  static bool classof(const ScopedPrinter *SP) {
+    return SP->getKind() == ScopedPrinterKind::JSON;
+  }
+
+  void printNumber(StringRef Label, uint64_t Value) override;
+  void printNumber(StringRef Label, uint32_t Value) override;
+  void printNumber(StringRef Label, uint16_t Value) override;
+  void printNumber(StringRef Label, uint8_t Value) override;
+  void printNumber(StringRef Label, int64_t Value) override;
+  void printNumber(StringRef Label, int32_t Value) override;
+  void printNumber(StringRef Label, int16_t Value) override;
+  void printNumber(StringRef Label, int8_t Value) override;
+  void printNumber(StringRef Label, const APSInt &Value) override;
+  void printBoolean(StringRef Label, bool Value) override;
+  void printString(StringRef Value) override;
+  void printString(StringRef Label, StringRef Value) override;
+  using ScopedPrinter::printNumber;
+  using ScopedPrinter::printString;
+
+  void objectBegin() override;
+  void objectBegin(StringRef Label) override;
+  void objectEnd() override;
+  void arrayBegin() override;
+  void arrayBegin(StringRef Label) override;
+  void arrayEnd() override;
+
+protected:
+  void printFlagsImpl(StringRef Label, HexNumber Value,
+                      ArrayRef<FlagEntry> Flags) override;
+  void printFlagsImpl(StringRef Label, HexNumber Value,
+                      ArrayRef<HexNumber> Flags) override;
+  void printListImpl(StringRef Label, ArrayRef<std::string> Items) override;
+  void printHexListImpl(StringRef Label, ArrayRef<HexNumber> Items) override;
+  void printHexImpl(StringRef Label, HexNumber Value) override;
+  void printHexImpl(StringRef Label, StringRef Str, HexNumber Value) override;
+  void printSymbolOffsetImpl(StringRef Label, StringRef Symbol,
+                             HexNumber Value) override;
+  void printNumberImpl(StringRef Label, StringRef Str,
+                       StringRef Value) override;
+  void printBinaryImpl(StringRef Label, StringRef Str, ArrayRef<uint8_t> Value,
+                       bool Block, uint32_t StartOffset = 0) override;
 
-  DelimitedScope(ScopedPrinter &W, StringRef N) : W(W) {
-    W.startLine() << N;
-    if (!N.empty())
-      W.getOStream() << ' ';
-    W.getOStream() << Open << '\n';
-    W.indent();
-  }
+private:
+  enum class Scope { Array, Object };
+
+  /// An open scope, whether it is the value of a labeled attribute, and
+  /// whether that attribute is wrapped in an extra object because the scope
+  /// was opened inside an array.
+  struct ScopeContext {
+    Scope Context;
+    bool Labeled;
+    bool Wrapped;
+  };
+
+  void printAttribute(StringRef Label, const json::Value &Value);
+  void scopedBegin(Scope Context);
+  void scopedBegin(StringRef Label, Scope Context);
+  void scopedEnd();
+
+  json::OStream JOS;
+  SmallVector<ScopeContext, 8> ScopeHistory;
+};
 
-  ~DelimitedScope() {
-    W.unindent();
-    W.startLine() << Close << '\n';
-  }
+/// Opens an object in the printer for the lifetime of the scope.
+struct DictScope {
+  explicit DictScope(ScopedPrinter &W) : W(W) { W.objectBegin(); }
+
+  DictScope(ScopedPrinter &W, StringRef N) : W(W) { W.objectBegin(N); }
+
+  ~DictScope() { W.objectEnd(); }
 
   ScopedPrinter &W;
 };
 
-using DictScope = DelimitedScope<'{', '}'>;
-using ListScope = DelimitedScope<'[', ']'>;
+/// Opens a list in the printer for the lifetime of the scope.
+struct ListScope {
+  explicit ListScope(ScopedPrinter &W) : W(W) { W.arrayBegin(); }
+
+  ListScope(ScopedPrinter &W, StringRef N) : W(W) { W.arrayBegin(N); }
+
+  ~ListScope() { W.arrayEnd(); }
+
+  ScopedPrinter &W;
+};
 
 } // namespace llvm
 
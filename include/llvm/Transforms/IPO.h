@@ -204,6 +204,13 @@ Pass *createReversePostOrderFunctionAttrsPass();
 ///
 ModulePass *createMergeFunctionsPass();
 
+//===----------------------------------------------------------------------===//
+/// createMergeSimilarFunctionsPass - This pass discovers functions that differ
+/// only in a few constants or callees, and merges them into one function that
+/// takes the differences as extra parameters.
+///
+ModulePass *createMergeSimilarFunctionsPass();
+
 //===----------------------------------------------------------------------===//
 /// createHotColdSplittingPass - This pass outlines cold blocks into a separate
 /// function(s).
@@ -223,6 +230,14 @@ ModulePass *createBarrierNoopPass();
 /// indicating the set of functions they may target at run-time.
 ModulePass *createCalledValuePropagationPass();
 
+/// createCallEvaluationPass - Replace calls to side-effect free functions with
+/// constant arguments by their result, evaluated at compile time.
+ModulePass *createCallEvaluationPass();
+
+/// createCalledValuePromotionPass - Promote indirect call sites with a small,
+/// statically known set of targets to guarded direct calls.
+ModulePass *createCalledValuePromotionPass();
+
 /// What to do with the summary when running passes that operate on it.
 enum class PassSummaryAction {
   None,   ///< Do nothing.
@@ -0,0 +1,30 @@
+//===- CallEvaluation.h - Evaluate calls at compile time --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass evaluates calls to side-effect free functions whose arguments are
+// all constants at compile time, and replaces them with their result. Typical
+// candidates are string-to-integer encoders or hash functions applied to
+// literals that were not evaluated by the frontend.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_CALLEVALUATION_H
+#define LLVM_TRANSFORMS_IPO_CALLEVALUATION_H
+
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class CallEvaluationPass : public PassInfoMixin<CallEvaluationPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+};
+} // namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_CALLEVALUATION_H
@@ -0,0 +1,34 @@
+//===- CalledValuePromotion.h - Promote known callees -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a transformation that promotes indirect call sites with
+// a small, statically known set of possible targets into chains of
+// compare-and-direct-call sequences. The targets are taken from !callees
+// metadata (as attached by CalledValuePropagation) or, for calls through a
+// load from a constant table of function pointers, from the table's
+// initializer. Unlike PGO-driven indirect call promotion, no profile data is
+// required. Promoted call sites become candidates for inlining.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_CALLEDVALUEPROMOTION_H
+#define LLVM_TRANSFORMS_IPO_CALLEDVALUEPROMOTION_H
+
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class CalledValuePromotionPass
+    : public PassInfoMixin<CalledValuePromotionPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+};
+} // namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_CALLEDVALUEPROMOTION_H
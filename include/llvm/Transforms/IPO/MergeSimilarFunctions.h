@@ -0,0 +1,32 @@
+//===- MergeSimilarFunctions.h - Merge similar functions --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass merges functions that are structurally identical but differ in a
+// small number of constant operands or direct callees, as is typical for C++
+// template instantiations. The differing operands are turned into extra
+// parameters of a single merged function, and the original functions become
+// thunks passing their own constants.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_MERGESIMILARFUNCTIONS_H
+#define LLVM_TRANSFORMS_IPO_MERGESIMILARFUNCTIONS_H
+
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class MergeSimilarFunctionsPass
+    : public PassInfoMixin<MergeSimilarFunctionsPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+};
+} // namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_MERGESIMILARFUNCTIONS_H
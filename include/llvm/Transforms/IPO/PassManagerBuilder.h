@@ -158,11 +158,17 @@ public:
   bool LoopsInterleaved;
   bool RerollLoops;
   bool NewGVN;
+  bool LoopVersioningLICM;
+  /// Largest loop, in instructions, that LoopVersioningLICM versions (0 for
+  /// no limit).
+  unsigned LoopVersioningLICMMaxBodySize;
   bool DisableGVNLoadPRE;
   bool ForgetAllSCEVInLoopUnroll;
   bool VerifyInput;
   bool VerifyOutput;
   bool MergeFunctions;
+  bool MergeSimilarFunctions;
+  bool HotColdSplitting;
   bool PrepareForLTO;
   bool PrepareForThinLTO;
   bool PerformThinLTO;
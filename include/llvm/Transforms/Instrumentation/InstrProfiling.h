@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <vector>
 
 namespace llvm {
@@ -61,6 +62,10 @@ private:
   GlobalVariable *NamesVar;
   size_t NamesSize;
 
+  // The records and function names of the WebAssembly layout section.
+  std::vector<Constant *> WasmLayoutRecords;
+  std::string WasmLayoutNames;
+
   // Is this lowering for the context-sensitive instrumentation.
   bool IsCS;
 
@@ -78,6 +83,10 @@ private:
   /// any lowering.
   bool lowerIntrinsics(Function *F);
 
+  /// Returns true if the counters are left in the linear memory of a
+  /// WebAssembly module instead of being written out by the profile runtime.
+  bool useWasmLayout() const;
+
   /// Register-promote counter loads and stores in loops.
   void promoteCounterLoadStores(Function *F);
 
@@ -105,6 +114,10 @@ private:
   /// Emit the section with compressed function names.
   void emitNameData();
 
+  /// Emit the custom section describing where the counters of a WebAssembly
+  /// module live in its linear memory.
+  void emitWasmLayout();
+
   /// Emit value nodes section for value profiling.
   void emitVNodes();
 
@@ -219,9 +219,10 @@ Pass *createLoopIdiomPass();
 
 //===----------------------------------------------------------------------===//
 //
-// LoopVersioningLICM - This pass is a loop versioning pass for LICM.
+// LoopVersioningLICM - This pass is a loop versioning pass for LICM. Loops
+// with more than MaxBodySize instructions are not versioned (0 for no limit).
 //
-Pass *createLoopVersioningLICMPass();
+Pass *createLoopVersioningLICMPass(unsigned MaxBodySize = 0);
 
 //===----------------------------------------------------------------------===//
 //
@@ -51,6 +51,18 @@ public:
         Tmp->replaceAllUsesWith(Constant::getNullValue(Tmp->getType()));
   }
 
+  /// Allow at most \p Steps instructions to be evaluated in total. With a
+  /// budget, loops are evaluated for as long as the budget lasts; without one
+  /// (the default), revisiting a block makes the evaluation fail.
+  void setStepBudget(unsigned Steps) { MaxSteps = Steps; }
+
+  /// Only read the initializers of global variables that are constant. This
+  /// is required when the evaluated code may run after other code has
+  /// modified memory, i.e. anywhere but in a static constructor.
+  void setOnlyReadConstantGlobals(bool Enable) {
+    OnlyReadConstantGlobals = Enable;
+  }
+
   /// Evaluate a call to function F, returning true if successful, false if we
   /// can't evaluate it.  ActualArgs contains the formal arguments for the
   /// function.
@@ -123,6 +135,14 @@ private:
   /// in a static initializer of a global.
   SmallPtrSet<Constant*, 8> SimpleConstants;
 
+  /// The maximum number of instructions to evaluate, or zero if loops are
+  /// not evaluated at all. Steps counts the instructions evaluated so far.
+  unsigned MaxSteps = 0;
+  unsigned Steps = 0;
+
+  /// Whether loads may only read initializers of constant global variables.
+  bool OnlyReadConstantGlobals = false;
+
   const DataLayout &DL;
   const TargetLibraryInfo *TLI;
 };
@@ -34,6 +34,7 @@
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/BinaryFormat/ELF.h"
+#include "llvm/CodeGen/CodeSizeReport.h"
 #include "llvm/CodeGen/GCMetadata.h"
 #include "llvm/CodeGen/GCMetadataPrinter.h"
 #include "llvm/CodeGen/GCStrategy.h"
@@ -106,6 +107,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
@@ -149,6 +151,13 @@ static cl::opt<bool> EnableRemarksSection(
     cl::desc("Emit a section containing remark diagnostics metadata"),
     cl::init(false));
 
+static cl::opt<std::string> SizeReportFile(
+    "mc-size-report",
+    cl::desc("Write a JSON report attributing the bytes of the object file "
+             "to functions, opcodes, source locations and passes to this "
+             "file"),
+    cl::value_desc("filename"), cl::init(""));
+
 char AsmPrinter::ID = 0;
 
 using gcp_map_type = DenseMap<GCStrategy *, std::unique_ptr<GCMetadataPrinter>>;
@@ -265,6 +274,16 @@ bool AsmPrinter::doInitialization(Module &M) {
 
   OutStreamer->InitSections(false);
 
+  if (!SizeReportFile.empty()) {
+    if (OutStreamer->isObj()) {
+      SizeReport = llvm::make_unique<CodeSizeReport>(*OutStreamer);
+      // Have every MachineFunctionPass record the instructions it inserts.
+      if (MMI)
+        MMI->setTracksInstrProvenance(true);
+    } else
+      M.getContext().emitError("-mc-size-report requires object file output");
+  }
+
   // Emit the version-min deployment target directive if needed.
   //
   // FIXME: If we end up with a collection of these sorts of Darwin-specific
@@ -1015,6 +1034,9 @@ static bool needFuncLabelsForEHOrDebugInfo(const MachineFunction &MF,
 void AsmPrinter::EmitFunctionBody() {
   EmitFunctionHeader();
 
+  if (SizeReport)
+    SizeReport->beginFunction(*MF);
+
   // Emit target-specific gunk before the function body.
   EmitFunctionBodyStart();
 
@@ -1068,6 +1090,9 @@ void AsmPrinter::EmitFunctionBody() {
       if (isVerbose())
         emitComments(MI, OutStreamer->GetCommentOS());
 
+      if (SizeReport)
+        SizeReport->beginInstruction(MI);
+
       switch (MI.getOpcode()) {
       case TargetOpcode::CFI_INSTRUCTION:
         emitCFIInstruction(MI);
@@ -1111,6 +1136,9 @@ void AsmPrinter::EmitFunctionBody() {
       if (MCSymbol *S = MI.getPostInstrSymbol())
         OutStreamer->EmitLabel(S);
 
+      if (SizeReport)
+        SizeReport->endInstruction();
+
       if (ShouldPrintDebugScopes) {
         for (const HandlerInfo &HI : Handlers) {
           NamedRegionTimer T(HI.TimerName, HI.TimerDescription,
@@ -1192,6 +1220,11 @@ void AsmPrinter::EmitFunctionBody() {
     HI.Handler->markFunctionEnd();
   }
 
+  // Jump tables and the like go to other sections and are only accounted for
+  // in the section sizes of the size report.
+  if (SizeReport)
+    SizeReport->endFunction();
+
   // Print out jump tables referenced by the function.
   EmitJumpTableInfo();
 
@@ -1664,6 +1697,17 @@ bool AsmPrinter::doFinalization(Module &M) {
   MMI = nullptr;
 
   OutStreamer->Finish();
+  if (SizeReport) {
+    SizeReport->finalize();
+    std::error_code EC;
+    raw_fd_ostream OS(SizeReportFile, EC, sys::fs::OF_Text);
+    if (EC)
+      M.getContext().emitError("could not open size report file '" +
+                               SizeReportFile + "': " + EC.message());
+    else
+      SizeReport->print(OS, M.getSourceFileName());
+    SizeReport.reset();
+  }
   OutStreamer->reset();
   OwnedMLI.reset();
   OwnedMDT.reset();
@@ -0,0 +1,379 @@
+//===- CodeSizeReport.cpp - Attribute encoded bytes to their origin -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the size report written by the AsmPrinter for
+// -mc-size-report.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/CodeSizeReport.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineInstr.h"
+#include "llvm/CodeGen/TargetInstrInfo.h"
+#include "llvm/CodeGen/TargetSubtargetInfo.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DiagnosticHandler.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/MC/MCAsmLayout.h"
+#include "llvm/MC/MCAssembler.h"
+#include "llvm/MC/MCFragment.h"
+#include "llvm/MC/MCObjectStreamer.h"
+#include "llvm/MC/MCSection.h"
+#include "llvm/MC/MCSectionCOFF.h"
+#include "llvm/MC/MCSectionELF.h"
+#include "llvm/MC/MCSectionMachO.h"
+#include "llvm/MC/MCSectionWasm.h"
+#include "llvm/MC/MCSectionXCOFF.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace llvm;
+
+/// The number of bytes a fragment holds before layout. Only fragments that
+/// hold encoded instructions and data are measured; alignment and other
+/// fragments whose size depends on layout only show up in section sizes.
+static uint64_t getContentsSize(const MCFragment &F) {
+  switch (F.getKind()) {
+  case MCFragment::FT_Data:
+    return cast<MCDataFragment>(F).getContents().size();
+  case MCFragment::FT_Relaxable:
+    return cast<MCRelaxableFragment>(F).getContents().size();
+  case MCFragment::FT_CompactEncodedInst:
+    return cast<MCCompactEncodedInstFragment>(F).getContents().size();
+  default:
+    return 0;
+  }
+}
+
+static StringRef getSectionName(const MCSection &Sec) {
+  switch (Sec.getVariant()) {
+  case MCSection::SV_COFF:
+    return cast<MCSectionCOFF>(Sec).getSectionName();
+  case MCSection::SV_ELF:
+    return cast<MCSectionELF>(Sec).getSectionName();
+  case MCSection::SV_MachO:
+    return cast<MCSectionMachO>(Sec).getSectionName();
+  case MCSection::SV_Wasm:
+    return cast<MCSectionWasm>(Sec).getSectionName();
+  case MCSection::SV_XCOFF:
+    return cast<MCSectionXCOFF>(Sec).getSectionName();
+  }
+  llvm_unreachable("Unknown section variant");
+}
+
+static StringRef getSectionKindName(SectionKind Kind) {
+  if (Kind.isText())
+    return "text";
+  if (Kind.isMetadata())
+    return "metadata";
+  if (Kind.isBSS())
+    return "bss";
+  if (Kind.isReadOnly())
+    return "readonly";
+  if (Kind.isWriteable())
+    return "data";
+  return "other";
+}
+
+CodeSizeReport::CodeSizeReport(MCStreamer &Streamer) : Streamer(Streamer) {}
+
+CodeSizeReport::~CodeSizeReport() = default;
+
+CodeSizeReport::Position CodeSizeReport::getPosition() const {
+  Position P;
+  P.Sec = Streamer.getCurrentSectionOnly();
+  if (!P.Sec)
+    return P;
+  // The AsmPrinter only creates a report for object streamers.
+  P.Frag = static_cast<MCObjectStreamer &>(Streamer).getCurrentFragment();
+  if (P.Frag)
+    P.Offset = getContentsSize(*P.Frag);
+  return P;
+}
+
+/// Return the number of bytes emitted since \p Start, and add the relaxable
+/// fragments created since then to \p Relaxable. Bytes that went to another
+/// section than the one current at \p Start are not counted.
+uint64_t CodeSizeReport::bytesSince(
+    const Position &Start,
+    SmallVectorImpl<const MCRelaxableFragment *> *Relaxable) const {
+  Position End = getPosition();
+  if (!Start.Sec || Start.Sec != End.Sec || !End.Frag)
+    return 0;
+  if (Start.Frag == End.Frag)
+    return End.Offset - Start.Offset;
+
+  uint64_t Size = 0;
+  MCSection::iterator I = Start.Sec->begin();
+  if (Start.Frag) {
+    Size = getContentsSize(*Start.Frag) - Start.Offset;
+    I = std::next(Start.Frag->getIterator());
+  }
+  for (;; ++I) {
+    assert(I != Start.Sec->end() && "End fragment precedes the start");
+    if (Relaxable)
+      if (auto *RF = dyn_cast<MCRelaxableFragment>(&*I))
+        Relaxable->push_back(RF);
+    if (&*I == End.Frag)
+      return Size + End.Offset;
+    Size += getContentsSize(*I);
+  }
+}
+
+void CodeSizeReport::beginFunction(const MachineFunction &MF) {
+  CurMF = &MF;
+  FunctionEntry FE;
+  FE.Name = MF.getName();
+  FE.F = &MF.getFunction();
+  Functions.push_back(std::move(FE));
+  FunctionStart = getPosition();
+}
+
+void CodeSizeReport::endFunction() {
+  assert(CurMF && "endFunction without beginFunction");
+  Functions.back().Size += bytesSince(FunctionStart, nullptr);
+  CurMF = nullptr;
+}
+
+void CodeSizeReport::beginInstruction(const MachineInstr &MI) {
+  CurMI = &MI;
+  InstrStart = getPosition();
+}
+
+void CodeSizeReport::endInstruction() {
+  assert(CurMF && CurMI && "endInstruction without beginInstruction");
+  const MachineInstr &MI = *CurMI;
+  CurMI = nullptr;
+
+  SmallVector<const MCRelaxableFragment *, 1> Relaxable;
+  uint64_t Size = bytesSince(InstrStart, &Relaxable);
+  if (!Size)
+    return;
+
+  FunctionEntry &FE = Functions.back();
+  FE.InstrSize += Size;
+  ++FE.NumInstrs;
+
+  const TargetInstrInfo *TII = CurMF->getSubtarget().getInstrInfo();
+  Entry &Opcode = Opcodes[TII->getName(MI.getOpcode())];
+  Opcode.Size += Size;
+  ++Opcode.Count;
+
+  // Instructions that were not inserted by a MachineFunctionPass, such as
+  // those read from MIR, have no provenance.
+  StringRef PassName = CurMF->getInstrProvenance(MI);
+  if (PassName.empty())
+    PassName = "<unknown>";
+  Entry &Pass = Passes[PassName];
+  Pass.Size += Size;
+  ++Pass.Count;
+
+  std::pair<std::string, unsigned> Loc("", 0);
+  LocationEntry *FunctionLocation = nullptr;
+  uint64_t *FunctionLocationPass = nullptr;
+  if (const DILocation *DL = MI.getDebugLoc().get()) {
+    Loc = std::make_pair(DL->getFilename().str(), DL->getLine());
+    auto Inserted = FE.Locations.insert(std::make_pair(DL, LocationEntry()));
+    FunctionLocation = &Inserted.first->second;
+    if (Inserted.second)
+      FunctionLocation->Order = FE.Locations.size() - 1;
+    FunctionLocation->Total.Size += Size;
+    ++FunctionLocation->Total.Count;
+    FunctionLocationPass = &FunctionLocation->PassBytes[PassName];
+    *FunctionLocationPass += Size;
+  }
+  Entry &Location = Locations[Loc];
+  Location.Size += Size;
+  ++Location.Count;
+
+  for (const MCRelaxableFragment *RF : Relaxable)
+    Relaxations.push_back({RF, getContentsSize(*RF),
+                           unsigned(Functions.size() - 1), &Opcode, &Location,
+                           &Pass, FunctionLocation, FunctionLocationPass});
+}
+
+void CodeSizeReport::addTargetBytes(StringRef Category, StringRef Name,
+                                    uint64_t Size, uint64_t Count) {
+  Entry &E = TargetBytes[Category][Name];
+  E.Size += Size;
+  E.Count += Count;
+}
+
+void CodeSizeReport::finalize() {
+  MCAssembler *Asm = &static_cast<MCObjectStreamer &>(Streamer).getAssembler();
+
+  // Relaxation only ever grows an instruction, in place in its fragment.
+  for (const PendingRelaxation &PR : Relaxations) {
+    uint64_t Growth = getContentsSize(*PR.Frag) - PR.Size;
+    FunctionEntry &FE = Functions[PR.FunctionIdx];
+    FE.Size += Growth;
+    FE.InstrSize += Growth;
+    PR.Opcode->Size += Growth;
+    PR.Location->Size += Growth;
+    PR.Pass->Size += Growth;
+    if (PR.FunctionLocation) {
+      PR.FunctionLocation->Total.Size += Growth;
+      *PR.FunctionLocationPass += Growth;
+    }
+  }
+  Relaxations.clear();
+
+  emitRemarks();
+
+  MCAsmLayout Layout(*Asm);
+  for (MCSection *Sec : Layout.getSectionOrder()) {
+    uint64_t Size = Layout.getSectionAddressSize(Sec);
+    if (Size)
+      Sections.push_back(
+          {getSectionName(*Sec), getSectionKindName(Sec->getKind()), Size});
+  }
+}
+
+/// Emit a remark with the size of every function, and one for every source
+/// location in it with the bytes of its instructions, split up by the pass
+/// that inserted them. With -pass-remarks-output these are written to the
+/// same YAML file as all other remarks, so opt-viewer can show them next to
+/// the source.
+void CodeSizeReport::emitRemarks() const {
+  using NV = DiagnosticInfoOptimizationBase::Argument;
+  static const char *const RemarkPassName = "size-report";
+  if (Functions.empty())
+    return;
+  LLVMContext &Ctx = Functions.front().F->getContext();
+  if (!Ctx.getRemarkStreamer() &&
+      !Ctx.getDiagHandlerPtr()->isAnalysisRemarkEnabled(RemarkPassName))
+    return;
+
+  for (const FunctionEntry &FE : Functions) {
+    const Function &F = *FE.F;
+    OptimizationRemarkAnalysis R(RemarkPassName, "FunctionSize",
+                                 DiagnosticLocation(F.getSubprogram()),
+                                 &F.getEntryBlock());
+    R << NV("Bytes", FE.Size) << " bytes, "
+      << NV("InstructionBytes", FE.InstrSize) << " of them in "
+      << NV("Instructions", FE.NumInstrs) << " instructions";
+    Ctx.diagnose(R);
+
+    std::vector<std::pair<const DILocation *, const LocationEntry *>> Locs;
+    for (const auto &L : FE.Locations)
+      Locs.push_back(std::make_pair(L.first, &L.second));
+    llvm::sort(Locs, [](const std::pair<const DILocation *,
+                                        const LocationEntry *> &A,
+                        const std::pair<const DILocation *,
+                                        const LocationEntry *> &B) {
+      return A.second->Order < B.second->Order;
+    });
+    for (const auto &L : Locs) {
+      const LocationEntry &LE = *L.second;
+      OptimizationRemarkAnalysis R(RemarkPassName, "InstructionSize",
+                                   DiagnosticLocation(DebugLoc(L.first)),
+                                   &F.getEntryBlock());
+      R << NV("Bytes", LE.Total.Size) << " bytes in "
+        << NV("Instructions", LE.Total.Count) << " instructions";
+      // Largest first, then by name so that the order is stable.
+      std::vector<const StringMapEntry<uint64_t> *> PassBytes;
+      for (const StringMapEntry<uint64_t> &P : LE.PassBytes)
+        PassBytes.push_back(&P);
+      llvm::sort(PassBytes, [](const StringMapEntry<uint64_t> *A,
+                               const StringMapEntry<uint64_t> *B) {
+        if (A->getValue() != B->getValue())
+          return A->getValue() > B->getValue();
+        return A->getKey() < B->getKey();
+      });
+      for (const StringMapEntry<uint64_t> *P : PassBytes)
+        R << "; " << NV("Pass", P->getKey()) << ": "
+          << NV("PassBytes", P->getValue());
+      Ctx.diagnose(R);
+    }
+  }
+}
+
+void CodeSizeReport::print(raw_ostream &OS, StringRef SourceFileName) const {
+  auto EmitEntry = [](json::OStream &J, StringRef Key, const Entry &E) {
+    J.object([&] {
+      J.attribute("name", Key);
+      J.attribute("count", int64_t(E.Count));
+      J.attribute("size", int64_t(E.Size));
+    });
+  };
+  // Largest first, so that the interesting entries come at the top.
+  auto SortBySize = [](const StringMap<Entry> &Map) {
+    std::vector<const StringMapEntry<Entry> *> Sorted;
+    for (const StringMapEntry<Entry> &E : Map)
+      Sorted.push_back(&E);
+    llvm::sort(Sorted, [](const StringMapEntry<Entry> *A,
+                          const StringMapEntry<Entry> *B) {
+      if (A->getValue().Size != B->getValue().Size)
+        return A->getValue().Size > B->getValue().Size;
+      return A->getKey() < B->getKey();
+    });
+    return Sorted;
+  };
+
+  json::OStream J(OS, /*IndentSize=*/2);
+  J.object([&] {
+    J.attribute("version", 1);
+    J.attribute("source", SourceFileName);
+    J.attributeArray("sections", [&] {
+      for (const SectionEntry &S : Sections)
+        J.object([&] {
+          J.attribute("name", S.Name);
+          J.attribute("kind", S.Kind);
+          J.attribute("size", int64_t(S.Size));
+        });
+    });
+    J.attributeArray("functions", [&] {
+      for (const FunctionEntry &F : Functions)
+        J.object([&] {
+          J.attribute("name", F.Name);
+          J.attribute("size", int64_t(F.Size));
+          J.attribute("instructions", int64_t(F.NumInstrs));
+          J.attribute("instructionSize", int64_t(F.InstrSize));
+        });
+    });
+    J.attributeArray("opcodes", [&] {
+      for (const StringMapEntry<Entry> *E : SortBySize(Opcodes))
+        EmitEntry(J, E->getKey(), E->getValue());
+    });
+    // The passes that inserted the instructions, see
+    // MachineFunction::getInstrProvenance().
+    J.attributeArray("passes", [&] {
+      for (const StringMapEntry<Entry> *E : SortBySize(Passes))
+        EmitEntry(J, E->getKey(), E->getValue());
+    });
+    // Instructions without a debug location are reported with an empty file
+    // name and line 0.
+    J.attributeArray("locations", [&] {
+      for (const auto &L : Locations)
+        J.object([&] {
+          J.attribute("file", L.first.first);
+          J.attribute("line", int64_t(L.first.second));
+          J.attribute("count", int64_t(L.second.Count));
+          J.attribute("size", int64_t(L.second.Size));
+        });
+    });
+    J.attributeObject("target", [&] {
+      std::vector<StringRef> Categories;
+      for (const auto &C : TargetBytes)
+        Categories.push_back(C.getKey());
+      llvm::sort(Categories);
+      for (StringRef Category : Categories)
+        J.attributeArray(Category, [&] {
+          for (const StringMapEntry<Entry> *E :
+               SortBySize(TargetBytes.find(Category)->getValue()))
+            EmitEntry(J, E->getKey(), E->getValue());
+        });
+    });
+  });
+  OS << '\n';
+}
@@ -370,6 +370,9 @@ MachineFunction::DeleteMachineInstr(MachineInstr *MI) {
   assert((!MI->isCall(MachineInstr::IgnoreBundle) ||
           CallSitesInfo.find(MI) == CallSitesInfo.end()) &&
          "Call site info was not updated!");
+  // The address may be reused for an instruction inserted by another pass.
+  if (!InstrProvenance.empty())
+    InstrProvenance.erase(MI);
   // Strip it for parts. The operand array and the MI object itself are
   // independently recyclable.
   if (MI->Operands)
@@ -380,6 +383,12 @@ MachineFunction::DeleteMachineInstr(MachineInstr *MI) {
   InstructionRecycler.Deallocate(Allocator, MI);
 }
 
+void MachineFunction::recordInstrProvenance(StringRef PassName) {
+  for (const MachineBasicBlock &MBB : *this)
+    for (const MachineInstr &MI : MBB.instrs())
+      InstrProvenance.insert(std::make_pair(&MI, PassName));
+}
+
 /// Allocate a new MachineBasicBlock. Use this instead of
 /// `new MachineBasicBlock'.
 MachineBasicBlock *
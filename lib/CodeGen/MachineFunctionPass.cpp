@@ -72,6 +72,10 @@ bool MachineFunctionPass::runOnFunction(Function &F) {
 
   bool RV = runOnMachineFunction(MF);
 
+  // Attribute the instructions this pass inserted to it.
+  if (MMI.tracksInstrProvenance())
+    MF.recordInstrProvenance(getPassName());
+
   if (ShouldEmitSizeRemarks) {
     // We wanted size remarks. Check if there was a change to the number of
     // MachineInstrs in the module. Emit a remark if there was a change.
@@ -207,6 +207,7 @@ bool MachineModuleInfo::doInitialization(Module &M) {
   CurCallSite = 0;
   UsesMSVCFloatingPoint = UsesMorestackAddr = false;
   HasSplitStack = HasNosplitStack = false;
+  TracksInstrProvenance = false;
   AddrLabelSymbols = nullptr;
   TheModule = &M;
   DbgInfoAvailable = !llvm::empty(M.debug_compile_units());
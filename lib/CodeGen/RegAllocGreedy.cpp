@@ -84,6 +84,7 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumReducedEffort, "Number of functions allocated with reduced effort");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -142,6 +143,27 @@ static cl::opt<bool> ConsiderLocalIntervalCost(
              "candidate when choosing the best split candidate."),
     cl::init(false));
 
+// Machine generated code can have functions large enough for region splitting
+// and eviction chains to take minutes. The effort spent on a function is
+// reduced when its number of live segments exceeds these budgets.
+static cl::opt<unsigned> ReducedEffortSegments(
+    "regalloc-budget-reduced", cl::Hidden,
+    cl::desc("Number of live segments in a function above which region "
+             "splitting is disabled and evictions are limited (0 = never)"),
+    cl::init(1000000));
+
+static cl::opt<unsigned> MinimalEffortSegments(
+    "regalloc-budget-minimal", cl::Hidden,
+    cl::desc("Number of live segments in a function above which only live "
+             "ranges local to a block are split (0 = never)"),
+    cl::init(4000000));
+
+static cl::opt<unsigned> ReducedEffortMaxEvictions(
+    "regalloc-budget-max-evictions", cl::Hidden,
+    cl::desc("Number of times a live range may be evicted when the "
+             "allocation effort is reduced"),
+    cl::init(4));
+
 static RegisterRegAlloc greedyRegAlloc("greedy", "greedy register allocator",
                                        createGreedyRegisterAllocator);
 
@@ -247,6 +269,9 @@ class RAGreedy : public MachineFunctionPass,
     // Cascade - Eviction loop prevention. See canEvictInterference().
     unsigned Cascade = 0;
 
+    // Evictions - Number of times the live range has been evicted.
+    unsigned Evictions = 0;
+
     RegInfo() = default;
   };
 
@@ -411,6 +436,20 @@ class RAGreedy : public MachineFunctionPass,
   /// Set of broken hints that may be reconciled later because of eviction.
   SmallSetVector<LiveInterval *, 8> SetOfBrokenHints;
 
+  /// How hard the allocator tries on the current function, chosen from its
+  /// size by chooseEffortLevel().
+  enum EffortLevel {
+    /// All splitting strategies and unlimited eviction chains.
+    EL_Full,
+    /// No region splitting; global live ranges are split around blocks.
+    /// Live ranges are evicted a limited number of times.
+    EL_Reduced,
+    /// Only live ranges local to a block are split, the others are spilled.
+    /// Live ranges are evicted a limited number of times.
+    EL_Minimal
+  };
+  EffortLevel Effort;
+
 public:
   RAGreedy();
 
@@ -503,6 +542,7 @@ private:
                                  unsigned PhysReg, unsigned &CostPerUseLimit,
                                  SmallVectorImpl<unsigned> &NewVRegs);
   void initializeCSRCost();
+  void chooseEffortLevel();
   unsigned tryBlockSplit(LiveInterval&, AllocationOrder&,
                          SmallVectorImpl<unsigned>&);
   unsigned tryInstructionSplit(LiveInterval&, AllocationOrder&,
@@ -921,6 +961,11 @@ bool RAGreedy::canEvictInterference(LiveInterval &VirtReg, unsigned PhysReg,
         (Intf->isSpillable() ||
          RegClassInfo.getNumAllocatableRegs(MRI->getRegClass(VirtReg.reg)) <
          RegClassInfo.getNumAllocatableRegs(MRI->getRegClass(Intf->reg)));
+      // With reduced effort, bound eviction chains by leaving live ranges
+      // that have been evicted often enough where they are.
+      if (Effort != EL_Full && !Urgent &&
+          ExtraRegInfo[Intf->reg].Evictions >= ReducedEffortMaxEvictions)
+        return false;
       // Only evict older cascades or live ranges without a cascade.
       unsigned IntfCascade = ExtraRegInfo[Intf->reg].Cascade;
       if (Cascade <= IntfCascade) {
@@ -1084,6 +1129,7 @@ void RAGreedy::evictInterference(LiveInterval &VirtReg, unsigned PhysReg,
             VirtReg.isSpillable() < Intf->isSpillable()) &&
            "Cannot decrease cascade number, illegal eviction");
     ExtraRegInfo[Intf->reg].Cascade = Cascade;
+    ++ExtraRegInfo[Intf->reg].Evictions;
     ++NumEvicted;
     NewVRegs.push_back(Intf->reg);
   }
@@ -2475,6 +2521,10 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
     return tryInstructionSplit(VirtReg, Order, NewVRegs);
   }
 
+  // With minimal effort, global live ranges are spilled rather than split.
+  if (Effort == EL_Minimal)
+    return 0;
+
   NamedRegionTimer T("global_split", "Global Splitting", TimerGroupName,
                      TimerGroupDescription, TimePassesIsEnabled);
 
@@ -2493,8 +2543,9 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
 
   // First try to split around a region spanning multiple blocks. RS_Split2
   // ranges already made dubious progress with region splitting, so they go
-  // straight to single block splitting.
-  if (getStage(VirtReg) < RS_Split2) {
+  // straight to single block splitting, as does everything when the effort is
+  // reduced.
+  if (getStage(VirtReg) < RS_Split2 && Effort == EL_Full) {
     unsigned PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
     if (PhysReg || !NewVRegs.empty())
       return PhysReg;
@@ -2817,7 +2868,7 @@ unsigned RAGreedy::tryAssignCSRFirstTime(LiveInterval &VirtReg,
     CostPerUseLimit = 1;
     return 0;
   }
-  if (getStage(VirtReg) < RS_Split) {
+  if (getStage(VirtReg) < RS_Split && Effort == EL_Full) {
     // We choose pre-splitting over using the CSR for the first time if
     // the cost of splitting is lower than CSRCost.
     SA->analyze(&VirtReg);
@@ -2841,6 +2892,51 @@ void RAGreedy::aboutToRemoveInterval(LiveInterval &LI) {
   SetOfBrokenHints.remove(&LI);
 }
 
+/// Choose how hard to try on the current function. The cost of region
+/// splitting and of eviction chains grows with the number of live segments,
+/// which is roughly the number of blocks each virtual register is live in,
+/// summed over all of them.
+void RAGreedy::chooseEffortLevel() {
+  uint64_t Segments = 0;
+  for (unsigned i = 0, e = MRI->getNumVirtRegs(); i != e; ++i) {
+    unsigned Reg = TargetRegisterInfo::index2VirtReg(i);
+    if (LIS->hasInterval(Reg))
+      Segments += LIS->getInterval(Reg).size();
+  }
+
+  Effort = EL_Full;
+  unsigned Budget = 0;
+  if (MinimalEffortSegments && Segments > MinimalEffortSegments) {
+    Effort = EL_Minimal;
+    Budget = MinimalEffortSegments;
+  } else if (ReducedEffortSegments && Segments > ReducedEffortSegments) {
+    Effort = EL_Reduced;
+    Budget = ReducedEffortSegments;
+  }
+  if (Effort == EL_Full)
+    return;
+
+  ++NumReducedEffort;
+  LLVM_DEBUG(dbgs() << "Reduced effort: " << Segments
+                    << " live segments exceed budget of " << Budget << '\n');
+
+  using namespace ore;
+  ORE->emit([&]() {
+    MachineOptimizationRemarkAnalysis R(DEBUG_TYPE, "ComplexityBudget",
+                                        MF->getFunction().getSubprogram(),
+                                        &MF->front());
+    R << "reduced register allocation effort: "
+      << NV("NumLiveSegments", Segments)
+      << " live segments exceed the budget of " << NV("Budget", Budget)
+      << (Effort == EL_Minimal
+              ? "; only live ranges local to a block are split"
+              : "; region splitting is disabled")
+      << " and live ranges are evicted at most "
+      << NV("MaxEvictions", unsigned(ReducedEffortMaxEvictions)) << " times";
+    return R;
+  });
+}
+
 void RAGreedy::initializeCSRCost() {
   // We use the larger one out of the command-line option and the value report
   // by TRI.
@@ -3243,6 +3339,7 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   initializeCSRCost();
 
   calculateSpillWeightsAndHints(*LIS, mf, VRM, *Loops, *MBFI);
+  chooseEffortLevel();
 
   LLVM_DEBUG(LIS->dump());
 
@@ -0,0 +1,354 @@
+//===-- RegAllocLinearScan.cpp - Linear Scan Register Allocator -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the RALinearScan function pass, a register allocator that
+// trades code quality for compile time. It sits between the fast allocator,
+// which works one basic block at a time, and the greedy allocator, whose live
+// range splitting and eviction cascades are expensive on huge functions.
+//
+// Live intervals are allocated in the order of their start points. A live
+// interval either gets a free register, evicts the cheapest set of interfering
+// intervals with a lower spill weight, or is spilled everywhere. There is no
+// live range splitting: the intervals created by spilling around each use get
+// a second chance at a register when they are dequeued, which is how values
+// end up in registers in the gaps between their spilled neighbours.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AllocationOrder.h"
+#include "LiveDebugVariables.h"
+#include "RegAllocBase.h"
+#include "Spiller.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/CalcSpillWeights.h"
+#include "llvm/CodeGen/LiveIntervals.h"
+#include "llvm/CodeGen/LiveRangeEdit.h"
+#include "llvm/CodeGen/LiveRegMatrix.h"
+#include "llvm/CodeGen/LiveStacks.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineLoopInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/Passes.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+#include "llvm/CodeGen/SlotIndexes.h"
+#include "llvm/CodeGen/TargetRegisterInfo.h"
+#include "llvm/CodeGen/VirtRegMap.h"
+#include "llvm/PassAnalysisSupport.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "regalloc"
+
+STATISTIC(NumAssigned, "Number of intervals assigned to a free register");
+STATISTIC(NumEvicted, "Number of intervals spilled to make room");
+STATISTIC(NumSpilledSelf, "Number of intervals spilled for lack of a register");
+
+static RegisterRegAlloc linearScanRegAlloc("linearscan",
+                                           "linear scan register allocator",
+                                           createLinearScanRegisterAllocator);
+
+namespace {
+/// RALinearScan allocates live intervals in the order of their start points
+/// and never splits them. See the file comment for the overall strategy.
+class RALinearScan : public MachineFunctionPass,
+                     public RegAllocBase,
+                     private LiveRangeEdit::Delegate {
+  // context
+  MachineFunction *MF;
+
+  // state
+  std::unique_ptr<Spiller> SpillerInstance;
+
+  /// Unassigned virtual registers ordered by the start of their live interval,
+  /// earliest first. The start is captured when the register is enqueued
+  /// because the spiller may empty a queued interval.
+  using QueueEntry = std::pair<SlotIndex, unsigned>;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>> Queue;
+
+  bool LRE_CanEraseVirtReg(unsigned) override;
+  void LRE_WillShrinkVirtReg(unsigned) override;
+
+public:
+  RALinearScan();
+
+  /// Return the pass name.
+  StringRef getPassName() const override {
+    return "Linear Scan Register Allocator";
+  }
+
+  /// RALinearScan analysis usage.
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  void releaseMemory() override;
+
+  Spiller &spiller() override { return *SpillerInstance; }
+
+  void enqueue(LiveInterval *LI) override {
+    // An empty interval has no start to be ordered by and cannot interfere
+    // with anything, so it takes the first register in its allocation order.
+    if (LI->empty()) {
+      AllocationOrder Order(LI->reg, *VRM, RegClassInfo, Matrix);
+      if (unsigned PhysReg = Order.next()) {
+        ++NumAssigned;
+        Matrix->assign(*LI, PhysReg);
+        return;
+      }
+    }
+    SlotIndex Start = LI->empty() ? LIS->getSlotIndexes()->getZeroIndex()
+                                  : LI->beginIndex();
+    Queue.push(std::make_pair(Start, LI->reg));
+  }
+
+  LiveInterval *dequeue() override {
+    if (Queue.empty())
+      return nullptr;
+    LiveInterval *LI = &LIS->getInterval(Queue.top().second);
+    Queue.pop();
+    return LI;
+  }
+
+  unsigned selectOrSplit(LiveInterval &VirtReg,
+                         SmallVectorImpl<unsigned> &SplitVRegs) override;
+
+  /// Perform register allocation.
+  bool runOnMachineFunction(MachineFunction &mf) override;
+
+  MachineFunctionProperties getRequiredProperties() const override {
+    return MachineFunctionProperties().set(
+        MachineFunctionProperties::Property::NoPHIs);
+  }
+
+  static char ID;
+
+private:
+  /// Collect the virtual registers assigned to PhysReg or its aliases that
+  /// interfere with VirtReg. Return false if any of them cannot be spilled or
+  /// is more expensive to spill than VirtReg; MaxWeight is set to the highest
+  /// spill weight among them otherwise.
+  bool collectEvictable(LiveInterval &VirtReg, unsigned PhysReg,
+                        SmallVectorImpl<LiveInterval *> &Intfs,
+                        float &MaxWeight);
+
+  /// Spill the live intervals in Intfs, appending the new intervals to
+  /// SplitVRegs.
+  void evict(ArrayRef<LiveInterval *> Intfs,
+             SmallVectorImpl<unsigned> &SplitVRegs);
+};
+
+char RALinearScan::ID = 0;
+
+} // end anonymous namespace
+
+char &llvm::RALinearScanID = RALinearScan::ID;
+
+INITIALIZE_PASS_BEGIN(RALinearScan, "regalloclinearscan",
+                      "Linear Scan Register Allocator", false, false)
+INITIALIZE_PASS_DEPENDENCY(LiveDebugVariables)
+INITIALIZE_PASS_DEPENDENCY(SlotIndexes)
+INITIALIZE_PASS_DEPENDENCY(LiveIntervals)
+INITIALIZE_PASS_DEPENDENCY(RegisterCoalescer)
+INITIALIZE_PASS_DEPENDENCY(MachineScheduler)
+INITIALIZE_PASS_DEPENDENCY(LiveStacks)
+INITIALIZE_PASS_DEPENDENCY(MachineDominatorTree)
+INITIALIZE_PASS_DEPENDENCY(MachineLoopInfo)
+INITIALIZE_PASS_DEPENDENCY(VirtRegMap)
+INITIALIZE_PASS_DEPENDENCY(LiveRegMatrix)
+INITIALIZE_PASS_END(RALinearScan, "regalloclinearscan",
+                    "Linear Scan Register Allocator", false, false)
+
+bool RALinearScan::LRE_CanEraseVirtReg(unsigned VirtReg) {
+  LiveInterval &LI = LIS->getInterval(VirtReg);
+  if (VRM->hasPhys(VirtReg)) {
+    Matrix->unassign(LI);
+    aboutToRemoveInterval(LI);
+    return true;
+  }
+  // Unassigned virtreg is probably in the queue.
+  // RegAllocBase will erase it after dequeueing.
+  LI.clear();
+  return false;
+}
+
+void RALinearScan::LRE_WillShrinkVirtReg(unsigned VirtReg) {
+  if (!VRM->hasPhys(VirtReg))
+    return;
+
+  // Register is assigned, put it back on the queue for reassignment.
+  LiveInterval &LI = LIS->getInterval(VirtReg);
+  Matrix->unassign(LI);
+  enqueue(&LI);
+}
+
+RALinearScan::RALinearScan() : MachineFunctionPass(ID) {}
+
+void RALinearScan::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesCFG();
+  AU.addRequired<AAResultsWrapperPass>();
+  AU.addPreserved<AAResultsWrapperPass>();
+  AU.addRequired<LiveIntervals>();
+  AU.addPreserved<LiveIntervals>();
+  AU.addPreserved<SlotIndexes>();
+  AU.addRequired<LiveDebugVariables>();
+  AU.addPreserved<LiveDebugVariables>();
+  AU.addRequired<LiveStacks>();
+  AU.addPreserved<LiveStacks>();
+  AU.addRequired<MachineBlockFrequencyInfo>();
+  AU.addPreserved<MachineBlockFrequencyInfo>();
+  AU.addRequiredID(MachineDominatorsID);
+  AU.addPreservedID(MachineDominatorsID);
+  AU.addRequired<MachineLoopInfo>();
+  AU.addPreserved<MachineLoopInfo>();
+  AU.addRequired<VirtRegMap>();
+  AU.addPreserved<VirtRegMap>();
+  AU.addRequired<LiveRegMatrix>();
+  AU.addPreserved<LiveRegMatrix>();
+  MachineFunctionPass::getAnalysisUsage(AU);
+}
+
+void RALinearScan::releaseMemory() {
+  SpillerInstance.reset();
+}
+
+bool RALinearScan::collectEvictable(LiveInterval &VirtReg, unsigned PhysReg,
+                                    SmallVectorImpl<LiveInterval *> &Intfs,
+                                    float &MaxWeight) {
+  Intfs.clear();
+  MaxWeight = 0;
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units) {
+    LiveIntervalUnion::Query &Q = Matrix->query(VirtReg, *Units);
+    Q.collectInterferingVRegs();
+    for (LiveInterval *Intf : Q.interferingVRegs()) {
+      if (!Intf->isSpillable() || Intf->weight >= VirtReg.weight)
+        return false;
+      MaxWeight = std::max(MaxWeight, Intf->weight);
+      Intfs.push_back(Intf);
+    }
+  }
+  return true;
+}
+
+void RALinearScan::evict(ArrayRef<LiveInterval *> Intfs,
+                         SmallVectorImpl<unsigned> &SplitVRegs) {
+  for (LiveInterval *Intf : Intfs) {
+    // The same interval may interfere through several register units.
+    if (!VRM->hasPhys(Intf->reg))
+      continue;
+
+    LLVM_DEBUG(dbgs() << "evicting " << *Intf << '\n');
+    Matrix->unassign(*Intf);
+    ++NumEvicted;
+
+    LiveRangeEdit LRE(Intf, SplitVRegs, *MF, *LIS, VRM, this, &DeadRemats);
+    spiller().spill(LRE);
+  }
+}
+
+// Pick a register for VirtReg. A free register in allocation order, which
+// puts hints first, is taken right away. Otherwise the register whose
+// interfering intervals are cheapest to spill is freed up, provided all of
+// them are cheaper than VirtReg. Failing that, VirtReg itself is spilled.
+//
+// Each candidate register is queried at most twice, so the cost per interval
+// is bounded by the size of its register class, and no interval is ever
+// revisited except for the small intervals the spiller creates.
+unsigned RALinearScan::selectOrSplit(LiveInterval &VirtReg,
+                                     SmallVectorImpl<unsigned> &SplitVRegs) {
+  SmallVector<unsigned, 8> EvictionCands;
+
+  AllocationOrder Order(VirtReg.reg, *VRM, RegClassInfo, Matrix);
+  while (unsigned PhysReg = Order.next()) {
+    switch (Matrix->checkInterference(VirtReg, PhysReg)) {
+    case LiveRegMatrix::IK_Free:
+      ++NumAssigned;
+      return PhysReg;
+
+    case LiveRegMatrix::IK_VirtReg:
+      EvictionCands.push_back(PhysReg);
+      continue;
+
+    default:
+      // RegMask or RegUnit interference.
+      continue;
+    }
+  }
+
+  unsigned BestPhysReg = 0;
+  float BestWeight = 0;
+  SmallVector<LiveInterval *, 8> Intfs;
+  for (unsigned PhysReg : EvictionCands) {
+    float MaxWeight;
+    if (!collectEvictable(VirtReg, PhysReg, Intfs, MaxWeight))
+      continue;
+    if (!BestPhysReg || MaxWeight < BestWeight) {
+      BestPhysReg = PhysReg;
+      BestWeight = MaxWeight;
+    }
+  }
+
+  if (BestPhysReg) {
+    // Intfs holds the interferences of the last candidate; collect those of
+    // the winner again. The interference queries are cached, so this is cheap.
+    collectEvictable(VirtReg, BestPhysReg, Intfs, BestWeight);
+    LLVM_DEBUG(dbgs() << "freeing " << printReg(BestPhysReg, TRI) << " for "
+                      << VirtReg << '\n');
+    evict(Intfs, SplitVRegs);
+    assert(!Matrix->checkInterference(VirtReg, BestPhysReg) &&
+           "Interference after eviction.");
+    return BestPhysReg;
+  }
+
+  // Nothing cheaper is in the way, so spill VirtReg everywhere.
+  LLVM_DEBUG(dbgs() << "spilling: " << VirtReg << '\n');
+  if (!VirtReg.isSpillable())
+    return ~0u;
+  ++NumSpilledSelf;
+  LiveRangeEdit LRE(&VirtReg, SplitVRegs, *MF, *LIS, VRM, this, &DeadRemats);
+  spiller().spill(LRE);
+
+  // The live virtual register requesting allocation was spilled, so tell
+  // the caller not to allocate anything during this round.
+  return 0;
+}
+
+bool RALinearScan::runOnMachineFunction(MachineFunction &mf) {
+  LLVM_DEBUG(dbgs() << "********** LINEAR SCAN REGISTER ALLOCATION **********\n"
+                    << "********** Function: " << mf.getName() << '\n');
+
+  MF = &mf;
+  RegAllocBase::init(getAnalysis<VirtRegMap>(),
+                     getAnalysis<LiveIntervals>(),
+                     getAnalysis<LiveRegMatrix>());
+
+  calculateSpillWeightsAndHints(*LIS, *MF, VRM,
+                                getAnalysis<MachineLoopInfo>(),
+                                getAnalysis<MachineBlockFrequencyInfo>());
+
+  SpillerInstance.reset(createInlineSpiller(*this, *MF, *VRM));
+
+  allocatePhysRegs();
+  postOptimization();
+
+  // Diagnostic output before rewriting
+  LLVM_DEBUG(dbgs() << "Post alloc VirtRegMap:\n" << *VRM << "\n");
+
+  releaseMemory();
+  return true;
+}
+
+FunctionPass *llvm::createLinearScanRegisterAllocator() {
+  return new RALinearScan();
+}
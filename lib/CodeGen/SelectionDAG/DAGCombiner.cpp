@@ -29,6 +29,7 @@
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/MemoryLocation.h"
 #include "llvm/CodeGen/DAGCombine.h"
@@ -57,21 +58,27 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/DebugCounter.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/KnownBits.h"
 #include "llvm/Support/MachineValueType.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <iterator>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace llvm;
 
@@ -84,6 +91,11 @@ STATISTIC(OpsNarrowed     , "Number of load/op/store narrowed");
 STATISTIC(LdStFP2Int      , "Number of fp load/store pairs transformed to int");
 STATISTIC(SlicedLoads, "Number of load sliced");
 STATISTIC(NumFPLogicOpsConv, "Number of logic ops converted to fp ops");
+STATISTIC(NumVisitLimitHits, "Number of nodes no longer combined because "
+                             "they reached the visit limit");
+
+DEBUG_COUNTER(DAGCombineCounter, "dagcombine",
+              "Controls whether a DAG combine is performed for a node");
 
 static cl::opt<bool>
 CombinerGlobalAA("combiner-global-alias-analysis", cl::Hidden,
@@ -115,6 +127,91 @@ static cl::opt<unsigned> TokenFactorInlineLimit(
     "combiner-tokenfactor-inline-limit", cl::Hidden, cl::init(2048),
     cl::desc("Limit the number of operands to inline for Token Factors"));
 
+/// Bound on how often a single node is combined during one run of the
+/// combiner. Pathological DAGs can keep requeueing the same nodes, each visit
+/// requeueing its operands and users; once a node reaches the limit it is only
+/// considered for deletion.
+static cl::opt<unsigned> MaxNodeVisits(
+    "combiner-max-node-visits", cl::Hidden, cl::init(1000),
+    cl::desc("Limit the number of times a node is combined in one run of the "
+             "DAG combiner (0 = unlimited)"));
+
+static cl::opt<bool>
+CombinerStats("combiner-stats", cl::Hidden, cl::init(false),
+              cl::desc("Report how often the DAG combines for each opcode are "
+                       "attempted and fire, and the time spent in them"));
+
+namespace {
+
+/// Per-opcode counters collected under -combiner-stats.
+struct CombineRuleStats {
+  uint64_t Visits = 0;
+  uint64_t Fired = 0;
+  std::chrono::nanoseconds Time{0};
+
+  void merge(const CombineRuleStats &Other) {
+    Visits += Other.Visits;
+    Fired += Other.Fired;
+    Time += Other.Time;
+  }
+};
+
+/// The statistics of all combiner runs in the process, keyed by operation
+/// name. The table is printed when it is destroyed by llvm_shutdown, next to
+/// the -stats and -time-passes reports.
+class CombineStatsTable {
+  sys::SmartMutex<true> Lock;
+  StringMap<CombineRuleStats> Rules;
+
+public:
+  ~CombineStatsTable() {
+    if (!Rules.empty())
+      print(*CreateInfoOutputFile());
+  }
+
+  void merge(StringRef Name, const CombineRuleStats &Stats) {
+    sys::SmartScopedLock<true> Guard(Lock);
+    Rules[Name].merge(Stats);
+  }
+
+  void print(raw_ostream &OS) {
+    std::vector<const StringMapEntry<CombineRuleStats> *> Sorted;
+    CombineRuleStats Total;
+    for (const auto &Entry : Rules) {
+      Sorted.push_back(&Entry);
+      Total.merge(Entry.getValue());
+    }
+    // Most expensive first; ties are broken by name to keep the output
+    // deterministic.
+    llvm::sort(Sorted, [](const StringMapEntry<CombineRuleStats> *A,
+                          const StringMapEntry<CombineRuleStats> *B) {
+      if (A->getValue().Time != B->getValue().Time)
+        return A->getValue().Time > B->getValue().Time;
+      return A->getKey() < B->getKey();
+    });
+
+    OS << "===" << std::string(73, '-') << "===\n"
+       << "                        ... DAG combine statistics ...\n"
+       << "===" << std::string(73, '-') << "===\n\n";
+    auto PrintRow = [&OS](const CombineRuleStats &Stats, StringRef Name) {
+      OS << format("%10llu %10llu %12.4f  ", (unsigned long long)Stats.Visits,
+                   (unsigned long long)Stats.Fired,
+                   std::chrono::duration<double>(Stats.Time).count())
+         << Name << '\n';
+    };
+    OS << "    Visits   Combined     Time (s)  Node\n";
+    for (const auto *Entry : Sorted)
+      PrintRow(Entry->getValue(), Entry->getKey());
+    PrintRow(Total, "Total");
+    OS << '\n';
+    OS.flush();
+  }
+};
+
+} // end anonymous namespace
+
+static ManagedStatic<CombineStatsTable> GlobalCombineStats;
+
 namespace {
 
   class DAGCombiner {
@@ -141,16 +238,22 @@ namespace {
     /// them) when they are deleted from the underlying DAG. It relies on
     /// stable indices of nodes within the worklist.
     DenseMap<SDNode *, unsigned> WorklistMap;
+
     /// This records all nodes attempted to add to the worklist since we
     /// considered a new worklist entry. As we keep do not add duplicate nodes
     /// in the worklist, this is different from the tail of the worklist.
     SmallSetVector<SDNode *, 32> PruningList;
 
-    /// Set of nodes which have been combined (at least once).
+    /// Number of times each node has been combined (at least once).
     ///
     /// This is used to allow us to reliably add any operands of a DAG node
-    /// which have not yet been combined to the worklist.
-    SmallPtrSet<SDNode *, 32> CombinedNodes;
+    /// which have not yet been combined to the worklist, and to stop
+    /// combining a node once it reaches -combiner-max-node-visits.
+    DenseMap<SDNode *, unsigned> CombinedNodes;
+
+    /// Per-opcode statistics of this run, merged into the process-wide table
+    /// at the end of Run. Only maintained under -combiner-stats.
+    DenseMap<unsigned, std::pair<std::string, CombineRuleStats>> RunStats;
 
     // AA - Used for DAG load/store alias analysis.
     AliasAnalysis *AA;
@@ -193,6 +296,19 @@ namespace {
       return N;
     }
 
+    /// Whether N has been combined as often as -combiner-max-node-visits
+    /// allows. Otherwise count this visit.
+    bool reachedVisitLimit(SDNode *N) {
+      unsigned &Visits = CombinedNodes[N];
+      if (MaxNodeVisits && Visits >= MaxNodeVisits)
+        return true;
+      ++Visits;
+      return false;
+    }
+
+    /// Run the combines for N, recording their cost under -combiner-stats.
+    SDValue combineAndRecord(SDNode *N);
+
     /// Call the node-specific routine that folds each particular type of node.
     SDValue visit(SDNode *N);
 
@@ -1600,15 +1716,24 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
 
     LLVM_DEBUG(dbgs() << "\nCombining: "; N->dump(&DAG));
 
+    // Nodes that keep being requeued are left alone once they reach the visit
+    // limit; they are still deleted above when they become dead.
+    if (reachedVisitLimit(N)) {
+      ++NumVisitLimitHits;
+      continue;
+    }
+
     // Add any operands of the new node which have not yet been combined to the
     // worklist as well. Because the worklist uniques things already, this
     // won't repeatedly process the same operand.
-    CombinedNodes.insert(N);
     for (const SDValue &ChildN : N->op_values())
       if (!CombinedNodes.count(ChildN.getNode()))
         AddToWorklist(ChildN.getNode());
 
-    SDValue RV = combine(N);
+    if (!DebugCounter::shouldExecute(DAGCombineCounter))
+      continue;
+
+    SDValue RV = combineAndRecord(N);
 
     if (!RV.getNode())
       continue;
@@ -1650,6 +1775,28 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
   // If the root changed (e.g. it was a dead load, update the root).
   DAG.setRoot(Dummy.getValue());
   DAG.RemoveDeadNodes();
+
+  for (const auto &Entry : RunStats)
+    GlobalCombineStats->merge(Entry.second.first, Entry.second.second);
+}
+
+SDValue DAGCombiner::combineAndRecord(SDNode *N) {
+  if (!CombinerStats)
+    return combine(N);
+
+  // Capture everything needed about N up front; the combine may delete it.
+  auto &Entry = RunStats[N->getOpcode()];
+  if (Entry.first.empty())
+    Entry.first = N->getOperationName(&DAG);
+  CombineRuleStats &Stats = Entry.second;
+
+  auto Start = std::chrono::steady_clock::now();
+  SDValue RV = combine(N);
+  Stats.Time += std::chrono::steady_clock::now() - Start;
+  ++Stats.Visits;
+  if (RV.getNode())
+    ++Stats.Fired;
+  return RV;
 }
 
 SDValue DAGCombiner::visit(SDNode *N) {
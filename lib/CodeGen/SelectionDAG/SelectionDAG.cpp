@@ -99,6 +99,11 @@ static cl::opt<int> MaxLdStGlue("ldstmemcpy-glue-max",
        cl::desc("Number limit for gluing ld/st of memcpy."),
        cl::Hidden, cl::init(0));
 
+static cl::opt<unsigned> MaxRetainedOperandMemory(
+    "selectiondag-max-retained-operand-memory", cl::Hidden, cl::init(16 << 20),
+    cl::desc("Maximum number of bytes of operand storage kept for reuse "
+             "when a SelectionDAG is cleared"));
+
 static void NewSDValueDbgMsg(SDValue V, StringRef Msg, SelectionDAG *G) {
   LLVM_DEBUG(dbgs() << Msg; V.getNode()->dump(G););
 }
@@ -1027,8 +1032,15 @@ SelectionDAG::~SelectionDAG() {
 void SelectionDAG::allnodes_clear() {
   assert(&*AllNodes.begin() == &EntryNode);
   AllNodes.remove(AllNodes.begin());
-  while (!AllNodes.empty())
-    DeallocateNode(&AllNodes.front());
+  // This is DeallocateNode, minus the per-node update of the debug info: the
+  // callers discard all of it anyway.
+  while (!AllNodes.empty()) {
+    SDNode *N = &AllNodes.front();
+    removeOperands(N);
+    NodeAllocator.Deallocate(AllNodes.remove(N));
+    __asan_unpoison_memory_region(&N->NodeType, sizeof(N->NodeType));
+    N->NodeType = ISD::DELETED_NODE;
+  }
 #ifndef NDEBUG
   NextPersistentId = 0;
 #endif
@@ -1075,10 +1087,27 @@ SDNode *SelectionDAG::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
 }
 
 void SelectionDAG::clear() {
+  // Clearing the CSE map touches every bucket. Once a large block has grown
+  // the table, that dominates the cost of clearing the DAG of a small block,
+  // so unlink the nodes one by one instead when there are few of them. This
+  // must happen before the nodes are deallocated.
+  if (CSEMap.size() * 64 < CSEMap.capacity()) {
+    for (SDNode &N : AllNodes)
+      CSEMap.RemoveNode(&N);
+    assert(CSEMap.empty() && "Node in the CSE map but not in the DAG?");
+  } else {
+    CSEMap.clear();
+  }
+
+  // The nodes and their operand arrays go back to the recyclers and are reused
+  // by the next DAG. The operand memory is only released once it grows past
+  // the retention limit, so that a function with many blocks doesn't pay for
+  // allocating it again for every block.
   allnodes_clear();
-  OperandRecycler.clear(OperandAllocator);
-  OperandAllocator.Reset();
-  CSEMap.clear();
+  if (OperandAllocator.getTotalMemory() > MaxRetainedOperandMemory) {
+    OperandRecycler.clear(OperandAllocator);
+    OperandAllocator.Reset();
+  }
 
   ExtendedValueTypeNodes.clear();
   ExternalSymbols.clear();
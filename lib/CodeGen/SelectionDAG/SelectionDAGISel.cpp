@@ -1015,7 +1015,11 @@ void SelectionDAGISel::CodeGenAndEmitDAG() {
   }
 
   // Free the SelectionDAG state, now that we're finished with it.
-  CurDAG->clear();
+  {
+    NamedRegionTimer T("clear", "DAG Teardown", GroupName, GroupDescription,
+                       TimePassesIsEnabled);
+    CurDAG->clear();
+  }
 }
 
 namespace {
@@ -53,6 +53,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/CFG.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
 #include "llvm/CodeGen/MachineDominators.h"
@@ -61,9 +62,11 @@
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineLoopInfo.h"
+#include "llvm/CodeGen/MachineMemOperand.h"
 #include "llvm/CodeGen/MachineOperand.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/MachinePostDominators.h"
+#include "llvm/CodeGen/PseudoSourceValue.h"
 #include "llvm/CodeGen/RegisterClassInfo.h"
 #include "llvm/CodeGen/RegisterScavenging.h"
 #include "llvm/CodeGen/TargetFrameLowering.h"
@@ -71,8 +74,10 @@
 #include "llvm/CodeGen/TargetLowering.h"
 #include "llvm/CodeGen/TargetRegisterInfo.h"
 #include "llvm/CodeGen/TargetSubtargetInfo.h"
+#include "llvm/IR/Argument.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalValue.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
@@ -156,6 +161,10 @@ class ShrinkWrap : public MachineFunctionPass {
   /// Current MachineFunction.
   MachineFunction *MachineFunc;
 
+  /// Whether memory accesses known not to touch the stack frame can be
+  /// ignored.
+  bool IgnoreNonStackAccesses;
+
   /// Check if \p MI uses or defines a callee-saved register or
   /// a frame index. If this is the case, this means \p MI must happen
   /// after Save and before Restore.
@@ -202,6 +211,8 @@ class ShrinkWrap : public MachineFunctionPass {
     Entry = &MF.front();
     CurrentCSRs.clear();
     MachineFunc = &MF;
+    IgnoreNonStackAccesses =
+        Subtarget.getFrameLowering()->shrinkWrapIgnoresNonStackAccesses(MF);
 
     ++NumFunc;
   }
@@ -230,10 +241,9 @@ public:
     MachineFunctionPass::getAnalysisUsage(AU);
   }
 
-  MachineFunctionProperties getRequiredProperties() const override {
-    return MachineFunctionProperties().set(
-      MachineFunctionProperties::Property::NoVRegs);
-  }
+  // This pass does not require the NoVRegs property: WebAssembly keeps virtual
+  // registers past register allocation, and they are simply ignored when
+  // looking for uses of callee-saved registers.
 
   StringRef getPassName() const override { return "Shrink Wrapping analysis"; }
 
@@ -256,15 +266,47 @@ INITIALIZE_PASS_DEPENDENCY(MachineLoopInfo)
 INITIALIZE_PASS_DEPENDENCY(MachineOptimizationRemarkEmitterPass)
 INITIALIZE_PASS_END(ShrinkWrap, DEBUG_TYPE, "Shrink Wrap Pass", false, false)
 
+/// Return true if all memory accessed by \p MI is known to lie outside of
+/// the stack frame of the current function: globals, constants and objects
+/// that the caller passed in.
+static bool isNonStackAccess(const MachineInstr &MI, const DataLayout &DL) {
+  if (MI.memoperands_empty() || MI.hasUnmodeledSideEffects())
+    return false;
+  for (const MachineMemOperand *MMO : MI.memoperands()) {
+    if (const PseudoSourceValue *PSV = MMO->getPseudoValue()) {
+      if (PSV->isGOT() || PSV->isConstantPool() || PSV->isJumpTable())
+        continue;
+      return false;
+    }
+    const Value *V = MMO->getValue();
+    if (!V)
+      return false;
+    const Value *Obj = GetUnderlyingObject(V, DL);
+    if (isa<GlobalValue>(Obj))
+      continue;
+    if (const auto *Arg = dyn_cast<Argument>(Obj))
+      if (!Arg->hasByValOrInAllocaAttr())
+        continue;
+    return false;
+  }
+  return true;
+}
+
 bool ShrinkWrap::useOrDefCSROrFI(const MachineInstr &MI,
                                  RegScavenger *RS) const {
   // This prevents premature stack popping when occurs a indirect stack
   // access. It is overly aggressive for the moment.
-  // TODO: - Obvious non-stack loads and store, such as global values,
-  //         are known to not access the stack.
-  //       - Further, data dependency and alias analysis can validate
-  //         that load and stores never derive from the stack pointer.
-  if (MI.mayLoadOrStore())
+  // TODO: Data dependency and alias analysis can validate that load and
+  //       stores never derive from the stack pointer.
+  if (MI.mayLoadOrStore() &&
+      !(IgnoreNonStackAccesses &&
+        isNonStackAccess(MI, MachineFunc->getDataLayout())))
+    return true;
+
+  // A call or inline asm may reach a frame object whose address escaped
+  // earlier, e.g. through a global. When non-stack accesses are ignored, it
+  // may not mention the stack pointer or a callee-saved register either.
+  if (IgnoreNonStackAccesses && (MI.isCall() || MI.isInlineAsm()))
     return true;
 
   if (MI.getOpcode() == FrameSetupOpcode ||
@@ -279,10 +321,10 @@ bool ShrinkWrap::useOrDefCSROrFI(const MachineInstr &MI,
       if (!MO.isDef() && !MO.readsReg())
         continue;
       unsigned PhysReg = MO.getReg();
-      if (!PhysReg)
+      // Virtual registers, which targets without a register allocator keep
+      // until emission, are neither callee-saved nor the stack pointer.
+      if (!PhysReg || TargetRegisterInfo::isVirtualRegister(PhysReg))
         continue;
-      assert(TargetRegisterInfo::isPhysicalRegister(PhysReg) &&
-             "Unallocated register?!");
       // The stack pointer is not normally described as a callee-saved register
       // in calling convention definitions, so we need to watch for it
       // separately. An SP mentioned by a call instruction, we can ignore,
@@ -1692,6 +1692,11 @@ static SectionKind getWasmKindForNamedSection(StringRef Name, SectionKind K) {
   if (K.isText())
     return SectionKind::getText();
 
+  // Globals placed in a ".custom_section." section make up the contents of a
+  // custom section of that name rather than of a data segment.
+  if (Name.startswith(".custom_section."))
+    return SectionKind::getMetadata();
+
   // Otherwise, ignore whatever section type the generic impl detected and use
   // a plain data section.
   return SectionKind::getData();
@@ -847,6 +847,7 @@ DWARFContext::getLineTableForUnit(DWARFUnit *U) {
 
 Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
     DWARFUnit *U, std::function<void(Error)> RecoverableErrorCallback) {
+  std::lock_guard<std::mutex> Lock(LineMutex);
   if (!Line)
     Line.reset(new DWARFDebugLine);
 
@@ -21,6 +21,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include <algorithm>
 #include <cassert>
@@ -126,6 +127,25 @@ DWARFUnit *DWARFUnitVector::addUnit(std::unique_ptr<DWARFUnit> Unit) {
   return this->insert(I, std::move(Unit))->get();
 }
 
+void DWARFUnitVector::extractDIEs(unsigned NumThreads) {
+  // The abbreviations of all units are parsed lazily into a cache shared
+  // between the units, so parse them from this thread first. Extracting the
+  // DIEs of a unit only touches the unit itself after that.
+  for (const auto &U : *this)
+    U->getAbbreviations();
+  if (NumThreads <= 1) {
+    for (const auto &U : *this)
+      U->getUnitDIE(/* ExtractUnitDIEOnly = */ false);
+    return;
+  }
+  ThreadPool Pool(NumThreads);
+  for (const auto &U : *this) {
+    DWARFUnit *Unit = U.get();
+    Pool.async([Unit] { Unit->getUnitDIE(/* ExtractUnitDIEOnly = */ false); });
+  }
+  Pool.wait();
+}
+
 DWARFUnit *DWARFUnitVector::getUnitForOffset(uint32_t Offset) const {
   auto end = begin() + getNumInfoUnits();
   auto *CU =
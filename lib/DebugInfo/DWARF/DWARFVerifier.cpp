@@ -16,6 +16,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFSection.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -280,10 +281,30 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   bool hasDIE = DebugInfoData.isValidOffset(Offset);
   DWARFUnitVector TypeUnitVector;
   DWARFUnitVector CompileUnitVector;
+
+  // When verifying in parallel, each unit gets its own verifier which
+  // buffers the diagnostics for the unit's header and contents.
+  struct UnitShard {
+    std::string Output;
+    raw_string_ostream OS;
+    DWARFVerifier Verifier;
+    DWARFUnit *Unit = nullptr;
+    unsigned NumErrors = 0;
+    UnitShard(DWARFContext &DCtx, DIDumpOptions DumpOpts)
+        : OS(Output), Verifier(OS, DCtx, std::move(DumpOpts)) {}
+  };
+  const bool Parallel = DumpOpts.NumThreads > 1;
+  std::vector<std::unique_ptr<UnitShard>> Shards;
+
   while (hasDIE) {
     OffsetStart = Offset;
-    if (!verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
-                          isUnitDWARF64)) {
+    DWARFVerifier *V = this;
+    if (Parallel) {
+      Shards.push_back(llvm::make_unique<UnitShard>(DCtx, DumpOpts));
+      V = &Shards.back()->Verifier;
+    }
+    if (!V->verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
+                             isUnitDWARF64)) {
       isHeaderChainValid = false;
       if (isUnitDWARF64)
         break;
@@ -318,11 +339,40 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
       }
       default: { llvm_unreachable("Invalid UnitType."); }
       }
-      NumDebugInfoErrors += verifyUnitContents(*Unit);
+      if (Parallel)
+        Shards.back()->Unit = Unit;
+      else
+        NumDebugInfoErrors += verifyUnitContents(*Unit);
     }
     hasDIE = DebugInfoData.isValidOffset(Offset);
     ++UnitIdx;
   }
+
+  if (Parallel) {
+    // A DIE may refer to a DIE of another unit, so extract all of them before
+    // any unit is verified. The location lists are parsed lazily as well.
+    CompileUnitVector.extractDIEs(DumpOpts.NumThreads);
+    TypeUnitVector.extractDIEs(DumpOpts.NumThreads);
+    DCtx.getDebugLoc();
+
+    ThreadPool Pool(DumpOpts.NumThreads);
+    for (auto &Shard : Shards) {
+      if (!Shard->Unit)
+        continue;
+      UnitShard *S = Shard.get();
+      Pool.async(
+          [S] { S->NumErrors = S->Verifier.verifyUnitContents(*S->Unit); });
+    }
+    Pool.wait();
+
+    for (auto &Shard : Shards) {
+      OS << Shard->OS.str();
+      NumDebugInfoErrors += Shard->NumErrors;
+      for (const auto &Ref : Shard->Verifier.ReferenceToDIEOffsets)
+        ReferenceToDIEOffsets[Ref.first].insert(Ref.second.begin(),
+                                                Ref.second.end());
+    }
+  }
   if (UnitIdx == 0 && !hasDIE) {
     warn() << "Section is empty.\n";
     isHeaderChainValid = true;
@@ -0,0 +1,298 @@
+//===- DwarfTransformer.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/InlineInfo.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_ostream.h"
+#include <inttypes.h>
+#include <mutex>
+
+using namespace llvm;
+using namespace gsym;
+
+struct llvm::gsym::CUInfo {
+  const DWARFDebugLine::LineTable *LineTable;
+  const char *CompDir;
+  std::vector<uint32_t> FileCache;
+
+  CUInfo(DWARFContext &DICtx, DWARFUnit *CU) {
+    // Both of these are parsed and cached lazily by the DWARF parser, which
+    // isn't thread safe, so they must be looked up before the compile unit
+    // is handed to a worker thread.
+    LineTable = DICtx.getLineTableForUnit(CU);
+    CompDir = CU->getCompilationDir();
+    if (LineTable)
+      FileCache.assign(LineTable->Prologue.FileNames.size() + 1, UINT32_MAX);
+  }
+
+  /// Convert a DWARF compile unit file index into a GSYM global file index.
+  ///
+  /// Each compile unit in DWARF has its own file table in the line table
+  /// prologue. GSYM has a single large file table that applies to all files
+  /// from all of the info in a GSYM file. This function converts between the
+  /// two and caches and DWARF CU file index that has already been converted so
+  /// the first client that asks for a compile unit file index will end up
+  /// doing the conversion, and subsequent clients will get the cached GSYM
+  /// index.
+  uint32_t DWARFToGSYMFileIndex(GsymCreator &Gsym, uint64_t DwarfFileIdx) {
+    if (!LineTable || DwarfFileIdx >= FileCache.size())
+      return 0;
+    uint32_t &GsymFileIdx = FileCache[DwarfFileIdx];
+    if (GsymFileIdx != UINT32_MAX)
+      return GsymFileIdx;
+    std::string File;
+    if (LineTable->getFileNameByIndex(
+            DwarfFileIdx, CompDir,
+            DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, File))
+      GsymFileIdx = Gsym.insertFile(File);
+    else
+      GsymFileIdx = 0;
+    return GsymFileIdx;
+  }
+};
+
+/// Get the name to use for a function or inlined function. The linkage name
+/// is preferred, so that C++ functions can be demangled by clients.
+static Optional<uint32_t> getNameIndex(DWARFDie Die, GsymCreator &Gsym) {
+  if (const char *Name = Die.getName(DINameKind::LinkageName))
+    if (*Name)
+      return Gsym.insertString(Name);
+  return None;
+}
+
+/// Convert the DW_TAG_inlined_subroutine DIEs below \p Die into children of
+/// \p Parent. Lexical blocks are looked through. Address ranges that are not
+/// contained in the parent are dropped, since a GSYM file requires every
+/// inlined range to be within the range of its caller.
+static void parseInlineInfo(GsymCreator &Gsym, CUInfo &CUI, DWARFDie Die,
+                            InlineInfo &Parent) {
+  for (DWARFDie ChildDie : Die.children()) {
+    switch (ChildDie.getTag()) {
+    case dwarf::DW_TAG_inlined_subroutine: {
+      InlineInfo II;
+      Expected<DWARFAddressRangesVector> RangesOrError =
+          ChildDie.getAddressRanges();
+      if (!RangesOrError) {
+        consumeError(RangesOrError.takeError());
+        break;
+      }
+      for (const DWARFAddressRange &Range : *RangesOrError) {
+        if (Range.LowPC >= Range.HighPC ||
+            !Parent.Ranges.contains(Range.LowPC) ||
+            !Parent.Ranges.contains(Range.HighPC - 1))
+          continue;
+        II.Ranges.insert(AddressRange(Range.LowPC, Range.HighPC));
+      }
+      if (II.Ranges.empty())
+        break;
+      if (auto NameIndex = getNameIndex(ChildDie, Gsym))
+        II.Name = *NameIndex;
+      II.CallFile = CUI.DWARFToGSYMFileIndex(
+          Gsym, dwarf::toUnsigned(ChildDie.find(dwarf::DW_AT_call_file), 0));
+      II.CallLine = dwarf::toUnsigned(ChildDie.find(dwarf::DW_AT_call_line), 0);
+      parseInlineInfo(Gsym, CUI, ChildDie, II);
+      Parent.Children.emplace_back(std::move(II));
+      break;
+    }
+    case dwarf::DW_TAG_lexical_block:
+      parseInlineInfo(Gsym, CUI, ChildDie, Parent);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+static void convertFunctionLineTable(CUInfo &CUI, DWARFDie Die,
+                                     const DWARFAddressRange &Range,
+                                     GsymCreator &Gsym, FunctionInfo &FI) {
+  std::vector<uint32_t> RowVector;
+  const object::SectionedAddress SecAddress{Range.LowPC, Range.SectionIndex};
+  if (!CUI.LineTable->lookupAddressRange(SecAddress, FI.size(), RowVector)) {
+    // If we have a DW_TAG_subprogram but no line entries, fall back to using
+    // the DW_AT_decl_file and DW_AT_decl_line if we have both attributes.
+    if (auto FileIdx =
+            dwarf::toUnsigned(Die.findRecursively({dwarf::DW_AT_decl_file})))
+      if (auto Line =
+              dwarf::toUnsigned(Die.findRecursively({dwarf::DW_AT_decl_line})))
+        FI.Lines.emplace_back(FI.startAddress(),
+                              CUI.DWARFToGSYMFileIndex(Gsym, *FileIdx),
+                              (uint32_t)*Line);
+    return;
+  }
+
+  for (uint32_t RowIndex : RowVector) {
+    const DWARFDebugLine::Row &Row = CUI.LineTable->Rows[RowIndex];
+    if (Row.EndSequence || !FI.Range.contains(Row.Address.Address))
+      continue;
+    LineEntry LE(Row.Address.Address, CUI.DWARFToGSYMFileIndex(Gsym, Row.File),
+                 Row.Line);
+    if (!FI.Lines.empty()) {
+      LineEntry &Prev = FI.Lines.back();
+      // Like a DWARF lookup, use the first of several rows for the same
+      // address. Rows that don't change the location add nothing.
+      if (Prev.Addr == LE.Addr ||
+          (Prev.File == LE.File && Prev.Line == LE.Line))
+        continue;
+    }
+    FI.Lines.push_back(LE);
+  }
+}
+
+void DwarfTransformer::handleDie(raw_ostream &OS, CUInfo &CUI, DWARFDie Die) {
+  if (Die.getTag() == dwarf::DW_TAG_subprogram) {
+    Expected<DWARFAddressRangesVector> RangesOrError = Die.getAddressRanges();
+    if (!RangesOrError) {
+      OS << "error: failed to get the address ranges of the function at "
+         << HEX32(Die.getOffset()) << ": "
+         << toString(RangesOrError.takeError()) << '\n';
+      return;
+    }
+    const DWARFAddressRangesVector &Ranges = *RangesOrError;
+    Optional<uint32_t> NameIndex;
+    if (!Ranges.empty()) {
+      NameIndex = getNameIndex(Die, Gsym);
+      if (!NameIndex)
+        OS << "warning: function at " << HEX32(Die.getOffset())
+           << " has no name\n";
+    }
+    // A function with several address ranges gets a FunctionInfo per range.
+    for (const DWARFAddressRange &Range : Ranges) {
+      // Linkers that discard a function often leave its DWARF in place with
+      // an empty range, or with both PC values set to the same tombstone.
+      if (!NameIndex || Range.LowPC >= Range.HighPC)
+        continue;
+      FunctionInfo FI(Range.LowPC, Range.HighPC - Range.LowPC, *NameIndex);
+      if (CUI.LineTable)
+        convertFunctionLineTable(CUI, Die, Range, Gsym, FI);
+      // The root InlineInfo stands for the function itself and has no name.
+      FI.Inline.Ranges.insert(FI.Range);
+      parseInlineInfo(Gsym, CUI, Die, FI.Inline);
+      if (FI.Inline.Children.empty())
+        FI.Inline.clear();
+      Gsym.addFunctionInfo(std::move(FI));
+    }
+  }
+  for (DWARFDie ChildDie : Die.children())
+    handleDie(OS, CUI, ChildDie);
+}
+
+Error DwarfTransformer::convert(uint32_t NumThreads) {
+  const size_t NumBefore = Gsym.getNumFunctionInfos();
+  if (NumThreads <= 1) {
+    // Parse all DWARF data from this thread.
+    for (const auto &CU : DICtx.compile_units()) {
+      DWARFDie Die = CU->getUnitDIE(false);
+      CUInfo CUI(DICtx, CU.get());
+      handleDie(Log, CUI, Die);
+    }
+  } else {
+    // The DWARF parser extracts DIEs lazily, so all DIEs are extracted before
+    // any of them are accessed: a DIE of one compile unit can refer to a DIE
+    // of another.
+    DICtx.extractAllDIEs(NumThreads);
+    ThreadPool Pool(NumThreads);
+
+    // Now convert all compile units in the thread pool. Each thread logs to
+    // its own stream, which is forwarded to the log when the thread is done.
+    std::mutex LogMutex;
+    for (const auto &CU : DICtx.compile_units()) {
+      DWARFDie Die = CU->getUnitDIE(false);
+      if (!Die)
+        continue;
+      CUInfo CUI(DICtx, CU.get());
+      Pool.async([this, CUI, &LogMutex, Die]() mutable {
+        std::string ThreadLogStorage;
+        raw_string_ostream ThreadOS(ThreadLogStorage);
+        handleDie(ThreadOS, CUI, Die);
+        ThreadOS.flush();
+        if (!ThreadLogStorage.empty()) {
+          std::lock_guard<std::mutex> Guard(LogMutex);
+          Log << ThreadLogStorage;
+        }
+      });
+    }
+    Pool.wait();
+  }
+  const size_t FunctionsAddedCount = Gsym.getNumFunctionInfos() - NumBefore;
+  Log << "Loaded " << FunctionsAddedCount << " functions from DWARF.\n";
+  return Error::success();
+}
+
+llvm::Error DwarfTransformer::verify(StringRef GsymPath) {
+  Log << "Verifying GSYM file \"" << GsymPath << "\":\n";
+
+  auto Gsym = GsymReader::openFile(GsymPath);
+  if (!Gsym)
+    return Gsym.takeError();
+
+  DILineInfoSpecifier DLIS(
+      DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath,
+      DILineInfoSpecifier::FunctionNameKind::LinkageName);
+  uint64_t NumMismatches = 0;
+  const uint32_t NumAddrs = Gsym->getNumAddresses();
+  for (uint32_t I = 0; I < NumAddrs; ++I) {
+    llvm::Expected<FunctionInfo> FI = Gsym->getFunctionInfoAtIndex(I);
+    if (!FI) {
+      Log << "error: failed to decode the FunctionInfo at index " << I << ": "
+          << toString(FI.takeError()) << '\n';
+      ++NumMismatches;
+      continue;
+    }
+    // Functions from the symbol table have no line table to compare.
+    for (const LineEntry &Line : FI->Lines) {
+      const uint64_t Addr = Line.Addr;
+      llvm::Expected<LookupResult> LR = Gsym->lookup(Addr);
+      if (!LR) {
+        Log << "error: lookup of " << HEX64(Addr) << " failed: "
+            << toString(LR.takeError()) << '\n';
+        ++NumMismatches;
+        continue;
+      }
+      DIInliningInfo DwarfInlineInfos =
+          DICtx.getInliningInfoForAddress({Addr, object::SectionedAddress::
+                                                     UndefSection}, DLIS);
+      const uint32_t NumDwarfFrames = DwarfInlineInfos.getNumberOfFrames();
+      bool Match = NumDwarfFrames == LR->Locations.size();
+      for (uint32_t F = 0; Match && F < NumDwarfFrames; ++F) {
+        const DILineInfo &DwarfFrame = DwarfInlineInfos.getFrame(F);
+        const SourceLocation &GsymFrame = LR->Locations[F];
+        Match = DwarfFrame.FunctionName == GsymFrame.Name &&
+                DwarfFrame.Line == GsymFrame.Line &&
+                DwarfFrame.FileName == GsymFrame.getPath();
+      }
+      if (Match)
+        continue;
+      ++NumMismatches;
+      Log << "error: lookup of " << HEX64(Addr)
+          << " doesn't match the DWARF\n  GSYM:\n";
+      for (const SourceLocation &GsymFrame : LR->Locations)
+        Log << "    " << GsymFrame << '\n';
+      Log << "  DWARF:\n";
+      for (uint32_t F = 0; F < NumDwarfFrames; ++F) {
+        const DILineInfo &DwarfFrame = DwarfInlineInfos.getFrame(F);
+        Log << "    " << DwarfFrame.FunctionName << " @ "
+            << DwarfFrame.FileName << ':' << DwarfFrame.Line << '\n';
+      }
+    }
+  }
+  if (NumMismatches)
+    return createStringError(std::errc::invalid_argument,
+                             "%" PRIu64 " lookups didn't match the DWARF",
+                             NumMismatches);
+  Log << "Verification succeeded.\n";
+  return Error::success();
+}
@@ -8,6 +8,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/FileWriter.h"
+#include "llvm/Support/DataExtractor.h"
+#include <inttypes.h>
 
 using namespace llvm;
 using namespace gsym;
@@ -20,3 +23,156 @@ raw_ostream &llvm::gsym::operator<<(raw_ostream &OS, const FunctionInfo &FI) {
   OS << FI.Inline;
   return OS;
 }
+
+/// The line table is encoded as the number of rows followed by, for each row,
+/// the unsigned address delta from the previous row, the file index and the
+/// signed line delta from the previous row. The first row is relative to the
+/// start of the function and line zero.
+static llvm::Error decodeLineTable(DataExtractor &Data, uint64_t BaseAddr,
+                                   std::vector<LineEntry> &Lines) {
+  uint32_t Offset = 0;
+  if (!Data.isValidOffset(Offset))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing LineTable row count", Offset);
+  uint64_t NumRows = Data.getULEB128(&Offset);
+  uint64_t Addr = BaseAddr;
+  int64_t Line = 0;
+  for (uint64_t I = 0; I < NumRows; ++I) {
+    if (!Data.isValidOffset(Offset))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing LineTable row", Offset);
+    Addr += Data.getULEB128(&Offset);
+    uint32_t File = (uint32_t)Data.getULEB128(&Offset);
+    if (!Data.isValidOffset(Offset))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing LineTable line delta", Offset);
+    Line += Data.getSLEB128(&Offset);
+    Lines.emplace_back(Addr, File, (uint32_t)Line);
+  }
+  return Error::success();
+}
+
+static llvm::Error encodeLineTable(FileWriter &O, uint64_t BaseAddr,
+                                   const std::vector<LineEntry> &Lines) {
+  O.writeULEB(Lines.size());
+  uint64_t Addr = BaseAddr;
+  int64_t Line = 0;
+  for (const LineEntry &Row : Lines) {
+    if (Row.Addr < Addr)
+      return createStringError(std::errc::invalid_argument,
+          "LineEntry address 0x%" PRIx64 " is not sorted", Row.Addr);
+    O.writeULEB(Row.Addr - Addr);
+    O.writeULEB(Row.File);
+    O.writeSLEB((int64_t)Row.Line - Line);
+    Addr = Row.Addr;
+    Line = Row.Line;
+  }
+  return Error::success();
+}
+
+llvm::Expected<FunctionInfo> FunctionInfo::decode(DataExtractor &Data,
+                                                  uint64_t BaseAddr) {
+  FunctionInfo FI;
+  FI.Range.Start = BaseAddr;
+  uint32_t Offset = 0;
+  if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing FunctionInfo Size", Offset);
+  FI.Range.End = FI.Range.Start + Data.getU32(&Offset);
+  if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing FunctionInfo Name", Offset);
+  FI.Name = Data.getU32(&Offset);
+  if (FI.Name == 0)
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": invalid FunctionInfo Name value 0x%8.8x",
+        Offset - 4, FI.Name);
+  bool Done = false;
+  while (!Done) {
+    if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing InfoType value", Offset);
+    const uint32_t IT = Data.getU32(&Offset);
+    if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing InfoType length", Offset);
+    const uint32_t InfoLength = Data.getU32(&Offset);
+    if (InfoLength && !Data.isValidOffsetForDataOfSize(Offset, InfoLength))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing InfoType data", Offset);
+    DataExtractor InfoData(Data.getData().substr(Offset, InfoLength),
+                           Data.isLittleEndian(),
+                           Data.getAddressSize());
+    switch (IT) {
+    case uint32_t(InfoType::EndOfList):
+      Done = true;
+      break;
+
+    case uint32_t(InfoType::LineTableInfo):
+      if (Error Err = decodeLineTable(InfoData, BaseAddr, FI.Lines))
+        return std::move(Err);
+      break;
+
+    case uint32_t(InfoType::InlineInfo): {
+      uint32_t InlineOffset = 0;
+      Expected<gsym::InlineInfo> II =
+          InlineInfo::decode(InfoData, InlineOffset, BaseAddr);
+      if (!II)
+        return II.takeError();
+      FI.Inline = std::move(*II);
+      break;
+    }
+
+    default:
+      // Skip chunks this version doesn't know about.
+      break;
+    }
+    Offset += InfoLength;
+  }
+  return FI;
+}
+
+llvm::Expected<uint64_t> FunctionInfo::encode(FileWriter &O) const {
+  if (!isValid())
+    return createStringError(std::errc::invalid_argument,
+        "attempted to encode invalid FunctionInfo object");
+  // Align FunctionInfo data to a 4 byte alignment.
+  O.alignTo(4);
+  const uint64_t FuncInfoOffset = O.tell();
+  // Write the size in bytes of this function as a uint32_t. This can be zero
+  // if we just have a symbol from a symbol table and that symbol has no size.
+  O.writeU32(size());
+  // Write the name of this function as a uint32_t string table offset.
+  O.writeU32(Name);
+
+  // Write each chunk as its type and length, and fix up the length once the
+  // data has been written.
+  auto EncodeChunk = [&](InfoType IT,
+                         function_ref<llvm::Error()> Encode) -> llvm::Error {
+    O.writeU32(uint32_t(IT));
+    const uint64_t LengthOffset = O.tell();
+    O.writeU32(0);
+    const uint64_t StartOffset = O.tell();
+    if (llvm::Error Err = Encode())
+      return Err;
+    O.fixup32((uint32_t)(O.tell() - StartOffset), LengthOffset);
+    return Error::success();
+  };
+
+  if (!Lines.empty())
+    if (llvm::Error Err = EncodeChunk(InfoType::LineTableInfo, [&] {
+          return encodeLineTable(O, startAddress(), Lines);
+        }))
+      return std::move(Err);
+
+  if (Inline.isValid())
+    if (llvm::Error Err = EncodeChunk(InfoType::InlineInfo, [&] {
+          return Inline.encode(O, startAddress());
+        }))
+      return std::move(Err);
+
+  // Terminate the data chunks with and end of list with zero size
+  O.writeU32(uint32_t(InfoType::EndOfList));
+  O.writeU32(0);
+  return FuncInfoOffset;
+}
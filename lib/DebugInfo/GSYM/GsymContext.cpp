@@ -0,0 +1,92 @@
+//===- GsymContext.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
+#include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/LookupResult.h"
+#include "llvm/Support/Path.h"
+
+using namespace llvm;
+using namespace llvm::gsym;
+
+GsymContext::GsymContext(std::unique_ptr<GsymReader> R)
+    : DIContext(CK_GSYM), Reader(std::move(R)) {}
+
+void GsymContext::dump(raw_ostream &OS, DIDumpOptions DumpOpts) {
+  Reader->dump(OS);
+}
+
+static DILineInfo convertSourceLocation(const SourceLocation &SL,
+                                        DILineInfoSpecifier Specifier) {
+  DILineInfo Info;
+  if (Specifier.FNKind != DINameKind::None)
+    Info.FunctionName = SL.Name;
+  if (Specifier.FLIKind != DILineInfoSpecifier::FileLineInfoKind::None &&
+      !SL.Base.empty()) {
+    if (Specifier.FLIKind ==
+        DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath)
+      Info.FileName = SL.getPath();
+    else
+      Info.FileName = SL.Base;
+  }
+  Info.Line = SL.Line;
+  return Info;
+}
+
+DILineInfo GsymContext::getLineInfoForAddress(object::SectionedAddress Address,
+                                              DILineInfoSpecifier Specifier) {
+  Expected<LookupResult> LR = Reader->lookup(Address.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return DILineInfo();
+  }
+  // The deepest inlined frame is first, which is what DWARF reports too.
+  return convertSourceLocation(LR->Locations.front(), Specifier);
+}
+
+DILineInfoTable
+GsymContext::getLineInfoForAddressRange(object::SectionedAddress Address,
+                                        uint64_t Size,
+                                        DILineInfoSpecifier Specifier) {
+  DILineInfoTable Table;
+  if (Size == 0)
+    return Table;
+  Expected<FunctionInfo> FI = Reader->getFunctionInfo(Address.Address);
+  if (!FI) {
+    consumeError(FI.takeError());
+    return Table;
+  }
+  const uint64_t EndAddr = Address.Address + Size;
+  for (const LineEntry &LE : FI->Lines) {
+    if (LE.Addr < Address.Address || LE.Addr >= EndAddr)
+      continue;
+    DILineInfo Info = getLineInfoForAddress(
+        {LE.Addr, Address.SectionIndex}, Specifier);
+    Table.push_back(std::make_pair(LE.Addr, Info));
+  }
+  return Table;
+}
+
+DIInliningInfo
+GsymContext::getInliningInfoForAddress(object::SectionedAddress Address,
+                                       DILineInfoSpecifier Specifier) {
+  DIInliningInfo InliningInfo;
+  Expected<LookupResult> LR = Reader->lookup(Address.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return InliningInfo;
+  }
+  for (const SourceLocation &SL : LR->Locations)
+    InliningInfo.addFrame(convertSourceLocation(SL, Specifier));
+  return InliningInfo;
+}
+
+std::vector<DILocal>
+GsymContext::getLocalsForAddress(object::SectionedAddress Address) {
+  return std::vector<DILocal>();
+}
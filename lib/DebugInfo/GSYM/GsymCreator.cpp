@@ -0,0 +1,246 @@
+//===- GsymCreator.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/FileWriter.h"
+#include "llvm/DebugInfo/GSYM/Header.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+using namespace llvm;
+using namespace gsym;
+
+GsymCreator::GsymCreator() : StringData(1, '\0') {
+  // File index zero is reserved for "no file" and uses empty strings for the
+  // directory and the basename.
+  Files.push_back(FileEntry());
+  FileEntryToIndex[FileEntry()] = 0;
+}
+
+uint32_t GsymCreator::insertFile(StringRef Path,
+                                 llvm::sys::path::Style Style) {
+  llvm::StringRef Directory = llvm::sys::path::parent_path(Path, Style);
+  llvm::StringRef Filename = llvm::sys::path::filename(Path, Style);
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  FileEntry FE(insertString(Directory), insertString(Filename));
+  const auto NextIndex = Files.size();
+  // Find FE in hash map and insert if not present.
+  auto R = FileEntryToIndex.insert(std::make_pair(FE, NextIndex));
+  if (R.second)
+    Files.emplace_back(FE);
+  return R.first->second;
+}
+
+llvm::Error GsymCreator::save(StringRef Path,
+                              llvm::support::endianness ByteOrder) const {
+  std::error_code EC;
+  raw_fd_ostream OutStrm(Path, EC);
+  if (EC)
+    return llvm::errorCodeToError(EC);
+  FileWriter O(OutStrm, ByteOrder);
+  return encode(O);
+}
+
+llvm::Error GsymCreator::encode(FileWriter &O) const {
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  if (Funcs.empty())
+    return createStringError(std::errc::invalid_argument,
+                             "no functions to encode");
+  if (!Finalized)
+    return createStringError(std::errc::invalid_argument,
+                             "GsymCreator wasn't finalized prior to encoding");
+
+  if (Funcs.size() > UINT32_MAX)
+    return createStringError(std::errc::invalid_argument,
+                             "too many FunctionInfos");
+  if (UUID.size() > GSYM_MAX_UUID_SIZE)
+    return createStringError(std::errc::invalid_argument,
+                             "invalid UUID size %u", (uint32_t)UUID.size());
+
+  // All offsets in the GSYM data are relative to the start of the header so
+  // that the data can also be embedded in a section of another file.
+  const uint64_t HeaderOffset = O.tell();
+  auto GetOffset = [&](uint64_t Offset) -> Expected<uint32_t> {
+    Offset -= HeaderOffset;
+    if (Offset > UINT32_MAX)
+      return createStringError(std::errc::file_too_large,
+                               "GSYM data exceeds 4GB");
+    return (uint32_t)Offset;
+  };
+
+  const uint64_t MinAddr = Funcs.front().startAddress();
+  const uint64_t MaxAddr = Funcs.back().startAddress();
+  const uint64_t AddrDelta = MaxAddr - MinAddr;
+  Header Hdr;
+  Hdr.Magic = GSYM_MAGIC;
+  Hdr.Version = GSYM_VERSION;
+  Hdr.AddrOffSize = 0;
+  Hdr.UUIDSize = static_cast<uint8_t>(UUID.size());
+  Hdr.BaseAddress = MinAddr;
+  Hdr.NumAddresses = static_cast<uint32_t>(Funcs.size());
+  // The string table offset and size are fixed up once it has been written.
+  Hdr.StrtabOffset = 0;
+  Hdr.StrtabSize = 0;
+  memset(Hdr.UUID, 0, sizeof(Hdr.UUID));
+  if (!UUID.empty())
+    memcpy(Hdr.UUID, UUID.data(), UUID.size());
+  // Use the smallest address offset size that can hold every offset.
+  if (AddrDelta <= UINT8_MAX)
+    Hdr.AddrOffSize = 1;
+  else if (AddrDelta <= UINT16_MAX)
+    Hdr.AddrOffSize = 2;
+  else if (AddrDelta <= UINT32_MAX)
+    Hdr.AddrOffSize = 4;
+  else
+    Hdr.AddrOffSize = 8;
+
+  if (llvm::Error Err = Hdr.encode(O))
+    return Err;
+
+  // Write out the address offsets.
+  O.alignTo(Hdr.AddrOffSize);
+  for (const auto &FuncInfo : Funcs) {
+    uint64_t AddrOffset = FuncInfo.startAddress() - Hdr.BaseAddress;
+    switch (Hdr.AddrOffSize) {
+    case 1: O.writeU8(static_cast<uint8_t>(AddrOffset)); break;
+    case 2: O.writeU16(static_cast<uint16_t>(AddrOffset)); break;
+    case 4: O.writeU32(static_cast<uint32_t>(AddrOffset)); break;
+    case 8: O.writeU64(AddrOffset); break;
+    }
+  }
+
+  // Write out all zeros for the AddrInfoOffsets; they are fixed up as each
+  // FunctionInfo is written.
+  O.alignTo(4);
+  const uint64_t AddrInfoOffsetsOffset = O.tell();
+  for (size_t I = 0, E = Funcs.size(); I < E; ++I)
+    O.writeU32(0);
+
+  // Write out the file table.
+  O.alignTo(4);
+  assert(!Files.empty());
+  assert(Files[0].Dir == 0);
+  assert(Files[0].Base == 0);
+  size_t NumFiles = Files.size();
+  if (NumFiles > UINT32_MAX)
+    return createStringError(std::errc::invalid_argument,
+                             "too many files");
+  O.writeU32(static_cast<uint32_t>(NumFiles));
+  for (auto File : Files) {
+    O.writeU32(File.Dir);
+    O.writeU32(File.Base);
+  }
+
+  // Write out the string table and fix up its offset and size in the header.
+  Expected<uint32_t> StrtabOffset = GetOffset(O.tell());
+  if (!StrtabOffset)
+    return StrtabOffset.takeError();
+  O.writeData(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(StringData.data()),
+      StringData.size()));
+  O.fixup32(*StrtabOffset, HeaderOffset + offsetof(Header, StrtabOffset));
+  O.fixup32(static_cast<uint32_t>(StringData.size()),
+            HeaderOffset + offsetof(Header, StrtabSize));
+
+  // Write out the address infos for each function info.
+  for (size_t I = 0, E = Funcs.size(); I < E; ++I) {
+    llvm::Expected<uint64_t> OffsetOrErr = Funcs[I].encode(O);
+    if (!OffsetOrErr)
+      return OffsetOrErr.takeError();
+    Expected<uint32_t> Offset = GetOffset(*OffsetOrErr);
+    if (!Offset)
+      return Offset.takeError();
+    O.fixup32(*Offset, AddrInfoOffsetsOffset + I * 4);
+  }
+  return Error::success();
+}
+
+llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  if (Finalized)
+    return createStringError(std::errc::invalid_argument,
+                             "already finalized");
+  Finalized = true;
+
+  // Sort function infos so we can emit sorted functions. Entries with the
+  // same range sort the one with the most information last.
+  llvm::sort(Funcs);
+
+  // Remove entries that start at the same address. Debug info is preferred
+  // over symbol table entries, and the larger range over the smaller one.
+  const size_t NumBefore = Funcs.size();
+  std::vector<FunctionInfo> Unique;
+  Unique.reserve(Funcs.size());
+  for (FunctionInfo &FI : Funcs) {
+    if (!Unique.empty()) {
+      FunctionInfo &Prev = Unique.back();
+      if (Prev.startAddress() == FI.startAddress()) {
+        if (Prev.hasRichInfo() && !FI.hasRichInfo())
+          continue;
+        if (Prev.hasRichInfo() && Prev.Range != FI.Range)
+          OS << "warning: duplicate function infos with different ranges:\n"
+             << Prev << '\n' << FI << '\n';
+        Prev = std::move(FI);
+        continue;
+      }
+      if (Prev.endAddress() > FI.startAddress() && Prev.hasRichInfo() &&
+          FI.hasRichInfo())
+        OS << "warning: overlapping function infos:\n"
+           << Prev << '\n' << FI << '\n';
+    }
+    Unique.push_back(std::move(FI));
+  }
+  Funcs.swap(Unique);
+
+  // Symbol table entries may not have a size; let them cover everything up
+  // to the next function so that lookups still find them.
+  for (size_t I = 0, E = Funcs.size(); I + 1 < E; ++I)
+    if (Funcs[I].size() == 0)
+      Funcs[I].setEndAddress(Funcs[I + 1].startAddress());
+
+  if (NumBefore != Funcs.size())
+    OS << "Pruned " << NumBefore - Funcs.size() << " functions, ended with "
+       << Funcs.size() << " total\n";
+  return Error::success();
+}
+
+uint32_t GsymCreator::insertString(StringRef S) {
+  if (S.empty())
+    return 0;
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  auto R = StringOffsets.insert(
+      std::make_pair(S, static_cast<uint32_t>(StringData.size())));
+  if (R.second) {
+    StringData.append(S.data(), S.size());
+    StringData.push_back('\0');
+  }
+  return R.first->second;
+}
+
+void GsymCreator::addFunctionInfo(FunctionInfo &&FI) {
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  Funcs.emplace_back(std::move(FI));
+}
+
+void GsymCreator::forEachFunctionInfo(
+    std::function<bool(FunctionInfo &)> const &Callback) {
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  for (auto &FI : Funcs) {
+    if (!Callback(FI))
+      break;
+  }
+}
+
+size_t GsymCreator::getNumFunctionInfos() const {
+  std::lock_guard<std::recursive_mutex> Guard(Mutex);
+  return Funcs.size();
+}
@@ -0,0 +1,423 @@
+//===- GsymReader.cpp -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/InlineInfo.h"
+#include "llvm/DebugInfo/GSYM/LineEntry.h"
+#include "llvm/Support/BinaryStreamReader.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <assert.h>
+#include <inttypes.h>
+
+using namespace llvm;
+using namespace gsym;
+
+GsymReader::GsymReader(std::unique_ptr<MemoryBuffer> Buffer)
+    : MemBuffer(std::move(Buffer)),
+      Endian(support::endian::system_endianness()) {}
+
+GsymReader::GsymReader(GsymReader &&RHS) = default;
+
+GsymReader::~GsymReader() = default;
+
+llvm::Expected<GsymReader> GsymReader::openFile(StringRef Filename) {
+  // Open the input file and return an appropriate error if needed. The file
+  // doesn't need a null terminator, which lets large files be mapped.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+      MemoryBuffer::getFile(Filename, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (std::error_code EC = BuffOrErr.getError())
+    return llvm::errorCodeToError(EC);
+  GsymReader GR(std::move(BuffOrErr.get()));
+  if (llvm::Error Err = GR.parse())
+    return std::move(Err);
+  return std::move(GR);
+}
+
+llvm::Expected<GsymReader> GsymReader::copyBuffer(StringRef Bytes) {
+  GsymReader GR(MemoryBuffer::getMemBufferCopy(Bytes, "GSYM bytes"));
+  if (llvm::Error Err = GR.parse())
+    return std::move(Err);
+  return std::move(GR);
+}
+
+llvm::Error GsymReader::parse() {
+  GsymBytes = MemBuffer->getBuffer();
+  BinaryStreamReader FileData(GsymBytes, support::endian::system_endianness());
+  // Check for the magic bytes. This file format is designed to be mmap'ed
+  // into a process and accessed as read only. This is done for performance
+  // and efficiency for symbolicating and parsing GSYM data.
+  if (errorToBool(FileData.readObject(Hdr)))
+    return createStringError(std::errc::invalid_argument,
+                             "not enough data for a GSYM header");
+
+  const auto HostByteOrder = support::endian::system_endianness();
+  switch (Hdr->Magic) {
+  case GSYM_MAGIC:
+    Endian = HostByteOrder;
+    break;
+  case GSYM_CIGAM:
+    // This is a GSYM file, but not native endianness.
+    Endian = sys::IsBigEndianHost ? support::little : support::big;
+    Swap.reset(new SwappedData);
+    break;
+  default:
+    return createStringError(std::errc::invalid_argument,
+                             "not a GSYM file");
+  }
+
+  bool DataIsLittleEndian = Endian == support::little;
+  // Read a correctly byte swapped header if we need to.
+  if (Swap) {
+    DataExtractor Data(MemBuffer->getBuffer(), DataIsLittleEndian, 4);
+    if (auto ExpectedHdr = Header::decode(Data))
+      Swap->Hdr = ExpectedHdr.get();
+    else
+      return ExpectedHdr.takeError();
+    Hdr = &Swap->Hdr;
+  }
+
+  // Detect errors in the header and report any that are found. If we make it
+  // past this without errors, we know we have a good magic value, a supported
+  // version number, verified address offset size and a valid UUID size.
+  if (Error Err = Hdr->checkForError())
+    return Err;
+
+  const uint32_t NumAddresses = Hdr->NumAddresses;
+  const uint64_t AddrOffsetsSize = (uint64_t)NumAddresses * Hdr->AddrOffSize;
+  if (AddrOffsetsSize > GsymBytes.size())
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read address table");
+
+  if (!Swap) {
+    // This is the native endianness case that is most common and optimized
+    // for efficient lookups. Here we just grab pointers to the native data
+    // and use ArrayRef objects to allow efficient read only access.
+
+    // Read the address offsets.
+    if (errorToBool(FileData.padToAlignment(Hdr->AddrOffSize)) ||
+        errorToBool(FileData.readArray(AddrOffsets, AddrOffsetsSize)))
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read address table");
+
+    // Read the address info offsets.
+    if (errorToBool(FileData.padToAlignment(4)) ||
+        errorToBool(FileData.readArray(AddrInfoOffsets, NumAddresses)))
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read address info offsets table");
+
+    // Read the file table.
+    uint32_t NumFiles = 0;
+    if (errorToBool(FileData.readInteger(NumFiles)) ||
+        errorToBool(FileData.readArray(Files, NumFiles)))
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read file table");
+  } else {
+    // This is the non native endianness case that is not common and not
+    // optimized for lookups. Here we decode the important tables into local
+    // storage and then set the ArrayRef objects to point to these swapped
+    // copies of the read only data so lookups can be as efficient as possible.
+    DataExtractor Data(MemBuffer->getBuffer(), DataIsLittleEndian, 4);
+
+    // Read the address offsets.
+    uint32_t Offset = alignTo(sizeof(Header), Hdr->AddrOffSize);
+    Swap->AddrOffsets.resize(AddrOffsetsSize);
+    bool Success = true;
+    if (NumAddresses) {
+      uint8_t *Dst = Swap->AddrOffsets.data();
+      switch (Hdr->AddrOffSize) {
+      case 1:
+        Success = Data.getU8(&Offset, Dst, NumAddresses);
+        break;
+      case 2:
+        Success = Data.getU16(&Offset, reinterpret_cast<uint16_t *>(Dst),
+                              NumAddresses);
+        break;
+      case 4:
+        Success = Data.getU32(&Offset, reinterpret_cast<uint32_t *>(Dst),
+                              NumAddresses);
+        break;
+      case 8:
+        Success = Data.getU64(&Offset, reinterpret_cast<uint64_t *>(Dst),
+                              NumAddresses);
+        break;
+      }
+    }
+    if (!Success)
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read address table");
+    AddrOffsets = ArrayRef<uint8_t>(Swap->AddrOffsets);
+
+    // Read the address info offsets.
+    Offset = alignTo(Offset, 4);
+    Swap->AddrInfoOffsets.resize(NumAddresses);
+    if (NumAddresses &&
+        !Data.getU32(&Offset, Swap->AddrInfoOffsets.data(), NumAddresses))
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read address info offsets table");
+    AddrInfoOffsets = ArrayRef<uint32_t>(Swap->AddrInfoOffsets);
+
+    // Read the file table.
+    if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read file table");
+    const uint32_t NumFiles = Data.getU32(&Offset);
+    if ((uint64_t)Offset + (uint64_t)NumFiles * 8 > GsymBytes.size())
+      return createStringError(std::errc::invalid_argument,
+                               "failed to read file table");
+    Swap->Files.resize(NumFiles);
+    for (auto &File : Swap->Files) {
+      File.Dir = Data.getU32(&Offset);
+      File.Base = Data.getU32(&Offset);
+    }
+    Files = ArrayRef<FileEntry>(Swap->Files);
+  }
+
+  // Get the string table.
+  const uint64_t StrtabEnd = (uint64_t)Hdr->StrtabOffset + Hdr->StrtabSize;
+  if (StrtabEnd > GsymBytes.size())
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read string table");
+  StrTab.Data = GsymBytes.substr(Hdr->StrtabOffset, Hdr->StrtabSize);
+  return Error::success();
+}
+
+const Header &GsymReader::getHeader() const {
+  // The only way to get a GsymReader is from GsymReader::openFile(...) or
+  // GsymReader::copyBuffer() and the header must be valid and initialized to
+  // a valid pointer value, so the assert below should not trigger.
+  assert(Hdr);
+  return *Hdr;
+}
+
+Optional<uint64_t> GsymReader::getAddress(size_t Index) const {
+  switch (Hdr->AddrOffSize) {
+  case 1: return addressForIndex<uint8_t>(Index);
+  case 2: return addressForIndex<uint16_t>(Index);
+  case 4: return addressForIndex<uint32_t>(Index);
+  case 8: return addressForIndex<uint64_t>(Index);
+  }
+  return llvm::None;
+}
+
+Optional<uint64_t> GsymReader::getAddressInfoOffset(size_t Index) const {
+  const auto NumAddrInfoOffsets = AddrInfoOffsets.size();
+  if (Index < NumAddrInfoOffsets)
+    return AddrInfoOffsets[Index];
+  return llvm::None;
+}
+
+Expected<uint64_t> GsymReader::getAddressIndex(const uint64_t Addr) const {
+  if (Addr < Hdr->BaseAddress)
+    return createStringError(std::errc::invalid_argument,
+                             "address 0x%" PRIx64 " is not in GSYM", Addr);
+  const uint64_t AddrOffset = Addr - Hdr->BaseAddress;
+  uint64_t Index = UINT64_MAX;
+  switch (Hdr->AddrOffSize) {
+  case 1: Index = getAddressOffsetIndex<uint8_t>(AddrOffset); break;
+  case 2: Index = getAddressOffsetIndex<uint16_t>(AddrOffset); break;
+  case 4: Index = getAddressOffsetIndex<uint32_t>(AddrOffset); break;
+  case 8: Index = getAddressOffsetIndex<uint64_t>(AddrOffset); break;
+  default:
+    return createStringError(std::errc::invalid_argument,
+                             "unsupported address offset size %u",
+                             Hdr->AddrOffSize);
+  }
+  if (Index >= getNumAddresses())
+    return createStringError(std::errc::invalid_argument,
+                             "address 0x%" PRIx64 " is not in GSYM", Addr);
+  return Index;
+}
+
+llvm::Expected<FunctionInfo>
+GsymReader::getFunctionInfoAtIndex(uint64_t Index) const {
+  Optional<uint64_t> AddrInfoOffset = getAddressInfoOffset(Index);
+  Optional<uint64_t> FuncAddr = getAddress(Index);
+  if (!AddrInfoOffset || !FuncAddr)
+    return createStringError(std::errc::invalid_argument,
+                             "invalid address index %" PRIu64, Index);
+  if (*AddrInfoOffset >= GsymBytes.size())
+    return createStringError(std::errc::invalid_argument,
+                             "invalid address info offset 0x%" PRIx64,
+                             *AddrInfoOffset);
+  DataExtractor Data(GsymBytes.substr(*AddrInfoOffset),
+                     Endian == support::little, 4);
+  return FunctionInfo::decode(Data, *FuncAddr);
+}
+
+llvm::Expected<FunctionInfo> GsymReader::getFunctionInfo(uint64_t Addr) const {
+  Expected<uint64_t> AddressIndex = getAddressIndex(Addr);
+  if (!AddressIndex)
+    return AddressIndex.takeError();
+  llvm::Expected<FunctionInfo> FI = getFunctionInfoAtIndex(*AddressIndex);
+  if (!FI)
+    return FI.takeError();
+  if (!FI->Range.contains(Addr))
+    return createStringError(std::errc::invalid_argument,
+                             "address 0x%" PRIx64 " is not in GSYM", Addr);
+  return FI;
+}
+
+llvm::Expected<LookupResult> GsymReader::lookup(uint64_t Addr) const {
+  llvm::Expected<FunctionInfo> FI = getFunctionInfo(Addr);
+  if (!FI)
+    return FI.takeError();
+
+  LookupResult LR;
+  LR.LookupAddr = Addr;
+  LR.FuncRange = FI->Range;
+  LR.FuncName = getString(FI->Name);
+
+  auto MakeLocation = [&](uint32_t Name, uint32_t File, uint32_t Line) {
+    SourceLocation SrcLoc;
+    SrcLoc.Name = getString(Name);
+    if (File != 0)
+      if (Optional<FileEntry> FE = getFile(File)) {
+        SrcLoc.Dir = getString(FE->Dir);
+        SrcLoc.Base = getString(FE->Base);
+      }
+    SrcLoc.Line = Line;
+    return SrcLoc;
+  };
+
+  // Find the row of the line table that contains the address.
+  uint32_t File = 0;
+  uint32_t Line = 0;
+  auto Row = std::upper_bound(FI->Lines.begin(), FI->Lines.end(),
+                              LineEntry(Addr));
+  if (Row != FI->Lines.begin()) {
+    --Row;
+    File = Row->File;
+    Line = Row->Line;
+  }
+
+  // Each inlined function is reported at the current location, and the
+  // location of its call site becomes the location of its caller.
+  if (auto InlineStack = FI->Inline.getInlineStack(Addr)) {
+    for (const InlineInfo *II : *InlineStack) {
+      LR.Locations.push_back(MakeLocation(II->Name, File, Line));
+      File = II->CallFile;
+      Line = II->CallLine;
+    }
+  }
+  LR.Locations.push_back(MakeLocation(FI->Name, File, Line));
+  return LR;
+}
+
+void GsymReader::dump(raw_ostream &OS) {
+  const auto &Header = getHeader();
+  // Dump the GSYM header.
+  OS << Header << "\n";
+  // Dump the address table.
+  OS << "Address Table:\n";
+  OS << "INDEX  OFFSET";
+
+  switch (Hdr->AddrOffSize) {
+  case 1: OS << "8 "; break;
+  case 2: OS << "16"; break;
+  case 4: OS << "32"; break;
+  case 8: OS << "64"; break;
+  default: OS << "??"; break;
+  }
+  OS << " (ADDRESS)\n";
+  OS << "====== =============================== \n";
+  for (uint32_t I = 0; I < Header.NumAddresses; ++I) {
+    OS << format("[%4u] ", I);
+    switch (Hdr->AddrOffSize) {
+    case 1: OS << HEX8(getAddrOffsets<uint8_t>()[I]); break;
+    case 2: OS << HEX16(getAddrOffsets<uint16_t>()[I]); break;
+    case 4: OS << HEX32(getAddrOffsets<uint32_t>()[I]); break;
+    case 8: OS << HEX64(getAddrOffsets<uint64_t>()[I]); break;
+    default: break;
+    }
+    OS << " (" << HEX64(*getAddress(I)) << ")\n";
+  }
+  // Dump the address info offsets table.
+  OS << "\nAddress Info Offsets:\n";
+  OS << "INDEX  Offset\n";
+  OS << "====== ==========\n";
+  for (uint32_t I = 0; I < Header.NumAddresses; ++I)
+    OS << format("[%4u] ", I) << HEX32(AddrInfoOffsets[I]) << "\n";
+  // Dump the file table.
+  OS << "\nFiles:\n";
+  OS << "INDEX  DIRECTORY  BASENAME   PATH\n";
+  OS << "====== ========== ========== ==============================\n";
+  for (uint32_t I = 0; I < Files.size(); ++I) {
+    OS << format("[%4u] ", I) << HEX32(Files[I].Dir) << ' '
+       << HEX32(Files[I].Base) << ' ';
+    dump(OS, getFile(I));
+    OS << "\n";
+  }
+  OS << "\n" << StrTab << "\n";
+
+  for (uint32_t I = 0; I < Header.NumAddresses; ++I) {
+    OS << "FunctionInfo @ " << HEX32(AddrInfoOffsets[I]) << ": ";
+    if (auto FI = getFunctionInfoAtIndex(I))
+      dump(OS, *FI);
+    else
+      logAllUnhandledErrors(FI.takeError(), OS, "FunctionInfo:");
+  }
+}
+
+void GsymReader::dump(raw_ostream &OS, const FunctionInfo &FI) {
+  OS << FI.Range << " \"" << getString(FI.Name) << "\"\n";
+  if (!FI.Lines.empty()) {
+    OS << "LineTable:\n";
+    for (const LineEntry &LE : FI.Lines) {
+      OS << "  " << HEX64(LE.Addr) << ' ';
+      dump(OS, getFile(LE.File));
+      OS << ':' << LE.Line << '\n';
+    }
+  }
+  if (FI.Inline.isValid()) {
+    OS << "InlineInfo:\n";
+    dump(OS, FI.Inline, 2);
+  }
+  OS << '\n';
+}
+
+void GsymReader::dump(raw_ostream &OS, const InlineInfo &II,
+                      uint32_t Indent) {
+  OS.indent(Indent);
+  OS << II.Ranges << ' ' << getString(II.Name);
+  if (II.CallFile != 0) {
+    if (auto File = getFile(II.CallFile)) {
+      OS << " called from ";
+      dump(OS, File);
+      OS << ':' << II.CallLine;
+    }
+  }
+  OS << '\n';
+  for (const auto &ChildII : II.Children)
+    dump(OS, ChildII, Indent + 2);
+}
+
+void GsymReader::dump(raw_ostream &OS, Optional<FileEntry> FE) {
+  if (FE) {
+    // The file at index 0 means there is no file, don't print anything.
+    if (FE->Dir == 0 && FE->Base == 0)
+      return;
+    StringRef Dir = getString(FE->Dir);
+    StringRef Base = getString(FE->Base);
+    if (!Dir.empty()) {
+      OS << Dir;
+      if (Dir.contains('\\') && !Dir.contains('/'))
+        OS << '\\';
+      else
+        OS << '/';
+    }
+    if (!Base.empty()) {
+      OS << Base;
+    }
+    if (!Dir.empty() || !Base.empty())
+      return;
+  }
+  OS << "<invalid-file>";
+}
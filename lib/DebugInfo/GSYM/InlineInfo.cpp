@@ -8,7 +8,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/GSYM/FileEntry.h"
+#include "llvm/DebugInfo/GSYM/FileWriter.h"
 #include "llvm/DebugInfo/GSYM/InlineInfo.h"
+#include "llvm/Support/DataExtractor.h"
 #include <algorithm>
 #include <inttypes.h>
 
@@ -57,3 +59,116 @@ llvm::Optional<InlineInfo::InlineArray> InlineInfo::getInlineStack(uint64_t Addr
     return Result;
   return llvm::None;
 }
+
+/// Decode the address ranges of an InlineInfo, which are encoded relative to
+/// \p BaseAddr.
+static llvm::Error decodeRanges(DataExtractor &Data, uint32_t &Offset,
+                                uint64_t BaseAddr, AddressRanges &Ranges) {
+  if (!Data.isValidOffset(Offset))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing InlineInfo address ranges data", Offset);
+  uint64_t NumRanges = Data.getULEB128(&Offset);
+  for (uint64_t I = 0; I < NumRanges; ++I) {
+    if (!Data.isValidOffset(Offset))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing InlineInfo address range", Offset);
+    uint64_t Start = BaseAddr + Data.getULEB128(&Offset);
+    if (!Data.isValidOffset(Offset))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx32 ": missing InlineInfo address range size", Offset);
+    uint64_t Size = Data.getULEB128(&Offset);
+    Ranges.insert(AddressRange(Start, Start + Size));
+  }
+  return Error::success();
+}
+
+llvm::Expected<InlineInfo> InlineInfo::decode(DataExtractor &Data,
+                                              uint32_t &Offset,
+                                              uint64_t BaseAddr) {
+  InlineInfo Inline;
+  if (llvm::Error Err = decodeRanges(Data, Offset, BaseAddr, Inline.Ranges))
+    return std::move(Err);
+  if (Inline.Ranges.empty())
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": InlineInfo has no address ranges", Offset);
+  if (!Data.isValidOffsetForDataOfSize(Offset, 5))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing InlineInfo data", Offset);
+  bool HasChildren = Data.getU8(&Offset) != 0;
+  Inline.Name = Data.getU32(&Offset);
+  if (!Data.isValidOffset(Offset))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing InlineInfo call file", Offset);
+  Inline.CallFile = (uint32_t)Data.getULEB128(&Offset);
+  if (!Data.isValidOffset(Offset))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx32 ": missing InlineInfo call line", Offset);
+  Inline.CallLine = (uint32_t)Data.getULEB128(&Offset);
+  if (HasChildren) {
+    // Child address ranges are encoded relative to the first address range
+    // of the parent.
+    const uint64_t ChildBaseAddr = Inline.Ranges[0].Start;
+    while (true) {
+      // Children are terminated by an empty address range list, so peek at
+      // the number of ranges before decoding the child.
+      uint32_t ChildOffset = Offset;
+      if (!Data.isValidOffset(ChildOffset))
+        return createStringError(std::errc::io_error,
+            "0x%8.8" PRIx32 ": missing InlineInfo child", ChildOffset);
+      if (Data.getULEB128(&ChildOffset) == 0) {
+        Offset = ChildOffset;
+        break;
+      }
+      llvm::Expected<InlineInfo> Child = decode(Data, Offset, ChildBaseAddr);
+      if (!Child)
+        return Child.takeError();
+      Inline.Children.emplace_back(std::move(*Child));
+    }
+  }
+  return Inline;
+}
+
+llvm::Error InlineInfo::encode(FileWriter &O, uint64_t BaseAddr) const {
+  // Users must verify the InlineInfo is valid prior to calling this funtion.
+  // We don't want to emit any InlineInfo objects if they are not valid since
+  // it will waste space in the GSYM file.
+  if (!isValid())
+    return createStringError(std::errc::invalid_argument,
+                             "attempted to encode invalid InlineInfo object");
+  O.writeULEB(Ranges.size());
+  for (const AddressRange &Range : Ranges) {
+    if (Range.Start < BaseAddr)
+      return createStringError(std::errc::invalid_argument,
+          "InlineInfo address range [0x%" PRIx64 "-0x%" PRIx64
+          ") starts before base address 0x%" PRIx64,
+          Range.Start, Range.End, BaseAddr);
+    O.writeULEB(Range.Start - BaseAddr);
+    O.writeULEB(Range.size());
+  }
+  bool HasChildren = !Children.empty();
+  O.writeU8(HasChildren);
+  O.writeU32(Name);
+  O.writeULEB(CallFile);
+  O.writeULEB(CallLine);
+  if (HasChildren) {
+    // Child address ranges are encoded as relative to the first
+    // address range in this object, so we need to get the base address
+    // of this object, and then make sure each child is fully contained
+    // in the ranges of this object.
+    const uint64_t ChildBaseAddr = Ranges[0].Start;
+    for (const auto &Child : Children) {
+      for (const auto &ChildRange : Child.Ranges) {
+        if (!Ranges.contains(ChildRange.Start) ||
+            !Ranges.contains(ChildRange.End - 1))
+          return createStringError(std::errc::invalid_argument,
+              "child range not contained in parent");
+      }
+      if (llvm::Error Err = Child.encode(O, ChildBaseAddr))
+        return Err;
+    }
+
+    // Terminate the list of children with an empty address range list.
+    O.writeULEB(0);
+  }
+  return Error::success();
+}
@@ -0,0 +1,45 @@
+//===- LookupResult.cpp ---------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/LookupResult.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace gsym;
+
+std::string SourceLocation::getPath() const {
+  if (Base.empty())
+    return std::string();
+  SmallString<128> Path(Dir);
+  llvm::sys::path::append(Path, Base);
+  return Path.str();
+}
+
+raw_ostream &llvm::gsym::operator<<(raw_ostream &OS, const SourceLocation &SL) {
+  OS << SL.Name;
+  if (!SL.Base.empty())
+    OS << " @ " << SL.getPath() << ':' << SL.Line;
+  return OS;
+}
+
+raw_ostream &llvm::gsym::operator<<(raw_ostream &OS, const LookupResult &LR) {
+  OS << HEX64(LR.LookupAddr) << ": ";
+  auto NumLocations = LR.Locations.size();
+  for (size_t I = 0; I < NumLocations; ++I) {
+    if (I > 0)
+      OS.indent(20);
+    OS << LR.Locations[I];
+    if (I + 1 < NumLocations)
+      OS << " [inlined]";
+    OS << '\n';
+  }
+  return OS;
+}
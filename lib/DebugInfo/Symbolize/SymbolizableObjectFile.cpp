@@ -20,6 +20,7 @@
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolSize.h"
+#include "llvm/Object/Wasm.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
@@ -73,11 +74,14 @@ SymbolizableObjectFile::create(const object::ObjectFile *Obj,
     res->addSymbol(P.first, P.second, OpdExtractor.get(), OpdAddress);
 
   // If this is a COFF object and we didn't find any symbols, try the export
-  // table.
+  // table. Linked Wasm modules have no symbol table either, but usually keep
+  // the "name" section.
   if (Symbols.empty()) {
     if (auto *CoffObj = dyn_cast<COFFObjectFile>(Obj))
       if (auto EC = res->addCoffExportSymbols(CoffObj))
         return EC;
+    if (auto *WasmObj = dyn_cast<WasmObjectFile>(Obj))
+      res->addWasmNameSymbols(WasmObj);
   }
 
   std::vector<std::pair<SymbolDesc, StringRef>> &Fs = res->Functions,
@@ -153,6 +157,18 @@ std::error_code SymbolizableObjectFile::addCoffExportSymbols(
   return std::error_code();
 }
 
+void SymbolizableObjectFile::addWasmNameSymbols(
+    const WasmObjectFile *WasmObj) {
+  // Addresses in Wasm modules are offsets into the code section, which is
+  // where each function's entry starts.
+  for (const wasm::WasmFunction &Function : WasmObj->functions()) {
+    if (Function.DebugName.empty())
+      continue;
+    SymbolDesc SD = {Function.CodeSectionOffset, Function.Size};
+    Functions.emplace_back(SD, Function.DebugName);
+  }
+}
+
 std::error_code SymbolizableObjectFile::addSymbol(const SymbolRef &Symbol,
                                                   uint64_t SymbolSize,
                                                   DataExtractor *OpdExtractor,
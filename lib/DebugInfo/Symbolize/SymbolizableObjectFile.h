@@ -64,6 +64,7 @@ private:
                             DataExtractor *OpdExtractor = nullptr,
                             uint64_t OpdAddress = 0);
   std::error_code addCoffExportSymbols(const object::COFFObjectFile *CoffObj);
+  void addWasmNameSymbols(const object::WasmObjectFile *WasmObj);
 
   /// Search for the first occurence of specified Address in ObjectFile.
   uint64_t getModuleSectionIndexForAddress(uint64_t Address) const;
@@ -17,12 +17,15 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/GsymContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/MachO.h"
 #include "llvm/Object/MachOUniversal.h"
+#include "llvm/Object/Wasm.h"
 #include "llvm/Support/CRC.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Compression.h"
@@ -176,6 +179,36 @@ LLVMSymbolizer::symbolizeFrame(const std::string &ModuleName,
   return Info->symbolizeFrame(ModuleOffset);
 }
 
+Expected<uint64_t>
+LLVMSymbolizer::getWasmCodeOffset(const std::string &ModuleName,
+                                  uint32_t FuncIndex, uint64_t BodyOffset) {
+  auto ObjectsOrErr = getOrCreateObjectPair(ModuleName, Opts.DefaultArch);
+  if (!ObjectsOrErr)
+    return ObjectsOrErr.takeError();
+  auto *WasmObj = dyn_cast<WasmObjectFile>(ObjectsOrErr->first);
+  if (!WasmObj)
+    return createStringError(
+        errc::invalid_argument,
+        "%s: function indices are only supported for WebAssembly modules",
+        ModuleName.c_str());
+  // Imported functions come first in the function index space and have no
+  // code.
+  const uint32_t NumImported = WasmObj->getNumImportedFunctions();
+  ArrayRef<wasm::WasmFunction> Functions = WasmObj->functions();
+  if (FuncIndex < NumImported || FuncIndex - NumImported >= Functions.size())
+    return createStringError(errc::invalid_argument,
+                             "%s: no function with code has index %u",
+                             ModuleName.c_str(), FuncIndex);
+  const wasm::WasmFunction &Function = Functions[FuncIndex - NumImported];
+  // The body follows the size of the function in its code section entry.
+  if (BodyOffset >= Function.Size - Function.CodeOffset)
+    return createStringError(errc::invalid_argument,
+                             "%s: offset 0x%" PRIx64
+                             " is past the end of function %u",
+                             ModuleName.c_str(), BodyOffset, FuncIndex);
+  return Function.CodeSectionOffset + Function.CodeOffset + BodyOffset;
+}
+
 void LLVMSymbolizer::flush() {
   ObjectForUBPathAndArch.clear();
   BinaryForPath.clear();
@@ -457,9 +490,22 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   ObjectPair Objects = ObjectsOrErr.get();
 
   std::unique_ptr<DIContext> Context;
+  // If a GSYM file was produced for this binary, prefer it to the much larger
+  // DWARF.
+  std::string GsymPath = BinaryName + ".gsym";
+  if (Opts.UseGsym && sys::fs::exists(GsymPath)) {
+    auto ReaderOrErr = gsym::GsymReader::openFile(GsymPath);
+    if (!ReaderOrErr) {
+      Modules.emplace(ModuleName, std::unique_ptr<SymbolizableModule>());
+      return createFileError(GsymPath, ReaderOrErr.takeError());
+    }
+    Context.reset(new gsym::GsymContext(
+        llvm::make_unique<gsym::GsymReader>(std::move(*ReaderOrErr))));
+  }
   // If this is a COFF object containing PDB info, use a PDBContext to
   // symbolize. Otherwise, use DWARF.
-  if (auto CoffObject = dyn_cast<COFFObjectFile>(Objects.first)) {
+  auto *CoffObject = dyn_cast<COFFObjectFile>(Objects.first);
+  if (!Context && CoffObject) {
     const codeview::DebugInfo *DebugInfo;
     StringRef PDBFileName;
     auto EC = CoffObject->getDebugPDBInfo(DebugInfo, PDBFileName);
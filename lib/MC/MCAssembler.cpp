@@ -8,6 +8,8 @@
 
 #include "llvm/MC/MCAssembler.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -66,6 +68,8 @@ STATISTIC(evaluateFixup, "Number of evaluated fixups");
 STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
+STATISTIC(SkippedSectionLayouts,
+          "Number of section layouts skipped because no dependency changed");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
 STATISTIC(PaddingFragmentsRelaxations,
           "Number of Padding Fragments relaxations");
@@ -754,6 +758,112 @@ MCAssembler::handleFixup(const MCAsmLayout &Layout, MCFragment &F,
   return std::make_tuple(Target, FixedValue, IsResolved);
 }
 
+namespace {
+
+/// Records which sections have to be laid out again after a section had
+/// fragments relaxed. Whether a fragment needs relaxation depends on the
+/// layout of its own section, which is iterated to a fixed point on the spot,
+/// and on the layout of the sections that define the symbols it refers to. The
+/// latter are the dependencies tracked here; a section whose fragments refer
+/// to expressions that cannot be looked through depends on every section.
+class RelaxationDependencies {
+  DenseMap<const MCSection *, SmallVector<const MCSection *, 4>> Dependents;
+  SmallVector<const MCSection *, 4> DependOnAll;
+
+  static void collectSections(const MCExpr &Expr,
+                              SmallPtrSetImpl<const MCSection *> &Sections,
+                              bool &Unknown, unsigned Depth = 0) {
+    switch (Expr.getKind()) {
+    case MCExpr::Constant:
+      return;
+    case MCExpr::SymbolRef: {
+      const MCSymbol &Sym = cast<MCSymbolRefExpr>(Expr).getSymbol();
+      if (Sym.isVariable()) {
+        // Look through a few levels of aliases; give up on anything deeper.
+        if (Depth >= 8)
+          Unknown = true;
+        else
+          collectSections(*Sym.getVariableValue(/*SetUsed=*/false), Sections,
+                          Unknown, Depth + 1);
+      } else if (Sym.isInSection()) {
+        Sections.insert(&Sym.getSection());
+      }
+      return;
+    }
+    case MCExpr::Unary:
+      collectSections(*cast<MCUnaryExpr>(Expr).getSubExpr(), Sections, Unknown,
+                      Depth);
+      return;
+    case MCExpr::Binary: {
+      const MCBinaryExpr &BE = cast<MCBinaryExpr>(Expr);
+      collectSections(*BE.getLHS(), Sections, Unknown, Depth);
+      collectSections(*BE.getRHS(), Sections, Unknown, Depth);
+      return;
+    }
+    case MCExpr::Target:
+      Unknown = true;
+      return;
+    }
+  }
+
+public:
+  explicit RelaxationDependencies(MCAssembler &Asm) {
+    for (const MCSection &Sec : Asm) {
+      SmallPtrSet<const MCSection *, 4> Sections;
+      bool Unknown = false;
+      for (const MCFragment &F : Sec) {
+        switch (F.getKind()) {
+        default:
+          break;
+        case MCFragment::FT_Relaxable:
+          for (const MCFixup &Fixup : cast<MCRelaxableFragment>(F).getFixups())
+            collectSections(*Fixup.getValue(), Sections, Unknown);
+          break;
+        case MCFragment::FT_Dwarf:
+          collectSections(cast<MCDwarfLineAddrFragment>(F).getAddrDelta(),
+                          Sections, Unknown);
+          break;
+        case MCFragment::FT_DwarfFrame:
+          collectSections(cast<MCDwarfCallFrameFragment>(F).getAddrDelta(),
+                          Sections, Unknown);
+          break;
+        case MCFragment::FT_LEB:
+          collectSections(cast<MCLEBFragment>(F).getValue(), Sections,
+                          Unknown);
+          break;
+        case MCFragment::FT_CVInlineLines:
+        case MCFragment::FT_CVDefRange:
+          // These refer to the line tables of other functions.
+          Unknown = true;
+          break;
+        }
+        if (Unknown)
+          break;
+      }
+
+      if (Unknown) {
+        DependOnAll.push_back(&Sec);
+        continue;
+      }
+      for (const MCSection *Dep : Sections)
+        if (Dep != &Sec)
+          Dependents[Dep].push_back(&Sec);
+    }
+  }
+
+  /// Add the sections that have to be laid out again after \p Relaxed had
+  /// fragments relaxed to \p Pending.
+  void addDependents(const MCSection *Relaxed,
+                     SmallPtrSetImpl<const MCSection *> &Pending) const {
+    auto It = Dependents.find(Relaxed);
+    if (It != Dependents.end())
+      Pending.insert(It->second.begin(), It->second.end());
+    Pending.insert(DependOnAll.begin(), DependOnAll.end());
+  }
+};
+
+} // end anonymous namespace
+
 void MCAssembler::layout(MCAsmLayout &Layout) {
   assert(getBackendPtr() && "Expected assembler backend");
   DEBUG_WITH_TYPE("mc-dump", {
@@ -781,10 +891,20 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
       Frag.setLayoutOrder(FragmentIndex++);
   }
 
-  // Layout until everything fits.
-  while (layoutOnce(Layout))
+  // Layout until everything fits. After the first round, only the sections
+  // that depend on a section relaxed in the previous round are laid out again.
+  RelaxationDependencies Deps(*this);
+  SmallPtrSet<const MCSection *, 16> Pending, Relaxed;
+  for (const MCSection &Sec : *this)
+    Pending.insert(&Sec);
+  while (layoutOnce(Layout, Pending, Relaxed)) {
     if (getContext().hadError())
       return;
+    Pending.clear();
+    for (const MCSection *Sec : Relaxed)
+      Deps.addDependents(Sec, Pending);
+    Relaxed.clear();
+  }
 
   DEBUG_WITH_TYPE("mc-dump", {
       errs() << "assembler backend - post-relaxation\n--\n";
@@ -1090,14 +1210,22 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
   return false;
 }
 
-bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
+bool MCAssembler::layoutOnce(MCAsmLayout &Layout,
+                             const SmallPtrSetImpl<const MCSection *> &Pending,
+                             SmallPtrSetImpl<const MCSection *> &Relaxed) {
   ++stats::RelaxationSteps;
 
   bool WasRelaxed = false;
   for (iterator it = begin(), ie = end(); it != ie; ++it) {
     MCSection &Sec = *it;
-    while (layoutSectionOnce(Layout, Sec))
+    if (!Pending.count(&Sec)) {
+      ++stats::SkippedSectionLayouts;
+      continue;
+    }
+    while (layoutSectionOnce(Layout, Sec)) {
       WasRelaxed = true;
+      Relaxed.insert(&Sec);
+    }
   }
 
   return WasRelaxed;
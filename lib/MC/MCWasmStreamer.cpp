@@ -173,22 +173,24 @@ void MCWasmStreamer::EmitInstToFragment(const MCInst &Inst,
 void MCWasmStreamer::EmitInstToData(const MCInst &Inst,
                                     const MCSubtargetInfo &STI) {
   MCAssembler &Assembler = getAssembler();
-  SmallVector<MCFixup, 4> Fixups;
-  SmallString<256> Code;
-  raw_svector_ostream VecOS(Code);
-  Assembler.getEmitter().encodeInstruction(Inst, VecOS, Fixups, STI);
 
   // Append the encoded instruction to the current data fragment (or create a
   // new such fragment if the current fragment is not a data fragment).
   MCDataFragment *DF = getOrCreateDataFragment();
 
-  // Add the fixups and data.
-  for (unsigned I = 0, E = Fixups.size(); I != E; ++I) {
-    Fixups[I].setOffset(Fixups[I].getOffset() + DF->getContents().size());
-    DF->getFixups().push_back(Fixups[I]);
-  }
+  // Wasm instructions are never relaxed, so the instruction is encoded straight
+  // into the fragment, with its fixups, rather than into a temporary buffer
+  // that is copied afterwards. The emitter reports fixup offsets relative to
+  // the start of the instruction, which are rebased onto the fragment here.
+  SmallVectorImpl<char> &Contents = DF->getContents();
+  SmallVectorImpl<MCFixup> &Fixups = DF->getFixups();
+  size_t InstStart = Contents.size();
+  size_t FirstFixup = Fixups.size();
+  raw_svector_ostream VecOS(Contents);
+  Assembler.getEmitter().encodeInstruction(Inst, VecOS, Fixups, STI);
+  for (size_t I = FirstFixup, E = Fixups.size(); I != E; ++I)
+    Fixups[I].setOffset(Fixups[I].getOffset() + InstStart);
   DF->setHasInstructions(STI);
-  DF->getContents().append(Code.begin(), Code.end());
 }
 
 void MCWasmStreamer::FinishImpl() {
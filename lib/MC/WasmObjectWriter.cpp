@@ -1128,6 +1128,12 @@ static bool isInSymtab(const MCSymbolWasm &Sym) {
   if (Sym.isSection())
     return false;
 
+  // Data placed in a custom section is not part of linear memory and cannot
+  // be described by a data symbol.
+  if (Sym.isData() && Sym.isDefined() &&
+      !static_cast<const MCSectionWasm &>(Sym.getSection()).isWasmData())
+    return false;
+
   return true;
 }
 
@@ -12,6 +12,7 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
 #include "llvm/IR/LLVMContext.h"
@@ -22,6 +23,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -452,7 +454,39 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  // Reading the symbols of every member is by far the most expensive part of
+  // writing an archive, especially for bitcode members, so do it for all
+  // members in parallel. Each member gets its own name buffer, and the buffers
+  // are appended to SymNames in member order below so that the symbol table
+  // is the same as if the members had been read one after the other.
+  std::vector<SmallString<0>> MemberSymNames(NewMembers.size());
+  std::vector<Optional<Expected<std::vector<unsigned>>>> MemberSymbols(
+      NewMembers.size());
+  std::vector<char> MemberHasObject(NewMembers.size());
+  parallel::for_each_n(
+      parallel::par, size_t(0), NewMembers.size(), [&](size_t I) {
+        raw_svector_ostream Names(MemberSymNames[I]);
+        bool MemberIsObject = false;
+        MemberSymbols[I].emplace(getSymbols(NewMembers[I].Buf->getMemBufferRef(),
+                                            Names, MemberIsObject));
+        MemberHasObject[I] = MemberIsObject;
+      });
+
+  // Report the error of the first member whose symbols couldn't be read.
+  Error Err = Error::success();
+  for (Optional<Expected<std::vector<unsigned>>> &Symbols : MemberSymbols) {
+    if (*Symbols)
+      continue;
+    if (Err)
+      consumeError(Symbols->takeError());
+    else
+      Err = Symbols->takeError();
+  }
+  if (Err)
+    return std::move(Err);
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -478,13 +512,15 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Buf.getBufferSize() + MemberPadding);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    std::vector<unsigned> Symbols = std::move(**MemberSymbols[I]);
+    uint64_t SymNamesOffset = SymNames.tell();
+    for (unsigned &Offset : Symbols)
+      Offset += SymNamesOffset;
+    SymNames << MemberSymNames[I];
+    HasObject |= MemberHasObject[I] != 0;
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back({std::move(Symbols), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -537,10 +573,63 @@ Expected<std::string> computeArchiveRelativePath(StringRef From, StringRef To) {
   return Relative.str();
 }
 
+// Rewrite the parts of the existing archive ArcName, whose contents are
+// OldArchive, that differ from the new archive made of Head (the magic and the
+// symbol table) and Members. Returns false without touching the file if the
+// new archive doesn't have the same size as the old one.
+static Expected<bool> updateArchiveInPlace(StringRef ArcName,
+                                           const MemoryBuffer &OldArchive,
+                                           StringRef Head,
+                                           ArrayRef<MemberData> Members) {
+  std::vector<StringRef> Parts = {Head};
+  for (const MemberData &M : Members) {
+    Parts.push_back(M.Header);
+    Parts.push_back(M.Data);
+    Parts.push_back(M.Padding);
+  }
+
+  uint64_t Size = 0;
+  for (StringRef Part : Parts)
+    Size += Part.size();
+  uint64_t FileSize;
+  if (Size != OldArchive.getBufferSize() ||
+      sys::fs::file_size(ArcName, FileSize) || FileSize != Size)
+    return false;
+
+  // The data of unchanged members refers to OldArchive, which may be a view of
+  // the file being written, so copy every changed part before writing any.
+  StringRef OldData = OldArchive.getBuffer();
+  std::vector<std::pair<uint64_t, std::string>> Changed;
+  uint64_t Pos = 0;
+  for (StringRef Part : Parts) {
+    if (OldData.substr(Pos, Part.size()) != Part)
+      Changed.emplace_back(Pos, Part.str());
+    Pos += Part.size();
+  }
+  if (Changed.empty())
+    return true;
+
+  int FD;
+  if (std::error_code EC = sys::fs::openFileForReadWrite(
+          ArcName, FD, sys::fs::CD_OpenExisting, sys::fs::OF_None))
+    return errorCodeToError(EC);
+  raw_fd_ostream Out(FD, /*shouldClose=*/true);
+  for (const auto &Part : Changed)
+    Out.pwrite(Part.second.data(), Part.second.size(), Part.first);
+  Out.close();
+  if (Out.has_error()) {
+    std::error_code EC = Out.error();
+    Out.clear_error();
+    return errorCodeToError(EC);
+  }
+  return true;
+}
+
 Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
                    bool WriteSymtab, object::Archive::Kind Kind,
                    bool Deterministic, bool Thin,
-                   std::unique_ptr<MemoryBuffer> OldArchiveBuf) {
+                   std::unique_ptr<MemoryBuffer> OldArchiveBuf,
+                   bool UpdateInPlace) {
   assert((!Thin || !isBSDLike(Kind)) && "Only the gnu format has a thin mode");
 
   SmallString<0> SymNamesBuf;
@@ -593,16 +682,31 @@ Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
     }
   }
 
+  StringRef Magic = Thin ? "!<thin>\n" : "!<arch>\n";
+
+  if (UpdateInPlace && OldArchiveBuf) {
+    // The symbol table refers to members by their offset in the file, so it
+    // has to be written after the magic.
+    SmallString<0> HeadBuf;
+    raw_svector_ostream Head(HeadBuf);
+    Head << Magic;
+    if (WriteSymtab)
+      writeSymbolTable(Head, Kind, Deterministic, Data, SymNamesBuf);
+    Expected<bool> UpdatedOrErr =
+        updateArchiveInPlace(ArcName, *OldArchiveBuf, HeadBuf, Data);
+    if (!UpdatedOrErr)
+      return UpdatedOrErr.takeError();
+    if (*UpdatedOrErr)
+      return Error::success();
+  }
+
   Expected<sys::fs::TempFile> Temp =
       sys::fs::TempFile::create(ArcName + ".temp-archive-%%%%%%%.a");
   if (!Temp)
     return Temp.takeError();
 
   raw_fd_ostream Out(Temp->FD, false);
-  if (Thin)
-    Out << "!<thin>\n";
-  else
-    Out << "!<arch>\n";
+  Out << Magic;
 
   if (WriteSymtab)
     writeSymbolTable(Out, Kind, Deterministic, Data, SymNamesBuf);
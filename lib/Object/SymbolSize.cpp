@@ -11,6 +11,7 @@
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/MachO.h"
+#include "llvm/Object/Wasm.h"
 
 using namespace llvm;
 using namespace object;
@@ -49,6 +50,14 @@ llvm::object::computeSymbolSizes(const ObjectFile &O) {
     return Ret;
   }
 
+  // Wasm symbols refer to functions and data segments whose sizes are known,
+  // and their values are indices rather than addresses.
+  if (const auto *W = dyn_cast<WasmObjectFile>(&O)) {
+    for (SymbolRef Sym : W->symbols())
+      Ret.push_back({Sym, W->getSymbolSize(Sym)});
+    return Ret;
+  }
+
   // Collect sorted symbol addresses. Include dummy addresses for the end
   // of each section.
   std::vector<SymEntry> Addresses;
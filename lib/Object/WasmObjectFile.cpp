@@ -1382,6 +1382,20 @@ uint64_t WasmObjectFile::getWasmSymbolValue(const WasmSymbol &Sym) const {
   llvm_unreachable("invalid symbol type");
 }
 
+uint64_t WasmObjectFile::getSymbolSize(SymbolRef Symb) const {
+  const WasmSymbol &Sym = getWasmSymbol(Symb);
+  if (Sym.isUndefined())
+    return 0;
+  switch (Sym.Info.Kind) {
+  case wasm::WASM_SYMBOL_TYPE_FUNCTION:
+    return getDefinedFunction(Sym.Info.ElementIndex).Size;
+  case wasm::WASM_SYMBOL_TYPE_DATA:
+    return Sym.Info.DataRef.Size;
+  default:
+    return 0;
+  }
+}
+
 uint64_t WasmObjectFile::getSymbolValueImpl(DataRefImpl Symb) const {
   return getWasmSymbolValue(getWasmSymbol(Symb));
 }
@@ -18,13 +18,17 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ProfileData/Coverage/CoverageMappingReader.h"
 #include "llvm/ProfileData/InstrProfReader.h"
+#include "llvm/Support/BinaryByteStream.h"
+#include "llvm/Support/BinaryStreamReader.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/LEB128.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -32,6 +36,7 @@
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -300,6 +305,245 @@ CoverageMapping::load(ArrayRef<StringRef> ObjectFilenames,
 
 namespace {
 
+/// The magic at the start of a coverage index, followed by its version.
+const char IndexMagic[] = {'\xff', 'l', 'c', 'o', 'v', 'i', 'd', 'x'};
+const uint64_t IndexVersion = 2;
+
+/// Reads the integers and strings of a coverage index.
+class IndexReader {
+  BinaryByteStream Stream;
+  BinaryStreamReader Reader;
+
+public:
+  IndexReader(StringRef Data)
+      : Stream(arrayRefFromStringRef(Data), support::little), Reader(Stream) {}
+
+  bool atEnd() const { return Reader.empty(); }
+
+  Error read(uint64_t &Value) {
+    if (Error E = Reader.readULEB128(Value)) {
+      consumeError(std::move(E));
+      return make_error<CoverageMapError>(coveragemap_error::truncated);
+    }
+    return Error::success();
+  }
+
+  Error read(unsigned &Value) {
+    uint64_t Value64;
+    if (Error E = read(Value64))
+      return E;
+    if (Value64 > std::numeric_limits<unsigned>::max())
+      return make_error<CoverageMapError>(coveragemap_error::malformed);
+    Value = Value64;
+    return Error::success();
+  }
+
+  Error read(StringRef &String) {
+    unsigned Size;
+    if (Error E = read(Size))
+      return E;
+    if (Error E = Reader.readFixedString(String, Size)) {
+      consumeError(std::move(E));
+      return make_error<CoverageMapError>(coveragemap_error::truncated);
+    }
+    return Error::success();
+  }
+};
+
+} // end anonymous namespace
+
+Expected<std::unique_ptr<CoverageMapping>>
+CoverageMapping::loadFromIndex(MemoryBufferRef Index,
+                               ArrayRef<CoverageIndexInput> Inputs) {
+  StringRef Data = Index.getBuffer();
+  if (!Data.startswith(StringRef(IndexMagic, sizeof(IndexMagic))))
+    return make_error<CoverageMapError>(coveragemap_error::no_data_found);
+  IndexReader Reader(Data.drop_front(sizeof(IndexMagic)));
+  auto Malformed = [] {
+    return make_error<CoverageMapError>(coveragemap_error::malformed);
+  };
+
+  uint64_t Version;
+  if (Error E = Reader.read(Version))
+    return std::move(E);
+  if (Version != IndexVersion)
+    return make_error<CoverageMapError>(coveragemap_error::unsupported_version);
+
+  // The inputs come first, so that a stale index is rejected before any of
+  // the records is decoded.
+  unsigned NumInputs;
+  if (Error E = Reader.read(NumInputs))
+    return std::move(E);
+  std::vector<CoverageIndexInput> IndexInputs(NumInputs);
+  for (CoverageIndexInput &Input : IndexInputs) {
+    StringRef Path, Arch;
+    if (Error E = Reader.read(Path))
+      return std::move(E);
+    if (Error E = Reader.read(Input.Size))
+      return std::move(E);
+    if (Error E = Reader.read(Input.ModificationTime))
+      return std::move(E);
+    if (Error E = Reader.read(Arch))
+      return std::move(E);
+    Input.Path = Path;
+    Input.Arch = Arch;
+  }
+  if (IndexInputs.size() != Inputs.size() ||
+      !std::equal(IndexInputs.begin(), IndexInputs.end(), Inputs.begin()))
+    return make_error<CoverageMapError>(coveragemap_error::index_out_of_date);
+
+  unsigned NumFilenames;
+  if (Error E = Reader.read(NumFilenames))
+    return std::move(E);
+  std::vector<StringRef> Filenames(NumFilenames);
+  for (StringRef &Filename : Filenames)
+    if (Error E = Reader.read(Filename))
+      return std::move(E);
+
+  auto Coverage = std::unique_ptr<CoverageMapping>(new CoverageMapping());
+  unsigned NumFunctions;
+  if (Error E = Reader.read(NumFunctions))
+    return std::move(E);
+  for (unsigned I = 0; I < NumFunctions; ++I) {
+    StringRef Name;
+    unsigned NumFunctionFiles;
+    if (Error E = Reader.read(Name))
+      return std::move(E);
+    if (Error E = Reader.read(NumFunctionFiles))
+      return std::move(E);
+    SmallVector<StringRef, 4> FunctionFiles;
+    for (unsigned J = 0; J < NumFunctionFiles; ++J) {
+      unsigned FilenameID;
+      if (Error E = Reader.read(FilenameID))
+        return std::move(E);
+      if (FilenameID >= Filenames.size())
+        return Malformed();
+      FunctionFiles.push_back(Filenames[FilenameID]);
+    }
+
+    FunctionRecord Function(Name, FunctionFiles);
+    unsigned NumRegions;
+    if (Error E = Reader.read(NumRegions))
+      return std::move(E);
+    if (NumRegions == 0)
+      return Malformed();
+    for (unsigned J = 0; J < NumRegions; ++J) {
+      unsigned Kind, EncodedCount, FileID, ExpandedFileID, LineStart,
+          ColumnStart, LineEnd, ColumnEnd;
+      uint64_t ExecutionCount;
+      for (unsigned *Field : {&Kind, &EncodedCount, &FileID, &ExpandedFileID,
+                              &LineStart, &ColumnStart, &LineEnd, &ColumnEnd})
+        if (Error E = Reader.read(*Field))
+          return std::move(E);
+      if (Error E = Reader.read(ExecutionCount))
+        return std::move(E);
+      if (Kind > CounterMappingRegion::GapRegion ||
+          FileID >= NumFunctionFiles ||
+          (Kind == CounterMappingRegion::ExpansionRegion &&
+           ExpandedFileID >= NumFunctionFiles))
+        return Malformed();
+
+      unsigned CounterID = EncodedCount >> Counter::EncodingTagBits;
+      Counter Count;
+      switch (EncodedCount & Counter::EncodingTagMask) {
+      case Counter::Zero:
+        break;
+      case Counter::CounterValueReference:
+        Count = Counter::getCounter(CounterID);
+        break;
+      case Counter::Expression:
+        Count = Counter::getExpression(CounterID);
+        break;
+      default:
+        return Malformed();
+      }
+      Function.pushRegion(
+          CounterMappingRegion(Count, FileID, ExpandedFileID, LineStart,
+                               ColumnStart, LineEnd, ColumnEnd,
+                               CounterMappingRegion::RegionKind(Kind)),
+          ExecutionCount);
+    }
+    Coverage->Functions.push_back(std::move(Function));
+  }
+
+  unsigned NumHashMismatches;
+  if (Error E = Reader.read(NumHashMismatches))
+    return std::move(E);
+  for (unsigned I = 0; I < NumHashMismatches; ++I) {
+    StringRef Name;
+    uint64_t Hash;
+    if (Error E = Reader.read(Name))
+      return std::move(E);
+    if (Error E = Reader.read(Hash))
+      return std::move(E);
+    Coverage->FuncHashMismatches.emplace_back(Name, Hash);
+  }
+
+  if (!Reader.atEnd())
+    return Malformed();
+  return std::move(Coverage);
+}
+
+void CoverageMapping::writeIndex(raw_ostream &OS,
+                                 ArrayRef<CoverageIndexInput> Inputs) const {
+  // Most filenames are shared by many functions, so write each of them once
+  // and refer to them by index.
+  StringMap<unsigned> FilenameIDs;
+  std::vector<StringRef> Filenames;
+  for (const FunctionRecord &Function : Functions)
+    for (const std::string &Filename : Function.Filenames)
+      if (FilenameIDs.insert({Filename, Filenames.size()}).second)
+        Filenames.push_back(Filename);
+
+  auto WriteString = [&](StringRef String) {
+    encodeULEB128(String.size(), OS);
+    OS << String;
+  };
+
+  OS.write(IndexMagic, sizeof(IndexMagic));
+  encodeULEB128(IndexVersion, OS);
+  encodeULEB128(Inputs.size(), OS);
+  for (const CoverageIndexInput &Input : Inputs) {
+    WriteString(Input.Path);
+    encodeULEB128(Input.Size, OS);
+    encodeULEB128(Input.ModificationTime, OS);
+    WriteString(Input.Arch);
+  }
+  encodeULEB128(Filenames.size(), OS);
+  for (StringRef Filename : Filenames)
+    WriteString(Filename);
+
+  encodeULEB128(Functions.size(), OS);
+  for (const FunctionRecord &Function : Functions) {
+    WriteString(Function.Name);
+    encodeULEB128(Function.Filenames.size(), OS);
+    for (const std::string &Filename : Function.Filenames)
+      encodeULEB128(FilenameIDs[Filename], OS);
+    // The execution count of the function is that of its first region.
+    encodeULEB128(Function.CountedRegions.size(), OS);
+    for (const CountedRegion &Region : Function.CountedRegions) {
+      encodeULEB128(Region.Kind, OS);
+      encodeULEB128((uint64_t(Region.Count.getCounterID())
+                     << Counter::EncodingTagBits) |
+                        Region.Count.getKind(),
+                    OS);
+      for (unsigned Field : {Region.FileID, Region.ExpandedFileID,
+                             Region.LineStart, Region.ColumnStart,
+                             Region.LineEnd, Region.ColumnEnd})
+        encodeULEB128(Field, OS);
+      encodeULEB128(Region.ExecutionCount, OS);
+    }
+  }
+
+  encodeULEB128(FuncHashMismatches.size(), OS);
+  for (const auto &Mismatch : FuncHashMismatches) {
+    WriteString(Mismatch.first);
+    encodeULEB128(Mismatch.second, OS);
+  }
+}
+
+namespace {
+
 /// Distributes functions into instantiation sets.
 ///
 /// An instantiation set is a collection of functions that have the same source
@@ -752,6 +996,8 @@ static std::string getCoverageMapErrString(coveragemap_error Err) {
     return "Truncated coverage data";
   case coveragemap_error::malformed:
     return "Malformed coverage data";
+  case coveragemap_error::index_out_of_date:
+    return "Coverage index is out of date";
   }
   llvm_unreachable("A value of coveragemap_error has no message.");
 }
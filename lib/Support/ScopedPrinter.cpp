@@ -2,6 +2,7 @@
 
 #include "llvm/Support/Format.h"
 #include <cctype>
+#include <limits>
 
 using namespace llvm::support;
 
@@ -43,4 +44,222 @@ void ScopedPrinter::printBinaryImpl(StringRef Label, StringRef Str,
   }
 }
 
+JSONScopedPrinter::JSONScopedPrinter(raw_ostream &OS, unsigned IndentSize)
+    : ScopedPrinter(OS, ScopedPrinterKind::JSON), JOS(OS, IndentSize) {}
+
+// Object files may contain arbitrary bytes where names are expected.
+static std::string toUTF8(StringRef Str) {
+  if (json::isUTF8(Str))
+    return Str;
+  return json::fixUTF8(Str);
+}
+
+// json::Value holds signed 64-bit integers; print larger values, such as
+// addresses in the upper half of a 64-bit address space, as strings rather
+// than let them wrap around.
+static json::Value toJSONNumber(uint64_t Value) {
+  if (Value <= uint64_t(std::numeric_limits<int64_t>::max()))
+    return int64_t(Value);
+  return std::to_string(Value);
+}
+
+// Lists hold the printed form of their items; keep integers as numbers.
+static json::Value toJSONListItem(StringRef Item) {
+  int64_t Number;
+  if (!Item.getAsInteger(10, Number))
+    return Number;
+  uint64_t UNumber;
+  if (!Item.getAsInteger(10, UNumber))
+    return toJSONNumber(UNumber);
+  return toUTF8(Item);
+}
+
+void JSONScopedPrinter::printAttribute(StringRef Label,
+                                       const json::Value &Value) {
+  if (ScopeHistory.empty() || ScopeHistory.back().Context != Scope::Object) {
+    JOS.object([&] { JOS.attribute(toUTF8(Label), Value); });
+    return;
+  }
+  JOS.attribute(toUTF8(Label), Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, uint64_t Value) {
+  printAttribute(Label, toJSONNumber(Value));
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, uint32_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, uint16_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, uint8_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, int64_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, int32_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, int16_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, int8_t Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printNumber(StringRef Label, const APSInt &Value) {
+  if (Value.getMinSignedBits() <= 64)
+    printAttribute(Label, Value.getSExtValue());
+  else
+    printAttribute(Label, Value.toString(10));
+}
+
+void JSONScopedPrinter::printBoolean(StringRef Label, bool Value) {
+  printAttribute(Label, Value);
+}
+
+void JSONScopedPrinter::printString(StringRef Value) {
+  if (!ScopeHistory.empty() && ScopeHistory.back().Context == Scope::Object)
+    JOS.attribute("Message", toUTF8(Value));
+  else
+    JOS.value(toUTF8(Value));
+}
+
+void JSONScopedPrinter::printString(StringRef Label, StringRef Value) {
+  printAttribute(Label, toUTF8(Value));
+}
+
+void JSONScopedPrinter::printFlagsImpl(StringRef Label, HexNumber Value,
+                                       ArrayRef<FlagEntry> Flags) {
+  json::Array FlagArray;
+  for (const FlagEntry &Flag : Flags)
+    FlagArray.push_back(
+        json::Object{{"Name", toUTF8(Flag.Name)},
+                     {"Value", toJSONNumber(Flag.Value.Value)}});
+  printAttribute(Label, json::Object{{"Value", toJSONNumber(Value.Value)},
+                                     {"Flags", std::move(FlagArray)}});
+}
+
+void JSONScopedPrinter::printFlagsImpl(StringRef Label, HexNumber Value,
+                                       ArrayRef<HexNumber> Flags) {
+  json::Array FlagArray;
+  for (const HexNumber &Flag : Flags)
+    FlagArray.push_back(toJSONNumber(Flag.Value));
+  printAttribute(Label, json::Object{{"Value", toJSONNumber(Value.Value)},
+                                     {"Flags", std::move(FlagArray)}});
+}
+
+void JSONScopedPrinter::printListImpl(StringRef Label,
+                                      ArrayRef<std::string> Items) {
+  json::Array Array;
+  for (const std::string &Item : Items)
+    Array.push_back(toJSONListItem(Item));
+  printAttribute(Label, std::move(Array));
+}
+
+void JSONScopedPrinter::printHexListImpl(StringRef Label,
+                                         ArrayRef<HexNumber> Items) {
+  json::Array Array;
+  for (const HexNumber &Item : Items)
+    Array.push_back(toJSONNumber(Item.Value));
+  printAttribute(Label, std::move(Array));
+}
+
+void JSONScopedPrinter::printHexImpl(StringRef Label, HexNumber Value) {
+  printAttribute(Label, toJSONNumber(Value.Value));
+}
+
+void JSONScopedPrinter::printHexImpl(StringRef Label, StringRef Str,
+                                     HexNumber Value) {
+  printAttribute(Label, json::Object{{"Name", toUTF8(Str)},
+                                     {"Value", toJSONNumber(Value.Value)}});
+}
+
+void JSONScopedPrinter::printSymbolOffsetImpl(StringRef Label, StringRef Symbol,
+                                              HexNumber Value) {
+  printAttribute(Label, json::Object{{"Symbol", toUTF8(Symbol)},
+                                     {"Offset", toJSONNumber(Value.Value)}});
+}
+
+void JSONScopedPrinter::printNumberImpl(StringRef Label, StringRef Str,
+                                        StringRef Value) {
+  printAttribute(Label, json::Object{{"Name", toUTF8(Str)},
+                                     {"Value", toJSONListItem(Value)}});
+}
+
+void JSONScopedPrinter::printBinaryImpl(StringRef Label, StringRef Str,
+                                        ArrayRef<uint8_t> Value, bool Block,
+                                        uint32_t StartOffset) {
+  json::Object Binary;
+  if (!Str.empty())
+    Binary["Name"] = toUTF8(Str);
+  if (Block)
+    Binary["Offset"] = StartOffset;
+  Binary["Bytes"] = json::Array(Value);
+  printAttribute(Label, std::move(Binary));
+}
+
+void JSONScopedPrinter::scopedBegin(Scope Context) {
+  // Attributes always have a name; give one to scopes opened without a label
+  // inside an object.
+  if (!ScopeHistory.empty() && ScopeHistory.back().Context == Scope::Object)
+    return scopedBegin(Context == Scope::Object ? "Object" : "Array", Context);
+  ScopeHistory.push_back({Context, /*Labeled=*/false, /*Wrapped=*/false});
+  if (Context == Scope::Object)
+    JOS.objectBegin();
+  else
+    JOS.arrayBegin();
+}
+
+void JSONScopedPrinter::scopedBegin(StringRef Label, Scope Context) {
+  bool Wrapped =
+      ScopeHistory.empty() || ScopeHistory.back().Context != Scope::Object;
+  if (Wrapped)
+    JOS.objectBegin();
+  JOS.attributeBegin(toUTF8(Label));
+  ScopeHistory.push_back({Context, /*Labeled=*/true, Wrapped});
+  if (Context == Scope::Object)
+    JOS.objectBegin();
+  else
+    JOS.arrayBegin();
+}
+
+void JSONScopedPrinter::scopedEnd() {
+  assert(!ScopeHistory.empty() && "Unmatched scopes");
+  ScopeContext Ctx = ScopeHistory.pop_back_val();
+  if (Ctx.Context == Scope::Object)
+    JOS.objectEnd();
+  else
+    JOS.arrayEnd();
+  if (Ctx.Labeled) {
+    JOS.attributeEnd();
+    if (Ctx.Wrapped)
+      JOS.objectEnd();
+  }
+}
+
+void JSONScopedPrinter::objectBegin() { scopedBegin(Scope::Object); }
+
+void JSONScopedPrinter::objectBegin(StringRef Label) {
+  scopedBegin(Label, Scope::Object);
+}
+
+void JSONScopedPrinter::objectEnd() { scopedEnd(); }
+
+void JSONScopedPrinter::arrayBegin() { scopedBegin(Scope::Array); }
+
+void JSONScopedPrinter::arrayBegin(StringRef Label) {
+  scopedBegin(Label, Scope::Array);
+}
+
+void JSONScopedPrinter::arrayEnd() { scopedEnd(); }
+
 } // namespace llvm
@@ -746,6 +746,9 @@ public:
         MatchInstructionImpl(Operands, Inst, ErrorInfo, MatchingInlineAsm);
     switch (MatchResult) {
     case Match_Success: {
+      // Tools like llvm-mca use the location to find the code region an
+      // instruction belongs to.
+      Inst.setLoc(IDLoc);
       if (CurrentState == FunctionStart) {
         // This is the first instruction in a function, but we haven't seen
         // a .local directive yet. The streamer requires locals to be encoded
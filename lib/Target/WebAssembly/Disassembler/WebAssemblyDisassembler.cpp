@@ -129,7 +129,7 @@ MCDisassembler::DecodeStatus WebAssemblyDisassembler::onSymbolStart(
     int64_t FunctionCount;
     if (!nextLEB(FunctionCount, Bytes, Size, false))
       return MCDisassembler::Fail;
-    outs() << "        # " << FunctionCount << " functions in section.";
+    CStream << "        # " << FunctionCount << " functions in section.";
   } else {
     // Parse the start of a single function.
     int64_t BodySize, LocalEntryCount;
@@ -137,7 +137,7 @@ MCDisassembler::DecodeStatus WebAssemblyDisassembler::onSymbolStart(
         !nextLEB(LocalEntryCount, Bytes, Size, false))
       return MCDisassembler::Fail;
     if (LocalEntryCount) {
-      outs() << "        .local ";
+      CStream << "        .local ";
       for (int64_t I = 0; I < LocalEntryCount; I++) {
         int64_t Count, Type;
         if (!nextLEB(Count, Bytes, Size, false) ||
@@ -145,13 +145,13 @@ MCDisassembler::DecodeStatus WebAssemblyDisassembler::onSymbolStart(
           return MCDisassembler::Fail;
         for (int64_t J = 0; J < Count; J++) {
           if (I || J)
-            outs() << ", ";
-          outs() << WebAssembly::anyTypeToString(Type);
+            CStream << ", ";
+          CStream << WebAssembly::anyTypeToString(Type);
         }
       }
     }
   }
-  outs() << "\n";
+  CStream << "\n";
   return MCDisassembler::Success;
 }
 
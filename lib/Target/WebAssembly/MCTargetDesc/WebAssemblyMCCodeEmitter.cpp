@@ -23,7 +23,7 @@
 #include "llvm/MC/MCSubtargetInfo.h"
 #include "llvm/MC/MCSymbol.h"
 #include "llvm/Support/Debug.h"
-#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -37,6 +37,13 @@ STATISTIC(MCNumFixups, "Number of MC fixups created.");
 namespace {
 class WebAssemblyMCCodeEmitter final : public MCCodeEmitter {
   const MCInstrInfo &MCII;
+  WebAssemblyLEBObserver LEBObserver;
+
+  /// Report an LEB128 field of \p Width bytes to the observer, if any.
+  void noteLEB(StringRef Kind, unsigned Width) const {
+    if (LEBObserver)
+      LEBObserver(Kind, Width);
+  }
 
   // Implementation generated by tablegen.
   uint64_t getBinaryCodeForInstr(const MCInst &MI,
@@ -49,6 +56,10 @@ class WebAssemblyMCCodeEmitter final : public MCCodeEmitter {
 
 public:
   WebAssemblyMCCodeEmitter(const MCInstrInfo &MCII) : MCII(MCII) {}
+
+  void setLEBObserver(WebAssemblyLEBObserver Observer) {
+    LEBObserver = std::move(Observer);
+  }
 };
 } // end anonymous namespace
 
@@ -56,29 +67,54 @@ MCCodeEmitter *llvm::createWebAssemblyMCCodeEmitter(const MCInstrInfo &MCII) {
   return new WebAssemblyMCCodeEmitter(MCII);
 }
 
+void llvm::setWebAssemblyLEBObserver(MCCodeEmitter &Emitter,
+                                     WebAssemblyLEBObserver Observer) {
+  static_cast<WebAssemblyMCCodeEmitter &>(Emitter).setLEBObserver(
+      std::move(Observer));
+}
+
+/// The largest number of bytes a single operand is encoded with: a padded
+/// 64-bit LEB128 or an 8-byte immediate.
+static const unsigned MaxOperandSize = 10;
+
 void WebAssemblyMCCodeEmitter::encodeInstruction(
     const MCInst &MI, raw_ostream &OS, SmallVectorImpl<MCFixup> &Fixups,
     const MCSubtargetInfo &STI) const {
-  uint64_t Start = OS.tell();
+  // Encode the whole instruction into a buffer large enough for any encoding
+  // of its operands, then hand it to the stream in one write. This avoids a
+  // stream call for every byte, which dominates emission of wasm code, where
+  // most instructions are only one to three bytes long. The inline storage
+  // covers any instruction with up to five operands, which includes every
+  // load and store, so only calls and br_tables with many operands allocate.
+  // The storage is reserved rather than resized so that it is not cleared.
+  SmallVector<uint8_t, 64> Buffer;
+  Buffer.reserve(3 + MaxOperandSize * (MI.getNumOperands() + 1));
+  uint8_t *const Begin = Buffer.data();
+  uint8_t *P = Begin;
 
   uint64_t Binary = getBinaryCodeForInstr(MI, Fixups, STI);
   if (Binary <= UINT8_MAX) {
-    OS << uint8_t(Binary);
+    *P++ = uint8_t(Binary);
   } else {
     assert(Binary <= UINT16_MAX && "Several-byte opcodes not supported yet");
-    OS << uint8_t(Binary >> 8);
-    encodeULEB128(uint8_t(Binary), OS);
+    *P++ = uint8_t(Binary >> 8);
+    P += encodeULEB128(uint8_t(Binary), P);
   }
 
   // For br_table instructions, encode the size of the table. In the MCInst,
   // there's an index operand (if not a stack instruction), one operand for
   // each table entry, and the default operand.
+  unsigned Width;
   if (MI.getOpcode() == WebAssembly::BR_TABLE_I32_S ||
-      MI.getOpcode() == WebAssembly::BR_TABLE_I64_S)
-    encodeULEB128(MI.getNumOperands() - 1, OS);
+      MI.getOpcode() == WebAssembly::BR_TABLE_I64_S) {
+    P += Width = encodeULEB128(MI.getNumOperands() - 1, P);
+    noteLEB("uleb", Width);
+  }
   if (MI.getOpcode() == WebAssembly::BR_TABLE_I32 ||
-      MI.getOpcode() == WebAssembly::BR_TABLE_I64)
-    encodeULEB128(MI.getNumOperands() - 2, OS);
+      MI.getOpcode() == WebAssembly::BR_TABLE_I64) {
+    P += Width = encodeULEB128(MI.getNumOperands() - 2, P);
+    noteLEB("uleb", Width);
+  }
 
   const MCInstrDesc &Desc = MCII.get(MI.getOpcode());
   for (unsigned I = 0, E = MI.getNumOperands(); I < E; ++I) {
@@ -93,36 +129,45 @@ void WebAssemblyMCCodeEmitter::encodeInstruction(
                           << int(Info.OperandType) << "\n");
         switch (Info.OperandType) {
         case WebAssembly::OPERAND_I32IMM:
-          encodeSLEB128(int32_t(MO.getImm()), OS);
+          P += Width = encodeSLEB128(int32_t(MO.getImm()), P);
+          noteLEB("sleb", Width);
           break;
         case WebAssembly::OPERAND_OFFSET32:
-          encodeULEB128(uint32_t(MO.getImm()), OS);
+          P += Width = encodeULEB128(uint32_t(MO.getImm()), P);
+          noteLEB("uleb", Width);
           break;
         case WebAssembly::OPERAND_I64IMM:
-          encodeSLEB128(int64_t(MO.getImm()), OS);
+          P += Width = encodeSLEB128(int64_t(MO.getImm()), P);
+          noteLEB("sleb", Width);
           break;
         case WebAssembly::OPERAND_SIGNATURE:
-          OS << uint8_t(MO.getImm());
+          *P++ = uint8_t(MO.getImm());
           break;
         case WebAssembly::OPERAND_VEC_I8IMM:
-          support::endian::write<uint8_t>(OS, MO.getImm(), support::little);
+          support::endian::write<uint8_t>(P, MO.getImm(), support::little);
+          P += 1;
           break;
         case WebAssembly::OPERAND_VEC_I16IMM:
-          support::endian::write<uint16_t>(OS, MO.getImm(), support::little);
+          support::endian::write<uint16_t>(P, MO.getImm(), support::little);
+          P += 2;
           break;
         case WebAssembly::OPERAND_VEC_I32IMM:
-          support::endian::write<uint32_t>(OS, MO.getImm(), support::little);
+          support::endian::write<uint32_t>(P, MO.getImm(), support::little);
+          P += 4;
           break;
         case WebAssembly::OPERAND_VEC_I64IMM:
-          support::endian::write<uint64_t>(OS, MO.getImm(), support::little);
+          support::endian::write<uint64_t>(P, MO.getImm(), support::little);
+          P += 8;
           break;
         case WebAssembly::OPERAND_GLOBAL:
           llvm_unreachable("wasm globals should only be accessed symbolicly");
         default:
-          encodeULEB128(uint64_t(MO.getImm()), OS);
+          P += Width = encodeULEB128(uint64_t(MO.getImm()), P);
+          noteLEB("uleb", Width);
         }
       } else {
-        encodeULEB128(uint64_t(MO.getImm()), OS);
+        P += Width = encodeULEB128(uint64_t(MO.getImm()), P);
+        noteLEB("uleb", Width);
       }
 
     } else if (MO.isFPImm()) {
@@ -131,11 +176,13 @@ void WebAssemblyMCCodeEmitter::encodeInstruction(
         // TODO: MC converts all floating point immediate operands to double.
         // This is fine for numeric values, but may cause NaNs to change bits.
         auto F = float(MO.getFPImm());
-        support::endian::write<float>(OS, F, support::little);
+        support::endian::write<float>(P, F, support::little);
+        P += 4;
       } else {
         assert(Info.OperandType == WebAssembly::OPERAND_F64IMM);
         double D = MO.getFPImm();
-        support::endian::write<double>(OS, D, support::little);
+        support::endian::write<double>(P, D, support::little);
+        P += 8;
       }
 
     } else if (MO.isExpr()) {
@@ -160,15 +207,21 @@ void WebAssemblyMCCodeEmitter::encodeInstruction(
       default:
         llvm_unreachable("unexpected symbolic operand kind");
       }
-      Fixups.push_back(MCFixup::create(OS.tell() - Start, MO.getExpr(),
-                                       FixupKind, MI.getLoc()));
+      Fixups.push_back(
+          MCFixup::create(P - Begin, MO.getExpr(), FixupKind, MI.getLoc()));
       ++MCNumFixups;
-      encodeULEB128(0, OS, PaddedSize);
+      P += encodeULEB128(0, P, PaddedSize);
+      noteLEB("padded", PaddedSize);
     } else {
       llvm_unreachable("unexpected operand kind");
     }
   }
 
+  assert(size_t(P - Begin) <= Buffer.capacity() &&
+         "Instruction encoding overflowed its buffer");
+  Buffer.set_size(P - Begin);
+  OS.write(reinterpret_cast<const char *>(Buffer.data()), Buffer.size());
+
   ++MCNumEmitted; // Keep track of the # of mi's emitted.
 }
 
@@ -16,6 +16,7 @@
 #include "MCTargetDesc/WebAssemblyMCAsmInfo.h"
 #include "MCTargetDesc/WebAssemblyTargetStreamer.h"
 #include "TargetInfo/WebAssemblyTargetInfo.h"
+#include "llvm/MC/MCInstrAnalysis.h"
 #include "llvm/MC/MCInstrInfo.h"
 #include "llvm/MC/MCRegisterInfo.h"
 #include "llvm/MC/MCSubtargetInfo.h"
@@ -28,6 +29,11 @@ using namespace llvm;
 #define GET_INSTRINFO_MC_DESC
 #include "WebAssemblyGenInstrInfo.inc"
 
+// Defines llvm::WebAssembly::getStackOpcode and getRegisterOpcode to convert
+// between register and stack instructions.
+#define GET_INSTRMAP_INFO 1
+#include "WebAssemblyGenInstrInfo.inc"
+
 #define GET_SUBTARGETINFO_MC_DESC
 #include "WebAssemblyGenSubtargetInfo.inc"
 
@@ -94,6 +100,35 @@ static MCTargetStreamer *createNullTargetStreamer(MCStreamer &S) {
   return new WebAssemblyTargetNullStreamer(S);
 }
 
+namespace {
+class WebAssemblyMCInstrAnalysis : public MCInstrAnalysis {
+public:
+  explicit WebAssemblyMCInstrAnalysis(const MCInstrInfo *Info)
+      : MCInstrAnalysis(Info) {}
+
+  bool getStackEffect(const MCInst &Inst, unsigned &Pops,
+                      unsigned &Pushes) const override {
+    // Stack instructions have no register operands. Their register based
+    // versions have a def for every value pushed and a register use for every
+    // value popped.
+    int RegOpcode = WebAssembly::getRegisterOpcode(Inst.getOpcode());
+    if (RegOpcode == -1)
+      return false;
+    const MCInstrDesc &Desc = Info->get(RegOpcode);
+    Pushes = Desc.getNumDefs();
+    Pops = 0;
+    for (unsigned I = Desc.getNumDefs(), E = Desc.getNumOperands(); I != E; ++I)
+      if (Desc.OpInfo[I].OperandType == MCOI::OPERAND_REGISTER)
+        ++Pops;
+    return true;
+  }
+};
+} // end anonymous namespace
+
+static MCInstrAnalysis *createMCInstrAnalysis(const MCInstrInfo *Info) {
+  return new WebAssemblyMCInstrAnalysis(Info);
+}
+
 // Force static initialization.
 extern "C" void LLVMInitializeWebAssemblyTargetMC() {
   for (Target *T :
@@ -119,6 +154,9 @@ extern "C" void LLVMInitializeWebAssemblyTargetMC() {
     // Register the MC subtarget info.
     TargetRegistry::RegisterMCSubtargetInfo(*T, createMCSubtargetInfo);
 
+    // Register the MC instruction analyzer.
+    TargetRegistry::RegisterMCInstrAnalysis(*T, createMCInstrAnalysis);
+
     // Register the object target streamer.
     TargetRegistry::RegisterObjectTargetStreamer(*T,
                                                  createObjectTargetStreamer);
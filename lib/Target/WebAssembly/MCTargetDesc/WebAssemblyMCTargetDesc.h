@@ -15,9 +15,11 @@
 #define LLVM_LIB_TARGET_WEBASSEMBLY_MCTARGETDESC_WEBASSEMBLYMCTARGETDESC_H
 
 #include "../WebAssemblySubtarget.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Wasm.h"
 #include "llvm/MC/MCInstrDesc.h"
 #include "llvm/Support/DataTypes.h"
+#include <functional>
 #include <memory>
 
 namespace llvm {
@@ -35,6 +37,17 @@ class raw_pwrite_stream;
 
 MCCodeEmitter *createWebAssemblyMCCodeEmitter(const MCInstrInfo &MCII);
 
+/// Called by the WebAssembly code emitter for every LEB128 field of an
+/// instruction, with the kind of field ("uleb", "sleb", or "padded" for
+/// relocatable operands, which are padded to their maximum width) and the
+/// number of bytes it was encoded with.
+using WebAssemblyLEBObserver = std::function<void(StringRef Kind, unsigned)>;
+
+/// Install \p Observer on \p Emitter, which must have been created by
+/// createWebAssemblyMCCodeEmitter. An empty function removes the observer.
+void setWebAssemblyLEBObserver(MCCodeEmitter &Emitter,
+                               WebAssemblyLEBObserver Observer);
+
 MCAsmBackend *createWebAssemblyAsmBackend(const Triple &TT);
 
 std::unique_ptr<MCObjectTargetWriter>
@@ -140,6 +153,14 @@ static const unsigned End = 0x0b;
 
 wasm::ValType toValType(const MVT &Ty);
 
+/// Return the stack based version of the register based instruction \p Opcode,
+/// or -1 if there is none.
+int getStackOpcode(unsigned short Opcode);
+
+/// Return the register based version of the stack based instruction
+/// \p Opcode, or -1 if there is none.
+int getRegisterOpcode(unsigned short Opcode);
+
 /// Return the default p2align value for a load or store with the given opcode.
 inline unsigned GetDefaultP2AlignAny(unsigned Opc) {
   switch (Opc) {
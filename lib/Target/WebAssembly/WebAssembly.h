@@ -21,6 +21,9 @@
 namespace llvm {
 
 class WebAssemblyTargetMachine;
+class WebAssemblySubtarget;
+class WebAssemblyRegisterBankInfo;
+class InstructionSelector;
 class ModulePass;
 class FunctionPass;
 
@@ -36,6 +39,10 @@ FunctionPass *createWebAssemblyISelDag(WebAssemblyTargetMachine &TM,
                                        CodeGenOpt::Level OptLevel);
 FunctionPass *createWebAssemblyArgumentMove();
 FunctionPass *createWebAssemblySetP2AlignOperands();
+InstructionSelector *
+createWebAssemblyInstructionSelector(const WebAssemblyTargetMachine &TM,
+                                     WebAssemblySubtarget &Subtarget,
+                                     WebAssemblyRegisterBankInfo &RBI);
 
 // Late passes.
 FunctionPass *createWebAssemblyReplacePhysRegs();
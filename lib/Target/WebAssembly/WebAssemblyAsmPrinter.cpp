@@ -28,6 +28,7 @@
 #include "llvm/BinaryFormat/Wasm.h"
 #include "llvm/CodeGen/Analysis.h"
 #include "llvm/CodeGen/AsmPrinter.h"
+#include "llvm/CodeGen/CodeSizeReport.h"
 #include "llvm/CodeGen/MachineConstantPool.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineModuleInfoImpls.h"
@@ -35,12 +36,15 @@
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Metadata.h"
+#include "llvm/MC/MCAssembler.h"
 #include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCObjectStreamer.h"
 #include "llvm/MC/MCSectionWasm.h"
 #include "llvm/MC/MCStreamer.h"
 #include "llvm/MC/MCSymbol.h"
 #include "llvm/MC/MCSymbolWasm.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/LEB128.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -81,6 +85,22 @@ WebAssemblyTargetStreamer *WebAssemblyAsmPrinter::getTargetStreamer() {
   return static_cast<WebAssemblyTargetStreamer *>(TS);
 }
 
+/// The number of bytes the local declarations of a function body take: a
+/// count of runs of equal types, then each run as a count and a type.
+static unsigned getLocalsDeclSize(ArrayRef<wasm::ValType> Locals) {
+  unsigned NumRuns = 0;
+  unsigned Size = 0;
+  for (unsigned I = 0, E = Locals.size(); I != E;) {
+    unsigned RunEnd = I + 1;
+    while (RunEnd != E && Locals[RunEnd] == Locals[I])
+      ++RunEnd;
+    ++NumRuns;
+    Size += getULEB128Size(RunEnd - I) + 1;
+    I = RunEnd;
+  }
+  return getULEB128Size(NumRuns) + Size;
+}
+
 //===----------------------------------------------------------------------===//
 // WebAssemblyAsmPrinter Implementation.
 //===----------------------------------------------------------------------===//
@@ -110,6 +130,21 @@ uint64_t string_to_name( const char* str ) {
    return name;
 }
 
+void WebAssemblyAsmPrinter::EmitStartOfAsmFile(Module &M) {
+  // Have the code emitter report the width of every LEB128 field it encodes.
+  // Symbolic operands are padded to their maximum width so that they can be
+  // relocated, and are reported apart.
+  if (!getSizeReport())
+    return;
+  MCCodeEmitter &Emitter =
+      static_cast<MCObjectStreamer &>(*OutStreamer).getAssembler().getEmitter();
+  setWebAssemblyLEBObserver(Emitter, [this](StringRef Kind, unsigned Width) {
+    if (CodeSizeReport *Report = getSizeReport())
+      Report->addTargetBytes("leb-width", (Kind + ":" + Twine(Width)).str(),
+                             Width);
+  });
+}
+
 void WebAssemblyAsmPrinter::EmitEndOfAsmFile(Module &M) {
   for (auto &It : OutContext.getSymbols()) {
     // Emit a .globaltype and .eventtype declaration.
@@ -402,6 +437,9 @@ void WebAssemblyAsmPrinter::EmitFunctionBodyStart() {
   SmallVector<wasm::ValType, 16> Locals;
   valTypesFromMVTs(MFI->getLocals(), Locals);
   getTargetStreamer()->emitLocal(Locals);
+  if (CodeSizeReport *Report = getSizeReport())
+    Report->addTargetBytes("locals", MF->getName(),
+                           getLocalsDeclSize(Locals), Locals.size());
 
   AsmPrinter::EmitFunctionBodyStart();
 }
@@ -57,6 +57,7 @@ public:
   // AsmPrinter Implementation.
   //===------------------------------------------------------------------===//
 
+  void EmitStartOfAsmFile(Module &M) override;
   void EmitEndOfAsmFile(Module &M) override;
   void EmitProducerInfo(Module &M);
   void EmitTargetFeatures(Module &M);
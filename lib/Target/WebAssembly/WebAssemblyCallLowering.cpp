@@ -0,0 +1,322 @@
+//===- WebAssemblyCallLowering.cpp - Call lowering for GlobalISel ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements the lowering of LLVM calls, arguments and returns to
+/// machine code for GlobalISel.
+///
+/// WebAssembly has no argument or return registers. Incoming arguments are
+/// defined by ARGUMENT instructions, and values are returned and passed to
+/// calls as plain virtual register operands. Those operands must already have
+/// a register class, so the generic virtual registers used by the rest of the
+/// function are connected to them with COPYs, which the coalescer removes.
+///
+/// Only scalar integer, floating-point and pointer values are handled so far;
+/// anything else (aggregates, SIMD, varargs, exnref) makes GlobalISel fall
+/// back to SelectionDAG.
+///
+//===----------------------------------------------------------------------===//
+
+#include "WebAssemblyCallLowering.h"
+#include "MCTargetDesc/WebAssemblyMCTargetDesc.h"
+#include "WebAssemblyISelLowering.h"
+#include "WebAssemblyMachineFunctionInfo.h"
+#include "WebAssemblySubtarget.h"
+#include "llvm/CodeGen/GlobalISel/MachineIRBuilder.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Function.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "wasm-call-lowering"
+
+WebAssemblyCallLowering::WebAssemblyCallLowering(
+    const WebAssemblyTargetLowering &TLI)
+    : CallLowering(&TLI) {}
+
+/// Returns the register class holding values of IR type \p Ty, or null if such
+/// values aren't supported by GlobalISel yet.
+static const TargetRegisterClass *getRegClassForType(const Type *Ty,
+                                                     const DataLayout &DL) {
+  unsigned Size;
+  if (Ty->isPointerTy())
+    Size = DL.getPointerSizeInBits(Ty->getPointerAddressSpace());
+  else if (Ty->isIntegerTy())
+    Size = Ty->getIntegerBitWidth();
+  else if (Ty->isFloatTy())
+    return &WebAssembly::F32RegClass;
+  else if (Ty->isDoubleTy())
+    return &WebAssembly::F64RegClass;
+  else
+    return nullptr;
+
+  if (Size <= 32)
+    return &WebAssembly::I32RegClass;
+  if (Size == 64)
+    return &WebAssembly::I64RegClass;
+  return nullptr;
+}
+
+static MVT getValueType(const TargetRegisterClass &RC) {
+  switch (RC.getID()) {
+  case WebAssembly::I32RegClassID:
+    return MVT::i32;
+  case WebAssembly::I64RegClassID:
+    return MVT::i64;
+  case WebAssembly::F32RegClassID:
+    return MVT::f32;
+  case WebAssembly::F64RegClassID:
+    return MVT::f64;
+  default:
+    llvm_unreachable("Unexpected register class");
+  }
+}
+
+static unsigned getArgumentOpcode(const TargetRegisterClass &RC) {
+  switch (RC.getID()) {
+  case WebAssembly::I32RegClassID:
+    return WebAssembly::ARGUMENT_i32;
+  case WebAssembly::I64RegClassID:
+    return WebAssembly::ARGUMENT_i64;
+  case WebAssembly::F32RegClassID:
+    return WebAssembly::ARGUMENT_f32;
+  case WebAssembly::F64RegClassID:
+    return WebAssembly::ARGUMENT_f64;
+  default:
+    llvm_unreachable("Unexpected register class");
+  }
+}
+
+static unsigned getReturnOpcode(const TargetRegisterClass &RC) {
+  switch (RC.getID()) {
+  case WebAssembly::I32RegClassID:
+    return WebAssembly::RETURN_I32;
+  case WebAssembly::I64RegClassID:
+    return WebAssembly::RETURN_I64;
+  case WebAssembly::F32RegClassID:
+    return WebAssembly::RETURN_F32;
+  case WebAssembly::F64RegClassID:
+    return WebAssembly::RETURN_F64;
+  default:
+    llvm_unreachable("Unexpected register class");
+  }
+}
+
+static unsigned getCallOpcode(const TargetRegisterClass *RC, bool IsDirect) {
+  if (!RC)
+    return IsDirect ? WebAssembly::CALL_VOID : WebAssembly::PCALL_INDIRECT_VOID;
+  switch (RC->getID()) {
+  case WebAssembly::I32RegClassID:
+    return IsDirect ? WebAssembly::CALL_i32 : WebAssembly::PCALL_INDIRECT_i32;
+  case WebAssembly::I64RegClassID:
+    return IsDirect ? WebAssembly::CALL_i64 : WebAssembly::PCALL_INDIRECT_i64;
+  case WebAssembly::F32RegClassID:
+    return IsDirect ? WebAssembly::CALL_f32 : WebAssembly::PCALL_INDIRECT_f32;
+  case WebAssembly::F64RegClassID:
+    return IsDirect ? WebAssembly::CALL_f64 : WebAssembly::PCALL_INDIRECT_f64;
+  default:
+    llvm_unreachable("Unexpected register class");
+  }
+}
+
+static bool callingConvSupported(CallingConv::ID CallConv) {
+  // Keep this in sync with the SelectionDAG lowering.
+  return CallConv == CallingConv::C || CallConv == CallingConv::Fast ||
+         CallConv == CallingConv::Cold ||
+         CallConv == CallingConv::PreserveMost ||
+         CallConv == CallingConv::PreserveAll ||
+         CallConv == CallingConv::CXX_FAST_TLS;
+}
+
+static bool flagsSupported(const ISD::ArgFlagsTy &Flags) {
+  return !Flags.isByVal() && !Flags.isInAlloca() && !Flags.isNest() &&
+         !Flags.isSwiftSelf() && !Flags.isSwiftError();
+}
+
+/// Copy the incoming value \p Src, which has register class \p RC, into the
+/// generic virtual register \p Dst, truncating it if \p Dst is narrower.
+static void copyIncomingValue(MachineIRBuilder &MIRBuilder, Register Dst,
+                              Register Src, const TargetRegisterClass &RC) {
+  MachineRegisterInfo &MRI = *MIRBuilder.getMRI();
+  const TargetRegisterInfo &TRI = *MRI.getTargetRegisterInfo();
+  unsigned Size = TRI.getRegSizeInBits(RC);
+  if (MRI.getType(Dst).getSizeInBits() == Size) {
+    MIRBuilder.buildCopy(Dst, Src);
+    return;
+  }
+  Register Tmp = MRI.createGenericVirtualRegister(LLT::scalar(Size));
+  MIRBuilder.buildCopy(Tmp, Src);
+  MIRBuilder.buildTrunc(Dst, Tmp);
+}
+
+/// Copy the outgoing generic virtual register \p Src into a new virtual
+/// register of class \p RC, extending it as requested by \p Flags if it is
+/// narrower.
+static Register copyOutgoingValue(MachineIRBuilder &MIRBuilder, Register Src,
+                                  const TargetRegisterClass &RC,
+                                  const ISD::ArgFlagsTy &Flags) {
+  MachineRegisterInfo &MRI = *MIRBuilder.getMRI();
+  const TargetRegisterInfo &TRI = *MRI.getTargetRegisterInfo();
+  unsigned Size = TRI.getRegSizeInBits(RC);
+  if (MRI.getType(Src).getSizeInBits() != Size) {
+    LLT ExtTy = LLT::scalar(Size);
+    if (Flags.isSExt())
+      Src = MIRBuilder.buildSExt(ExtTy, Src).getReg(0);
+    else if (Flags.isZExt())
+      Src = MIRBuilder.buildZExt(ExtTy, Src).getReg(0);
+    else
+      Src = MIRBuilder.buildAnyExt(ExtTy, Src).getReg(0);
+  }
+  Register Dst = MRI.createVirtualRegister(&RC);
+  MIRBuilder.buildCopy(Dst, Src);
+  return Dst;
+}
+
+bool WebAssemblyCallLowering::lowerReturn(MachineIRBuilder &MIRBuilder,
+                                          const Value *Val,
+                                          ArrayRef<Register> VRegs) const {
+  if (!Val) {
+    MIRBuilder.buildInstr(WebAssembly::RETURN_VOID);
+    return true;
+  }
+
+  MachineFunction &MF = MIRBuilder.getMF();
+  const Function &F = MF.getFunction();
+  const TargetRegisterClass *RC =
+      getRegClassForType(Val->getType(), MF.getDataLayout());
+  if (!RC || VRegs.size() != 1)
+    return false;
+
+  ISD::ArgFlagsTy Flags;
+  const AttributeList &Attrs = F.getAttributes();
+  if (Attrs.hasAttribute(AttributeList::ReturnIndex, Attribute::SExt))
+    Flags.setSExt();
+  else if (Attrs.hasAttribute(AttributeList::ReturnIndex, Attribute::ZExt))
+    Flags.setZExt();
+
+  Register Reg = copyOutgoingValue(MIRBuilder, VRegs[0], *RC, Flags);
+  MIRBuilder.buildInstr(getReturnOpcode(*RC)).addUse(Reg);
+  return true;
+}
+
+bool WebAssemblyCallLowering::lowerFormalArguments(
+    MachineIRBuilder &MIRBuilder, const Function &F,
+    ArrayRef<ArrayRef<Register>> VRegs) const {
+  if (F.isVarArg() || !callingConvSupported(F.getCallingConv()))
+    return false;
+
+  MachineFunction &MF = MIRBuilder.getMF();
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+  const DataLayout &DL = MF.getDataLayout();
+  auto *MFI = MF.getInfo<WebAssemblyFunctionInfo>();
+
+  // Check everything up front, so that no parameters are recorded for
+  // functions we fall back on.
+  const TargetRegisterClass *RetRC = nullptr;
+  if (!F.getReturnType()->isVoidTy()) {
+    RetRC = getRegClassForType(F.getReturnType(), DL);
+    if (!RetRC)
+      return false;
+  }
+  for (const Argument &Arg : F.args()) {
+    if (VRegs[Arg.getArgNo()].size() != 1 ||
+        !getRegClassForType(Arg.getType(), DL))
+      return false;
+    const AttributeList &Attrs = F.getAttributes();
+    unsigned I = Arg.getArgNo();
+    if (Attrs.hasParamAttribute(I, Attribute::ByVal) ||
+        Attrs.hasParamAttribute(I, Attribute::InAlloca) ||
+        Attrs.hasParamAttribute(I, Attribute::Nest) ||
+        Attrs.hasParamAttribute(I, Attribute::SwiftSelf) ||
+        Attrs.hasParamAttribute(I, Attribute::SwiftError))
+      return false;
+  }
+
+  // Set up the incoming ARGUMENTS value, which serves to represent the liveness
+  // of the incoming values before they're represented by virtual registers.
+  // Unlike SelectionDAG, the IRTranslator does not copy the function live-ins
+  // to the entry block.
+  MRI.addLiveIn(WebAssembly::ARGUMENTS);
+  MIRBuilder.getMBB().addLiveIn(WebAssembly::ARGUMENTS);
+
+  for (const Argument &Arg : F.args()) {
+    const TargetRegisterClass &RC = *getRegClassForType(Arg.getType(), DL);
+    Register ArgReg = MRI.createVirtualRegister(&RC);
+    MIRBuilder.buildInstr(getArgumentOpcode(RC))
+        .addDef(ArgReg)
+        .addImm(Arg.getArgNo());
+    copyIncomingValue(MIRBuilder, VRegs[Arg.getArgNo()][0], ArgReg, RC);
+    MFI->addParam(getValueType(RC));
+  }
+  if (RetRC)
+    MFI->addResult(getValueType(*RetRC));
+  return true;
+}
+
+bool WebAssemblyCallLowering::lowerCall(MachineIRBuilder &MIRBuilder,
+                                        CallingConv::ID CallConv,
+                                        const MachineOperand &Callee,
+                                        const ArgInfo &OrigRet,
+                                        ArrayRef<ArgInfo> OrigArgs) const {
+  if (!callingConvSupported(CallConv))
+    return false;
+
+  MachineFunction &MF = MIRBuilder.getMF();
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+  const DataLayout &DL = MF.getDataLayout();
+  // Direct calls in PIC code go through the GOT; leave them to SelectionDAG.
+  if (!Callee.isReg() && MF.getTarget().isPositionIndependent())
+    return false;
+
+  const TargetRegisterClass *RetRC = nullptr;
+  if (!OrigRet.Ty->isVoidTy()) {
+    RetRC = getRegClassForType(OrigRet.Ty, DL);
+    if (!RetRC || OrigRet.Regs.size() != 1)
+      return false;
+  }
+  for (const ArgInfo &Arg : OrigArgs)
+    if (!Arg.IsFixed || Arg.Regs.size() != 1 || !flagsSupported(Arg.Flags) ||
+        !getRegClassForType(Arg.Ty, DL))
+      return false;
+
+  // Calls don't pass anything in the linear memory stack, so unlike other
+  // targets there is no call frame to set up around them.
+  SmallVector<Register, 8> ArgRegs;
+  for (const ArgInfo &Arg : OrigArgs)
+    ArgRegs.push_back(copyOutgoingValue(MIRBuilder, Arg.Regs[0],
+                                        *getRegClassForType(Arg.Ty, DL),
+                                        Arg.Flags));
+
+  bool IsDirect = !Callee.isReg();
+  Register CalleeReg;
+  if (!IsDirect) {
+    const TargetRegisterClass &PtrRC =
+        *MRI.getTargetRegisterInfo()->getPointerRegClass(MF);
+    CalleeReg = MRI.createVirtualRegister(&PtrRC);
+    MIRBuilder.buildCopy(CalleeReg, Callee.getReg());
+  }
+
+  auto MIB = MIRBuilder.buildInstrNoInsert(getCallOpcode(RetRC, IsDirect));
+  Register ResultReg;
+  if (RetRC) {
+    ResultReg = MRI.createVirtualRegister(RetRC);
+    MIB.addDef(ResultReg);
+  }
+  if (IsDirect)
+    MIB.add(Callee);
+  else
+    MIB.addUse(CalleeReg);
+  for (Register Reg : ArgRegs)
+    MIB.addUse(Reg);
+  MIRBuilder.insertInstr(MIB);
+
+  if (RetRC)
+    copyIncomingValue(MIRBuilder, OrigRet.Regs[0], ResultReg, *RetRC);
+  return true;
+}
@@ -117,11 +117,32 @@ bool WebAssemblyFrameLowering::needsSPWriteback(
   // 1. We need SP not only for EH support but also because we actually use
   // stack or we have a frame address taken.
   // 2. We cannot use the red zone.
-  bool CanUseRedZone = MFI.getStackSize() <= RedZoneSize && !MFI.hasCalls() &&
+  // Nothing else runs while a function that makes no calls is active, so such
+  // a function can keep its frame below __stack_pointer whatever its size.
+  bool CanUseRedZone = !MFI.hasCalls() &&
                        !MF.getFunction().hasFnAttribute(Attribute::NoRedZone);
   return needsSPForLocalFrame(MF) && !CanUseRedZone;
 }
 
+/// The prolog and epilog only touch __stack_pointer and the SP32 and FP32
+/// registers, so they can be moved onto the paths that use the frame, as long
+/// as no code outside of those paths needs the stack pointer: EH pads copy it
+/// in the prolog, and dynamic allocas and llvm.frameaddress read it anywhere.
+bool WebAssemblyFrameLowering::enableShrinkWrapping(
+    const MachineFunction &MF) const {
+  const MachineFrameInfo &MFI = MF.getFrameInfo();
+  return !needsPrologForEH(MF) && !MFI.hasVarSizedObjects() &&
+         !MFI.isFrameAddressTaken();
+}
+
+/// The user stack lives in linear memory, so most functions load or store
+/// something; only the accesses that may reach the frame need to keep it.
+/// Until the frame is laid out, it is only addressed through frame indices.
+bool WebAssemblyFrameLowering::shrinkWrapIgnoresNonStackAccesses(
+    const MachineFunction &MF) const {
+  return true;
+}
+
 void WebAssemblyFrameLowering::writeSPToGlobal(
     unsigned SrcReg, MachineFunction &MF, MachineBasicBlock &MBB,
     MachineBasicBlock::iterator &InsertStore, const DebugLoc &DL) const {
@@ -22,12 +22,6 @@ class MachineFrameInfo;
 
 class WebAssemblyFrameLowering final : public TargetFrameLowering {
 public:
-  /// Size of the red zone for the user stack (leaf functions can use this much
-  /// space below the stack pointer without writing it back to __stack_pointer
-  /// global).
-  // TODO: (ABI) Revisit and decide how large it should be.
-  static const size_t RedZoneSize = 128;
-
   WebAssemblyFrameLowering()
       : TargetFrameLowering(StackGrowsDown, /*StackAlignment=*/16,
                             /*LocalAreaOffset=*/0,
@@ -44,6 +38,9 @@ public:
 
   bool hasFP(const MachineFunction &MF) const override;
   bool hasReservedCallFrame(const MachineFunction &MF) const override;
+  bool enableShrinkWrapping(const MachineFunction &MF) const override;
+  bool
+  shrinkWrapIgnoresNonStackAccesses(const MachineFunction &MF) const override;
 
   bool needsPrologForEH(const MachineFunction &MF) const;
 
@@ -0,0 +1,554 @@
+//===- WebAssemblyInstructionSelector.cpp - Instruction selection ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements the targeting of the InstructionSelector class for
+/// WebAssembly. Most instructions are selected by the patterns imported from
+/// the SelectionDAG instruction descriptions; the remaining ones (comparisons,
+/// branches, memory accesses and addresses) are selected by hand here.
+///
+//===----------------------------------------------------------------------===//
+
+#include "MCTargetDesc/WebAssemblyMCTargetDesc.h"
+#include "WebAssembly.h"
+#include "WebAssemblyRegisterBankInfo.h"
+#include "WebAssemblySubtarget.h"
+#include "WebAssemblyTargetMachine.h"
+#include "llvm/CodeGen/GlobalISel/InstructionSelector.h"
+#include "llvm/CodeGen/GlobalISel/InstructionSelectorImpl.h"
+#include "llvm/CodeGen/GlobalISel/Utils.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/IR/GlobalVariable.h"
+
+#define DEBUG_TYPE "wasm-isel"
+
+using namespace llvm;
+
+namespace {
+
+#define GET_GLOBALISEL_PREDICATE_BITSET
+#include "WebAssemblyGenGlobalISel.inc"
+#undef GET_GLOBALISEL_PREDICATE_BITSET
+
+class WebAssemblyInstructionSelector : public InstructionSelector {
+public:
+  WebAssemblyInstructionSelector(const WebAssemblyTargetMachine &TM,
+                                 const WebAssemblySubtarget &STI,
+                                 const WebAssemblyRegisterBankInfo &RBI);
+
+  bool select(MachineInstr &I, CodeGenCoverage &CoverageInfo) const override;
+  static const char *getName() { return DEBUG_TYPE; }
+
+private:
+  bool selectImpl(MachineInstr &I, CodeGenCoverage &CoverageInfo) const;
+
+  const TargetRegisterClass *getRegClass(Register Reg,
+                                         MachineRegisterInfo &MRI) const;
+  bool constrainRegToClass(Register Reg, MachineRegisterInfo &MRI) const;
+
+  bool selectCopy(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectLoadStore(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectICmp(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectFCmp(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectGlobalValue(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectNarrowExtOrTrunc(MachineInstr &I, MachineRegisterInfo &MRI) const;
+
+  const WebAssemblyTargetMachine &TM;
+  const WebAssemblySubtarget &STI;
+  const WebAssemblyInstrInfo &TII;
+  const WebAssemblyRegisterInfo &TRI;
+  const WebAssemblyRegisterBankInfo &RBI;
+
+#define GET_GLOBALISEL_PREDICATES_DECL
+#include "WebAssemblyGenGlobalISel.inc"
+#undef GET_GLOBALISEL_PREDICATES_DECL
+
+#define GET_GLOBALISEL_TEMPORARIES_DECL
+#include "WebAssemblyGenGlobalISel.inc"
+#undef GET_GLOBALISEL_TEMPORARIES_DECL
+};
+
+} // end anonymous namespace
+
+#define GET_GLOBALISEL_IMPL
+#include "WebAssemblyGenGlobalISel.inc"
+#undef GET_GLOBALISEL_IMPL
+
+WebAssemblyInstructionSelector::WebAssemblyInstructionSelector(
+    const WebAssemblyTargetMachine &TM, const WebAssemblySubtarget &STI,
+    const WebAssemblyRegisterBankInfo &RBI)
+    : InstructionSelector(), TM(TM), STI(STI), TII(*STI.getInstrInfo()),
+      TRI(*STI.getRegisterInfo()), RBI(RBI),
+
+#define GET_GLOBALISEL_PREDICATES_INIT
+#include "WebAssemblyGenGlobalISel.inc"
+#undef GET_GLOBALISEL_PREDICATES_INIT
+#define GET_GLOBALISEL_TEMPORARIES_INIT
+#include "WebAssemblyGenGlobalISel.inc"
+#undef GET_GLOBALISEL_TEMPORARIES_INIT
+{
+}
+
+/// Return the register class for \p Reg, based on its register bank and size,
+/// or null if the register can't be represented.
+const TargetRegisterClass *
+WebAssemblyInstructionSelector::getRegClass(Register Reg,
+                                            MachineRegisterInfo &MRI) const {
+  const RegisterBank *RB = RBI.getRegBank(Reg, MRI, TRI);
+  if (!RB)
+    return nullptr;
+  unsigned Size = RBI.getSizeInBits(Reg, MRI, TRI);
+  // i8 and i16 values live in i32 registers.
+  if (Size < 32 && RB->getID() == WebAssembly::IntRegBankID)
+    Size = 32;
+  if (Size != 32 && Size != 64)
+    return nullptr;
+  if (RB->getID() == WebAssembly::FloatRegBankID)
+    return Size == 32 ? &WebAssembly::F32RegClass : &WebAssembly::F64RegClass;
+  return Size == 32 ? &WebAssembly::I32RegClass : &WebAssembly::I64RegClass;
+}
+
+bool WebAssemblyInstructionSelector::constrainRegToClass(
+    Register Reg, MachineRegisterInfo &MRI) const {
+  if (TargetRegisterInfo::isPhysicalRegister(Reg))
+    return true;
+  const TargetRegisterClass *RC = getRegClass(Reg, MRI);
+  if (!RC || !RBI.constrainGenericRegister(Reg, *RC, MRI)) {
+    LLVM_DEBUG(dbgs() << "Failed to constrain " << printReg(Reg, &TRI)
+                      << "\n");
+    return false;
+  }
+  return true;
+}
+
+bool WebAssemblyInstructionSelector::selectCopy(
+    MachineInstr &I, MachineRegisterInfo &MRI) const {
+  Register DstReg = I.getOperand(0).getReg();
+  Register SrcReg = I.getOperand(1).getReg();
+  if (TargetRegisterInfo::isPhysicalRegister(DstReg) ||
+      TargetRegisterInfo::isPhysicalRegister(SrcReg))
+    return true;
+
+  if (!constrainRegToClass(DstReg, MRI) || !constrainRegToClass(SrcReg, MRI))
+    return false;
+
+  // A copy between the banks reinterprets the bits of the value.
+  const TargetRegisterClass *DstRC = MRI.getRegClass(DstReg);
+  const TargetRegisterClass *SrcRC = MRI.getRegClass(SrcReg);
+  if (DstRC == SrcRC)
+    return true;
+  unsigned Opc;
+  if (DstRC == &WebAssembly::I32RegClass && SrcRC == &WebAssembly::F32RegClass)
+    Opc = WebAssembly::I32_REINTERPRET_F32;
+  else if (DstRC == &WebAssembly::F32RegClass &&
+           SrcRC == &WebAssembly::I32RegClass)
+    Opc = WebAssembly::F32_REINTERPRET_I32;
+  else if (DstRC == &WebAssembly::I64RegClass &&
+           SrcRC == &WebAssembly::F64RegClass)
+    Opc = WebAssembly::I64_REINTERPRET_F64;
+  else if (DstRC == &WebAssembly::F64RegClass &&
+           SrcRC == &WebAssembly::I64RegClass)
+    Opc = WebAssembly::F64_REINTERPRET_I64;
+  else
+    return false;
+  I.setDesc(TII.get(Opc));
+  return true;
+}
+
+/// Return the opcode of the load or store \p GenericOpc of a value of
+/// \p ValSize bits in register bank \p RBID from or to \p MemSize bits of
+/// memory, or 0 if there is none.
+static unsigned getLoadStoreOpcode(unsigned GenericOpc, unsigned RBID,
+                                   unsigned ValSize, unsigned MemSize) {
+  bool Is64 = ValSize == 64;
+  if (RBID == WebAssembly::FloatRegBankID) {
+    if (MemSize != ValSize)
+      return 0;
+    if (GenericOpc == TargetOpcode::G_LOAD)
+      return Is64 ? WebAssembly::LOAD_F64 : WebAssembly::LOAD_F32;
+    if (GenericOpc == TargetOpcode::G_STORE)
+      return Is64 ? WebAssembly::STORE_F64 : WebAssembly::STORE_F32;
+    return 0;
+  }
+
+  switch (GenericOpc) {
+  case TargetOpcode::G_STORE:
+    switch (MemSize) {
+    case 8:
+      return Is64 ? WebAssembly::STORE8_I64 : WebAssembly::STORE8_I32;
+    case 16:
+      return Is64 ? WebAssembly::STORE16_I64 : WebAssembly::STORE16_I32;
+    case 32:
+      return Is64 ? WebAssembly::STORE32_I64 : WebAssembly::STORE_I32;
+    case 64:
+      return Is64 ? WebAssembly::STORE_I64 : 0;
+    }
+    return 0;
+  case TargetOpcode::G_SEXTLOAD:
+    switch (MemSize) {
+    case 8:
+      return Is64 ? WebAssembly::LOAD8_S_I64 : WebAssembly::LOAD8_S_I32;
+    case 16:
+      return Is64 ? WebAssembly::LOAD16_S_I64 : WebAssembly::LOAD16_S_I32;
+    case 32:
+      return Is64 ? WebAssembly::LOAD32_S_I64 : 0;
+    }
+    return 0;
+  case TargetOpcode::G_LOAD:
+    // Any-extending loads are zero-extending ones.
+    if (MemSize == ValSize)
+      return Is64 ? WebAssembly::LOAD_I64 : WebAssembly::LOAD_I32;
+    LLVM_FALLTHROUGH;
+  case TargetOpcode::G_ZEXTLOAD:
+    switch (MemSize) {
+    case 8:
+      return Is64 ? WebAssembly::LOAD8_U_I64 : WebAssembly::LOAD8_U_I32;
+    case 16:
+      return Is64 ? WebAssembly::LOAD16_U_I64 : WebAssembly::LOAD16_U_I32;
+    case 32:
+      return Is64 ? WebAssembly::LOAD32_U_I64 : 0;
+    }
+    return 0;
+  }
+  return 0;
+}
+
+bool WebAssemblyInstructionSelector::selectLoadStore(
+    MachineInstr &I, MachineRegisterInfo &MRI) const {
+  if (!I.hasOneMemOperand())
+    return false;
+  MachineMemOperand *MMO = *I.memoperands_begin();
+  if (MMO->getOrdering() != AtomicOrdering::NotAtomic)
+    return false;
+
+  Register ValReg = I.getOperand(0).getReg();
+  Register AddrReg = I.getOperand(1).getReg();
+  // The memory instructions only take 32-bit addresses.
+  if (MRI.getType(AddrReg).getSizeInBits() != 32)
+    return false;
+
+  const RegisterBank *RB = RBI.getRegBank(ValReg, MRI, TRI);
+  unsigned Opc = getLoadStoreOpcode(I.getOpcode(), RB->getID(),
+                                    MRI.getType(ValReg).getSizeInBits(),
+                                    MMO->getSize() * 8);
+  if (!Opc)
+    return false;
+
+  MachineBasicBlock &MBB = *I.getParent();
+  bool IsStore = I.getOpcode() == TargetOpcode::G_STORE;
+  auto MIB = BuildMI(MBB, I, I.getDebugLoc(), TII.get(Opc));
+  if (!IsStore)
+    MIB.addDef(ValReg);
+  // The p2align operand is filled in by WebAssemblySetP2AlignOperands.
+  MIB.addImm(0).addImm(0);
+  // Accesses to stack objects use the frame index directly, so that the frame
+  // offset is folded into the instruction's offset.
+  MachineInstr *AddrDef = MRI.getVRegDef(AddrReg);
+  if (AddrDef && AddrDef->getOpcode() == TargetOpcode::G_FRAME_INDEX)
+    MIB.add(AddrDef->getOperand(1));
+  else
+    MIB.addUse(AddrReg);
+  if (IsStore)
+    MIB.addUse(ValReg);
+  MIB.addMemOperand(MMO);
+
+  I.eraseFromParent();
+  return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+}
+
+bool WebAssemblyInstructionSelector::selectICmp(
+    MachineInstr &I, MachineRegisterInfo &MRI) const {
+  auto Pred = static_cast<CmpInst::Predicate>(I.getOperand(1).getPredicate());
+  bool Is64 = MRI.getType(I.getOperand(2).getReg()).getSizeInBits() == 64;
+  unsigned Opc;
+  switch (Pred) {
+  case CmpInst::ICMP_EQ:
+    Opc = Is64 ? WebAssembly::EQ_I64 : WebAssembly::EQ_I32;
+    break;
+  case CmpInst::ICMP_NE:
+    Opc = Is64 ? WebAssembly::NE_I64 : WebAssembly::NE_I32;
+    break;
+  case CmpInst::ICMP_SLT:
+    Opc = Is64 ? WebAssembly::LT_S_I64 : WebAssembly::LT_S_I32;
+    break;
+  case CmpInst::ICMP_ULT:
+    Opc = Is64 ? WebAssembly::LT_U_I64 : WebAssembly::LT_U_I32;
+    break;
+  case CmpInst::ICMP_SLE:
+    Opc = Is64 ? WebAssembly::LE_S_I64 : WebAssembly::LE_S_I32;
+    break;
+  case CmpInst::ICMP_ULE:
+    Opc = Is64 ? WebAssembly::LE_U_I64 : WebAssembly::LE_U_I32;
+    break;
+  case CmpInst::ICMP_SGT:
+    Opc = Is64 ? WebAssembly::GT_S_I64 : WebAssembly::GT_S_I32;
+    break;
+  case CmpInst::ICMP_UGT:
+    Opc = Is64 ? WebAssembly::GT_U_I64 : WebAssembly::GT_U_I32;
+    break;
+  case CmpInst::ICMP_SGE:
+    Opc = Is64 ? WebAssembly::GE_S_I64 : WebAssembly::GE_S_I32;
+    break;
+  case CmpInst::ICMP_UGE:
+    Opc = Is64 ? WebAssembly::GE_U_I64 : WebAssembly::GE_U_I32;
+    break;
+  default:
+    return false;
+  }
+
+  auto MIB = BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(Opc))
+                 .add(I.getOperand(0))
+                 .add(I.getOperand(2))
+                 .add(I.getOperand(3));
+  I.eraseFromParent();
+  return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+}
+
+bool WebAssemblyInstructionSelector::selectFCmp(
+    MachineInstr &I, MachineRegisterInfo &MRI) const {
+  auto Pred = static_cast<CmpInst::Predicate>(I.getOperand(1).getPredicate());
+  bool Is64 = MRI.getType(I.getOperand(2).getReg()).getSizeInBits() == 64;
+
+  // Unordered comparisons are the negation of the inverse ordered comparison,
+  // except for une, which WebAssembly provides directly.
+  bool Negate = false;
+  if (Pred != CmpInst::FCMP_UNE && CmpInst::isUnordered(Pred)) {
+    Pred = CmpInst::getInversePredicate(Pred);
+    Negate = true;
+  }
+
+  unsigned Opc;
+  switch (Pred) {
+  case CmpInst::FCMP_OEQ:
+    Opc = Is64 ? WebAssembly::EQ_F64 : WebAssembly::EQ_F32;
+    break;
+  case CmpInst::FCMP_UNE:
+    Opc = Is64 ? WebAssembly::NE_F64 : WebAssembly::NE_F32;
+    break;
+  case CmpInst::FCMP_OLT:
+    Opc = Is64 ? WebAssembly::LT_F64 : WebAssembly::LT_F32;
+    break;
+  case CmpInst::FCMP_OLE:
+    Opc = Is64 ? WebAssembly::LE_F64 : WebAssembly::LE_F32;
+    break;
+  case CmpInst::FCMP_OGT:
+    Opc = Is64 ? WebAssembly::GT_F64 : WebAssembly::GT_F32;
+    break;
+  case CmpInst::FCMP_OGE:
+    Opc = Is64 ? WebAssembly::GE_F64 : WebAssembly::GE_F32;
+    break;
+  default:
+    // one, ueq, ord, uno, true and false need more than one instruction;
+    // leave them to SelectionDAG.
+    return false;
+  }
+
+  MachineBasicBlock &MBB = *I.getParent();
+  Register DstReg = I.getOperand(0).getReg();
+  Register CmpReg =
+      Negate ? MRI.createVirtualRegister(&WebAssembly::I32RegClass) : DstReg;
+  auto MIB = BuildMI(MBB, I, I.getDebugLoc(), TII.get(Opc), CmpReg)
+                 .add(I.getOperand(2))
+                 .add(I.getOperand(3));
+  if (!constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI))
+    return false;
+  if (Negate) {
+    auto NotMIB =
+        BuildMI(MBB, I, I.getDebugLoc(), TII.get(WebAssembly::EQZ_I32), DstReg)
+            .addUse(CmpReg);
+    if (!constrainSelectedInstRegOperands(*NotMIB, TII, TRI, RBI))
+      return false;
+  }
+  I.eraseFromParent();
+  return true;
+}
+
+bool WebAssemblyInstructionSelector::selectGlobalValue(
+    MachineInstr &I, MachineRegisterInfo &MRI) const {
+  const GlobalValue *GV = I.getOperand(1).getGlobal();
+  // Position independent and thread local addresses are computed relative to
+  // a base global; leave them to SelectionDAG.
+  if (TM.isPositionIndependent() || GV->isThreadLocal() ||
+      GV->getAddressSpace() != 0)
+    return false;
+  bool Is64 = MRI.getType(I.getOperand(0).getReg()).getSizeInBits() == 64;
+  I.setDesc(TII.get(Is64 ? WebAssembly::CONST_I64 : WebAssembly::CONST_I32));
+  return constrainSelectedInstRegOperands(I, TII, TRI, RBI);
+}
+
+/// Select an extension of an i8 or i16 value to i32, or a truncation to i8 or
+/// i16. The narrow values live in i32 registers whose high bits are undefined.
+bool WebAssemblyInstructionSelector::selectNarrowExtOrTrunc(
+    MachineInstr &I, MachineRegisterInfo &MRI) const {
+  Register DstReg = I.getOperand(0).getReg();
+  Register SrcReg = I.getOperand(1).getReg();
+  unsigned DstSize = MRI.getType(DstReg).getSizeInBits();
+  unsigned SrcSize = MRI.getType(SrcReg).getSizeInBits();
+  MachineBasicBlock &MBB = *I.getParent();
+  const DebugLoc &DL = I.getDebugLoc();
+
+  if (I.getOpcode() == TargetOpcode::G_TRUNC) {
+    if (DstSize >= 32)
+      return false;
+    if (SrcSize == 32) {
+      I.setDesc(TII.get(TargetOpcode::COPY));
+      return selectCopy(I, MRI);
+    }
+    auto MIB = BuildMI(MBB, I, DL, TII.get(WebAssembly::I32_WRAP_I64), DstReg)
+                   .addUse(SrcReg);
+    I.eraseFromParent();
+    return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+  }
+
+  if (DstSize != 32 || SrcSize >= 32)
+    return false;
+
+  MachineInstrBuilder MIB;
+  switch (I.getOpcode()) {
+  case TargetOpcode::G_ANYEXT:
+    I.setDesc(TII.get(TargetOpcode::COPY));
+    return selectCopy(I, MRI);
+  case TargetOpcode::G_ZEXT: {
+    Register Mask = MRI.createVirtualRegister(&WebAssembly::I32RegClass);
+    BuildMI(MBB, I, DL, TII.get(WebAssembly::CONST_I32), Mask)
+        .addImm(maskTrailingOnes<uint32_t>(SrcSize));
+    MIB = BuildMI(MBB, I, DL, TII.get(WebAssembly::AND_I32), DstReg)
+              .addUse(SrcReg)
+              .addUse(Mask);
+    break;
+  }
+  case TargetOpcode::G_SEXT:
+    if (STI.hasSignExt()) {
+      MIB = BuildMI(MBB, I, DL,
+                    TII.get(SrcSize == 8 ? WebAssembly::I32_EXTEND8_S_I32
+                                         : WebAssembly::I32_EXTEND16_S_I32),
+                    DstReg)
+                .addUse(SrcReg);
+    } else {
+      Register Amount = MRI.createVirtualRegister(&WebAssembly::I32RegClass);
+      Register Shl = MRI.createVirtualRegister(&WebAssembly::I32RegClass);
+      BuildMI(MBB, I, DL, TII.get(WebAssembly::CONST_I32), Amount)
+          .addImm(32 - SrcSize);
+      BuildMI(MBB, I, DL, TII.get(WebAssembly::SHL_I32), Shl)
+          .addUse(SrcReg)
+          .addUse(Amount);
+      MIB = BuildMI(MBB, I, DL, TII.get(WebAssembly::SHR_S_I32), DstReg)
+                .addUse(Shl)
+                .addUse(Amount);
+    }
+    break;
+  default:
+    return false;
+  }
+  I.eraseFromParent();
+  return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+}
+
+bool WebAssemblyInstructionSelector::select(MachineInstr &I,
+                                            CodeGenCoverage &CoverageInfo) const {
+  MachineBasicBlock &MBB = *I.getParent();
+  MachineFunction &MF = *MBB.getParent();
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+
+  if (!isPreISelGenericOpcode(I.getOpcode())) {
+    if (I.isCopy())
+      return selectCopy(I, MRI);
+    return true;
+  }
+
+  switch (I.getOpcode()) {
+  case TargetOpcode::G_LOAD:
+  case TargetOpcode::G_SEXTLOAD:
+  case TargetOpcode::G_ZEXTLOAD:
+  case TargetOpcode::G_STORE:
+    return selectLoadStore(I, MRI);
+  default:
+    break;
+  }
+
+  if (selectImpl(I, CoverageInfo))
+    return true;
+
+  using namespace TargetOpcode;
+  auto IsDef64 = [&]() {
+    return RBI.getSizeInBits(I.getOperand(0).getReg(), MRI, TRI) == 64;
+  };
+
+  switch (I.getOpcode()) {
+  case G_PHI:
+    I.setDesc(TII.get(TargetOpcode::PHI));
+    return constrainRegToClass(I.getOperand(0).getReg(), MRI);
+  case G_IMPLICIT_DEF:
+    I.setDesc(TII.get(TargetOpcode::IMPLICIT_DEF));
+    return constrainRegToClass(I.getOperand(0).getReg(), MRI);
+  case G_PTRTOINT:
+  case G_INTTOPTR:
+    I.setDesc(TII.get(TargetOpcode::COPY));
+    return selectCopy(I, MRI);
+  case G_ICMP:
+    return selectICmp(I, MRI);
+  case G_FCMP:
+    return selectFCmp(I, MRI);
+  case G_GLOBAL_VALUE:
+    return selectGlobalValue(I, MRI);
+  case G_ANYEXT:
+  case G_ZEXT:
+  case G_SEXT:
+  case G_TRUNC:
+    return selectNarrowExtOrTrunc(I, MRI);
+  case G_CONSTANT: {
+    // Integer constants are selected by the imported patterns; this is a
+    // pointer constant.
+    const ConstantInt *CI = I.getOperand(1).getCImm();
+    I.getOperand(1).ChangeToImmediate(CI->getSExtValue());
+    I.setDesc(
+        TII.get(IsDef64() ? WebAssembly::CONST_I64 : WebAssembly::CONST_I32));
+    return constrainSelectedInstRegOperands(I, TII, TRI, RBI);
+  }
+  case G_FRAME_INDEX:
+    // The frame index is replaced by the stack pointer plus an offset when
+    // frame indices are eliminated.
+    I.setDesc(
+        TII.get(IsDef64() ? WebAssembly::COPY_I64 : WebAssembly::COPY_I32));
+    return constrainSelectedInstRegOperands(I, TII, TRI, RBI);
+  case G_GEP:
+    I.setDesc(
+        TII.get(IsDef64() ? WebAssembly::ADD_I64 : WebAssembly::ADD_I32));
+    return constrainSelectedInstRegOperands(I, TII, TRI, RBI);
+  case G_SELECT: {
+    // Selects of pointers; other types are selected by the imported patterns.
+    // The condition comes last in WebAssembly.
+    unsigned Opc = IsDef64() ? WebAssembly::SELECT_I64 : WebAssembly::SELECT_I32;
+    auto MIB = BuildMI(MBB, I, I.getDebugLoc(), TII.get(Opc))
+                   .add(I.getOperand(0))
+                   .add(I.getOperand(2))
+                   .add(I.getOperand(3))
+                   .add(I.getOperand(1));
+    I.eraseFromParent();
+    return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+  }
+  case G_BRCOND: {
+    auto MIB = BuildMI(MBB, I, I.getDebugLoc(), TII.get(WebAssembly::BR_IF))
+                   .add(I.getOperand(1))
+                   .add(I.getOperand(0));
+    I.eraseFromParent();
+    return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+  }
+  default:
+    return false;
+  }
+}
+
+namespace llvm {
+InstructionSelector *
+createWebAssemblyInstructionSelector(const WebAssemblyTargetMachine &TM,
+                                     WebAssemblySubtarget &Subtarget,
+                                     WebAssemblyRegisterBankInfo &RBI) {
+  return new WebAssemblyInstructionSelector(TM, Subtarget, RBI);
+}
+} // end namespace llvm
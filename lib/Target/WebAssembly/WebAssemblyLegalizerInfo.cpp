@@ -0,0 +1,155 @@
+//===- WebAssemblyLegalizerInfo.cpp - Legalizer rules for GlobalISel ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements the targeting of the MachineLegalizer class for
+/// WebAssembly. Only scalar i32, i64, f32 and f64 values and pointers are
+/// legal, apart from i8 and i16 values being extended or truncated. Narrower
+/// integers are widened where the rules below say so; operations on anything
+/// else make the legalizer fail, and the function falls back to SelectionDAG
+/// when fallback is enabled.
+///
+//===----------------------------------------------------------------------===//
+
+#include "WebAssemblyLegalizerInfo.h"
+#include "WebAssemblySubtarget.h"
+#include "llvm/CodeGen/GlobalISel/LegalizerHelper.h"
+
+using namespace llvm;
+
+WebAssemblyLegalizerInfo::WebAssemblyLegalizerInfo(
+    const WebAssemblySubtarget &ST) {
+  using namespace TargetOpcode;
+
+  const LLT s8 = LLT::scalar(8);
+  const LLT s16 = LLT::scalar(16);
+  const LLT s32 = LLT::scalar(32);
+  const LLT s64 = LLT::scalar(64);
+  const unsigned PtrSize = ST.hasAddr64() ? 64 : 32;
+  const LLT p0 = LLT::pointer(0, PtrSize);
+  const LLT sPtr = LLT::scalar(PtrSize);
+
+  getActionDefinitionsBuilder({G_ADD, G_SUB, G_MUL, G_AND, G_OR, G_XOR, G_SDIV,
+                               G_UDIV, G_SREM, G_UREM})
+      .legalFor({s32, s64})
+      .widenScalarToNextPow2(0)
+      .clampScalar(0, s32, s64);
+
+  getActionDefinitionsBuilder({G_SHL, G_LSHR, G_ASHR})
+      .legalFor({{s32, s32}, {s64, s64}})
+      .widenScalarToNextPow2(0)
+      .clampScalar(0, s32, s64)
+      .minScalarSameAs(1, 0);
+
+  getActionDefinitionsBuilder({G_CTLZ, G_CTTZ, G_CTPOP})
+      .legalFor({{s32, s32}, {s64, s64}});
+
+  getActionDefinitionsBuilder({G_CONSTANT, G_IMPLICIT_DEF})
+      .legalFor({s32, s64, p0})
+      .widenScalarToNextPow2(0)
+      .clampScalar(0, s32, s64);
+
+  getActionDefinitionsBuilder(G_FCONSTANT)
+      .legalFor({s32, s64});
+
+  // Extensions and truncations of narrow values are normally combined away as
+  // legalization artifacts. The ones that remain, such as the extension of an
+  // i8 or i16 operation that is only widened afterwards, operate on the i32
+  // register holding the narrow value.
+  getActionDefinitionsBuilder({G_SEXT, G_ZEXT, G_ANYEXT})
+      .legalFor({{s64, s32}})
+      .legalForCartesianProduct({s32}, {s8, s16})
+      .widenScalarToNextPow2(0)
+      .clampScalar(0, s32, s64);
+
+  getActionDefinitionsBuilder(G_TRUNC)
+      .legalFor({{s32, s64}})
+      .legalForCartesianProduct({s8, s16}, {s32, s64});
+
+  getActionDefinitionsBuilder({G_LOAD, G_STORE})
+      .legalForTypesWithMemDesc({{s32, p0, 8, 8},
+                                 {s32, p0, 16, 8},
+                                 {s32, p0, 32, 8},
+                                 {s64, p0, 8, 8},
+                                 {s64, p0, 16, 8},
+                                 {s64, p0, 32, 8},
+                                 {s64, p0, 64, 8},
+                                 {p0, p0, PtrSize, 8}})
+      .clampScalar(0, s32, s64);
+
+  getActionDefinitionsBuilder({G_SEXTLOAD, G_ZEXTLOAD})
+      .legalForTypesWithMemDesc({{s32, p0, 8, 8},
+                                 {s32, p0, 16, 8},
+                                 {s64, p0, 8, 8},
+                                 {s64, p0, 16, 8},
+                                 {s64, p0, 32, 8}})
+      .clampScalar(0, s32, s64);
+
+  getActionDefinitionsBuilder(G_ICMP)
+      .legalForCartesianProduct({s32}, {s32, s64, p0})
+      .clampScalar(0, s32, s32)
+      .widenScalarToNextPow2(1)
+      .clampScalar(1, s32, s64);
+
+  getActionDefinitionsBuilder(G_FCMP)
+      .legalForCartesianProduct({s32}, {s32, s64})
+      .clampScalar(0, s32, s32);
+
+  getActionDefinitionsBuilder(G_BRCOND)
+      .legalFor({s32})
+      .minScalar(0, s32);
+
+  getActionDefinitionsBuilder(G_SELECT)
+      .legalForCartesianProduct({s32, s64, p0}, {s32})
+      .widenScalarToNextPow2(0)
+      .clampScalar(0, s32, s64)
+      .clampScalar(1, s32, s32);
+
+  getActionDefinitionsBuilder(G_PHI)
+      .legalFor({s32, s64, p0})
+      .widenScalarToNextPow2(0)
+      .clampScalar(0, s32, s64);
+
+  getActionDefinitionsBuilder(G_GEP)
+      .legalFor({{p0, sPtr}})
+      .clampScalar(1, sPtr, sPtr);
+
+  getActionDefinitionsBuilder({G_FRAME_INDEX, G_GLOBAL_VALUE})
+      .legalFor({p0});
+
+  getActionDefinitionsBuilder(G_PTRTOINT)
+      .legalFor({{sPtr, p0}});
+
+  getActionDefinitionsBuilder(G_INTTOPTR)
+      .legalFor({{p0, sPtr}});
+
+  getActionDefinitionsBuilder({G_FADD, G_FSUB, G_FMUL, G_FDIV, G_FNEG, G_FABS,
+                               G_FSQRT, G_FCEIL, G_FFLOOR})
+      .legalFor({s32, s64});
+
+  getActionDefinitionsBuilder(G_FPEXT)
+      .legalFor({{s64, s32}});
+
+  getActionDefinitionsBuilder(G_FPTRUNC)
+      .legalFor({{s32, s64}});
+
+  getActionDefinitionsBuilder({G_SITOFP, G_UITOFP})
+      .legalForCartesianProduct({s32, s64}, {s32, s64})
+      .widenScalarToNextPow2(1)
+      .clampScalar(1, s32, s64);
+
+  // Without the saturating conversions, float to int conversions are selected
+  // to pseudo instructions that need a custom inserter, which GlobalISel does
+  // not run. Leave them to SelectionDAG.
+  if (ST.hasNontrappingFPToInt())
+    getActionDefinitionsBuilder({G_FPTOSI, G_FPTOUI})
+        .legalForCartesianProduct({s32, s64}, {s32, s64});
+
+  computeTables();
+  verify(*ST.getInstrInfo());
+}
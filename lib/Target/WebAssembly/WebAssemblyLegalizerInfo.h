@@ -0,0 +1,32 @@
+//===- WebAssemblyLegalizerInfo.h - Legalizer rules for GlobalISel -*- C++ -*-//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file declares the targeting of the MachineLegalizer class for
+/// WebAssembly.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_WEBASSEMBLY_WEBASSEMBLYLEGALIZERINFO_H
+#define LLVM_LIB_TARGET_WEBASSEMBLY_WEBASSEMBLYLEGALIZERINFO_H
+
+#include "llvm/CodeGen/GlobalISel/LegalizerInfo.h"
+
+namespace llvm {
+
+class WebAssemblySubtarget;
+
+/// This class provides the legalization rules for WebAssembly.
+class WebAssemblyLegalizerInfo : public LegalizerInfo {
+public:
+  WebAssemblyLegalizerInfo(const WebAssemblySubtarget &ST);
+};
+
+} // end namespace llvm
+
+#endif
@@ -0,0 +1,214 @@
+//===- WebAssemblyRegisterBankInfo.cpp - Register banks for GlobalISel ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements the targeting of the RegisterBankInfo class for
+/// WebAssembly. Integer and pointer values are assigned to the Int bank and
+/// floating point values to the Float bank. Operations that merely move bits
+/// around, such as loads and stores, follow the values they produce or
+/// consume, so that no reinterpretations between the banks are needed.
+///
+//===----------------------------------------------------------------------===//
+
+#include "WebAssemblyRegisterBankInfo.h"
+#include "MCTargetDesc/WebAssemblyMCTargetDesc.h"
+#include "llvm/CodeGen/GlobalISel/RegisterBank.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/TargetRegisterInfo.h"
+
+#define GET_TARGET_REGBANK_IMPL
+#include "WebAssemblyGenRegisterBank.inc"
+
+using namespace llvm;
+
+namespace llvm {
+namespace WebAssembly {
+enum PartialMappingIdx {
+  PMI_I32,
+  PMI_I64,
+  PMI_F32,
+  PMI_F64,
+};
+
+RegisterBankInfo::PartialMapping PartMappings[]{
+    {0, 32, IntRegBank},
+    {0, 64, IntRegBank},
+    {0, 32, FloatRegBank},
+    {0, 64, FloatRegBank},
+};
+
+RegisterBankInfo::ValueMapping ValueMappings[] = {
+    {&PartMappings[PMI_I32], 1},
+    {&PartMappings[PMI_I64], 1},
+    {&PartMappings[PMI_F32], 1},
+    {&PartMappings[PMI_F64], 1},
+};
+} // end namespace WebAssembly
+} // end namespace llvm
+
+WebAssemblyRegisterBankInfo::WebAssemblyRegisterBankInfo(
+    const TargetRegisterInfo &TRI)
+    : WebAssemblyGenRegisterBankInfo() {}
+
+const RegisterBank &WebAssemblyRegisterBankInfo::getRegBankFromRegClass(
+    const TargetRegisterClass &RC) const {
+  switch (RC.getID()) {
+  case WebAssembly::I32RegClassID:
+  case WebAssembly::I64RegClassID:
+    return getRegBank(WebAssembly::IntRegBankID);
+  case WebAssembly::F32RegClassID:
+  case WebAssembly::F64RegClassID:
+    return getRegBank(WebAssembly::FloatRegBankID);
+  default:
+    llvm_unreachable("Unsupported register class");
+  }
+}
+
+/// Whether \p Opc computes a floating point value from floating point
+/// operands.
+static bool isFloatingPointArithmetic(unsigned Opc) {
+  switch (Opc) {
+  case TargetOpcode::G_FADD:
+  case TargetOpcode::G_FSUB:
+  case TargetOpcode::G_FMUL:
+  case TargetOpcode::G_FDIV:
+  case TargetOpcode::G_FNEG:
+  case TargetOpcode::G_FABS:
+  case TargetOpcode::G_FSQRT:
+  case TargetOpcode::G_FCEIL:
+  case TargetOpcode::G_FFLOOR:
+  case TargetOpcode::G_FPEXT:
+  case TargetOpcode::G_FPTRUNC:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool WebAssemblyRegisterBankInfo::isFloatingPointDef(
+    Register Reg, const MachineRegisterInfo &MRI,
+    const TargetRegisterInfo &TRI) const {
+  if (const RegisterBank *RB = getRegBank(Reg, MRI, TRI))
+    return RB->getID() == WebAssembly::FloatRegBankID;
+  const MachineInstr *Def = MRI.getVRegDef(Reg);
+  if (!Def)
+    return false;
+  unsigned Opc = Def->getOpcode();
+  return isFloatingPointArithmetic(Opc) || Opc == TargetOpcode::G_FCONSTANT ||
+         Opc == TargetOpcode::G_SITOFP || Opc == TargetOpcode::G_UITOFP;
+}
+
+bool WebAssemblyRegisterBankInfo::hasOnlyFloatingPointUses(
+    Register Reg, const MachineRegisterInfo &MRI) const {
+  bool HasUses = false;
+  for (const MachineInstr &UseMI : MRI.use_nodbg_instructions(Reg)) {
+    unsigned Opc = UseMI.getOpcode();
+    if (!isFloatingPointArithmetic(Opc) && Opc != TargetOpcode::G_FCMP &&
+        Opc != TargetOpcode::G_FPTOSI && Opc != TargetOpcode::G_FPTOUI)
+      return false;
+    HasUses = true;
+  }
+  return HasUses;
+}
+
+const RegisterBankInfo::InstructionMapping &
+WebAssemblyRegisterBankInfo::getInstrMapping(const MachineInstr &MI) const {
+  unsigned Opc = MI.getOpcode();
+
+  // Try the default logic for non-generic instructions that are either copies
+  // or already have some operands assigned to banks.
+  if (!isPreISelGenericOpcode(Opc) || Opc == TargetOpcode::G_PHI) {
+    const InstructionMapping &Mapping = getInstrMappingImpl(MI);
+    if (Mapping.isValid())
+      return Mapping;
+  }
+
+  using namespace TargetOpcode;
+
+  const MachineFunction &MF = *MI.getParent()->getParent();
+  const MachineRegisterInfo &MRI = MF.getRegInfo();
+  const TargetRegisterInfo &TRI = *MF.getSubtarget().getRegisterInfo();
+  unsigned NumOperands = MI.getNumOperands();
+
+  // Which register operands hold floating point values; everything else,
+  // including pointers and condition values, lives in the Int bank.
+  SmallVector<bool, 4> IsFloat(NumOperands, false);
+  switch (Opc) {
+  case G_FADD:
+  case G_FSUB:
+  case G_FMUL:
+  case G_FDIV:
+  case G_FNEG:
+  case G_FABS:
+  case G_FSQRT:
+  case G_FCEIL:
+  case G_FFLOOR:
+  case G_FPEXT:
+  case G_FPTRUNC:
+  case G_FCONSTANT:
+    IsFloat.assign(NumOperands, true);
+    break;
+  case G_FPTOSI:
+  case G_FPTOUI:
+    IsFloat[1] = true;
+    break;
+  case G_SITOFP:
+  case G_UITOFP:
+    IsFloat[0] = true;
+    break;
+  case G_FCMP:
+    IsFloat[2] = IsFloat[3] = true;
+    break;
+  case G_LOAD:
+    IsFloat[0] = hasOnlyFloatingPointUses(MI.getOperand(0).getReg(), MRI);
+    break;
+  case G_STORE:
+    IsFloat[0] = isFloatingPointDef(MI.getOperand(0).getReg(), MRI, TRI);
+    break;
+  case G_SELECT:
+    IsFloat[0] = IsFloat[2] = IsFloat[3] =
+        isFloatingPointDef(MI.getOperand(2).getReg(), MRI, TRI) &&
+        isFloatingPointDef(MI.getOperand(3).getReg(), MRI, TRI);
+    break;
+  case G_PHI: {
+    bool AnyFloat = false;
+    for (unsigned Idx = 1; Idx < NumOperands; Idx += 2)
+      AnyFloat |= isFloatingPointDef(MI.getOperand(Idx).getReg(), MRI, TRI);
+    IsFloat.assign(NumOperands, AnyFloat);
+    break;
+  }
+  default:
+    break;
+  }
+
+  SmallVector<const ValueMapping *, 4> OperandsMapping(NumOperands);
+  for (unsigned Idx = 0; Idx != NumOperands; ++Idx) {
+    const MachineOperand &MO = MI.getOperand(Idx);
+    if (!MO.isReg() || !MO.getReg())
+      continue;
+    LLT Ty = MRI.getType(MO.getReg());
+    if (!Ty.isValid() || Ty.isVector())
+      return getInvalidInstructionMapping();
+    unsigned Size = Ty.getSizeInBits();
+    // Narrow integers, which are only extended or truncated, live in i32
+    // registers.
+    if (Size < 32 && !IsFloat[Idx])
+      Size = 32;
+    if (Size != 32 && Size != 64)
+      return getInvalidInstructionMapping();
+    unsigned PMI = IsFloat[Idx] ? (Size == 32 ? WebAssembly::PMI_F32
+                                              : WebAssembly::PMI_F64)
+                                : (Size == 32 ? WebAssembly::PMI_I32
+                                              : WebAssembly::PMI_I64);
+    OperandsMapping[Idx] = &WebAssembly::ValueMappings[PMI];
+  }
+
+  return getInstructionMapping(DefaultMappingID, /*Cost=*/1,
+                               getOperandsMapping(OperandsMapping),
+                               NumOperands);
+}
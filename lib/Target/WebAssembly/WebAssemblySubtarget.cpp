@@ -14,7 +14,12 @@
 
 #include "WebAssemblySubtarget.h"
 #include "MCTargetDesc/WebAssemblyMCTargetDesc.h"
+#include "WebAssembly.h"
+#include "WebAssemblyCallLowering.h"
 #include "WebAssemblyInstrInfo.h"
+#include "WebAssemblyLegalizerInfo.h"
+#include "WebAssemblyRegisterBankInfo.h"
+#include "WebAssemblyTargetMachine.h"
 #include "llvm/Support/TargetRegistry.h"
 using namespace llvm;
 
@@ -42,7 +47,15 @@ WebAssemblySubtarget::WebAssemblySubtarget(const Triple &TT,
     : WebAssemblyGenSubtargetInfo(TT, CPU, FS), CPUString(CPU),
       TargetTriple(TT), FrameLowering(),
       InstrInfo(initializeSubtargetDependencies(FS)), TSInfo(),
-      TLInfo(TM, *this) {}
+      TLInfo(TM, *this) {
+  CallLoweringInfo.reset(new WebAssemblyCallLowering(*getTargetLowering()));
+  Legalizer.reset(new WebAssemblyLegalizerInfo(*this));
+
+  auto *RBI = new WebAssemblyRegisterBankInfo(*getRegisterInfo());
+  RegBankInfo.reset(RBI);
+  InstSelector.reset(createWebAssemblyInstructionSelector(
+      *static_cast<const WebAssemblyTargetMachine *>(&TM), *this, *RBI));
+}
 
 bool WebAssemblySubtarget::enableAtomicExpand() const {
   // If atomics are disabled, atomic ops are lowered instead of expanded
@@ -57,3 +70,20 @@ bool WebAssemblySubtarget::enableMachineScheduler() const {
 }
 
 bool WebAssemblySubtarget::useAA() const { return true; }
+
+const CallLowering *WebAssemblySubtarget::getCallLowering() const {
+  return CallLoweringInfo.get();
+}
+
+const LegalizerInfo *WebAssemblySubtarget::getLegalizerInfo() const {
+  return Legalizer.get();
+}
+
+const RegisterBankInfo *WebAssemblySubtarget::getRegBankInfo() const {
+  return RegBankInfo.get();
+}
+
+const InstructionSelector *
+WebAssemblySubtarget::getInstructionSelector() const {
+  return InstSelector.get();
+}
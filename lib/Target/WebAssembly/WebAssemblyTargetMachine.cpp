@@ -18,6 +18,10 @@
 #include "WebAssemblyMachineFunctionInfo.h"
 #include "WebAssemblyTargetObjectFile.h"
 #include "WebAssemblyTargetTransformInfo.h"
+#include "llvm/CodeGen/GlobalISel/IRTranslator.h"
+#include "llvm/CodeGen/GlobalISel/InstructionSelect.h"
+#include "llvm/CodeGen/GlobalISel/Legalizer.h"
+#include "llvm/CodeGen/GlobalISel/RegBankSelect.h"
 #include "llvm/CodeGen/MIRParser/MIParser.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/Passes.h"
@@ -26,6 +30,7 @@
 #include "llvm/IR/Function.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Target/TargetOptions.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Scalar/LowerAtomic.h"
 #include "llvm/Transforms/Utils.h"
@@ -54,6 +59,7 @@ extern "C" void LLVMInitializeWebAssemblyTarget() {
 
   // Register backend passes
   auto &PR = *PassRegistry::getPassRegistry();
+  initializeGlobalISel(PR);
   initializeWebAssemblyAddMissingPrototypesPass(PR);
   initializeWebAssemblyLowerEmscriptenEHSjLjPass(PR);
   initializeLowerGlobalDtorsPass(PR);
@@ -307,6 +313,10 @@ public:
 
   void addIRPasses() override;
   bool addInstSelector() override;
+  bool addIRTranslator() override;
+  bool addLegalizeMachineIR() override;
+  bool addRegBankSelect() override;
+  bool addGlobalInstructionSelect() override;
   void addPostRegAlloc() override;
   bool addGCPasses() override { return false; }
   void addPreEmitPass() override;
@@ -324,6 +334,25 @@ WebAssemblyTargetMachine::getTargetTransformInfo(const Function &F) {
   return TargetTransformInfo(WebAssemblyTTIImpl(this, F));
 }
 
+void WebAssemblyTargetMachine::adjustPassManager(PassManagerBuilder &Builder) {
+  // Failure paths (failed assertions and the code building their messages)
+  // are common and rarely executed in WebAssembly code. Moving them out of
+  // line keeps hot functions small, which helps engines that compile
+  // functions in tiers. At -Oz the extra calls aren't worth it.
+  if (Builder.OptLevel >= 2 && Builder.SizeLevel < 2)
+    Builder.HotColdSplitting = true;
+
+  // Loops over byte buffers often can't be proven not to alias. Versioning
+  // small loops behind a runtime check lets invariant accesses be hoisted and
+  // the loop be vectorized. This duplicates the loop, so skip it when
+  // optimizing for size, and only version loops of up to 64 instructions to
+  // keep the growth of the module in check.
+  if (Builder.OptLevel >= 2 && Builder.SizeLevel == 0) {
+    Builder.LoopVersioningLICM = true;
+    Builder.LoopVersioningLICMMaxBodySize = 64;
+  }
+}
+
 TargetPassConfig *
 WebAssemblyTargetMachine::createPassConfig(PassManagerBase &PM) {
   return new WebAssemblyPassConfig(*this, PM);
@@ -385,8 +414,11 @@ void WebAssemblyPassConfig::addIRPasses() {
 
 bool WebAssemblyPassConfig::addInstSelector() {
   (void)TargetPassConfig::addInstSelector();
+  // When falling back from GlobalISel, the ARGUMENT instructions may be out of
+  // place until the argument-move pass has run, so don't verify in between.
   addPass(
-      createWebAssemblyISelDag(getWebAssemblyTargetMachine(), getOptLevel()));
+      createWebAssemblyISelDag(getWebAssemblyTargetMachine(), getOptLevel()),
+      /*verifyAfter=*/!TM->Options.EnableGlobalISel);
   // Run the argument-move pass immediately after the ScheduleDAG scheduler
   // so that we can fix up the ARGUMENT instructions before anything else
   // sees them in the wrong place.
@@ -398,6 +430,32 @@ bool WebAssemblyPassConfig::addInstSelector() {
   return false;
 }
 
+bool WebAssemblyPassConfig::addIRTranslator() {
+  addPass(new IRTranslator());
+  return false;
+}
+
+bool WebAssemblyPassConfig::addLegalizeMachineIR() {
+  addPass(new Legalizer());
+  return false;
+}
+
+bool WebAssemblyPassConfig::addRegBankSelect() {
+  addPass(new RegBankSelect());
+  return false;
+}
+
+bool WebAssemblyPassConfig::addGlobalInstructionSelect() {
+  addPass(new InstructionSelect());
+  // When GlobalISel may fall back to SelectionDAG, these passes are added by
+  // addInstSelector and run on every function.
+  if (isGlobalISelAbortEnabled()) {
+    addPass(createWebAssemblyArgumentMove());
+    addPass(createWebAssemblySetP2AlignOperands());
+  }
+  return false;
+}
+
 void WebAssemblyPassConfig::addPostRegAlloc() {
   // TODO: The following CodeGen passes don't currently support code containing
   // virtual registers. Consider removing their restrictions and re-enabling
@@ -411,7 +469,6 @@ void WebAssemblyPassConfig::addPostRegAlloc() {
   disablePass(&StackMapLivenessID);
   disablePass(&LiveDebugValuesID);
   disablePass(&PatchableFunctionID);
-  disablePass(&ShrinkWrapID);
 
   // This pass hurts code size for wasm because it can generate irreducible
   // control flow.
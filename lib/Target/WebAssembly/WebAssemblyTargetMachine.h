@@ -47,6 +47,8 @@ public:
 
   TargetTransformInfo getTargetTransformInfo(const Function &F) override;
 
+  void adjustPassManager(PassManagerBuilder &Builder) override;
+
   bool usesPhysRegsForPEI() const override { return false; }
 
   yaml::MachineFunctionInfo *createDefaultFuncInfoYAML() const override;
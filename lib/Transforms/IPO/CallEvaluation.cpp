@@ -0,0 +1,189 @@
+//===- CallEvaluation.cpp - Evaluate calls at compile time ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass evaluates calls to side-effect free functions whose arguments are
+// all constants at compile time, and replaces them with their result. Typical
+// candidates are string-to-integer encoders or hash functions applied to
+// literals that were not evaluated by the frontend.
+//
+// The evaluation is done by the Evaluator used by GlobalOpt for static
+// constructors, with two differences: loops are allowed within a per-call
+// budget of evaluated instructions, and only constant global variables may be
+// read, since the call may execute at any time.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/CallEvaluation.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Utils/Evaluator.h"
+#include <map>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "call-evaluation"
+
+STATISTIC(NumCallsEvaluated, "Number of calls replaced by their result");
+
+static cl::opt<unsigned> MaxEvaluationSteps(
+    "call-evaluation-max-steps", cl::Hidden, cl::init(10000),
+    cl::desc("The maximum number of instructions evaluated per call"));
+
+/// Whether \p CI is a call that may be replaced by its result if it can be
+/// evaluated: a call to a known, side-effect free function with only constant
+/// arguments whose result is used.
+static bool isCandidate(const CallInst &CI) {
+  const Function *F = CI.getCalledFunction();
+  if (!F || F->isDeclaration() || F->isInterposable() || F->isVarArg() ||
+      !F->onlyReadsMemory() || CI.getType()->isVoidTy() || CI.use_empty())
+    return false;
+  for (const Value *Arg : CI.arg_operands())
+    if (!isa<Constant>(Arg))
+      return false;
+  return true;
+}
+
+/// Whether \p Ptr points into memory that belongs to the evaluation itself,
+/// i.e. into the temporaries the Evaluator creates for allocas. These are
+/// global variables that are not part of any module.
+static bool isEvaluationTemporary(Constant *Ptr) {
+  while (auto *CE = dyn_cast<ConstantExpr>(Ptr))
+    if (CE->getOpcode() == Instruction::GetElementPtr ||
+        CE->getOpcode() == Instruction::BitCast)
+      Ptr = CE->getOperand(0);
+    else
+      break;
+  auto *GV = dyn_cast<GlobalVariable>(Ptr);
+  return GV && !GV->getParent();
+}
+
+/// Evaluate a call to \p F with the constant arguments \p Args. Returns the
+/// result or null if the call can't be evaluated.
+static Constant *evaluateCall(Function *F,
+                              const SmallVectorImpl<Constant *> &Args,
+                              const DataLayout &DL,
+                              const TargetLibraryInfo *TLI) {
+  Evaluator Eval(DL, TLI);
+  Eval.setStepBudget(MaxEvaluationSteps);
+  Eval.setOnlyReadConstantGlobals(true);
+
+  Constant *RetVal = nullptr;
+  if (!Eval.EvaluateFunction(F, RetVal, Args) || !RetVal)
+    return nullptr;
+
+  // The function only reads memory, but be conservative about anything the
+  // evaluation believes was written outside of its own stack.
+  for (auto &Mutated : Eval.getMutatedMemory())
+    if (!isEvaluationTemporary(Mutated.first))
+      return nullptr;
+
+  // Pointers into the evaluation's stack don't survive it; only accept plain
+  // data.
+  if (!isa<ConstantData>(RetVal))
+    return nullptr;
+  return RetVal;
+}
+
+static bool evaluateCalls(Module &M, const TargetLibraryInfo *TLI) {
+  const DataLayout &DL = M.getDataLayout();
+  // Results of earlier evaluations, keyed by the callee followed by the
+  // arguments. Failures are recorded as null.
+  std::map<SmallVector<Constant *, 8>, Constant *> Cache;
+
+  bool Changed = false;
+  for (Function &F : M) {
+    SmallVector<CallInst *, 16> Calls;
+    for (Instruction &I : instructions(F))
+      if (auto *CI = dyn_cast<CallInst>(&I))
+        if (isCandidate(*CI))
+          Calls.push_back(CI);
+
+    // Calls may be appended while iterating, when replacing a call makes the
+    // arguments of another one constant.
+    for (unsigned Idx = 0; Idx != Calls.size(); ++Idx) {
+      CallInst *CI = Calls[Idx];
+
+      Function *Callee = CI->getCalledFunction();
+      SmallVector<Constant *, 8> Key;
+      Key.push_back(Callee);
+      for (Value *Arg : CI->arg_operands())
+        Key.push_back(cast<Constant>(Arg));
+
+      auto It = Cache.find(Key);
+      if (It == Cache.end()) {
+        SmallVector<Constant *, 8> Args(std::next(Key.begin()), Key.end());
+        It = Cache.emplace(Key, evaluateCall(Callee, Args, DL, TLI)).first;
+      }
+      Constant *Result = It->second;
+      if (!Result)
+        continue;
+
+      LLVM_DEBUG(dbgs() << "CallEval: " << *CI << " in " << F.getName()
+                        << " evaluates to " << *Result << "\n");
+      SmallVector<User *, 4> Users(CI->user_begin(), CI->user_end());
+      CI->replaceAllUsesWith(Result);
+      CI->eraseFromParent();
+      for (User *U : Users)
+        if (auto *UserCI = dyn_cast<CallInst>(U))
+          if (isCandidate(*UserCI) && !is_contained(Calls, UserCI))
+            Calls.push_back(UserCI);
+      ++NumCallsEvaluated;
+      Changed = true;
+    }
+  }
+  return Changed;
+}
+
+PreservedAnalyses CallEvaluationPass::run(Module &M,
+                                          ModuleAnalysisManager &AM) {
+  auto &TLI = AM.getResult<TargetLibraryAnalysis>(M);
+  if (!evaluateCalls(M, &TLI))
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
+}
+
+namespace {
+class CallEvaluationLegacyPass : public ModulePass {
+public:
+  static char ID;
+
+  CallEvaluationLegacyPass() : ModulePass(ID) {
+    initializeCallEvaluationLegacyPassPass(*PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
+    auto *TLI = &getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
+    return evaluateCalls(M, TLI);
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<TargetLibraryInfoWrapperPass>();
+  }
+};
+} // end anonymous namespace
+
+char CallEvaluationLegacyPass::ID = 0;
+INITIALIZE_PASS_BEGIN(CallEvaluationLegacyPass, "call-evaluation",
+                      "Evaluate calls with constant arguments", false, false)
+INITIALIZE_PASS_DEPENDENCY(TargetLibraryInfoWrapperPass)
+INITIALIZE_PASS_END(CallEvaluationLegacyPass, "call-evaluation",
+                    "Evaluate calls with constant arguments", false, false)
+
+ModulePass *llvm::createCallEvaluationPass() {
+  return new CallEvaluationLegacyPass();
+}
@@ -0,0 +1,225 @@
+//===- CalledValuePromotion.cpp - Promote statically known callees --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a transformation that promotes indirect call sites with
+// a small, statically known set of possible targets into chains of
+// compare-and-direct-call sequences. The targets are taken from !callees
+// metadata (as attached by CalledValuePropagation) or, for calls through a
+// load from a constant table of function pointers, from the table's
+// initializer. Unlike PGO-driven indirect call promotion, no profile data is
+// required. Promoted call sites become candidates for inlining.
+//
+// When the set of targets is exhaustive (calling anything else is undefined
+// behavior), the last target in the chain is called unconditionally and the
+// original indirect call disappears entirely. Otherwise the indirect call is
+// kept as the fallback at the end of the chain.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/CalledValuePromotion.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Utils/CallPromotionUtils.h"
+using namespace llvm;
+
+#define DEBUG_TYPE "called-value-promotion"
+
+STATISTIC(NumPromotedCallSites, "Number of indirect call sites promoted");
+STATISTIC(NumPromotedTargets, "Number of direct calls created by promotion");
+STATISTIC(NumTableCallSites,
+          "Number of call sites whose targets came from a constant table");
+
+/// The maximum number of targets an indirect call site may have for it to be
+/// promoted. Each target except the last one costs a compare and a branch, so
+/// this should be kept small.
+static cl::opt<unsigned> MaxPromotedTargets(
+    "cvpromote-max-targets", cl::Hidden, cl::init(4),
+    cl::desc("The maximum number of targets to promote per call site"));
+
+/// Whether to derive targets from constant function-pointer tables for call
+/// sites that do not carry !callees metadata.
+static cl::opt<bool> PromoteFromTables(
+    "cvpromote-tables", cl::Hidden, cl::init(true),
+    cl::desc("Promote calls through loads from constant function tables"));
+
+/// Collect the functions stored in the constant \p C into \p Targets. Any
+/// member that is not a function, such as a null pointer or an integer that may
+/// be loaded and converted to a function pointer, clears \p Exhaustive. A
+/// pointer to anything else makes the table opaque, and false is returned.
+static bool collectTableTargets(Constant *C,
+                                SmallSetVector<Function *, 4> &Targets,
+                                bool &Exhaustive) {
+  if (isa<ConstantPointerNull>(C) || isa<UndefValue>(C) ||
+      isa<ConstantAggregateZero>(C)) {
+    Exhaustive = false;
+    return true;
+  }
+  if (C->getType()->isPointerTy()) {
+    auto *F = dyn_cast<Function>(C->stripPointerCasts());
+    if (!F)
+      return false;
+    Targets.insert(F);
+    return Targets.size() <= MaxPromotedTargets;
+  }
+  if (isa<ConstantAggregate>(C)) {
+    for (Use &Op : C->operands())
+      if (!collectTableTargets(cast<Constant>(Op), Targets, Exhaustive))
+        return false;
+    return true;
+  }
+  // Scalars and ConstantDataSequential (which never holds pointers).
+  Exhaustive = false;
+  return !isa<ConstantExpr>(C);
+}
+
+/// Compute the possible targets of the indirect call site \p CS. Returns false
+/// if they are unknown or too many. \p Exhaustive is set if calling anything
+/// else is undefined behavior.
+static bool getPossibleTargets(CallSite CS, const DataLayout &DL,
+                               SmallVectorImpl<Function *> &Targets,
+                               bool &Exhaustive) {
+  SmallSetVector<Function *, 4> Set;
+  Exhaustive = true;
+  if (MDNode *Callees =
+          CS.getInstruction()->getMetadata(LLVMContext::MD_callees)) {
+    for (const MDOperand &Op : Callees->operands())
+      if (auto *F = mdconst::extract_or_null<Function>(Op))
+        Set.insert(F);
+  } else if (PromoteFromTables) {
+    auto *LI = dyn_cast<LoadInst>(CS.getCalledValue()->stripPointerCasts());
+    if (!LI || !LI->isSimple())
+      return false;
+    auto *GV = dyn_cast<GlobalVariable>(
+        GetUnderlyingObject(LI->getPointerOperand(), DL));
+    if (!GV || !GV->isConstant() || !GV->hasDefinitiveInitializer())
+      return false;
+    if (!collectTableTargets(GV->getInitializer(), Set, Exhaustive))
+      return false;
+    ++NumTableCallSites;
+  }
+
+  if (Set.empty() || Set.size() > MaxPromotedTargets)
+    return false;
+  // Promote in the order of the !callees operands or table elements, which
+  // is deterministic and lets the frontend put the likely callees first.
+  Targets.append(Set.begin(), Set.end());
+  return true;
+}
+
+/// Promote the indirect call site \p CS to the given \p Targets, which are all
+/// of its possible callees if \p Exhaustive is set. Returns true if any
+/// promotion was performed.
+static bool promoteCallSite(CallSite CS, ArrayRef<Function *> Targets,
+                            bool Exhaustive) {
+  SmallVector<Function *, 4> Legal;
+  for (Function *F : Targets) {
+    const char *Reason = nullptr;
+    if (isLegalToPromote(CS, F, &Reason))
+      Legal.push_back(F);
+    else
+      LLVM_DEBUG(dbgs() << "CVPromote: cannot promote " << *CS.getInstruction()
+                        << " to " << F->getName() << ": " << Reason << "\n");
+  }
+  if (Legal.empty())
+    return false;
+
+  // If every possible target can be called directly, the last one needs no
+  // guard.
+  Exhaustive &= Legal.size() == Targets.size();
+  ArrayRef<Function *> Guarded = Legal;
+  if (Exhaustive)
+    Guarded = Guarded.drop_back();
+
+  for (Function *F : Guarded) {
+    Instruction *NewInst = promoteCallWithIfThenElse(CS, F);
+    NewInst->setMetadata(LLVMContext::MD_callees, nullptr);
+    ++NumPromotedTargets;
+  }
+  if (Exhaustive) {
+    Instruction *NewInst = promoteCall(CS, Legal.back());
+    NewInst->setMetadata(LLVMContext::MD_callees, nullptr);
+    ++NumPromotedTargets;
+  }
+  ++NumPromotedCallSites;
+  return true;
+}
+
+static bool runCalledValuePromotion(Module &M) {
+  const DataLayout &DL = M.getDataLayout();
+  bool Changed = false;
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+    // Collect the call sites first; promotion splits blocks.
+    struct CallSiteTargets {
+      CallSite CS;
+      SmallVector<Function *, 4> Targets;
+      bool Exhaustive;
+    };
+    SmallVector<CallSiteTargets, 8> Worklist;
+    for (Instruction &I : instructions(F)) {
+      CallSite CS(&I);
+      if (!CS || CS.getCalledFunction() || CS.isInlineAsm())
+        continue;
+      SmallVector<Function *, 4> Targets;
+      bool Exhaustive;
+      if (getPossibleTargets(CS, DL, Targets, Exhaustive))
+        Worklist.push_back({CS, std::move(Targets), Exhaustive});
+    }
+    for (CallSiteTargets &Entry : Worklist) {
+      LLVM_DEBUG(dbgs() << "CVPromote: promoting "
+                        << *Entry.CS.getInstruction() << " in " << F.getName()
+                        << " to " << Entry.Targets.size() << " target(s)\n");
+      Changed |= promoteCallSite(Entry.CS, Entry.Targets, Entry.Exhaustive);
+    }
+  }
+  return Changed;
+}
+
+PreservedAnalyses CalledValuePromotionPass::run(Module &M,
+                                                ModuleAnalysisManager &) {
+  if (!runCalledValuePromotion(M))
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
+}
+
+namespace {
+class CalledValuePromotionLegacyPass : public ModulePass {
+public:
+  static char ID;
+
+  CalledValuePromotionLegacyPass() : ModulePass(ID) {
+    initializeCalledValuePromotionLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
+    return runCalledValuePromotion(M);
+  }
+};
+} // namespace
+
+char CalledValuePromotionLegacyPass::ID = 0;
+INITIALIZE_PASS(CalledValuePromotionLegacyPass, "called-value-promotion",
+                "Called Value Promotion", false, false)
+
+ModulePass *llvm::createCalledValuePromotionPass() {
+  return new CalledValuePromotionLegacyPass();
+}
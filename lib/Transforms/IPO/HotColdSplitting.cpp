@@ -28,6 +28,7 @@
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/BranchProbabilityInfo.h"
@@ -84,6 +85,13 @@ static cl::opt<int>
                        cl::desc("Base penalty for splitting cold code (as a "
                                 "multiple of TCC_Basic)"));
 
+static cl::opt<std::string> AssertionFunctions(
+    "hotcoldsplit-assert-functions", cl::Hidden,
+    cl::init("abort,__assert_fail,eosio_assert,eosio_assert_message,"
+             "eosio_assert_code"),
+    cl::desc("Comma-separated list of functions that report a failed "
+             "assertion. Calls to them are considered cold"));
+
 namespace {
 
 /// A sequence of basic blocks.
@@ -106,17 +114,36 @@ bool blockEndsInUnreachable(const BasicBlock &BB) {
   return !(isa<ReturnInst>(I) || isa<IndirectBrInst>(I));
 }
 
-bool unlikelyExecuted(BasicBlock &BB) {
+/// Whether \p CS reports a failed assertion through one of the functions in
+/// \p AssertFns. Functions taking the asserted condition as an integer first
+/// argument (e.g. eosio_assert) only fail when it is known to be zero, as on
+/// the failure path of an inlined check().
+bool isFailedAssertion(CallSite CS, const StringSet<> &AssertFns) {
+  const Function *Callee = CS.getCalledFunction();
+  if (!Callee || !AssertFns.count(Callee->getName()))
+    return false;
+  if (CS.arg_empty() || !CS.getArgument(0)->getType()->isIntegerTy())
+    return true;
+  auto *Cond = dyn_cast<ConstantInt>(CS.getArgument(0));
+  return Cond && Cond->isZero();
+}
+
+bool unlikelyExecuted(BasicBlock &BB, const StringSet<> &AssertFns) {
   // Exception handling blocks are unlikely executed.
   if (BB.isEHPad() || isa<ResumeInst>(BB.getTerminator()))
     return true;
 
   // The block is cold if it calls/invokes a cold function. However, do not
-  // mark sanitizer traps as cold.
+  // mark sanitizer traps as cold. Failed assertions are cold as well; the
+  // code building their messages is usually only reachable from them, so it
+  // becomes part of the outlined region.
   for (Instruction &I : BB)
-    if (auto CS = CallSite(&I))
+    if (auto CS = CallSite(&I)) {
       if (CS.hasFnAttr(Attribute::Cold) && !CS->getMetadata("nosanitize"))
         return true;
+      if (isFailedAssertion(CS, AssertFns))
+        return true;
+    }
 
   // The block is cold if it has an unreachable terminator, unless it's
   // preceded by a call to a (possibly warm) noreturn call (e.g. longjmp).
@@ -192,6 +219,8 @@ private:
   function_ref<TargetTransformInfo &(Function &)> GetTTI;
   std::function<OptimizationRemarkEmitter &(Function &)> *GetORE;
   function_ref<AssumptionCache *(Function &)> LookupAC;
+  /// The functions named by -hotcoldsplit-assert-functions.
+  StringSet<> AssertFns;
 };
 
 class HotColdSplittingLegacyPass : public ModulePass {
@@ -597,7 +626,7 @@ bool HotColdSplitting::outlineColdRegions(Function &F, bool HasProfileSummary) {
       continue;
 
     bool Cold = (BFI && PSI->isColdBlock(BB, BFI)) ||
-                (EnableStaticAnalyis && unlikelyExecuted(*BB));
+                (EnableStaticAnalyis && unlikelyExecuted(*BB, AssertFns));
     if (!Cold)
       continue;
 
@@ -665,6 +694,11 @@ bool HotColdSplitting::outlineColdRegions(Function &F, bool HasProfileSummary) {
 bool HotColdSplitting::run(Module &M) {
   bool Changed = false;
   bool HasProfileSummary = (M.getProfileSummary(/* IsCS */ false) != nullptr);
+  SmallVector<StringRef, 8> AssertFnNames;
+  StringRef(AssertionFunctions)
+      .split(AssertFnNames, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  AssertFns.clear();
+  AssertFns.insert(AssertFnNames.begin(), AssertFnNames.end());
   for (auto It = M.begin(), End = M.end(); It != End; ++It) {
     Function &F = *It;
 
@@ -0,0 +1,475 @@
+//===- MergeSimilarFunctions.cpp - Merge similar functions ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass merges functions that are structurally identical but differ in a
+// small number of constant operands or direct callees, as is typical for C++
+// template instantiations. MergeFunctions only folds functions that are exactly
+// equivalent; this pass goes one step further by parametrizing the
+// differences.
+//
+// Candidates are bucketed by FunctionComparator::functionHash, which only
+// looks at the CFG shape and the opcode sequence and therefore ignores
+// constants and call targets. Within a bucket, each function is compared
+// against the leader of every group found so far. Two functions are similar if
+// their instructions pair up one to one, agree on everything but operands, and
+// every operand either corresponds (arguments, blocks and instructions at the
+// same position), is identical, or is a "parametrizable" difference: an
+// integer or floating-point constant in a position where any value is allowed,
+// or the callee of a direct call.
+//
+// A group is merged by moving the leader's body into a new internal function
+// that takes one extra argument per parametrized operand, and by rewriting
+// every member of the group as a thunk that passes its own constants. A simple
+// instruction-count cost model decides whether this actually saves code.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/MergeSimilarFunctions.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GetElementPtrTypeIterator.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Utils/FunctionComparator.h"
+#include <algorithm>
+#include <iterator>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "mergesimilarfunc"
+
+STATISTIC(NumGroupsMerged, "Number of groups of similar functions merged");
+STATISTIC(NumFunctionsMerged, "Number of functions turned into thunks");
+STATISTIC(NumParamsAdded, "Number of parameters added to merged functions");
+STATISTIC(NumGroupsUnprofitable,
+          "Number of groups of similar functions not merged due to cost");
+
+static cl::opt<unsigned> MaxExtraParams(
+    "mergesimilarfunc-max-params", cl::Hidden, cl::init(4),
+    cl::desc("The maximum number of parameters a merged function may gain"));
+
+static cl::opt<unsigned> MinInstructions(
+    "mergesimilarfunc-min-instructions", cl::Hidden, cl::init(8),
+    cl::desc("Ignore functions with fewer instructions than this"));
+
+static cl::opt<int> MinSavings(
+    "mergesimilarfunc-min-savings", cl::Hidden, cl::init(4),
+    cl::desc("The minimum estimated number of instructions a merge must save"));
+
+static cl::opt<unsigned> CalleeParamCost(
+    "mergesimilarfunc-callee-param-cost", cl::Hidden, cl::init(4),
+    cl::desc("The estimated cost of turning a direct call into an indirect "
+             "call"));
+
+namespace {
+
+/// An operand position in a function body: operand \c OpIdx of the
+/// \c InstIdx'th instruction, counting instructions in layout order.
+using OperandSite = std::pair<unsigned, unsigned>;
+
+/// A function that is a candidate for merging, together with its
+/// instructions in layout order. Debug intrinsics are not part of the list;
+/// they refer to function-specific metadata and are dropped from thunks.
+struct Candidate {
+  Function *F;
+  SmallVector<Instruction *, 32> Insts;
+};
+
+/// A set of similar functions. Members are compared against the leader only;
+/// \c Sites is the union of the operand positions where any member differs
+/// from the leader, kept sorted.
+struct MergeGroup {
+  unsigned Leader;
+  SmallVector<unsigned, 4> Members;
+  SmallVector<OperandSite, 4> Sites;
+};
+
+class SimilarFunctionMerger {
+public:
+  SimilarFunctionMerger(Module &M) : M(M) {}
+
+  bool run();
+
+private:
+  Module &M;
+  std::vector<Candidate> Candidates;
+
+  bool compare(const Candidate &L, const Candidate &R,
+               SmallVectorImpl<OperandSite> &Sites) const;
+  bool isProfitable(const MergeGroup &G) const;
+  void merge(const MergeGroup &G);
+  void writeThunk(Function *F, Function *Merged, ArrayRef<Constant *> Consts);
+};
+
+} // end anonymous namespace
+
+/// Whether \p F may take part in merging at all.
+static bool isEligible(const Function &F) {
+  if (F.isDeclarationForLinker() || F.isVarArg() || F.hasGC() ||
+      F.hasFnAttribute(Attribute::Naked) ||
+      F.hasFnAttribute(Attribute::OptimizeNone))
+    return false;
+  for (const Argument &A : F.args())
+    if (A.hasInAllocaAttr() || A.hasSwiftErrorAttr())
+      return false;
+  for (const BasicBlock &BB : F) {
+    // Blocks whose address is taken can't be moved into another function.
+    if (BB.hasAddressTaken())
+      return false;
+    for (const Instruction &I : BB)
+      // The merged function has a different signature, which musttail calls
+      // would have to match.
+      if (auto *CI = dyn_cast<CallInst>(&I))
+        if (CI->isMustTailCall())
+          return false;
+  }
+  return true;
+}
+
+/// Whether operand \p OpIdx of \p I may be replaced by an arbitrary value of
+/// the same type, given that the two functions being compared use the
+/// different constants \p L and \p R there.
+static bool canParametrize(const Instruction *I, unsigned OpIdx,
+                           const Constant *L, const Constant *R) {
+  if (L->getType() != R->getType())
+    return false;
+
+  if (ImmutableCallSite CS = ImmutableCallSite(I)) {
+    if (CS.isInlineAsm())
+      return false;
+    const Use &U = I->getOperandUse(OpIdx);
+    if (CS.isCallee(&U)) {
+      auto *FL = dyn_cast<Function>(L);
+      auto *FR = dyn_cast<Function>(R);
+      return FL && FR && !FL->isIntrinsic() && !FR->isIntrinsic();
+    }
+    // Intrinsic arguments are frequently required to be immediates.
+    const Function *Callee = CS.getCalledFunction();
+    if (Callee && Callee->isIntrinsic())
+      return false;
+    if (!CS.isArgOperand(&U))
+      return false;
+  } else if (auto *GEP = dyn_cast<GetElementPtrInst>(I)) {
+    // Struct indices must be constants.
+    if (OpIdx == 0)
+      return false;
+    auto GTI = gep_type_begin(GEP);
+    std::advance(GTI, OpIdx - 1);
+    if (GTI.isStruct())
+      return false;
+  } else if (isa<StoreInst>(I)) {
+    // Only the stored value, not the address.
+    if (OpIdx != 0)
+      return false;
+  } else if (!isa<BinaryOperator>(I) && !isa<CmpInst>(I) &&
+             !isa<CastInst>(I) && !isa<SelectInst>(I) && !isa<PHINode>(I) &&
+             !isa<ReturnInst>(I)) {
+    return false;
+  }
+
+  return (isa<ConstantInt>(L) && isa<ConstantInt>(R)) ||
+         (isa<ConstantFP>(L) && isa<ConstantFP>(R));
+}
+
+/// Compare \p L and \p R. If they are similar, return true and fill \p Sites
+/// with the operand positions where they differ.
+bool SimilarFunctionMerger::compare(const Candidate &L, const Candidate &R,
+                                    SmallVectorImpl<OperandSite> &Sites) const {
+  const Function *FL = L.F, *FR = R.F;
+  if (FL->getFunctionType() != FR->getFunctionType() ||
+      FL->getCallingConv() != FR->getCallingConv() ||
+      FL->getAttributes() != FR->getAttributes() ||
+      FL->getSection() != FR->getSection() ||
+      FL->hasPersonalityFn() != FR->hasPersonalityFn() ||
+      (FL->hasPersonalityFn() &&
+       FL->getPersonalityFn() != FR->getPersonalityFn()) ||
+      FL->size() != FR->size() || L.Insts.size() != R.Insts.size())
+    return false;
+
+  // Values local to the function correspond by position.
+  DenseMap<const Value *, const Value *> Map;
+  for (auto AL = FL->arg_begin(), AR = FR->arg_begin(), E = FL->arg_end();
+       AL != E; ++AL, ++AR)
+    Map[&*AL] = &*AR;
+  for (auto BL = FL->begin(), BR = FR->begin(), E = FL->end(); BL != E;
+       ++BL, ++BR)
+    Map[&*BL] = &*BR;
+  for (unsigned I = 0, E = L.Insts.size(); I != E; ++I)
+    Map[L.Insts[I]] = R.Insts[I];
+
+  Sites.clear();
+  for (unsigned Idx = 0, E = L.Insts.size(); Idx != E; ++Idx) {
+    const Instruction *IL = L.Insts[Idx], *IR = R.Insts[Idx];
+    if (!IL->isSameOperationAs(IR) ||
+        IL->getRawSubclassOptionalData() != IR->getRawSubclassOptionalData() ||
+        Map.lookup(IL->getParent()) != IR->getParent())
+      return false;
+
+    if (auto *PL = dyn_cast<PHINode>(IL)) {
+      auto *PR = cast<PHINode>(IR);
+      for (unsigned I = 0, N = PL->getNumIncomingValues(); I != N; ++I)
+        if (Map.lookup(PL->getIncomingBlock(I)) != PR->getIncomingBlock(I))
+          return false;
+    }
+
+    for (unsigned Op = 0, N = IL->getNumOperands(); Op != N; ++Op) {
+      const Value *VL = IL->getOperand(Op), *VR = IR->getOperand(Op);
+      if (const Value *Mapped = Map.lookup(VL)) {
+        if (Mapped != VR)
+          return false;
+        continue;
+      }
+      if (VL == VR)
+        continue;
+      auto *CL = dyn_cast<Constant>(VL);
+      auto *CR = dyn_cast<Constant>(VR);
+      if (!CL || !CR || !canParametrize(IL, Op, CL, CR))
+        return false;
+      Sites.push_back({Idx, Op});
+      if (Sites.size() > MaxExtraParams)
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Estimate whether merging \p G saves code, counting instructions. Before
+/// merging, every member has its own copy of the body. Afterwards, there is a
+/// single body, and every member becomes a thunk that materializes its
+/// arguments, calls the merged function and returns.
+bool SimilarFunctionMerger::isProfitable(const MergeGroup &G) const {
+  const Candidate &Leader = Candidates[G.Leader];
+  int NumMembers = G.Members.size();
+  int BodySize = Leader.Insts.size();
+  int ThunkSize = Leader.F->arg_size() + G.Sites.size() + 2;
+
+  int CalleeCost = 0;
+  for (const OperandSite &S : G.Sites)
+    if (ImmutableCallSite CS = ImmutableCallSite(Leader.Insts[S.first]))
+      if (CS.isCallee(&Leader.Insts[S.first]->getOperandUse(S.second)))
+        CalleeCost += CalleeParamCost;
+
+  int Before = NumMembers * BodySize;
+  int After = BodySize + CalleeCost + NumMembers * ThunkSize;
+  LLVM_DEBUG(dbgs() << "MSF: group led by " << Leader.F->getName() << " with "
+                    << NumMembers << " members, " << G.Sites.size()
+                    << " parameter(s): cost " << Before << " -> " << After
+                    << "\n");
+  return Before - After >= MinSavings;
+}
+
+/// Replace the body of \p F with a tail call to \p Merged passing the
+/// arguments of \p F followed by \p Consts.
+void SimilarFunctionMerger::writeThunk(Function *F, Function *Merged,
+                                       ArrayRef<Constant *> Consts) {
+  for (BasicBlock &BB : *F)
+    BB.dropAllReferences();
+  while (!F->empty())
+    F->begin()->eraseFromParent();
+
+  BasicBlock *BB = BasicBlock::Create(F->getContext(), "", F);
+  IRBuilder<> Builder(BB);
+  SmallVector<Value *, 16> Args;
+  for (Argument &A : F->args())
+    Args.push_back(&A);
+  Args.append(Consts.begin(), Consts.end());
+
+  CallInst *CI = Builder.CreateCall(Merged, Args);
+  CI->setTailCall();
+  CI->setCallingConv(Merged->getCallingConv());
+  CI->setAttributes(Merged->getAttributes());
+  ReturnInst *RI = F->getReturnType()->isVoidTy() ? Builder.CreateRetVoid()
+                                                  : Builder.CreateRet(CI);
+
+  if (DISubprogram *SP = F->getSubprogram()) {
+    DebugLoc DL = DebugLoc::get(SP->getScopeLine(), 0, SP);
+    CI->setDebugLoc(DL);
+    RI->setDebugLoc(DL);
+  }
+  ++NumFunctionsMerged;
+}
+
+void SimilarFunctionMerger::merge(const MergeGroup &G) {
+  Candidate &Leader = Candidates[G.Leader];
+  Function *LF = Leader.F;
+
+  // Record the constants every member passes before any body is touched.
+  std::vector<SmallVector<Constant *, 4>> Consts;
+  for (unsigned Member : G.Members) {
+    Consts.emplace_back();
+    for (const OperandSite &S : G.Sites)
+      Consts.back().push_back(cast<Constant>(
+          Candidates[Member].Insts[S.first]->getOperand(S.second)));
+  }
+
+  // Metadata such as !tbaa or !range may only be kept if every member agrees.
+  for (unsigned Idx = 0, E = Leader.Insts.size(); Idx != E; ++Idx) {
+    Instruction *I = Leader.Insts[Idx];
+    SmallVector<std::pair<unsigned, MDNode *>, 4> MDs;
+    I->getAllMetadataOtherThanDebugLoc(MDs);
+    for (auto &MD : MDs)
+      for (unsigned Member : G.Members)
+        if (Candidates[Member].Insts[Idx]->getMetadata(MD.first) !=
+            MD.second) {
+          I->setMetadata(MD.first, nullptr);
+          break;
+        }
+  }
+
+  SmallVector<Type *, 8> ParamTys(LF->getFunctionType()->param_begin(),
+                                  LF->getFunctionType()->param_end());
+  for (Constant *C : Consts.front())
+    ParamTys.push_back(C->getType());
+  FunctionType *FTy =
+      FunctionType::get(LF->getReturnType(), ParamTys, /*isVarArg=*/false);
+
+  Function *Merged =
+      Function::Create(FTy, GlobalValue::InternalLinkage,
+                       LF->getAddressSpace(), LF->getName() + ".merged", &M);
+  Merged->copyAttributesFrom(LF);
+  Merged->setLinkage(GlobalValue::InternalLinkage);
+  Merged->setVisibility(GlobalValue::DefaultVisibility);
+  Merged->setDLLStorageClass(GlobalValue::DefaultStorageClass);
+  Merged->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+  // The leader's comdat may be discarded in favor of another copy, while the
+  // other members' thunks still need the merged body.
+  Merged->setComdat(nullptr);
+
+  // Move the leader's body over, and rewrite the differing operands to use the
+  // new parameters.
+  Merged->getBasicBlockList().splice(Merged->begin(),
+                                     LF->getBasicBlockList());
+  auto NewArg = Merged->arg_begin();
+  for (Argument &A : LF->args()) {
+    A.replaceAllUsesWith(&*NewArg);
+    NewArg->setName(A.getName());
+    ++NewArg;
+  }
+  for (const OperandSite &S : G.Sites) {
+    NewArg->setName("merge.param");
+    Leader.Insts[S.first]->setOperand(S.second, &*NewArg);
+    ++NewArg;
+    ++NumParamsAdded;
+  }
+  Merged->setSubprogram(LF->getSubprogram());
+  LF->setSubprogram(nullptr);
+
+  LLVM_DEBUG(dbgs() << "MSF: merged " << G.Members.size()
+                    << " functions into " << Merged->getName() << "\n");
+  for (unsigned I = 0, E = G.Members.size(); I != E; ++I)
+    writeThunk(Candidates[G.Members[I]].F, Merged, Consts[I]);
+  ++NumGroupsMerged;
+}
+
+bool SimilarFunctionMerger::run() {
+  // Bucket the candidates by their structural hash. Iteration order follows
+  // the module, keeping the result deterministic.
+  MapVector<FunctionComparator::FunctionHash, SmallVector<unsigned, 4>>
+      Buckets;
+  for (Function &F : M) {
+    if (!isEligible(F))
+      continue;
+    Candidate C;
+    C.F = &F;
+    for (Instruction &I : instructions(F))
+      if (!isa<DbgInfoIntrinsic>(I))
+        C.Insts.push_back(&I);
+    if (C.Insts.size() < MinInstructions)
+      continue;
+    Buckets[FunctionComparator::functionHash(F)].push_back(Candidates.size());
+    Candidates.push_back(std::move(C));
+  }
+
+  std::vector<MergeGroup> Groups;
+  SmallVector<OperandSite, 4> Sites;
+  for (auto &Bucket : Buckets) {
+    if (Bucket.second.size() < 2)
+      continue;
+    size_t FirstGroup = Groups.size();
+    for (unsigned Idx : Bucket.second) {
+      bool Joined = false;
+      for (size_t GI = FirstGroup, GE = Groups.size(); GI != GE; ++GI) {
+        MergeGroup &G = Groups[GI];
+        if (!compare(Candidates[G.Leader], Candidates[Idx], Sites))
+          continue;
+        SmallVector<OperandSite, 4> Union;
+        std::set_union(G.Sites.begin(), G.Sites.end(), Sites.begin(),
+                       Sites.end(), std::back_inserter(Union));
+        if (Union.size() > MaxExtraParams)
+          continue;
+        G.Sites = std::move(Union);
+        G.Members.push_back(Idx);
+        Joined = true;
+        break;
+      }
+      if (!Joined) {
+        Groups.emplace_back();
+        Groups.back().Leader = Idx;
+        Groups.back().Members.push_back(Idx);
+      }
+    }
+  }
+
+  bool Changed = false;
+  for (const MergeGroup &G : Groups) {
+    if (G.Members.size() < 2)
+      continue;
+    if (!isProfitable(G)) {
+      ++NumGroupsUnprofitable;
+      continue;
+    }
+    merge(G);
+    Changed = true;
+  }
+  return Changed;
+}
+
+PreservedAnalyses MergeSimilarFunctionsPass::run(Module &M,
+                                                 ModuleAnalysisManager &) {
+  if (!SimilarFunctionMerger(M).run())
+    return PreservedAnalyses::all();
+  return PreservedAnalyses::none();
+}
+
+namespace {
+class MergeSimilarFunctionsLegacyPass : public ModulePass {
+public:
+  static char ID;
+
+  MergeSimilarFunctionsLegacyPass() : ModulePass(ID) {
+    initializeMergeSimilarFunctionsLegacyPassPass(
+        *PassRegistry::getPassRegistry());
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
+    return SimilarFunctionMerger(M).run();
+  }
+};
+} // end anonymous namespace
+
+char MergeSimilarFunctionsLegacyPass::ID = 0;
+INITIALIZE_PASS(MergeSimilarFunctionsLegacyPass, "mergesimilarfunc",
+                "Merge Similar Functions", false, false)
+
+ModulePass *llvm::createMergeSimilarFunctionsPass() {
+  return new MergeSimilarFunctionsLegacyPass();
+}
@@ -101,6 +101,19 @@ static cl::opt<bool>
 cl::opt<bool> EnableHotColdSplit("hot-cold-split", cl::init(false), cl::Hidden,
     cl::desc("Enable hot-cold splitting pass"));
 
+static cl::opt<bool> EnableCalledValuePromotion(
+    "enable-called-value-promotion", cl::init(false), cl::Hidden,
+    cl::desc("Promote indirect calls with statically known targets"));
+
+static cl::opt<bool> EnableCallEvaluation(
+    "enable-call-evaluation", cl::init(false), cl::Hidden,
+    cl::desc("Evaluate calls with constant arguments at compile time"));
+
+static cl::opt<bool> EnableMergeSimilarFunctions(
+    "enable-merge-similar-functions", cl::init(false), cl::Hidden,
+    cl::desc("Enable merging of functions that differ only in constants or "
+             "callees"));
+
 static cl::opt<bool> UseLoopVersioningLICM(
     "enable-loop-versioning-licm", cl::init(false), cl::Hidden,
     cl::desc("Enable the experimental Loop Versioning LICM pass"));
@@ -158,6 +171,8 @@ PassManagerBuilder::PassManagerBuilder() {
     LoopsInterleaved = EnableLoopInterleaving;
     RerollLoops = RunLoopRerolling;
     NewGVN = RunNewGVN;
+    LoopVersioningLICM = UseLoopVersioningLICM;
+    LoopVersioningLICMMaxBodySize = 0;
     LicmMssaOptCap = SetLicmMssaOptCap;
     LicmMssaNoAccForPromotionCap = SetLicmMssaNoAccForPromotionCap;
     DisableGVNLoadPRE = false;
@@ -165,6 +180,8 @@ PassManagerBuilder::PassManagerBuilder() {
     VerifyInput = false;
     VerifyOutput = false;
     MergeFunctions = false;
+    MergeSimilarFunctions = EnableMergeSimilarFunctions;
+    HotColdSplitting = EnableHotColdSplit;
     PrepareForLTO = false;
     EnablePGOInstrGen = false;
     EnablePGOCSInstrGen = false;
@@ -516,6 +533,8 @@ void PassManagerBuilder::populateModulePassManager(
 
   MPM.add(createIPSCCPPass());          // IP SCCP
   MPM.add(createCalledValuePropagationPass());
+  if (EnableCalledValuePromotion)
+    MPM.add(createCalledValuePromotionPass());
 
   // Infer attributes on declarations, call sites, arguments, etc.
   MPM.add(createAttributorLegacyPass());
@@ -597,6 +616,11 @@ void PassManagerBuilder::populateModulePassManager(
 
   MPM.add(createReversePostOrderFunctionAttrsPass());
 
+  // Now that function attributes are inferred, calls to functions known to be
+  // free of side effects can be evaluated if all their arguments are constant.
+  if (EnableCallEvaluation)
+    MPM.add(createCallEvaluationPass());
+
   // The inliner performs some kind of dead code elimination as it goes,
   // but there are cases that are not really caught by it. We might
   // at some point consider teaching the inliner about them, but it
@@ -631,8 +655,9 @@ void PassManagerBuilder::populateModulePassManager(
   // early versioning may prevent further inlining due to increase of code
   // size. By placing it just after inlining other optimizations which runs
   // later might get benefit of no-alias assumption in clone loop.
-  if (UseLoopVersioningLICM) {
-    MPM.add(createLoopVersioningLICMPass());    // Do LoopVersioningLICM
+  if (LoopVersioningLICM) {
+    // Do LoopVersioningLICM
+    MPM.add(createLoopVersioningLICMPass(LoopVersioningLICMMaxBodySize));
     MPM.add(createLICMPass(LicmMssaOptCap, LicmMssaNoAccForPromotionCap));
   }
 
@@ -753,11 +778,13 @@ void PassManagerBuilder::populateModulePassManager(
 
   // See comment in the new PM for justification of scheduling splitting at
   // this stage (\ref buildModuleSimplificationPipeline).
-  if (EnableHotColdSplit && !(PrepareForLTO || PrepareForThinLTO))
+  if (HotColdSplitting && !(PrepareForLTO || PrepareForThinLTO))
     MPM.add(createHotColdSplittingPass());
 
   if (MergeFunctions)
     MPM.add(createMergeFunctionsPass());
+  if (MergeSimilarFunctions)
+    MPM.add(createMergeSimilarFunctionsPass());
 
   // LoopSink pass sinks instructions hoisted by LICM, which serves as a
   // canonicalization pass that enables other optimizations. As a result,
@@ -824,6 +851,8 @@ void PassManagerBuilder::addLTOOptimizationPasses(legacy::PassManagerBase &PM) {
     // Attach metadata to indirect call sites indicating the set of functions
     // they may target at run-time. This should follow IPSCCP.
     PM.add(createCalledValuePropagationPass());
+    if (EnableCalledValuePromotion)
+      PM.add(createCalledValuePromotionPass());
 
     // Infer attributes on declarations, call sites, arguments, etc.
     PM.add(createAttributorLegacyPass());
@@ -958,7 +987,7 @@ void PassManagerBuilder::addLateLTOOptimizationPasses(
     legacy::PassManagerBase &PM) {
   // See comment in the new PM for justification of scheduling splitting at
   // this stage (\ref buildLTODefaultPipeline).
-  if (EnableHotColdSplit)
+  if (HotColdSplitting)
     PM.add(createHotColdSplittingPass());
 
   // Delete basic blocks, which optimization passes may have killed.
@@ -974,6 +1003,8 @@ void PassManagerBuilder::addLateLTOOptimizationPasses(
   // currently it damages debug info.
   if (MergeFunctions)
     PM.add(createMergeFunctionsPass());
+  if (MergeSimilarFunctions)
+    PM.add(createMergeSimilarFunctionsPass());
 }
 
 void PassManagerBuilder::populateThinLTOPassManager(
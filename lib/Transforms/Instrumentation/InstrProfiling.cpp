@@ -142,6 +142,12 @@ cl::opt<bool> IterativeCounterPromotion(
     cl::ZeroOrMore, "iterative-counter-promotion", cl::init(true),
     cl::desc("Allow counter promotion across the whole loop nest."));
 
+cl::opt<bool> WasmCounterLayout(
+    "instrprof-wasm-layout", cl::ZeroOrMore, cl::init(true),
+    cl::desc("Leave the counters of wasm32 modules in linear memory and "
+             "describe them in a custom section, instead of relying on the "
+             "profile runtime to write them out"));
+
 class InstrProfilingLegacyPass : public ModulePass {
   InstrProfiling InstrProf;
 
@@ -489,6 +495,8 @@ bool InstrProfiling::run(Module &M, const TargetLibraryInfo &TLI) {
   NamesSize = 0;
   ProfileDataMap.clear();
   UsedVars.clear();
+  WasmLayoutRecords.clear();
+  WasmLayoutNames.clear();
   getMemOPSizeRangeFromOption(MemOPSizeRange, MemOPSizeRangeStart,
                               MemOPSizeRangeLast);
   TT = Triple(M.getTargetTriple());
@@ -533,6 +541,7 @@ bool InstrProfiling::run(Module &M, const TargetLibraryInfo &TLI) {
 
   emitVNodes();
   emitNameData();
+  emitWasmLayout();
   emitRegistration();
   emitUses();
   emitInitialization();
@@ -586,6 +595,12 @@ void InstrProfiling::computeNumValueSiteCounts(InstrProfValueProfileInst *Ind) {
 }
 
 void InstrProfiling::lowerValueProfileInst(InstrProfValueProfileInst *Ind) {
+  // Value profiling needs the runtime to record the values.
+  if (useWasmLayout()) {
+    Ind->eraseFromParent();
+    return;
+  }
+
   GlobalVariable *Name = Ind->getName();
   auto It = ProfileDataMap.find(Name);
   assert(It != ProfileDataMap.end() && It->second.DataVar &&
@@ -707,6 +722,10 @@ static inline bool shouldRecordFunctionAddr(Function *F) {
   return F->hasAddressTaken() || F->hasLinkOnceLinkage();
 }
 
+bool InstrProfiling::useWasmLayout() const {
+  return WasmCounterLayout && TT.getArch() == Triple::wasm32;
+}
+
 static bool needsRuntimeRegistrationOfSectionRange(const Triple &TT) {
   // Don't do this for Darwin.  compiler-rt uses linker magic.
   if (TT.isOSDarwin())
@@ -809,6 +828,27 @@ InstrProfiling::getOrCreateRegionCounters(InstrProfIncrementInst *Inc) {
     }
   }
 
+  PD.RegionCounters = CounterPtr;
+
+  if (useWasmLayout()) {
+    // Describe the counters in the layout section rather than in a data
+    // variable for the runtime.
+    auto *Int32Ty = Type::getInt32Ty(Ctx);
+    auto *Int64Ty = Type::getInt64Ty(Ctx);
+    Constant *RecordVals[] = {
+        ConstantInt::get(Int64Ty, IndexedInstrProf::ComputeHash(
+                                      getPGOFuncNameVarInitializer(NamePtr))),
+        ConstantInt::get(Int64Ty, Inc->getHash()->getZExtValue()),
+        ConstantExpr::getPtrToInt(CounterPtr, Int32Ty),
+        ConstantInt::get(Int32Ty, NumCounters)};
+    WasmLayoutRecords.push_back(
+        ConstantStruct::getAnon(Ctx, RecordVals, /*Packed=*/true));
+    ProfileDataMap[NamePtr] = PD;
+    NamePtr->setLinkage(GlobalValue::PrivateLinkage);
+    ReferencedNames.push_back(NamePtr);
+    return CounterPtr;
+  }
+
   // Create data variable.
   auto *Int16Ty = Type::getInt16Ty(Ctx);
   auto *Int16ArrayTy = ArrayType::get(Int16Ty, IPVK_Last + 1);
@@ -839,7 +879,6 @@ InstrProfiling::getOrCreateRegionCounters(InstrProfIncrementInst *Inc) {
   MaybeSetComdat(Data);
   Data->setLinkage(Linkage);
 
-  PD.RegionCounters = CounterPtr;
   PD.DataVar = Data;
   ProfileDataMap[NamePtr] = PD;
 
@@ -856,7 +895,7 @@ InstrProfiling::getOrCreateRegionCounters(InstrProfIncrementInst *Inc) {
 }
 
 void InstrProfiling::emitVNodes() {
-  if (!ValueProfileStaticAlloc)
+  if (!ValueProfileStaticAlloc || useWasmLayout())
     return;
 
   // For now only support this on platforms that do
@@ -914,27 +953,64 @@ void InstrProfiling::emitNameData() {
     report_fatal_error(toString(std::move(E)), false);
   }
 
-  auto &Ctx = M->getContext();
-  auto *NamesVal = ConstantDataArray::getString(
-      Ctx, StringRef(CompressedNameStr), false);
-  NamesVar = new GlobalVariable(*M, NamesVal->getType(), true,
-                                GlobalValue::PrivateLinkage, NamesVal,
-                                getInstrProfNamesVarName());
-  NamesSize = CompressedNameStr.size();
-  NamesVar->setSection(
-      getInstrProfSectionName(IPSK_name, TT.getObjectFormat()));
-  // On COFF, it's important to reduce the alignment down to 1 to prevent the
-  // linker from inserting padding before the start of the names section or
-  // between names entries.
-  NamesVar->setAlignment(1);
-  UsedVars.push_back(NamesVar);
+  if (useWasmLayout()) {
+    // The names go in the layout section, where they don't take up linear
+    // memory.
+    WasmLayoutNames = std::move(CompressedNameStr);
+  } else {
+    auto &Ctx = M->getContext();
+    auto *NamesVal = ConstantDataArray::getString(
+        Ctx, StringRef(CompressedNameStr), false);
+    NamesVar = new GlobalVariable(*M, NamesVal->getType(), true,
+                                  GlobalValue::PrivateLinkage, NamesVal,
+                                  getInstrProfNamesVarName());
+    NamesSize = CompressedNameStr.size();
+    NamesVar->setSection(
+        getInstrProfSectionName(IPSK_name, TT.getObjectFormat()));
+    // On COFF, it's important to reduce the alignment down to 1 to prevent
+    // the linker from inserting padding before the start of the names section
+    // or between names entries.
+    NamesVar->setAlignment(1);
+    UsedVars.push_back(NamesVar);
+  }
 
   for (auto *NamePtr : ReferencedNames)
     NamePtr->eraseFromParent();
 }
 
+void InstrProfiling::emitWasmLayout() {
+  if (!useWasmLayout() || WasmLayoutRecords.empty())
+    return;
+
+  auto &Ctx = M->getContext();
+  auto *Int32Ty = Type::getInt32Ty(Ctx);
+  uint64_t Version = WasmInstrProf::Version;
+  if (isIRPGOFlagSet(M))
+    Version |= VARIANT_MASK_IR_PROF;
+  if (IsCS)
+    Version |= VARIANT_MASK_CSIR_PROF;
+
+  auto *RecordsTy =
+      ArrayType::get(WasmLayoutRecords.front()->getType(),
+                     WasmLayoutRecords.size());
+  Constant *LayoutVals[] = {
+      ConstantInt::get(Type::getInt64Ty(Ctx), Version),
+      ConstantInt::get(Int32Ty, WasmLayoutRecords.size()),
+      ConstantInt::get(Int32Ty, WasmLayoutNames.size()),
+      ConstantArray::get(RecordsTy, WasmLayoutRecords),
+      ConstantDataArray::getString(Ctx, WasmLayoutNames, false)};
+  auto *LayoutVal = ConstantStruct::getAnon(Ctx, LayoutVals, /*Packed=*/true);
+  auto *LayoutVar = new GlobalVariable(
+      *M, LayoutVal->getType(), true, GlobalValue::PrivateLinkage, LayoutVal,
+      getInstrProfWasmLayoutVarName());
+  LayoutVar->setSection(
+      (".custom_section." + getInstrProfWasmLayoutSectionName()).str());
+  LayoutVar->setAlignment(1);
+  UsedVars.push_back(LayoutVar);
+}
+
 void InstrProfiling::emitRegistration() {
-  if (!needsRuntimeRegistrationOfSectionRange(TT))
+  if (!needsRuntimeRegistrationOfSectionRange(TT) || useWasmLayout())
     return;
 
   // Construct the function.
@@ -974,8 +1050,9 @@ void InstrProfiling::emitRegistration() {
 
 bool InstrProfiling::emitRuntimeHook() {
   // We expect the linker to be invoked with -u<hook_var> flag for linux,
-  // for which case there is no need to emit the user function.
-  if (TT.isOSLinux())
+  // for which case there is no need to emit the user function. WebAssembly
+  // modules that keep their counters in linear memory have no runtime.
+  if (TT.isOSLinux() || useWasmLayout())
     return false;
 
   // If the module's provided its own runtime, we don't need to do anything.
@@ -1014,6 +1091,10 @@ void InstrProfiling::emitUses() {
 }
 
 void InstrProfiling::emitInitialization() {
+  // Nothing is written out at run time without the runtime.
+  if (useWasmLayout())
+    return;
+
   // Create ProfileFileName variable. Don't don't this for the
   // context-sensitive instrumentation lowering: This lowering is after
   // LTO/ThinLTO linking. Pass PGOInstrumentationGenCreateVar should
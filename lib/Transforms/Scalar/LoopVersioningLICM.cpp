@@ -69,11 +69,13 @@
 #include "llvm/Analysis/LoopPass.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Metadata.h"
@@ -112,6 +114,23 @@ static cl::opt<unsigned> LVLoopDepthThreshold(
         "LoopVersioningLICM's threshold for maximum allowed loop nest/depth"),
     cl::init(2), cl::Hidden);
 
+/// Threshold for the maximum size of a versioned loop body. Versioning
+/// duplicates the loop, so targets that care about code size can ask for a
+/// limit when they create the pass. This option overrides it.
+static cl::opt<unsigned> LVBodySizeThreshold(
+    "licm-versioning-max-body-size",
+    cl::desc("LoopVersioningLICM's threshold for the maximum number of "
+             "instructions in a versioned loop (0 for no limit)"),
+    cl::init(0), cl::Hidden);
+
+/// Trip count assumed when neither a constant trip count nor profile data is
+/// available, to weigh the runtime checks against the hoisted accesses.
+static cl::opt<unsigned> LVAssumedTripCount(
+    "licm-versioning-assumed-trip-count",
+    cl::desc("LoopVersioningLICM's assumed trip count for loops whose trip "
+             "count is unknown"),
+    cl::init(16), cl::Hidden);
+
 /// Create MDNode for input string.
 static MDNode *createStringMetadata(Loop *TheLoop, StringRef Name, unsigned V) {
   LLVMContext &Context = TheLoop->getHeader()->getContext();
@@ -148,8 +167,11 @@ namespace {
 struct LoopVersioningLICM : public LoopPass {
   static char ID;
 
-  LoopVersioningLICM()
+  explicit LoopVersioningLICM(unsigned MaxBodySize = 0)
       : LoopPass(ID), LoopDepthThreshold(LVLoopDepthThreshold),
+        BodySizeThreshold(LVBodySizeThreshold.getNumOccurrences()
+                              ? LVBodySizeThreshold
+                              : MaxBodySize),
         InvariantThreshold(LVInvarThreshold) {
     initializeLoopVersioningLICMPass(*PassRegistry::getPassRegistry());
   }
@@ -165,6 +187,7 @@ struct LoopVersioningLICM : public LoopPass {
     AU.addRequired<LoopInfoWrapperPass>();
     AU.addRequiredID(LoopSimplifyID);
     AU.addRequired<ScalarEvolutionWrapperPass>();
+    AU.addRequired<TargetTransformInfoWrapperPass>();
     AU.addPreserved<AAResultsWrapperPass>();
     AU.addPreserved<GlobalsAAWrapperPass>();
     AU.addRequired<OptimizationRemarkEmitterWrapperPass>();
@@ -175,10 +198,12 @@ struct LoopVersioningLICM : public LoopPass {
   void reset() {
     AA = nullptr;
     SE = nullptr;
+    TTI = nullptr;
     LAA = nullptr;
     CurLoop = nullptr;
     LoadAndStoreCounter = 0;
     InvariantCounter = 0;
+    InvariantAccessCost = 0;
     IsReadOnlyLoop = true;
     ORE = nullptr;
     CurAST.reset();
@@ -200,6 +225,9 @@ private:
   // Current ScalarEvolution
   ScalarEvolution *SE = nullptr;
 
+  // Current TargetTransformInfo
+  const TargetTransformInfo *TTI = nullptr;
+
   // Current LoopAccessAnalysis
   LoopAccessLegacyAnalysis *LAA = nullptr;
 
@@ -215,6 +243,9 @@ private:
   // Maximum loop nest threshold
   unsigned LoopDepthThreshold;
 
+  // Maximum loop body size threshold
+  unsigned BodySizeThreshold;
+
   // Minimum invariant threshold
   float InvariantThreshold;
 
@@ -224,6 +255,9 @@ private:
   // Counter to track num of invariant
   unsigned InvariantCounter = 0;
 
+  // Cost of executing the invariant loads & stores once
+  int InvariantAccessCost = 0;
+
   // Read only loop marker.
   bool IsReadOnlyLoop = true;
 
@@ -234,6 +268,7 @@ private:
   bool legalLoopStructure();
   bool legalLoopInstructions();
   bool legalLoopMemoryAccesses();
+  bool isProfitableToVersion();
   bool isLoopAlreadyVisited();
   void setNoAliasToLoop(Loop *VerLoop);
   bool instructionSafeForVersioning(Instruction *I);
@@ -388,8 +423,12 @@ bool LoopVersioningLICM::instructionSafeForVersioning(Instruction *I) {
     LoadAndStoreCounter++;
     Value *Ptr = Ld->getPointerOperand();
     // Check loop invariant.
-    if (SE->isLoopInvariant(SE->getSCEV(Ptr), CurLoop))
+    if (SE->isLoopInvariant(SE->getSCEV(Ptr), CurLoop)) {
       InvariantCounter++;
+      InvariantAccessCost += TTI->getMemoryOpCost(
+          Instruction::Load, Ld->getType(), Ld->getAlignment(),
+          Ld->getPointerAddressSpace(), Ld);
+    }
   }
   // If current instruction is store instruction
   // make sure it's a simple store (non atomic & non volatile)
@@ -402,8 +441,12 @@ bool LoopVersioningLICM::instructionSafeForVersioning(Instruction *I) {
     LoadAndStoreCounter++;
     Value *Ptr = St->getPointerOperand();
     // Check loop invariant.
-    if (SE->isLoopInvariant(SE->getSCEV(Ptr), CurLoop))
+    if (SE->isLoopInvariant(SE->getSCEV(Ptr), CurLoop)) {
       InvariantCounter++;
+      InvariantAccessCost += TTI->getMemoryOpCost(
+          Instruction::Store, St->getValueOperand()->getType(),
+          St->getAlignment(), St->getPointerAddressSpace(), St);
+    }
 
     IsReadOnlyLoop = false;
   }
@@ -416,10 +459,12 @@ bool LoopVersioningLICM::legalLoopInstructions() {
   // Resetting counters.
   LoadAndStoreCounter = 0;
   InvariantCounter = 0;
+  InvariantAccessCost = 0;
   IsReadOnlyLoop = true;
   using namespace ore;
   // Iterate over loop blocks and instructions of each block and check
   // instruction safety.
+  unsigned BodySize = 0;
   for (auto *Block : CurLoop->getBlocks())
     for (auto &Inst : *Block) {
       // If instruction is unsafe just return false.
@@ -430,7 +475,23 @@ bool LoopVersioningLICM::legalLoopInstructions() {
         });
         return false;
       }
+      if (!isa<DbgInfoIntrinsic>(Inst))
+        ++BodySize;
     }
+  // Loop body size should be within the threshold, since versioning
+  // duplicates it.
+  if (BodySizeThreshold && BodySize > BodySizeThreshold) {
+    LLVM_DEBUG(dbgs() << "    Loop body size " << BodySize
+                      << " is more than threshold\n");
+    ORE->emit([&]() {
+      return OptimizationRemarkMissed(DEBUG_TYPE, "BodySizeThreshold",
+                                      CurLoop->getStartLoc(),
+                                      CurLoop->getHeader())
+             << "Loop body size " << NV("BodySize", BodySize)
+             << " exceeds threshold " << NV("Threshold", BodySizeThreshold);
+    });
+    return false;
+  }
   // Get LoopAccessInfo from current loop.
   LAI = &LAA->getInfo(CurLoop);
   // Check LoopAccessInfo for need of runtime check.
@@ -546,6 +607,11 @@ bool LoopVersioningLICM::isLegalForVersioning() {
     });
     return false;
   }
+  // Check that the runtime checks pay for themselves.
+  if (!isProfitableToVersion()) {
+    LLVM_DEBUG(dbgs() << "    Loop versioning not profitable\n\n");
+    return false;
+  }
   // Loop versioning is feasible, return true.
   LLVM_DEBUG(dbgs() << "    Loop Versioning found to be beneficial\n\n");
   ORE->emit([&]() {
@@ -558,6 +624,47 @@ bool LoopVersioningLICM::isLegalForVersioning() {
   return true;
 }
 
+/// Weigh the cost of the runtime alias checks against the invariant loads &
+/// stores that LICM can hoist out of the versioned loop. The checks run once
+/// per entry to the loop: for every pair of pointer groups the bounds are
+/// compared twice, the results are and'ed, and or'ed into the final result.
+/// The hoisted accesses are saved on every iteration.
+bool LoopVersioningLICM::isProfitableToVersion() {
+  using namespace ore;
+  LLVMContext &Context = CurLoop->getHeader()->getContext();
+  Type *BoolTy = Type::getInt1Ty(Context);
+  int PerCheckCost =
+      2 * TTI->getCmpSelInstrCost(Instruction::ICmp,
+                                  Type::getInt8PtrTy(Context), BoolTy) +
+      TTI->getArithmeticInstrCost(Instruction::And, BoolTy) +
+      TTI->getArithmeticInstrCost(Instruction::Or, BoolTy);
+  int64_t CheckCost =
+      int64_t(PerCheckCost) * LAI->getNumRuntimePointerChecks();
+
+  // Use the constant trip count, or the one estimated from profile data.
+  unsigned TripCount = SE->getSmallConstantTripCount(CurLoop);
+  if (!TripCount)
+    TripCount = getLoopEstimatedTripCount(CurLoop).getValueOr(0);
+  if (!TripCount)
+    TripCount = LVAssumedTripCount;
+  int64_t Benefit = int64_t(InvariantAccessCost) * TripCount;
+  if (Benefit > CheckCost)
+    return true;
+
+  LLVM_DEBUG(dbgs() << "    Runtime check cost " << CheckCost
+                    << " exceeds hoisting benefit " << Benefit << " ("
+                    << InvariantAccessCost << " x trip count " << TripCount
+                    << ")\n");
+  ORE->emit([&]() {
+    return OptimizationRemarkMissed(DEBUG_TYPE, "CheckCost",
+                                    CurLoop->getStartLoc(),
+                                    CurLoop->getHeader())
+           << "Runtime check cost " << NV("CheckCost", CheckCost)
+           << " exceeds the benefit of hoisting " << NV("Benefit", Benefit);
+  });
+  return false;
+}
+
 /// Update loop with aggressive aliasing assumptions.
 /// It marks no-alias to any pairs of memory operations by assuming
 /// loop should not have any must-alias memory accesses pairs.
@@ -610,6 +717,8 @@ bool LoopVersioningLICM::runOnLoop(Loop *L, LPPassManager &LPM) {
   // Get Analysis information.
   AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
   SE = &getAnalysis<ScalarEvolutionWrapperPass>().getSE();
+  TTI = &getAnalysis<TargetTransformInfoWrapperPass>().getTTI(
+      *L->getHeader()->getParent());
   LAA = &getAnalysis<LoopAccessLegacyAnalysis>();
   ORE = &getAnalysis<OptimizationRemarkEmitterWrapperPass>().getORE();
   LAI = nullptr;
@@ -664,8 +773,11 @@ INITIALIZE_PASS_DEPENDENCY(LoopAccessLegacyAnalysis)
 INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(LoopSimplify)
 INITIALIZE_PASS_DEPENDENCY(ScalarEvolutionWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(TargetTransformInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(OptimizationRemarkEmitterWrapperPass)
 INITIALIZE_PASS_END(LoopVersioningLICM, "loop-versioning-licm",
                     "Loop Versioning For LICM", false, false)
 
-Pass *llvm::createLoopVersioningLICMPass() { return new LoopVersioningLICM(); }
+Pass *llvm::createLoopVersioningLICMPass(unsigned MaxBodySize) {
+  return new LoopVersioningLICM(MaxBodySize);
+}
@@ -221,6 +221,22 @@ Constant *Evaluator::ComputeLoadResult(Constant *P) {
   if (Constant *Val = findMemLoc(P))
     return Val;
 
+  // Memory that isn't constant may have been modified before the evaluated
+  // code runs. Alloca temporaries aren't part of the module, and everything
+  // stored to them is in MutatedMemory.
+  if (OnlyReadConstantGlobals) {
+    Constant *Base = P;
+    while (auto *CE = dyn_cast<ConstantExpr>(Base))
+      if (CE->getOpcode() == Instruction::GetElementPtr ||
+          CE->getOpcode() == Instruction::BitCast)
+        Base = CE->getOperand(0);
+      else
+        break;
+    auto *GV = dyn_cast<GlobalVariable>(Base);
+    if (!GV || (GV->getParent() && !GV->isConstant()))
+      return nullptr;
+  }
+
   // Access it.
   if (GlobalVariable *GV = dyn_cast<GlobalVariable>(P)) {
     if (GV->hasDefinitiveInitializer())
@@ -331,6 +347,11 @@ bool Evaluator::EvaluateBlock(BasicBlock::iterator CurInst,
   while (true) {
     Constant *InstResult = nullptr;
 
+    if (MaxSteps && ++Steps > MaxSteps) {
+      LLVM_DEBUG(dbgs() << "Step budget exhausted. Can not evaluate.\n");
+      return false;
+    }
+
     LLVM_DEBUG(dbgs() << "Evaluating Instruction: " << *CurInst << "\n");
 
     if (StoreInst *SI = dyn_cast<StoreInst>(CurInst)) {
@@ -713,17 +734,20 @@ bool Evaluator::EvaluateFunction(Function *F, Constant *&RetVal,
 
     // Okay, we succeeded in evaluating this control flow.  See if we have
     // executed the new block before.  If so, we have a looping function,
-    // which we cannot evaluate in reasonable time.
-    if (!ExecutedBlocks.insert(NextBB).second)
+    // which we can only evaluate within a step budget.
+    if (!ExecutedBlocks.insert(NextBB).second && !MaxSteps)
       return false;  // looped!
 
-    // Okay, we have never been in this block before.  Check to see if there
-    // are any PHI nodes.  If so, evaluate them with information about where
-    // we came from.
+    // Check to see if there are any PHI nodes.  If so, evaluate them with
+    // information about where we came from.  On a back edge, PHI nodes may
+    // refer to each other, so read all incoming values before updating any.
+    SmallVector<std::pair<PHINode *, Constant *>, 8> PHIValues;
     PHINode *PN = nullptr;
     for (CurInst = NextBB->begin();
          (PN = dyn_cast<PHINode>(CurInst)); ++CurInst)
-      setVal(PN, getVal(PN->getIncomingValueForBlock(CurBB)));
+      PHIValues.push_back({PN, getVal(PN->getIncomingValueForBlock(CurBB))});
+    for (auto &PHIValue : PHIValues)
+      setVal(PHIValue.first, PHIValue.second);
 
     // Advance to the next block.
     CurBB = NextBB;
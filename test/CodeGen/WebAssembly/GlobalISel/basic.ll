@@ -0,0 +1,98 @@
+; RUN: llc < %s -asm-verbose=false -global-isel -global-isel-abort=1 -verify-machineinstrs -disable-wasm-fallthrough-return-opt -wasm-disable-explicit-locals -wasm-keep-registers | FileCheck %s
+
+; Test that simple functions are selected by GlobalISel without falling back
+; to SelectionDAG.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; CHECK-LABEL: add32:
+; CHECK-NEXT: .functype add32 (i32, i32) -> (i32){{$}}
+; CHECK: i32.add $push[[R:[0-9]+]]=, $0, $1{{$}}
+; CHECK-NEXT: return $pop[[R]]{{$}}
+define i32 @add32(i32 %x, i32 %y) {
+  %a = add i32 %x, %y
+  ret i32 %a
+}
+
+; CHECK-LABEL: fadd64:
+; CHECK-NEXT: .functype fadd64 (f64, f64) -> (f64){{$}}
+; CHECK: f64.add $push[[R:[0-9]+]]=, $0, $1{{$}}
+; CHECK-NEXT: return $pop[[R]]{{$}}
+define double @fadd64(double %x, double %y) {
+  %a = fadd double %x, %y
+  ret double %a
+}
+
+; CHECK-LABEL: load_store:
+; CHECK: i32.load8_u $push[[L:[0-9]+]]=, 0($0){{$}}
+; CHECK: i32.const $push[[M:[0-9]+]]=, 255{{$}}
+; CHECK: i32.and $push[[R:[0-9]+]]=, $pop[[L]], $pop[[M]]{{$}}
+; CHECK: i32.store16 0($1), $pop[[R]]{{$}}
+define void @load_store(i8* %p, i16* %q) {
+  %v = load i8, i8* %p
+  %e = zext i8 %v to i16
+  store i16 %e, i16* %q
+  ret void
+}
+
+; CHECK-LABEL: sext_arg:
+; CHECK: i32.shl
+; CHECK: i32.shr_s
+; CHECK: i64.extend_i32_s
+define i64 @sext_arg(i16 %x) {
+  %e = sext i16 %x to i32
+  %w = sext i32 %e to i64
+  ret i64 %w
+}
+
+; CHECK-LABEL: load_float:
+; CHECK: f32.load $push[[L:[0-9]+]]=, 0($0){{$}}
+; CHECK: f32.mul
+define float @load_float(float* %p) {
+  %v = load float, float* %p
+  %m = fmul float %v, %v
+  ret float %m
+}
+
+; CHECK-LABEL: compare_branch:
+; CHECK: i32.lt_s
+; CHECK: br_if
+; CHECK: return
+define i32 @compare_branch(i32 %x, i32 %y) {
+entry:
+  %c = icmp slt i32 %x, %y
+  br i1 %c, label %then, label %else
+then:
+  ret i32 %x
+else:
+  ret i32 %y
+}
+
+; CHECK-LABEL: unordered:
+; CHECK: f32.ge $push[[C:[0-9]+]]=, $0, $1{{$}}
+; CHECK-NEXT: i32.eqz $push{{[0-9]+}}=, $pop[[C]]{{$}}
+define i32 @unordered(float %x, float %y) {
+  %c = fcmp ult float %x, %y
+  %r = zext i1 %c to i32
+  ret i32 %r
+}
+
+@g = global i32 0
+
+; CHECK-LABEL: global_addr:
+; CHECK: i32.const $push[[A:[0-9]+]]=, g{{$}}
+; CHECK: i32.load
+define i32 @global_addr() {
+  %v = load i32, i32* @g
+  ret i32 %v
+}
+
+declare i32 @callee(i32)
+
+; CHECK-LABEL: direct_call:
+; CHECK: call $push[[R:[0-9]+]]=, callee, $0{{$}}
+define i32 @direct_call(i32 %x) {
+  %r = call i32 @callee(i32 %x)
+  ret i32 %r
+}
@@ -0,0 +1,25 @@
+; RUN: llc < %s -asm-verbose=false -global-isel -global-isel-abort=2 -pass-remarks-missed='gisel*' -verify-machineinstrs -disable-wasm-fallthrough-return-opt -wasm-keep-registers 2>&1 | FileCheck %s
+
+; Test that functions GlobalISel can't handle yet are compiled by SelectionDAG
+; instead.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; CHECK: remark: {{.*}} cannot select: {{.*}}G_FCMP floatpred(one)
+; CHECK: warning: Instruction selection used fallback path for ordered_ne
+; CHECK-LABEL: ordered_ne:
+; CHECK: f32.{{[a-z]+}} $push
+define i32 @ordered_ne(float %x, float %y) {
+  %c = fcmp one float %x, %y
+  %r = zext i1 %c to i32
+  ret i32 %r
+}
+
+; CHECK-NOT: fallback path for add32
+; CHECK-LABEL: add32:
+; CHECK: i32.add
+define i32 @add32(i32 %x, i32 %y) {
+  %a = add i32 %x, %y
+  ret i32 %a
+}
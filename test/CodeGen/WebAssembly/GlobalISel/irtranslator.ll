@@ -0,0 +1,49 @@
+; RUN: llc < %s -global-isel -stop-after=irtranslator -verify-machineinstrs | FileCheck %s
+
+; Test that arguments, calls and returns are lowered to the WebAssembly
+; pseudo instructions by the GlobalISel call lowering.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; CHECK-LABEL: name: args
+; CHECK: [[A:%[0-9]+]]:i32 = ARGUMENT_i32 0
+; CHECK: [[X:%[0-9]+]]:_(s32) = COPY [[A]]
+; CHECK: [[B:%[0-9]+]]:f64 = ARGUMENT_f64 1
+; CHECK: [[Y:%[0-9]+]]:_(s64) = COPY [[B]]
+; CHECK: G_FPTOSI [[Y]]
+; CHECK: RETURN_I32
+define i32 @args(i32 %a, double %b) {
+  %c = fptosi double %b to i32
+  %r = add i32 %a, %c
+  ret i32 %r
+}
+
+; CHECK-LABEL: name: narrow
+; CHECK: [[A:%[0-9]+]]:i32 = ARGUMENT_i32 0
+; CHECK: [[X:%[0-9]+]]:_(s32) = COPY [[A]]
+; CHECK: G_TRUNC [[X]](s32)
+; CHECK: G_ZEXT
+; CHECK: RETURN_I32
+define zeroext i8 @narrow(i8 %a) {
+  %r = add i8 %a, 1
+  ret i8 %r
+}
+
+declare float @callee(float, i64)
+
+; CHECK-LABEL: name: direct_call
+; CHECK-NOT: ADJCALLSTACKDOWN
+; CHECK: {{%[0-9]+}}:f32 = CALL_f32 @callee
+; CHECK: RETURN_VOID
+define void @direct_call(float %a) {
+  %r = call float @callee(float %a, i64 7)
+  ret void
+}
+
+; CHECK-LABEL: name: indirect_call
+; CHECK: PCALL_INDIRECT_VOID
+define void @indirect_call(void ()* %f) {
+  call void %f()
+  ret void
+}
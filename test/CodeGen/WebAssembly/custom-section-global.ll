@@ -0,0 +1,31 @@
+; RUN: llc -filetype=obj %s -o - | obj2yaml | FileCheck %s
+
+; Globals placed in a ".custom_section." section are emitted as the contents
+; of a custom section rather than as a data segment.
+
+target triple = "wasm32-unknown-unknown"
+
+@counter = hidden global i32 0, align 4
+@desc = private constant <{ i32, i32 }> <{ i32 7, i32 ptrtoint (i32* @counter to i32) }>, section ".custom_section.my_desc", align 1
+@llvm.used = appending global [1 x i8*] [i8* bitcast (<{ i32, i32 }>* @desc to i8*)], section "llvm.metadata"
+
+; CHECK:        - Type:            DATA{{$}}
+; CHECK-NEXT:     Segments:
+; CHECK-NEXT:       - SectionOffset:   6
+; CHECK-NEXT:         InitFlags:       0
+; CHECK-NEXT:         Offset:
+; CHECK-NEXT:           Opcode:          I32_CONST
+; CHECK-NEXT:           Value:           0
+; CHECK-NEXT:         Content:         '00000000'
+; CHECK-NEXT:   - Type:            CUSTOM
+; CHECK-NEXT:     Relocations:
+; CHECK-NEXT:       - Type:            R_WASM_MEMORY_ADDR_I32
+; CHECK-NEXT:         Index:           0
+; CHECK-NEXT:         Offset:          0x00000004
+; CHECK-NEXT:     Name:            my_desc
+; CHECK-NEXT:     Payload:         '0700000000000000'
+; CHECK:          SymbolTable:
+; CHECK-NEXT:       - Index:           0
+; CHECK-NEXT:         Kind:            DATA
+; CHECK-NEXT:         Name:            counter
+; CHECK-NOT:        - Index:           1
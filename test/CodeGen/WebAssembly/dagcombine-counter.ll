@@ -0,0 +1,24 @@
+; RUN: llc < %s -asm-verbose=false -disable-wasm-fallthrough-return-opt \
+; RUN:   -wasm-disable-explicit-locals -wasm-keep-registers \
+; RUN:   | FileCheck %s --check-prefix=ALL
+; RUN: llc < %s -asm-verbose=false -disable-wasm-fallthrough-return-opt \
+; RUN:   -wasm-disable-explicit-locals -wasm-keep-registers \
+; RUN:   -debug-counter=dagcombine-skip=1000000 \
+; RUN:   | FileCheck %s --check-prefix=NONE
+; REQUIRES: asserts
+
+; Test that the dagcombine debug counter controls which nodes are combined.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; ALL-LABEL: sub_self:
+; ALL:       i32.const $push[[R:[0-9]+]]=, 0{{$}}
+; ALL-NEXT:  return $pop[[R]]{{$}}
+; NONE-LABEL: sub_self:
+; NONE:       i32.sub $push[[R:[0-9]+]]=, $0, $0{{$}}
+; NONE-NEXT:  return $pop[[R]]{{$}}
+define i32 @sub_self(i32 %x) {
+  %r = sub i32 %x, %x
+  ret i32 %r
+}
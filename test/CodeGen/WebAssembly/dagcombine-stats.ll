@@ -0,0 +1,16 @@
+; RUN: llc < %s -asm-verbose=false -combiner-stats -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s
+
+; Test that -combiner-stats reports the combines that fire.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; CHECK: ... DAG combine statistics ...
+; CHECK: Visits   Combined     Time (s)  Node
+; CHECK: {{^ +[0-9]+ +[1-9][0-9]* +[0-9]+\.[0-9]+}}  sub{{$}}
+; CHECK: Total{{$}}
+define i32 @sub_self(i32 %x) {
+  %r = sub i32 %x, %x
+  ret i32 %r
+}
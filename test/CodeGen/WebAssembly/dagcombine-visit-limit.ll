@@ -0,0 +1,28 @@
+; RUN: llc < %s -stats -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEFAULT
+; RUN: llc < %s -stats -combiner-max-node-visits=1 -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=LIMIT1
+; RUN: llc < %s -stats -combiner-max-node-visits=3 -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=LIMIT3
+; REQUIRES: asserts
+
+; Test that -combiner-max-node-visits stops the DAG combiner from revisiting a
+; node once it has been combined that many times, and that the default limit
+; is not reached by ordinary code.
+
+; DEFAULT-NOT: reached the visit limit
+; LIMIT1: 5 dagcombine - Number of nodes no longer combined because they reached the visit limit
+; LIMIT3: 1 dagcombine - Number of nodes no longer combined because they reached the visit limit
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; Folding the chain of adds into one requeues the users of every folded node.
+define i32 @chain(i32 %x) {
+  %a = add i32 %x, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = shl i32 %c, 2
+  %e = and i32 %d, 252
+  ret i32 %e
+}
@@ -0,0 +1,100 @@
+; RUN: llc < %s -asm-verbose=false -disable-wasm-fallthrough-return-opt -wasm-keep-registers | FileCheck %s
+; RUN: llc < %s -asm-verbose=false -disable-wasm-fallthrough-return-opt -wasm-keep-registers -enable-shrink-wrap=false | FileCheck %s --check-prefix=NOSW
+
+; Test that the stack pointer is only set up on the paths that use the frame.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+@counter = global i32 0
+@escaped = global i32* null
+
+declare void @report(i8*)
+declare void @use()
+
+; The fast path loads and stores globals and arguments, which cannot be in the
+; frame, so only the error path sets up and tears down the stack pointer.
+; CHECK-LABEL: error_path_frame:
+; CHECK-NOT:   __stack_pointer
+; CHECK:       br_if
+; CHECK-NOT:   __stack_pointer
+; CHECK:       i32.load {{.*}}counter
+; CHECK-NOT:   __stack_pointer
+; CHECK:       return
+; CHECK:       global.get $push{{.+}}=, __stack_pointer{{$}}
+; CHECK:       global.set __stack_pointer,
+; CHECK:       call report,
+; CHECK:       global.set __stack_pointer,
+; CHECK:       end_function
+
+; NOSW-LABEL: error_path_frame:
+; NOSW-NOT:   br_if
+; NOSW:       global.get $push{{.+}}=, __stack_pointer{{$}}
+; NOSW:       br_if
+define i32 @error_path_frame(i32* %p, i32 %n) {
+entry:
+  %buf = alloca [32 x i8]
+  %bad = icmp slt i32 %n, 0
+  br i1 %bad, label %error, label %ok
+
+ok:
+  %v = load i32, i32* %p
+  %c = load i32, i32* @counter
+  %inc = add i32 %c, %v
+  store i32 %inc, i32* @counter
+  ret i32 %inc
+
+error:
+  %b = getelementptr inbounds [32 x i8], [32 x i8]* %buf, i32 0, i32 0
+  store i8 0, i8* %b
+  call void @report(i8* %b)
+  ret i32 -1
+}
+
+; A load through a pointer of unknown origin may read the frame, so it keeps
+; the frame set up in the entry block.
+; CHECK-LABEL: unknown_pointer:
+; CHECK-NOT:   br_if
+; CHECK:       global.get $push{{.+}}=, __stack_pointer{{$}}
+; CHECK:       br_if
+define i32 @unknown_pointer(i32** %pp, i32 %n) {
+entry:
+  %buf = alloca [32 x i8]
+  %p = load i32*, i32** %pp
+  %bad = icmp slt i32 %n, 0
+  br i1 %bad, label %error, label %ok
+
+ok:
+  %v = load i32, i32* %p
+  ret i32 %v
+
+error:
+  %b = getelementptr inbounds [32 x i8], [32 x i8]* %buf, i32 0, i32 0
+  call void @report(i8* %b)
+  ret i32 -1
+}
+
+; The address of %a escapes through a global in %t, and the call in %e may
+; read it, so the frame must be live in both blocks.
+; CHECK-LABEL: escaped_then_call:
+; CHECK-NOT:   br_if
+; CHECK:       global.get $push{{.+}}=, __stack_pointer{{$}}
+; CHECK:       br_if
+; CHECK:       i32.store escaped
+; CHECK-NOT:   __stack_pointer
+; CHECK:       call use{{$}}
+; CHECK:       global.set __stack_pointer,
+; CHECK:       end_function
+define void @escaped_then_call(i1 %c) {
+entry:
+  %a = alloca i32
+  br i1 %c, label %t, label %e
+
+t:
+  store i32* %a, i32** @escaped
+  br label %e
+
+e:
+  call void @use()
+  ret void
+}
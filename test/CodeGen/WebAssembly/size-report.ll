@@ -0,0 +1,138 @@
+; RUN: llc < %s -filetype=obj -mc-size-report=%t.json \
+; RUN:   -pass-remarks-output=%t.yaml -o /dev/null
+; RUN: FileCheck %s < %t.json
+; RUN: FileCheck %s --check-prefix=YAML < %t.yaml
+; RUN: not llc < %s -mc-size-report=%t.json -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=ASM
+
+; Test that -mc-size-report attributes the bytes of the object file to
+; functions, opcodes, source locations, the passes that inserted the
+; instructions and Wasm specific encodings, and that it emits the sizes as
+; remarks.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; ASM: error: -mc-size-report requires object file output
+
+declare void @ext()
+
+define i32 @add(i32 %a, i32 %b) !dbg !7 {
+  call void @ext(), !dbg !10
+  %s = add i32 %a, %b, !dbg !10
+  %r = add i32 %s, 100, !dbg !10
+  ret i32 %r, !dbg !10
+}
+
+!0 = !{ !"red", !"foo" }
+!wasm.custom_sections = !{ !0 }
+
+!llvm.module.flags = !{!4}
+!4 = !{i32 2, !"Debug Info Version", i32 3}
+
+!llvm.dbg.cu = !{!5}
+!5 = distinct !DICompileUnit(language: DW_LANG_C99, file: !6, emissionKind: LineTablesOnly)
+!6 = !DIFile(filename: "size.c", directory: "/src")
+!7 = distinct !DISubprogram(name: "add", scope: !6, file: !6, line: 2, type: !8, spFlags: DISPFlagDefinition, unit: !5)
+!8 = !DISubroutineType(types: !9)
+!9 = !{}
+!10 = !DILocation(line: 3, column: 7, scope: !7)
+
+; CHECK:      "sections": [
+; CHECK:          "name": ".custom_section.red",
+; CHECK-NEXT:     "kind": "metadata",
+; CHECK-NEXT:     "size": 3
+
+; The function body is the locals declaration and 16 bytes of instructions:
+; call (6), two local.get (2 each), two i32.add (1 each), i32.const (3) and
+; end_function (1).
+; CHECK:      "functions": [
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "name": "add",
+; CHECK-NEXT:     "size": 17,
+; CHECK-NEXT:     "instructions": 7,
+; CHECK-NEXT:     "instructionSize": 16
+
+; CHECK:      "opcodes": [
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "name": "CALL_VOID",
+; CHECK-NEXT:     "count": 1,
+; CHECK-NEXT:     "size": 6
+
+; The call and the adds come from instruction selection, the local.gets from
+; explicit locals and end_function from CFG stackify.
+; CHECK:      "passes": [
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "name": "WebAssembly Instruction Selection",
+; CHECK-NEXT:     "count": 4,
+; CHECK-NEXT:     "size": 11
+; CHECK-NEXT:   },
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "name": "WebAssembly Explicit Locals",
+; CHECK-NEXT:     "count": 2,
+; CHECK-NEXT:     "size": 4
+; CHECK-NEXT:   },
+; CHECK-NEXT:   {
+; CHECK-NEXT:     "name": "WebAssembly CFG Stackify",
+; CHECK-NEXT:     "count": 1,
+; CHECK-NEXT:     "size": 1
+
+; CHECK:      "locations": [
+; CHECK:          "file": "size.c",
+; CHECK-NEXT:     "line": 3,
+
+; CHECK:      "target": {
+; CHECK-NEXT:   "leb-width": [
+; CHECK-NEXT:     {
+; CHECK-NEXT:       "name": "padded:5",
+; CHECK-NEXT:       "count": 1,
+; CHECK-NEXT:       "size": 5
+; CHECK-NEXT:     },
+; CHECK-NEXT:     {
+; CHECK-NEXT:       "name": "sleb:2",
+; CHECK-NEXT:       "count": 1,
+; CHECK-NEXT:       "size": 2
+; CHECK-NEXT:     },
+; CHECK-NEXT:     {
+; CHECK-NEXT:       "name": "uleb:1",
+; CHECK-NEXT:       "count": 2,
+; CHECK-NEXT:       "size": 2
+; CHECK-NEXT:     }
+; CHECK-NEXT:   ],
+; CHECK-NEXT:   "locals": [
+; CHECK-NEXT:     {
+; CHECK-NEXT:       "name": "add",
+; CHECK-NEXT:       "count": 0,
+; CHECK-NEXT:       "size": 1
+
+; YAML:      Pass:            size-report
+; YAML-NEXT: Name:            FunctionSize
+; YAML:      Function:        add
+; YAML-NEXT: Args:
+; YAML-NEXT:   - Bytes:           '17'
+; YAML-NEXT:   - String:          ' bytes, '
+; YAML-NEXT:   - InstructionBytes: '16'
+; YAML-NEXT:   - String:          ' of them in '
+; YAML-NEXT:   - Instructions:    '7'
+; YAML-NEXT:   - String:          ' instructions'
+; YAML:      Pass:            size-report
+; YAML-NEXT: Name:            InstructionSize
+; YAML-NEXT: DebugLoc:        { File: size.c, Line: 3, Column: 7 }
+; YAML-NEXT: Function:        add
+; YAML-NEXT: Args:
+; YAML-NEXT:   - Bytes:           '13'
+; YAML-NEXT:   - String:          ' bytes in '
+; YAML-NEXT:   - Instructions:    '6'
+; YAML-NEXT:   - String:          ' instructions'
+; YAML-NEXT:   - String:          '; '
+; YAML-NEXT:   - Pass:            WebAssembly Instruction Selection
+; YAML-NEXT:   - String:          ': '
+; YAML-NEXT:   - PassBytes:       '8'
+; YAML-NEXT:   - String:          '; '
+; YAML-NEXT:   - Pass:            WebAssembly Explicit Locals
+; YAML-NEXT:   - String:          ': '
+; YAML-NEXT:   - PassBytes:       '4'
+; YAML-NEXT:   - String:          '; '
+; YAML-NEXT:   - Pass:            WebAssembly CFG Stackify
+; YAML-NEXT:   - String:          ': '
+; YAML-NEXT:   - PassBytes:       '1'
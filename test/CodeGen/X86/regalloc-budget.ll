@@ -0,0 +1,52 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -verify-machineinstrs \
+; RUN:   -pass-remarks-analysis=regalloc -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=FULL --allow-empty
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -verify-machineinstrs \
+; RUN:   -pass-remarks-analysis=regalloc -regalloc-budget-reduced=1 \
+; RUN:   -o /dev/null 2>&1 | FileCheck %s --check-prefix=REDUCED
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -verify-machineinstrs \
+; RUN:   -pass-remarks-analysis=regalloc -regalloc-budget-minimal=1 \
+; RUN:   -o /dev/null 2>&1 | FileCheck %s --check-prefix=MINIMAL
+
+; Test that the greedy allocator reduces its effort on functions that exceed
+; the complexity budget, and says so in a remark.
+
+; FULL-NOT: reduced register allocation effort
+; REDUCED: remark: {{.*}} reduced register allocation effort: {{[0-9]+}} live segments exceed the budget of 1; region splitting is disabled and live ranges are evicted at most 4 times
+; MINIMAL: remark: {{.*}} reduced register allocation effort: {{[0-9]+}} live segments exceed the budget of 1; only live ranges local to a block are split and live ranges are evicted at most 4 times
+
+declare void @clobber()
+
+define i32 @pressure(i32* %p, i1 %c) {
+entry:
+  %p1 = getelementptr i32, i32* %p, i64 1
+  %p2 = getelementptr i32, i32* %p, i64 2
+  %p3 = getelementptr i32, i32* %p, i64 3
+  %p4 = getelementptr i32, i32* %p, i64 4
+  %p5 = getelementptr i32, i32* %p, i64 5
+  %p6 = getelementptr i32, i32* %p, i64 6
+  %p7 = getelementptr i32, i32* %p, i64 7
+  %v0 = load volatile i32, i32* %p
+  %v1 = load volatile i32, i32* %p1
+  %v2 = load volatile i32, i32* %p2
+  %v3 = load volatile i32, i32* %p3
+  %v4 = load volatile i32, i32* %p4
+  %v5 = load volatile i32, i32* %p5
+  %v6 = load volatile i32, i32* %p6
+  %v7 = load volatile i32, i32* %p7
+  br i1 %c, label %call, label %exit
+
+call:
+  call void @clobber()
+  br label %exit
+
+exit:
+  %s1 = add i32 %v0, %v1
+  %s2 = add i32 %s1, %v2
+  %s3 = add i32 %s2, %v3
+  %s4 = add i32 %s3, %v4
+  %s5 = add i32 %s4, %v5
+  %s6 = add i32 %s5, %v6
+  %s7 = add i32 %s6, %v7
+  ret i32 %s7
+}
@@ -0,0 +1,66 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -regalloc=linearscan \
+; RUN:   -verify-machineinstrs | FileCheck %s
+
+; Test that the linear scan allocator assigns free registers, keeps values
+; live across a call in callee-saved registers, spills when it runs out of
+; them, and copes with registers whose live interval is empty.
+
+declare void @clobber()
+
+; CHECK-LABEL: no_pressure:
+; CHECK-NOT:   Spill
+; CHECK:       leal (%rdi,%rsi), %eax
+; CHECK-NEXT:  retq
+define i32 @no_pressure(i32 %a, i32 %b) {
+  %s = add i32 %a, %b
+  ret i32 %s
+}
+
+; Eight i32 values and the pointer are live across the call to clobber, but
+; only six callee-saved registers are available, so three values are spilled
+; to 4-byte slots. Storing them keeps the reloads from being folded.
+; CHECK-LABEL: pressure:
+; CHECK:       4-byte Spill
+; CHECK:       4-byte Spill
+; CHECK:       4-byte Spill
+; CHECK:       callq clobber
+; CHECK:       4-byte Reload
+; CHECK:       4-byte Reload
+; CHECK:       4-byte Reload
+; CHECK:       retq
+define void @pressure(i32* %p) {
+  %p1 = getelementptr i32, i32* %p, i64 1
+  %p2 = getelementptr i32, i32* %p, i64 2
+  %p3 = getelementptr i32, i32* %p, i64 3
+  %p4 = getelementptr i32, i32* %p, i64 4
+  %p5 = getelementptr i32, i32* %p, i64 5
+  %p6 = getelementptr i32, i32* %p, i64 6
+  %p7 = getelementptr i32, i32* %p, i64 7
+  %v0 = load volatile i32, i32* %p
+  %v1 = load volatile i32, i32* %p1
+  %v2 = load volatile i32, i32* %p2
+  %v3 = load volatile i32, i32* %p3
+  %v4 = load volatile i32, i32* %p4
+  %v5 = load volatile i32, i32* %p5
+  %v6 = load volatile i32, i32* %p6
+  %v7 = load volatile i32, i32* %p7
+  call void @clobber()
+  store volatile i32 %v0, i32* %p
+  store volatile i32 %v1, i32* %p
+  store volatile i32 %v2, i32* %p
+  store volatile i32 %v3, i32* %p
+  store volatile i32 %v4, i32* %p
+  store volatile i32 %v5, i32* %p
+  store volatile i32 %v6, i32* %p
+  store volatile i32 %v7, i32* %p
+  ret void
+}
+
+; The address is an undef register with an empty live interval.
+; CHECK-LABEL: undef_address:
+; CHECK:       movl %edi, (%rax)
+; CHECK-NEXT:  retq
+define void @undef_address(i32 %x) {
+  store i32 %x, i32* undef
+  ret void
+}
@@ -0,0 +1,53 @@
+;; Checks that WebAssembly modules describe their counters with a custom
+;; section instead of registering profile data with the runtime.
+
+; RUN: opt < %s -instrprof -S | FileCheck %s
+; RUN: opt < %s -passes=instrprof -S | FileCheck %s
+; RUN: opt < %s -instrprof -instrprof-wasm-layout=false -S | FileCheck %s -check-prefix=RUNTIME
+
+target triple = "wasm32-unknown-unknown"
+
+@__profn_foo = hidden constant [3 x i8] c"foo"
+@__profn_bar = private constant [3 x i8] c"bar"
+
+; CHECK: @__profc_foo = hidden global [2 x i64] zeroinitializer, section "__llvm_prf_cnts", align 8
+; CHECK-NOT: @__profd_foo
+; CHECK: @__profc_bar = private global [1 x i64] zeroinitializer, section "__llvm_prf_cnts", align 8
+; CHECK-NOT: @__profd_bar
+; CHECK-NOT: @__llvm_prf_nm
+; CHECK: @__llvm_prf_layout_desc = private constant <{ i64, i32, i32, [2 x <{ i64, i64, i32, i32 }>], [{{[0-9]+}} x i8] }> <{ i64 1, i32 2, i32 {{[0-9]+}},
+; CHECK-SAME: <{ i64 6699318081062747564, i64 7, i32 ptrtoint ([2 x i64]* @__profc_foo to i32), i32 2 }>
+; CHECK-SAME: <{ i64 -2012135647395072713, i64 9, i32 ptrtoint ([1 x i64]* @__profc_bar to i32), i32 1 }>
+; CHECK-SAME: section ".custom_section.__llvm_prf_layout", align 1
+; CHECK: @llvm.used = appending global [1 x i8*] [i8* bitcast ({{.*}}* @__llvm_prf_layout_desc to i8*)]
+; CHECK-NOT: @llvm.global_ctors
+
+; RUNTIME: @__llvm_profile_runtime = external global i32
+; RUNTIME: @__profd_foo = hidden global
+; RUNTIME: @__llvm_prf_nm = private constant
+; RUNTIME-NOT: __llvm_prf_layout
+
+define void @foo(void ()* %f) {
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_foo, i32 0, i32 0), i64 7, i32 2, i32 0)
+  %t = ptrtoint void ()* %f to i64
+;; Value profiles have nowhere to go without the runtime.
+; CHECK-LABEL: define void @foo
+; CHECK-NOT: __llvm_profile_instrument_target
+; CHECK: call void %f()
+  call void @llvm.instrprof.value.profile(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_foo, i32 0, i32 0), i64 7, i64 %t, i32 0, i32 0)
+  call void %f()
+  ret void
+}
+
+define void @bar() {
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 9, i32 1, i32 0)
+  ret void
+}
+
+; CHECK-NOT: define {{.*}} @__llvm_profile_runtime_user
+; CHECK-NOT: define {{.*}} @__llvm_profile_register_functions
+; CHECK-NOT: define {{.*}} @__llvm_profile_init
+; RUNTIME: define internal void @__llvm_profile_register_functions()
+
+declare void @llvm.instrprof.increment(i8*, i64, i32, i32)
+declare void @llvm.instrprof.value.profile(i8*, i64, i64, i32, i32)
@@ -0,0 +1,25 @@
+// RUN: llvm-mc -filetype=obj -triple x86_64-pc-linux-gnu %s -o - \
+// RUN:   | llvm-readobj -S --sd | FileCheck %s
+
+// Test that a section whose fragments depend on the layout of another section
+// is laid out again when that section is relaxed. .text is laid out first,
+// while the jump in .text.b is still short, so the difference fits in one byte
+// until the jump is relaxed.
+
+	.text
+	.uleb128 mid - start
+	.byte 0xff
+
+	.section .text.b,"ax",@progbits
+start:
+	jmp end
+	.fill 123, 1, 0x90
+mid:
+	.fill 10, 1, 0x90
+end:
+	ret
+
+// CHECK:      Name: .text
+// CHECK:      SectionData (
+// CHECK-NEXT:   0000: 8001FF
+// CHECK-NEXT: )
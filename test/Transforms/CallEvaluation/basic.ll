@@ -0,0 +1,91 @@
+; RUN: opt -call-evaluation -S < %s | FileCheck %s
+; RUN: opt -passes=call-evaluation -S < %s | FileCheck %s
+; RUN: opt -call-evaluation -call-evaluation-max-steps=20 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=BUDGET
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+@.str = private unnamed_addr constant [9 x i8] c"transfer\00", align 1
+@mutable = global i64 42, align 8
+
+; Encode a NUL-terminated string by shifting in each character.
+define internal i64 @encode(i8* %s) readonly {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %body ]
+  %acc = phi i64 [ 0, %entry ], [ %acc.next, %body ]
+  %p = getelementptr inbounds i8, i8* %s, i32 %i
+  %c = load i8, i8* %p, align 1
+  %done = icmp eq i8 %c, 0
+  br i1 %done, label %exit, label %body
+
+body:
+  %cz = zext i8 %c to i64
+  %shl = shl i64 %acc, 5
+  %acc.next = xor i64 %shl, %cz
+  %i.next = add i32 %i, 1
+  br label %loop
+
+exit:
+  ret i64 %acc
+}
+
+define internal i64 @mix(i64 %v) readnone {
+  %mul = mul i64 %v, 31
+  %add = add i64 %mul, 7
+  ret i64 %add
+}
+
+define internal i64 @read_mutable(i64 %v) readonly {
+  %g = load i64, i64* @mutable, align 8
+  %add = add i64 %g, %v
+  ret i64 %add
+}
+
+define internal i64 @write_mutable(i64 %v) {
+  store i64 %v, i64* @mutable, align 8
+  ret i64 %v
+}
+
+; The loop is evaluated, and the result feeds a second call that becomes
+; evaluable once the first one is replaced.
+;
+; CHECK-LABEL: @literal(
+; CHECK-NEXT: ret i64 127321456149877
+; BUDGET-LABEL: @literal(
+; BUDGET: call i64 @encode(
+define i64 @literal() {
+  %n = call i64 @encode(i8* getelementptr inbounds ([9 x i8], [9 x i8]* @.str, i32 0, i32 0))
+  %h = call i64 @mix(i64 %n)
+  ret i64 %h
+}
+
+; The value of a mutable global depends on when the call executes.
+;
+; CHECK-LABEL: @reads_mutable(
+; CHECK: call i64 @read_mutable(i64 1)
+define i64 @reads_mutable() {
+  %r = call i64 @read_mutable(i64 1)
+  ret i64 %r
+}
+
+; Calls with side effects are left alone.
+;
+; CHECK-LABEL: @writes_mutable(
+; CHECK: call i64 @write_mutable(i64 1)
+define i64 @writes_mutable() {
+  %r = call i64 @write_mutable(i64 1)
+  ret i64 %r
+}
+
+; Non-constant arguments.
+;
+; CHECK-LABEL: @non_constant(
+; CHECK: call i64 @mix(i64 %v)
+define i64 @non_constant(i64 %v) {
+  %r = call i64 @mix(i64 %v)
+  ret i64 %r
+}
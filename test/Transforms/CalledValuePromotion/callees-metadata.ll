@@ -0,0 +1,65 @@
+; RUN: opt -called-value-promotion -S < %s | FileCheck %s
+; RUN: opt -passes=called-value-promotion -S < %s | FileCheck %s
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; A call site with two known targets is promoted to a single guarded direct
+; call followed by an unconditional call to the remaining target.
+;
+; CHECK-LABEL: @two_targets(
+; CHECK: [[CMP:%.*]] = icmp eq void ()* %fp, @callee_a
+; CHECK: br i1 [[CMP]]
+; CHECK: call void @callee_a(){{$}}
+; CHECK: call void @callee_b(){{$}}
+; CHECK-NOT: call void %fp
+; CHECK: ret void
+define void @two_targets(void ()* %fp) {
+entry:
+  call void %fp(), !callees !0
+  ret void
+}
+
+; Return values of the promoted calls are merged with a phi.
+;
+; CHECK-LABEL: @returns_value(
+; CHECK: icmp eq i32 (i32)* %fp, @inc
+; CHECK: [[A:%.*]] = call i32 @inc(i32 %x)
+; CHECK: [[B:%.*]] = call i32 @dec(i32 %x)
+; CHECK: phi i32 [ [[B]], %{{.*}} ], [ [[A]], %{{.*}} ]
+define i32 @returns_value(i32 (i32)* %fp, i32 %x) {
+entry:
+  %r = call i32 %fp(i32 %x), !callees !1
+  ret i32 %r
+}
+
+; A single target needs no guard at all.
+;
+; CHECK-LABEL: @one_target(
+; CHECK-NOT: icmp
+; CHECK: call void @callee_a(){{$}}
+; CHECK-NEXT: ret void
+define void @one_target(void ()* %fp) {
+entry:
+  call void %fp(), !callees !2
+  ret void
+}
+
+; Call sites without metadata and without a constant table are left alone.
+;
+; CHECK-LABEL: @unknown(
+; CHECK: call void %fp()
+define void @unknown(void ()* %fp) {
+entry:
+  call void %fp()
+  ret void
+}
+
+declare void @callee_a()
+declare void @callee_b()
+declare i32 @inc(i32)
+declare i32 @dec(i32)
+
+!0 = !{void ()* @callee_a, void ()* @callee_b}
+!1 = !{i32 (i32)* @inc, i32 (i32)* @dec}
+!2 = !{void ()* @callee_a}
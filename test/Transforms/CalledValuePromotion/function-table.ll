@@ -0,0 +1,94 @@
+; RUN: opt -called-value-promotion -S < %s | FileCheck %s
+; RUN: opt -called-value-promotion -cvpromote-max-targets=1 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=LIMIT
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+%struct.visitor = type { i32, void (i8*)* }
+
+; A dispatch table of function pointers.
+@table = internal constant [2 x void (i8*)*] [void (i8*)* @visit_a, void (i8*)* @visit_b]
+
+; A table with a null entry, which is not a known callee.
+@nullable = internal constant [3 x void (i8*)*] [void (i8*)* @visit_a, void (i8*)* @visit_b, void (i8*)* null]
+
+; A table of structs mixing integer tags and function pointers.
+@visitors = internal constant [2 x %struct.visitor] [%struct.visitor { i32 1, void (i8*)* @visit_a }, %struct.visitor { i32 2, void (i8*)* @visit_a }]
+
+; A table that is writable cannot be trusted.
+@mutable = internal global [2 x void (i8*)*] [void (i8*)* @visit_a, void (i8*)* @visit_b]
+
+; A table containing a pointer to something other than a function is opaque.
+@data = internal global i32 0
+@mixed = internal constant [2 x i8*] [i8* bitcast (void (i8*)* @visit_a to i8*), i8* bitcast (i32* @data to i8*)]
+
+; CHECK-LABEL: @dispatch(
+; CHECK: icmp eq void (i8*)* %fp, @visit_a
+; CHECK: call void @visit_a(i8* %p)
+; CHECK: call void @visit_b(i8* %p)
+; CHECK-NOT: call void %fp
+; LIMIT-LABEL: @dispatch(
+; LIMIT: call void %fp(i8* %p)
+define void @dispatch(i32 %i, i8* %p) {
+entry:
+  %slot = getelementptr inbounds [2 x void (i8*)*], [2 x void (i8*)*]* @table, i32 0, i32 %i
+  %fp = load void (i8*)*, void (i8*)** %slot
+  call void %fp(i8* %p)
+  ret void
+}
+
+; CHECK-LABEL: @dispatch_nullable(
+; CHECK: icmp eq void (i8*)* %fp, @visit_a
+; CHECK: call void @visit_a(i8* %p)
+; CHECK: icmp eq void (i8*)* %fp, @visit_b
+; CHECK: call void @visit_b(i8* %p)
+; CHECK: call void %fp(i8* %p)
+define void @dispatch_nullable(i32 %i, i8* %p) {
+entry:
+  %slot = getelementptr inbounds [3 x void (i8*)*], [3 x void (i8*)*]* @nullable, i32 0, i32 %i
+  %fp = load void (i8*)*, void (i8*)** %slot
+  call void %fp(i8* %p)
+  ret void
+}
+
+; The integer tags may be loaded as function pointers too, so the indirect call
+; is kept.
+; CHECK-LABEL: @dispatch_struct(
+; CHECK: icmp eq void (i8*)* %fp, @visit_a
+; CHECK: call void @visit_a(i8* %p)
+; CHECK: call void %fp(i8* %p)
+; LIMIT-LABEL: @dispatch_struct(
+; LIMIT: call void @visit_a(i8* %p)
+; LIMIT: call void %fp(i8* %p)
+define void @dispatch_struct(i32 %i, i8* %p) {
+entry:
+  %slot = getelementptr inbounds [2 x %struct.visitor], [2 x %struct.visitor]* @visitors, i32 0, i32 %i, i32 1
+  %fp = load void (i8*)*, void (i8*)** %slot
+  call void %fp(i8* %p)
+  ret void
+}
+
+; CHECK-LABEL: @dispatch_mutable(
+; CHECK: call void %fp(i8* %p)
+define void @dispatch_mutable(i32 %i, i8* %p) {
+entry:
+  %slot = getelementptr inbounds [2 x void (i8*)*], [2 x void (i8*)*]* @mutable, i32 0, i32 %i
+  %fp = load void (i8*)*, void (i8*)** %slot
+  call void %fp(i8* %p)
+  ret void
+}
+
+; CHECK-LABEL: @dispatch_mixed(
+; CHECK: call void %fp(i8* %p)
+define void @dispatch_mixed(i32 %i, i8* %p) {
+entry:
+  %slot = getelementptr inbounds [2 x i8*], [2 x i8*]* @mixed, i32 0, i32 %i
+  %raw = load i8*, i8** %slot
+  %fp = bitcast i8* %raw to void (i8*)*
+  call void %fp(i8* %p)
+  ret void
+}
+
+declare void @visit_a(i8*)
+declare void @visit_b(i8*)
@@ -0,0 +1,20 @@
+; RUN: opt -O2 -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=SPLIT
+; RUN: opt -Os -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=SPLIT
+; RUN: opt -Oz -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOSPLIT
+; RUN: opt -O1 -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOSPLIT
+
+; Hot/cold splitting is enabled by default for WebAssembly at -O2 and -Os.
+
+; SPLIT: Hot Cold Splitting
+; NOSPLIT-NOT: Hot Cold Splitting
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+define void @f() {
+  ret void
+}
@@ -0,0 +1,79 @@
+; RUN: opt -hotcoldsplit -hotcoldsplit-threshold=0 -S < %s | FileCheck %s
+; RUN: opt -hotcoldsplit -hotcoldsplit-threshold=0 \
+; RUN:   -hotcoldsplit-assert-functions= -S < %s | FileCheck %s --check-prefix=OFF
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+@.msg = private unnamed_addr constant [15 x i8] c"missing auth: \00", align 1
+
+; The failure path of an inlined check(), including the code building its
+; message, is outlined.
+
+; CHECK-LABEL: define {{.*}}@failed_check(
+; CHECK: call {{.*}}@failed_check.cold.1(
+; OFF-LABEL: define {{.*}}@failed_check(
+; OFF-NOT: failed_check.cold.1
+define void @failed_check(i32 %cond, i8* %buf) {
+entry:
+  %ok = icmp ne i32 %cond, 0
+  br i1 %ok, label %exit, label %fail
+
+fail:
+  call void @build_message(i8* %buf, i8* getelementptr inbounds ([15 x i8], [15 x i8]* @.msg, i32 0, i32 0))
+  call void @eosio_assert(i32 0, i8* %buf)
+  br label %exit
+
+exit:
+  call void @sideeffect()
+  ret void
+}
+
+; An assertion with a condition that isn't known to fail is not cold.
+
+; CHECK-LABEL: define {{.*}}@unknown_condition(
+; CHECK-NOT: unknown_condition.cold.1
+define void @unknown_condition(i32 %cond, i32 %x) {
+entry:
+  %ok = icmp ne i32 %x, 0
+  br i1 %ok, label %then, label %exit
+
+then:
+  call void @sideeffect()
+  call void @eosio_assert(i32 %cond, i8* getelementptr inbounds ([15 x i8], [15 x i8]* @.msg, i32 0, i32 0))
+  br label %exit
+
+exit:
+  ret void
+}
+
+; Calls to noreturn assertion functions are cold.
+
+; CHECK-LABEL: define {{.*}}@noreturn_abort(
+; CHECK: call {{.*}}@noreturn_abort.cold.1(
+define void @noreturn_abort(i32 %x) {
+entry:
+  %ok = icmp ne i32 %x, 0
+  br i1 %ok, label %exit, label %fail
+
+fail:
+  call void @sideeffect()
+  call void @abort()
+  unreachable
+
+exit:
+  ret void
+}
+
+; The outlined functions are added at the end of the module.
+
+; CHECK-LABEL: define {{.*}}@failed_check.cold.1(
+; CHECK: call void @build_message(
+; CHECK: call void @eosio_assert(i32 0,
+; CHECK-LABEL: define {{.*}}@noreturn_abort.cold.1(
+; CHECK: call void @abort()
+
+declare void @build_message(i8*, i8*)
+declare void @eosio_assert(i32, i8*)
+declare void @sideeffect()
+declare void @abort() noreturn nounwind
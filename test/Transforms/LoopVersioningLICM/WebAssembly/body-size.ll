@@ -0,0 +1,117 @@
+; RUN: opt -O2 -debug-only=loop-versioning-licm -disable-output < %s 2>&1 \
+; RUN:   | FileCheck %s
+; RUN: opt -O2 -debug-only=loop-versioning-licm -disable-output \
+; RUN:   -licm-versioning-max-body-size=0 < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOLIMIT
+; REQUIRES: asserts
+
+; WebAssembly only versions loops of up to 64 instructions for LICM, unless
+; -licm-versioning-max-body-size says otherwise.
+
+; CHECK: Loop Versioning found to be beneficial
+; CHECK: Loop body size 71 is more than threshold
+; NOLIMIT: Loop Versioning found to be beneficial
+; NOLIMIT: Loop Versioning found to be beneficial
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+define void @small(i32* %dst, i32* %src, i32 %n) {
+entry:
+  %cmp0 = icmp eq i32 %n, 0
+  br i1 %cmp0, label %exit, label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %p = getelementptr inbounds i32, i32* %dst, i32 %i
+  %v = load i32, i32* %src, align 4
+  store i32 %v, i32* %p, align 4
+  %inc = add nuw i32 %i, 1
+  %cmp = icmp ult i32 %inc, %n
+  br i1 %cmp, label %body, label %exit
+
+exit:
+  ret void
+}
+
+define void @large(i32* %dst, i32* %src, i32 %n) {
+entry:
+  %cmp0 = icmp eq i32 %n, 0
+  br i1 %cmp0, label %exit, label %body
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %p = getelementptr inbounds i32, i32* %dst, i32 %i
+  %v = load i32, i32* %src, align 4
+  %m0 = mul i32 %v, %i
+  %x0 = xor i32 %m0, 3
+  %m1 = mul i32 %x0, %i
+  %x1 = xor i32 %m1, 10
+  %m2 = mul i32 %x1, %i
+  %x2 = xor i32 %m2, 17
+  %m3 = mul i32 %x2, %i
+  %x3 = xor i32 %m3, 24
+  %m4 = mul i32 %x3, %i
+  %x4 = xor i32 %m4, 31
+  %m5 = mul i32 %x4, %i
+  %x5 = xor i32 %m5, 38
+  %m6 = mul i32 %x5, %i
+  %x6 = xor i32 %m6, 45
+  %m7 = mul i32 %x6, %i
+  %x7 = xor i32 %m7, 52
+  %m8 = mul i32 %x7, %i
+  %x8 = xor i32 %m8, 59
+  %m9 = mul i32 %x8, %i
+  %x9 = xor i32 %m9, 66
+  %m10 = mul i32 %x9, %i
+  %x10 = xor i32 %m10, 73
+  %m11 = mul i32 %x10, %i
+  %x11 = xor i32 %m11, 80
+  %m12 = mul i32 %x11, %i
+  %x12 = xor i32 %m12, 87
+  %m13 = mul i32 %x12, %i
+  %x13 = xor i32 %m13, 94
+  %m14 = mul i32 %x13, %i
+  %x14 = xor i32 %m14, 101
+  %m15 = mul i32 %x14, %i
+  %x15 = xor i32 %m15, 108
+  %m16 = mul i32 %x15, %i
+  %x16 = xor i32 %m16, 115
+  %m17 = mul i32 %x16, %i
+  %x17 = xor i32 %m17, 122
+  %m18 = mul i32 %x17, %i
+  %x18 = xor i32 %m18, 129
+  %m19 = mul i32 %x18, %i
+  %x19 = xor i32 %m19, 136
+  %m20 = mul i32 %x19, %i
+  %x20 = xor i32 %m20, 143
+  %m21 = mul i32 %x20, %i
+  %x21 = xor i32 %m21, 150
+  %m22 = mul i32 %x21, %i
+  %x22 = xor i32 %m22, 157
+  %m23 = mul i32 %x22, %i
+  %x23 = xor i32 %m23, 164
+  %m24 = mul i32 %x23, %i
+  %x24 = xor i32 %m24, 171
+  %m25 = mul i32 %x24, %i
+  %x25 = xor i32 %m25, 178
+  %m26 = mul i32 %x25, %i
+  %x26 = xor i32 %m26, 185
+  %m27 = mul i32 %x26, %i
+  %x27 = xor i32 %m27, 192
+  %m28 = mul i32 %x27, %i
+  %x28 = xor i32 %m28, 199
+  %m29 = mul i32 %x28, %i
+  %x29 = xor i32 %m29, 206
+  %m30 = mul i32 %x29, %i
+  %x30 = xor i32 %m30, 213
+  %m31 = mul i32 %x30, %i
+  %x31 = xor i32 %m31, 220
+  store i32 %x31, i32* %p, align 4
+  %inc = add nuw i32 %i, 1
+  %cmp = icmp ult i32 %inc, %n
+  br i1 %cmp, label %body, label %exit
+
+exit:
+  ret void
+}
@@ -0,0 +1,21 @@
+; RUN: opt -O2 -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=VERSION
+; RUN: opt -O3 -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=VERSION
+; RUN: opt -Os -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOVERSION
+; RUN: opt -O1 -debug-pass=Structure < %s -o /dev/null 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=NOVERSION
+
+; Loop versioning for LICM is enabled by default for WebAssembly when not
+; optimizing for size.
+
+; VERSION: Loop Versioning for LICM
+; NOVERSION-NOT: Loop Versioning for LICM
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+define void @f() {
+  ret void
+}
@@ -0,0 +1,60 @@
+; RUN: opt < %s -loop-versioning-licm -debug-only=loop-versioning-licm \
+; RUN:   -disable-output 2>&1 | FileCheck %s
+; RUN: opt < %s -loop-versioning-licm -debug-only=loop-versioning-licm \
+; RUN:   -licm-versioning-max-body-size=4 -disable-output 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=SIZE
+; RUN: opt < %s -loop-versioning-licm -debug-only=loop-versioning-licm \
+; RUN:   -licm-versioning-assumed-trip-count=2 -disable-output 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=ASSUMED
+; REQUIRES: asserts
+;
+; Test the body size limit of LoopVersioningLICM, and that the runtime checks
+; are weighed against the invariant accesses they allow to be hoisted. Without
+; a target, every check and every access costs one.
+
+; The trip count of @fill is unknown, so it is assumed. The loop has one
+; runtime check (cost 4) and one invariant load (cost 1 per iteration).
+
+; CHECK-LABEL: Loop: Loop at depth 1 containing: %copy.body<header><latch><exiting>
+; CHECK-NEXT:   Loop Versioning found to be beneficial
+; SIZE-LABEL: Loop: Loop at depth 1 containing: %copy.body<header><latch><exiting>
+; SIZE-NEXT:   Loop body size 7 is more than threshold
+; ASSUMED-LABEL: Loop: Loop at depth 1 containing: %copy.body<header><latch><exiting>
+; ASSUMED-NEXT:   Runtime check cost 4 exceeds hoisting benefit 2 (1 x trip count 2)
+define void @fill(i8* %dst, i8* %src, i32 %n) {
+entry:
+  br label %copy.body
+
+copy.body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %copy.body ]
+  %p = getelementptr inbounds i8, i8* %dst, i32 %i
+  %v = load i8, i8* %src, align 1
+  store i8 %v, i8* %p, align 1
+  %inc = add nuw i32 %i, 1
+  %cmp = icmp ult i32 %inc, %n
+  br i1 %cmp, label %copy.body, label %exit
+
+exit:
+  ret void
+}
+
+; A loop that runs once does not amortize the runtime check.
+;
+; CHECK-LABEL: Loop: Loop at depth 1 containing: %once.body<header><latch><exiting>
+; CHECK-NEXT:   Runtime check cost 4 exceeds hoisting benefit 1 (1 x trip count 1)
+define void @once(i8* %dst, i8* %src) {
+entry:
+  br label %once.body
+
+once.body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %once.body ]
+  %p = getelementptr inbounds i8, i8* %dst, i32 %i
+  %v = load i8, i8* %src, align 1
+  store i8 %v, i8* %p, align 1
+  %inc = add nuw i32 %i, 1
+  %cmp = icmp ult i32 %inc, 1
+  br i1 %cmp, label %once.body, label %exit
+
+exit:
+  ret void
+}
@@ -0,0 +1,69 @@
+; RUN: opt -mergesimilarfunc -S < %s | FileCheck %s
+; RUN: opt -mergesimilarfunc -mergesimilarfunc-callee-param-cost=100 -S < %s \
+; RUN:   | FileCheck %s --check-prefix=EXPENSIVE
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; Functions that only differ in the function they call are merged, with the
+; callee passed as a parameter. Three members make this profitable.
+
+; CHECK-LABEL: define void @visit_int(i32* %p)
+; CHECK-NEXT: tail call void @visit_int.merged(i32* %p, void (i32)* @print_int)
+; CHECK-LABEL: define void @visit_uint(i32* %p)
+; CHECK-NEXT: tail call void @visit_int.merged(i32* %p, void (i32)* @print_uint)
+; CHECK-LABEL: define void @visit_hex(i32* %p)
+; CHECK-NEXT: tail call void @visit_int.merged(i32* %p, void (i32)* @print_hex)
+; CHECK-LABEL: define internal void @visit_int.merged(i32* %p, void (i32)* %merge.param)
+; CHECK: call void %merge.param(i32 %v)
+
+; EXPENSIVE-NOT: merged
+
+define void @visit_int(i32* %p) {
+entry:
+  %v = load i32, i32* %p
+  %a = add i32 %v, 1
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  store i32 %d, i32* %p
+  call void @print_int(i32 %v)
+  %e = load i32, i32* %p
+  %f = add i32 %e, %d
+  store i32 %f, i32* %p
+  ret void
+}
+
+define void @visit_uint(i32* %p) {
+entry:
+  %v = load i32, i32* %p
+  %a = add i32 %v, 1
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  store i32 %d, i32* %p
+  call void @print_uint(i32 %v)
+  %e = load i32, i32* %p
+  %f = add i32 %e, %d
+  store i32 %f, i32* %p
+  ret void
+}
+
+define void @visit_hex(i32* %p) {
+entry:
+  %v = load i32, i32* %p
+  %a = add i32 %v, 1
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  store i32 %d, i32* %p
+  call void @print_hex(i32 %v)
+  %e = load i32, i32* %p
+  %f = add i32 %e, %d
+  store i32 %f, i32* %p
+  ret void
+}
+
+declare void @print_int(i32)
+declare void @print_uint(i32)
+declare void @print_hex(i32)
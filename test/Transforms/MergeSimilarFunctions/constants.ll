@@ -0,0 +1,69 @@
+; RUN: opt -mergesimilarfunc -S < %s | FileCheck %s
+; RUN: opt -passes=mergesimilarfunc -S < %s | FileCheck %s
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+; Two instantiations of the same template that only differ in the element
+; size and a stored tag are merged into one function taking both constants as
+; parameters.
+
+; CHECK-LABEL: define linkonce_odr i32 @copy_4(i8* %dst, i8* %src, i32 %n)
+; CHECK-NEXT: [[R:%.*]] = tail call i32 @copy_4.merged(i8* %dst, i8* %src, i32 %n, i32 4, i32 17)
+; CHECK-NEXT: ret i32 [[R]]
+
+; CHECK-LABEL: define linkonce_odr i32 @copy_8(i8* %dst, i8* %src, i32 %n)
+; CHECK-NEXT: [[R:%.*]] = tail call i32 @copy_4.merged(i8* %dst, i8* %src, i32 %n, i32 8, i32 42)
+; CHECK-NEXT: ret i32 [[R]]
+
+; CHECK-LABEL: define internal i32 @copy_4.merged(i8* %dst, i8* %src, i32 %n, i32 %merge.param, i32 %merge.param1)
+; CHECK: %bytes = mul nsw i32 %n, %merge.param
+; CHECK: store i32 %merge.param1, i32* %tag
+
+define linkonce_odr i32 @copy_4(i8* %dst, i8* %src, i32 %n) {
+entry:
+  %bytes = mul nsw i32 %n, 4
+  %end = getelementptr inbounds i8, i8* %src, i32 %bytes
+  %dst.end = getelementptr inbounds i8, i8* %dst, i32 %bytes
+  %tagp = getelementptr inbounds i8, i8* %dst.end, i32 4
+  %tag = bitcast i8* %tagp to i32*
+  store i32 17, i32* %tag
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %dst, i8* %src, i32 %bytes, i1 false)
+  %cmp = icmp ugt i8* %end, %src
+  %ext = zext i1 %cmp to i32
+  %sum = add i32 %ext, %bytes
+  %h0 = mul i32 %sum, 31
+  %h1 = xor i32 %h0, %n
+  %h2 = mul i32 %h1, 31
+  %h3 = xor i32 %h2, %bytes
+  %h4 = mul i32 %h3, 31
+  %h5 = xor i32 %h4, %ext
+  %h6 = lshr i32 %h5, 7
+  %h7 = xor i32 %h6, %h5
+  ret i32 %h7
+}
+
+define linkonce_odr i32 @copy_8(i8* %dst, i8* %src, i32 %n) {
+entry:
+  %bytes = mul nsw i32 %n, 8
+  %end = getelementptr inbounds i8, i8* %src, i32 %bytes
+  %dst.end = getelementptr inbounds i8, i8* %dst, i32 %bytes
+  %tagp = getelementptr inbounds i8, i8* %dst.end, i32 4
+  %tag = bitcast i8* %tagp to i32*
+  store i32 42, i32* %tag
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %dst, i8* %src, i32 %bytes, i1 false)
+  %cmp = icmp ugt i8* %end, %src
+  %ext = zext i1 %cmp to i32
+  %sum = add i32 %ext, %bytes
+  %h0 = mul i32 %sum, 31
+  %h1 = xor i32 %h0, %n
+  %h2 = mul i32 %h1, 31
+  %h3 = xor i32 %h2, %bytes
+  %h4 = mul i32 %h3, 31
+  %h5 = xor i32 %h4, %ext
+  %h6 = lshr i32 %h5, 7
+  %h7 = xor i32 %h6, %h5
+  ret i32 %h7
+}
+
+declare void @llvm.memcpy.p0i8.p0i8.i32(i8* nocapture, i8* nocapture readonly, i32, i1)
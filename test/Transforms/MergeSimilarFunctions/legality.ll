@@ -0,0 +1,136 @@
+; RUN: opt -mergesimilarfunc -mergesimilarfunc-min-savings=-1000 -S < %s \
+; RUN:   | FileCheck %s
+
+; The cost model is effectively disabled so that these tests only exercise
+; the similarity check.
+
+target datalayout = "e-m:e-p:32:32-i64:64-n32:64-S128"
+target triple = "wasm32-unknown-unknown"
+
+%pair = type { i32, i32 }
+
+; Differing wrap flags prevent merging.
+
+; CHECK-LABEL: define i32 @flags_a(
+; CHECK-NOT: merged
+; CHECK: ret i32
+define i32 @flags_a(i32 %a, i32 %b) {
+entry:
+  %m = mul nsw i32 %a, 3
+  %x = add i32 %m, %b
+  %y = sub i32 %x, %a
+  %z = xor i32 %y, %b
+  %w = shl i32 %z, 2
+  %v = or i32 %w, %a
+  %u = and i32 %v, %x
+  %t = add i32 %u, %m
+  ret i32 %t
+}
+
+; CHECK-LABEL: define i32 @flags_b(
+; CHECK-NOT: merged
+; CHECK: ret i32
+define i32 @flags_b(i32 %a, i32 %b) {
+entry:
+  %m = mul i32 %a, 5
+  %x = add i32 %m, %b
+  %y = sub i32 %x, %a
+  %z = xor i32 %y, %b
+  %w = shl i32 %z, 2
+  %v = or i32 %w, %a
+  %u = and i32 %v, %x
+  %t = add i32 %u, %m
+  ret i32 %t
+}
+
+; Intrinsic arguments are never parametrized.
+
+; CHECK-LABEL: define void @volatile_a(
+; CHECK: call void @llvm.memcpy
+define void @volatile_a(i8* %dst, i8* %src, i32 %n) {
+entry:
+  %a = add i32 %n, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = add i32 %c, 4
+  %e = add i32 %d, 5
+  %f = add i32 %e, 6
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %dst, i8* %src, i32 %f, i1 false)
+  ret void
+}
+
+; CHECK-LABEL: define void @volatile_b(
+; CHECK: call void @llvm.memcpy
+define void @volatile_b(i8* %dst, i8* %src, i32 %n) {
+entry:
+  %a = add i32 %n, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = add i32 %c, 4
+  %e = add i32 %d, 5
+  %f = add i32 %e, 6
+  call void @llvm.memcpy.p0i8.p0i8.i32(i8* %dst, i8* %src, i32 %f, i1 true)
+  ret void
+}
+
+; Struct indices of a GEP must remain constants.
+
+; CHECK-LABEL: define i32 @field_a(
+; CHECK: getelementptr inbounds %pair, %pair* %p, i32 0, i32 0
+define i32 @field_a(%pair* %p, i32 %n) {
+entry:
+  %f = getelementptr inbounds %pair, %pair* %p, i32 0, i32 0
+  %v = load i32, i32* %f
+  %a = add i32 %v, %n
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  %e = add i32 %d, %n
+  ret i32 %e
+}
+
+; CHECK-LABEL: define i32 @field_b(
+; CHECK: getelementptr inbounds %pair, %pair* %p, i32 0, i32 1
+define i32 @field_b(%pair* %p, i32 %n) {
+entry:
+  %f = getelementptr inbounds %pair, %pair* %p, i32 0, i32 1
+  %v = load i32, i32* %f
+  %a = add i32 %v, %n
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  %e = add i32 %d, %n
+  ret i32 %e
+}
+
+; Array indices, on the other hand, can be parametrized.
+
+; CHECK-LABEL: define i32 @elt_a(i32* %p, i32 %n)
+; CHECK-NEXT: tail call i32 @elt_a.merged(i32* %p, i32 %n, i32 2)
+; CHECK-LABEL: define i32 @elt_b(i32* %p, i32 %n)
+; CHECK-NEXT: tail call i32 @elt_a.merged(i32* %p, i32 %n, i32 3)
+define i32 @elt_a(i32* %p, i32 %n) {
+entry:
+  %f = getelementptr inbounds i32, i32* %p, i32 2
+  %v = load i32, i32* %f
+  %a = add i32 %v, %n
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  %e = add i32 %d, %n
+  ret i32 %e
+}
+
+define i32 @elt_b(i32* %p, i32 %n) {
+entry:
+  %f = getelementptr inbounds i32, i32* %p, i32 3
+  %v = load i32, i32* %f
+  %a = add i32 %v, %n
+  %b = mul i32 %a, %v
+  %c = sub i32 %b, %a
+  %d = xor i32 %c, %b
+  %e = add i32 %d, %n
+  ret i32 %e
+}
+
+declare void @llvm.memcpy.p0i8.p0i8.i32(i8* nocapture, i8* nocapture readonly, i32, i1)
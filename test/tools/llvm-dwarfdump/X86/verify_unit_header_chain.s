@@ -1,6 +1,6 @@
-# RUN: llvm-mc %s -filetype obj -triple x86_64-apple-darwin -o - \
-# RUN: | not llvm-dwarfdump -verify - \
-# RUN: | FileCheck %s
+# RUN: llvm-mc %s -filetype obj -triple x86_64-apple-darwin -o %t.o
+# RUN: not llvm-dwarfdump -verify %t.o | FileCheck %s
+# RUN: not llvm-dwarfdump -verify -j 2 %t.o | FileCheck %s
 
 # CHECK: Verifying .debug_info Unit Header Chain...
 # CHECK-NEXT: error: Units[1] - start offset: 0x0000000d
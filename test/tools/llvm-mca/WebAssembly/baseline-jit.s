@@ -0,0 +1,128 @@
+# NOTE: Assertions have been autogenerated by utils/update_mca_test_checks.py
+# RUN: llvm-mca -mtriple=wasm32-unknown-unknown -mcpu=baseline-jit -stack-depth -resource-pressure=false -iterations=100 < %s | FileCheck %s
+
+  .text
+  .functype	f (i32, i32) -> (i32)
+f:
+  .functype	f (i32, i32) -> (i32)
+  .local  	i32
+  local.get	0
+# LLVM-MCA-BEGIN div
+  local.get	1
+  i32.div_s
+  local.tee	2
+  i64.extend_i32_s
+  drop
+# LLVM-MCA-END
+# LLVM-MCA-BEGIN memory
+  local.get	2
+  local.get	2
+  i32.load	0
+  i32.const	1
+  i32.add
+  i32.store	4
+  local.get	2
+  f64.load	8
+  f64.sqrt
+  i64.trunc_f64_s
+  i32.wrap_i64
+# LLVM-MCA-END
+  end_function
+
+# CHECK:      [0] Code Region - div
+
+# CHECK:      Iterations:        100
+# CHECK-NEXT: Instructions:      500
+# CHECK-NEXT: Total Cycles:      2608
+# CHECK-NEXT: Total uOps:        1400
+
+# CHECK:      Dispatch Width:    4
+# CHECK-NEXT: uOps Per Cycle:    0.54
+# CHECK-NEXT: IPC:               0.19
+# CHECK-NEXT: Block RThroughput: 26.0
+
+# CHECK:      Instruction Info:
+# CHECK-NEXT: [1]: #uOps
+# CHECK-NEXT: [2]: Latency
+# CHECK-NEXT: [3]: RThroughput
+# CHECK-NEXT: [4]: MayLoad
+# CHECK-NEXT: [5]: MayStore
+# CHECK-NEXT: [6]: HasSideEffects (U)
+
+# CHECK:      [1]    [2]    [3]    [4]    [5]    [6]    Instructions:
+# CHECK-NEXT:  2      5     1.00    *                   local.get	1
+# CHECK-NEXT:  6      30    26.00                 U     i32.div_s
+# CHECK-NEXT:  2      5     1.00           *            local.tee	2
+# CHECK-NEXT:  3      6     1.00                  U     i64.extend_i32_s
+# CHECK-NEXT:  1      1     0.33                        drop
+
+# CHECK:      Stack Depth:
+# CHECK-NEXT: [1]: Depth
+# CHECK-NEXT: [2]: Pops
+# CHECK-NEXT: [3]: Pushes
+
+# CHECK:      [1]    [2]    [3]    Instructions:
+# CHECK-NEXT:  0     0      1      local.get	1
+# CHECK-NEXT:  1     2      1      i32.div_s
+# CHECK-NEXT:  0     1      1      local.tee	2
+# CHECK-NEXT:  0     1      1      i64.extend_i32_s
+# CHECK-NEXT:  0     1      0      drop
+
+# CHECK:      Max Depth:        1
+# CHECK-NEXT: Values Consumed:  1
+# CHECK-NEXT: Net Effect:       -1
+
+# CHECK:      [1] Code Region - memory
+
+# CHECK:      Iterations:        100
+# CHECK-NEXT: Instructions:      1100
+# CHECK-NEXT: Total Cycles:      2203
+# CHECK-NEXT: Total uOps:        3300
+
+# CHECK:      Dispatch Width:    4
+# CHECK-NEXT: uOps Per Cycle:    1.50
+# CHECK-NEXT: IPC:               0.50
+# CHECK-NEXT: Block RThroughput: 11.0
+
+# CHECK:      Instruction Info:
+# CHECK-NEXT: [1]: #uOps
+# CHECK-NEXT: [2]: Latency
+# CHECK-NEXT: [3]: RThroughput
+# CHECK-NEXT: [4]: MayLoad
+# CHECK-NEXT: [5]: MayStore
+# CHECK-NEXT: [6]: HasSideEffects (U)
+
+# CHECK:      [1]    [2]    [3]    [4]    [5]    [6]    Instructions:
+# CHECK-NEXT:  2      5     1.00    *                   local.get	2
+# CHECK-NEXT:  2      5     1.00    *                   local.get	2
+# CHECK-NEXT:  4      9     1.00    *             U     i32.load	0
+# CHECK-NEXT:  1      1     1.00                  U     i32.const	1
+# CHECK-NEXT:  3      6     1.00                  U     i32.add
+# CHECK-NEXT:  4      1     1.00           *      U     i32.store	4
+# CHECK-NEXT:  2      5     1.00    *                   local.get	2
+# CHECK-NEXT:  4      9     1.00    *             U     f64.load	8
+# CHECK-NEXT:  3      20    8.00                  U     f64.sqrt
+# CHECK-NEXT:  5      10    1.00                  U     i64.trunc_f64_s
+# CHECK-NEXT:  3      6     1.00                  U     i32.wrap_i64
+
+# CHECK:      Stack Depth:
+# CHECK-NEXT: [1]: Depth
+# CHECK-NEXT: [2]: Pops
+# CHECK-NEXT: [3]: Pushes
+
+# CHECK:      [1]    [2]    [3]    Instructions:
+# CHECK-NEXT:  0     0      1      local.get	2
+# CHECK-NEXT:  1     0      1      local.get	2
+# CHECK-NEXT:  2     1      1      i32.load	0
+# CHECK-NEXT:  2     0      1      i32.const	1
+# CHECK-NEXT:  3     2      1      i32.add
+# CHECK-NEXT:  2     2      0      i32.store	4
+# CHECK-NEXT:  0     0      1      local.get	2
+# CHECK-NEXT:  1     1      1      f64.load	8
+# CHECK-NEXT:  1     1      1      f64.sqrt
+# CHECK-NEXT:  1     1      1      i64.trunc_f64_s
+# CHECK-NEXT:  1     1      1      i32.wrap_i64
+
+# CHECK:      Max Depth:        3
+# CHECK-NEXT: Values Consumed:  0
+# CHECK-NEXT: Net Effect:       1
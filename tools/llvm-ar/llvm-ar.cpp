@@ -76,6 +76,8 @@ OPTIONS:
     =darwin             -   darwin
     =bsd                -   bsd
   --plugin=<string>     - Ignored for compatibility
+  --update-in-place     - Rewrite only the changed parts of an archive that
+                          keeps its size when replacing members
   --help                - Display available options
   --version             - Display the version of this program
   @<file>               - read options from <file>
@@ -182,6 +184,7 @@ static bool Symtab = true;           ///< 's' modifier
 static bool Deterministic = true;    ///< 'D' and 'U' modifiers
 static bool Thin = false;            ///< 'T' modifier
 static bool AddLibrary = false;      ///< 'L' modifier
+static bool UpdateInPlace = false;   ///< '--update-in-place' option
 
 // Relative Positional Argument (for insert/move). This variable holds
 // the name of the archive member to which the 'a', 'b' or 'i' modifier
@@ -871,9 +874,11 @@ static void performWriteOperation(ArchiveOperation Operation,
     llvm_unreachable("");
   }
 
+  // Rewriting the existing file is not atomic, so it is only done on request.
   Error E =
       writeArchive(ArchiveName, NewMembersP ? *NewMembersP : NewMembers, Symtab,
-                   Kind, Deterministic, Thin, std::move(OldArchiveBuf));
+                   Kind, Deterministic, Thin, std::move(OldArchiveBuf),
+                   UpdateInPlace && Operation == ReplaceOrInsert);
   failIfError(std::move(E), ArchiveName);
 }
 
@@ -1088,6 +1093,8 @@ static int ar_main(int argc, char **argv) {
           fail(std::string("Invalid format ") + match);
       } else if (MatchFlagWithArg("plugin")) {
         // Ignored.
+      } else if (Arg == "update-in-place") {
+        UpdateInPlace = true;
       } else {
         Options += Argv[i] + 1;
       }
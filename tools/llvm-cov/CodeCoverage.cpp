@@ -98,6 +98,19 @@ private:
   /// Load the coverage mapping data. Return nullptr if an error occurred.
   std::unique_ptr<CoverageMapping> load();
 
+  /// Describe the profile and the objects for the coverage index. Return
+  /// false if any of them can't be found.
+  bool getIndexInputs(std::vector<CoverageIndexInput> &Inputs);
+
+  /// Load the coverage mapping data from the coverage index. Return nullptr
+  /// if the index couldn't be read or was written for different inputs.
+  std::unique_ptr<CoverageMapping>
+  loadIndex(ArrayRef<CoverageIndexInput> Inputs);
+
+  /// Save the coverage mapping data to the coverage index.
+  void writeIndex(const CoverageMapping &Coverage,
+                  ArrayRef<CoverageIndexInput> Inputs);
+
   /// Create a mapping from files in the Coverage data to local copies
   /// (path-equivalence).
   void remapPathNames(const CoverageMapping &Coverage);
@@ -131,6 +144,9 @@ private:
   /// The path to the indexed profile.
   std::string PGOFilename;
 
+  /// The path to the coverage index caching the coverage mapping data.
+  std::string IndexFilename;
+
   /// A list of input source files.
   std::vector<std::string> SourceFiles;
 
@@ -351,14 +367,23 @@ std::unique_ptr<CoverageMapping> CodeCoverageTool::load() {
     if (modifiedTimeGT(ObjectFilename, PGOFilename))
       warning("profile data may be out of date - object is newer",
               ObjectFilename);
-  auto CoverageOrErr =
-      CoverageMapping::load(ObjectFilenames, PGOFilename, CoverageArches);
-  if (Error E = CoverageOrErr.takeError()) {
-    error("Failed to load coverage: " + toString(std::move(E)),
-          join(ObjectFilenames.begin(), ObjectFilenames.end(), ", "));
-    return nullptr;
+  std::unique_ptr<CoverageMapping> Coverage;
+  std::vector<CoverageIndexInput> IndexInputs;
+  bool UseIndex = !IndexFilename.empty() && getIndexInputs(IndexInputs);
+  if (UseIndex && sys::fs::exists(IndexFilename))
+    Coverage = loadIndex(IndexInputs);
+  if (!Coverage) {
+    auto CoverageOrErr =
+        CoverageMapping::load(ObjectFilenames, PGOFilename, CoverageArches);
+    if (Error E = CoverageOrErr.takeError()) {
+      error("Failed to load coverage: " + toString(std::move(E)),
+            join(ObjectFilenames.begin(), ObjectFilenames.end(), ", "));
+      return nullptr;
+    }
+    Coverage = std::move(CoverageOrErr.get());
+    if (UseIndex)
+      writeIndex(*Coverage, IndexInputs);
   }
-  auto Coverage = std::move(CoverageOrErr.get());
   unsigned Mismatched = Coverage->getMismatchedCount();
   if (Mismatched) {
     warning(Twine(Mismatched) + " functions have mismatched data");
@@ -382,6 +407,81 @@ std::unique_ptr<CoverageMapping> CodeCoverageTool::load() {
   return Coverage;
 }
 
+bool CodeCoverageTool::getIndexInputs(std::vector<CoverageIndexInput> &Inputs) {
+  auto AddInput = [&](StringRef Filename, StringRef Arch) {
+    SmallString<256> Path(Filename);
+    sys::fs::file_status Status;
+    if (sys::fs::make_absolute(Path) || sys::fs::status(Path, Status))
+      return false;
+    CoverageIndexInput Input;
+    Input.Path = Path.str();
+    Input.Size = Status.getSize();
+    Input.ModificationTime =
+        Status.getLastModificationTime().time_since_epoch().count();
+    Input.Arch = Arch;
+    Inputs.push_back(std::move(Input));
+    return true;
+  };
+
+  if (!AddInput(PGOFilename, ""))
+    return false;
+  for (unsigned I = 0, E = ObjectFilenames.size(); I != E; ++I)
+    if (!AddInput(ObjectFilenames[I],
+                  CoverageArches.empty() ? "" : CoverageArches[I]))
+      return false;
+  return true;
+}
+
+std::unique_ptr<CoverageMapping>
+CodeCoverageTool::loadIndex(ArrayRef<CoverageIndexInput> Inputs) {
+  auto BufOrErr = MemoryBuffer::getFile(IndexFilename, /*FileSize=*/-1,
+                                        /*RequiresNullTerminator=*/false);
+  if (std::error_code EC = BufOrErr.getError()) {
+    warning("Could not read coverage index: " + EC.message(), IndexFilename);
+    return nullptr;
+  }
+  auto CoverageOrErr =
+      CoverageMapping::loadFromIndex(BufOrErr.get()->getMemBufferRef(), Inputs);
+  if (Error E = CoverageOrErr.takeError()) {
+    handleAllErrors(std::move(E), [&](const CoverageMapError &CME) {
+      // An index for other inputs is simply rewritten.
+      if (CME.get() == coveragemap_error::index_out_of_date) {
+        if (ViewOpts.Debug)
+          errs() << "Coverage index " << IndexFilename << " is out of date\n";
+        return;
+      }
+      warning("Ignoring coverage index: " + CME.message(), IndexFilename);
+    });
+    return nullptr;
+  }
+  if (ViewOpts.Debug)
+    errs() << "Loaded coverage from index " << IndexFilename << '\n';
+  return std::move(CoverageOrErr.get());
+}
+
+void CodeCoverageTool::writeIndex(const CoverageMapping &Coverage,
+                                  ArrayRef<CoverageIndexInput> Inputs) {
+  // Write the index to a temporary file first, so that concurrent runs never
+  // see a partially written index.
+  auto TempOrErr = sys::fs::TempFile::create(IndexFilename + ".tmp%%%%%%");
+  if (Error E = TempOrErr.takeError()) {
+    warning("Could not write coverage index: " + toString(std::move(E)),
+            IndexFilename);
+    return;
+  }
+  {
+    raw_fd_ostream OS(TempOrErr->FD, /*shouldClose=*/false);
+    Coverage.writeIndex(OS, Inputs);
+  }
+  if (Error E = TempOrErr->keep(IndexFilename)) {
+    warning("Could not write coverage index: " + toString(std::move(E)),
+            IndexFilename);
+    return;
+  }
+  if (ViewOpts.Debug)
+    errs() << "Wrote coverage index " << IndexFilename << '\n';
+}
+
 void CodeCoverageTool::remapPathNames(const CoverageMapping &Coverage) {
   if (!PathRemapping)
     return;
@@ -558,6 +658,13 @@ int CodeCoverageTool::run(Command Cmd, int argc, const char **argv) {
   cl::list<std::string> Arches(
       "arch", cl::desc("architectures of the coverage mapping binaries"));
 
+  cl::opt<std::string, true> IndexFilename(
+      "index-file", cl::Optional, cl::location(this->IndexFilename),
+      cl::desc("Cache the coverage mapping data in the given file. It is "
+               "read instead of the objects and the profile when the paths, "
+               "sizes and modification times it records for them, and the "
+               "architectures, all still match, and written otherwise"));
+
   cl::opt<bool> DebugDump("dump", cl::Optional,
                           cl::desc("Show internal debug dump"));
 
@@ -44,9 +44,11 @@ public:
 
   virtual ~BenchmarkRunner();
 
-  InstructionBenchmark runConfiguration(const BenchmarkCode &Configuration,
-                                        unsigned NumRepetitions,
-                                        bool DumpObjectToDisk) const;
+  // Targets whose code does not run on the host can override this to
+  // assemble and execute the configuration their own way.
+  virtual InstructionBenchmark
+  runConfiguration(const BenchmarkCode &Configuration, unsigned NumRepetitions,
+                   bool DumpObjectToDisk) const;
 
   // Scratch space to run instructions that touch memory.
   struct ScratchSpace {
@@ -8,13 +8,16 @@
 ///
 /// \file
 ///
-/// Utilities to handle the creation of the native exegesis target.
+/// Utilities to handle the creation of the native exegesis target, and of the
+/// targets whose snippets do not run on the host.
 ///
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_TOOLS_LLVM_EXEGESIS_TARGET_SELECT_H
 #define LLVM_TOOLS_LLVM_EXEGESIS_TARGET_SELECT_H
 
+#include "llvm/Support/TargetSelect.h"
+
 namespace llvm {
 namespace exegesis {
 
@@ -34,6 +37,27 @@ inline bool InitializeNativeExegesisTarget() {
 #endif
 }
 
+#ifdef LLVM_EXEGESIS_HAS_WEBASSEMBLY_TARGET
+void InitializeWebAssemblyExegesisTarget();
+#endif
+
+// Initializes the WebAssembly target and its exegesis target, or returns false
+// if they are not linked in. WebAssembly snippets run under an external
+// runtime, so this does not depend on the host.
+inline bool InitializeWebAssemblyExegesisTargets() {
+#ifdef LLVM_EXEGESIS_HAS_WEBASSEMBLY_TARGET
+  LLVMInitializeWebAssemblyTargetInfo();
+  LLVMInitializeWebAssemblyTarget();
+  LLVMInitializeWebAssemblyTargetMC();
+  LLVMInitializeWebAssemblyAsmParser();
+  LLVMInitializeWebAssemblyDisassembler();
+  InitializeWebAssemblyExegesisTarget();
+  return true;
+#else
+  return false;
+#endif
+}
+
 } // namespace exegesis
 } // namespace llvm
 
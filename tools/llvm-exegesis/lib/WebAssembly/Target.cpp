@@ -0,0 +1,684 @@
+//===-- Target.cpp ----------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// The WebAssembly ExegesisTarget.
+//
+// WebAssembly code does not run on the host. Snippets are instead wrapped in
+// a module that is run by the external runtime given with -wasm-runner, and
+// their cost is derived from how long the runtime takes to run it.
+//===----------------------------------------------------------------------===//
+#include "../Target.h"
+#include "../BenchmarkRunner.h"
+#include "../SnippetGenerator.h"
+#include "MCTargetDesc/WebAssemblyMCTargetDesc.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/BinaryFormat/Wasm.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCFixup.h"
+#include "llvm/MC/MCInstrAnalysis.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Target/TargetMachine.h"
+#include <chrono>
+
+namespace llvm {
+namespace exegesis {
+
+static cl::opt<std::string>
+    WasmRunner("wasm-runner",
+               cl::desc("command that runs the WebAssembly module given as "
+                        "its last argument, e.g. 'wasmtime run'"),
+               cl::init(""));
+
+static cl::opt<unsigned>
+    WasmIterations("wasm-iterations",
+                   cl::desc("number of times the benchmark module runs the "
+                            "repeated snippet"),
+                   cl::init(1000));
+
+static cl::opt<unsigned>
+    WasmRuns("wasm-runs",
+             cl::desc("number of times each benchmark module is run, the "
+                      "fastest run is kept"),
+             cl::init(5));
+
+static cl::opt<double>
+    WasmHostGHz("wasm-host-ghz",
+                cl::desc("clock rate of the host in GHz, used to convert run "
+                         "times to cycles"),
+                cl::init(1.0));
+
+namespace {
+
+// The value types that snippets operate on, in the order in which the
+// benchmark function declares their locals.
+enum ValueType { VT_I32, VT_I64, VT_F32, VT_F64, VT_Count };
+
+// Each value type has kLocalsPerType locals: an input that is never written,
+// followed by locals that carry results from one repetition to the next.
+constexpr unsigned kLocalsPerType = 8;
+// The loop counter comes after the value locals.
+constexpr unsigned kCounterLocal = VT_Count * kLocalsPerType;
+// The number of independent chains used to measure inverse throughput.
+constexpr unsigned kNumParallelChains = 4;
+
+// Inputs are loaded from kInputAddress + 8 * ValueType. The i32 input is the
+// address of itself so that loads can be chained, and the other inputs are
+// one so that division does not trap.
+constexpr uint32_t kInputAddress = 256;
+// Results are stored to kResultAddress + 8 * LocalIndex on exit so that the
+// runtime cannot optimize the snippet away.
+constexpr uint32_t kResultAddress = 1024;
+
+const unsigned LocalGetOpcodes[] = {
+    WebAssembly::LOCAL_GET_I32_S, WebAssembly::LOCAL_GET_I64_S,
+    WebAssembly::LOCAL_GET_F32_S, WebAssembly::LOCAL_GET_F64_S};
+const unsigned LocalSetOpcodes[] = {
+    WebAssembly::LOCAL_SET_I32_S, WebAssembly::LOCAL_SET_I64_S,
+    WebAssembly::LOCAL_SET_F32_S, WebAssembly::LOCAL_SET_F64_S};
+// Cheap instructions that fold a result into an accumulator.
+const unsigned FoldOpcodes[] = {WebAssembly::XOR_I32_S, WebAssembly::XOR_I64_S,
+                                WebAssembly::ADD_F32_S, WebAssembly::ADD_F64_S};
+
+unsigned getInputLocal(ValueType VT) { return VT * kLocalsPerType; }
+
+unsigned getChainLocal(ValueType VT, unsigned Chain) {
+  assert(Chain + 1 < kLocalsPerType && "not enough locals");
+  return VT * kLocalsPerType + 1 + Chain;
+}
+
+llvm::Optional<ValueType> getValueType(const llvm::MCOperandInfo &Info) {
+  switch (Info.RegClass) {
+  case WebAssembly::I32RegClassID:
+    return VT_I32;
+  case WebAssembly::I64RegClassID:
+    return VT_I64;
+  case WebAssembly::F32RegClassID:
+    return VT_F32;
+  case WebAssembly::F64RegClassID:
+    return VT_F64;
+  }
+  return llvm::None;
+}
+
+// Generates snippets that run an instruction on values kept in locals.
+// Snippets start with the instruction so that it is the key instruction of
+// the benchmark, and end by pushing the operands of the next repetition. The
+// runner pushes the operands of the first repetition.
+class WebAssemblySnippetGenerator : public SnippetGenerator {
+public:
+  // With a single chain, each repetition uses the result of the previous one
+  // and the snippet measures latency. With several chains, the repetitions
+  // are independent and it measures inverse throughput.
+  WebAssemblySnippetGenerator(const LLVMState &State, unsigned NumChains)
+      : SnippetGenerator(State), NumChains(NumChains) {}
+
+private:
+  llvm::Expected<std::vector<CodeTemplate>>
+  generateCodeTemplates(const Instruction &Instr) const override;
+
+  InstructionTemplate createLocalAccess(unsigned Opcode, unsigned Local) const;
+
+  const unsigned NumChains;
+};
+
+InstructionTemplate
+WebAssemblySnippetGenerator::createLocalAccess(unsigned Opcode,
+                                               unsigned Local) const {
+  InstructionTemplate IT(State.getIC().getInstr(Opcode));
+  IT.getValueFor(IT.Instr.Variables[0]) = llvm::MCOperand::createImm(Local);
+  return IT;
+}
+
+llvm::Expected<std::vector<CodeTemplate>>
+WebAssemblySnippetGenerator::generateCodeTemplates(
+    const Instruction &Instr) const {
+  const unsigned Opcode = Instr.Description->getOpcode();
+  // The register form of the instruction tells which values it pops and
+  // pushes.
+  const int RegOpcode = WebAssembly::getRegisterOpcode(Opcode);
+  if (RegOpcode == -1)
+    return llvm::make_error<SnippetGeneratorFailure>(
+        "only stack instructions (with an _S suffix) can be measured");
+  const llvm::MCInstrDesc &RegDesc = State.getInstrInfo().get(RegOpcode);
+
+  if (RegDesc.getNumDefs() > 1)
+    return llvm::make_error<SnippetGeneratorFailure>(
+        "instructions with several results are not supported");
+  llvm::Optional<ValueType> ResultType;
+  if (RegDesc.getNumDefs() == 1) {
+    ResultType = getValueType(RegDesc.OpInfo[0]);
+    if (!ResultType)
+      return llvm::make_error<SnippetGeneratorFailure>(
+          "unsupported result type");
+  }
+  llvm::SmallVector<ValueType, 4> OperandTypes;
+  for (unsigned I = RegDesc.getNumDefs(), E = RegDesc.getNumOperands(); I != E;
+       ++I) {
+    if (RegDesc.OpInfo[I].OperandType != llvm::MCOI::OPERAND_REGISTER)
+      continue;
+    const llvm::Optional<ValueType> VT = getValueType(RegDesc.OpInfo[I]);
+    if (!VT)
+      return llvm::make_error<SnippetGeneratorFailure>(
+          "unsupported operand type");
+    OperandTypes.push_back(*VT);
+  }
+
+  // The operand that receives the result of the previous repetition.
+  int ChainOperand = -1;
+  if (ResultType) {
+    const auto It = llvm::find(OperandTypes, *ResultType);
+    if (It != OperandTypes.end())
+      ChainOperand = It - OperandTypes.begin();
+  }
+  if (NumChains == 1 && ChainOperand < 0)
+    return llvm::make_error<SnippetGeneratorFailure>(
+        "no operand has the type of the result, the instruction cannot be "
+        "chained to itself");
+
+  InstructionTemplate IT(Instr);
+  for (const Variable &Var : Instr.Variables) {
+    const Operand &Op = Instr.getPrimaryOperand(Var);
+    llvm::MCOperand &Value = IT.getValueFor(Var);
+    switch (Op.getExplicitOperandInfo().OperandType) {
+    case llvm::MCOI::OPERAND_IMMEDIATE:
+    case WebAssembly::OPERAND_OFFSET32:
+      Value = llvm::MCOperand::createImm(0);
+      break;
+    case WebAssembly::OPERAND_P2ALIGN:
+      Value = llvm::MCOperand::createImm(WebAssembly::GetDefaultP2Align(Opcode));
+      break;
+    case WebAssembly::OPERAND_I32IMM:
+    case WebAssembly::OPERAND_I64IMM:
+      Value = llvm::MCOperand::createImm(1);
+      break;
+    case WebAssembly::OPERAND_F32IMM:
+    case WebAssembly::OPERAND_F64IMM:
+      Value = llvm::MCOperand::createFPImm(1.0);
+      break;
+    default:
+      return llvm::make_error<SnippetGeneratorFailure>(
+          "unsupported immediate operand");
+    }
+  }
+
+  CodeTemplate CT;
+  for (unsigned Chain = 0; Chain < NumChains; ++Chain) {
+    CT.Instructions.push_back(IT);
+    if (ResultType) {
+      const unsigned Local = getChainLocal(*ResultType, Chain);
+      if (ChainOperand < 0) {
+        // Fold the result into an accumulator so that it is not dead.
+        CT.Instructions.push_back(
+            createLocalAccess(LocalGetOpcodes[*ResultType], Local));
+        CT.Instructions.emplace_back(
+            State.getIC().getInstr(FoldOpcodes[*ResultType]));
+      }
+      CT.Instructions.push_back(
+          createLocalAccess(LocalSetOpcodes[*ResultType], Local));
+    }
+    // Push the operands of the next repetition.
+    const unsigned NextChain = (Chain + 1) % NumChains;
+    for (unsigned I = 0, E = OperandTypes.size(); I != E; ++I) {
+      const ValueType VT = OperandTypes[I];
+      CT.Instructions.push_back(createLocalAccess(
+          LocalGetOpcodes[VT], static_cast<int>(I) == ChainOperand
+                                   ? getChainLocal(VT, NextChain)
+                                   : getInputLocal(VT)));
+    }
+  }
+  if (NumChains == 1)
+    CT.Info = "result chained to the next repetition through a local";
+  else if (ChainOperand >= 0)
+    CT.Info = llvm::formatv("{0} independent chains", NumChains).str();
+  else
+    CT.Info =
+        llvm::formatv("results folded into {0} accumulators", NumChains).str();
+  return getSingleton(std::move(CT));
+}
+
+// A snippet in the binary format, ready to be repeated in the benchmark loop.
+struct EncodedSnippet {
+  // Pushes the operands of the first repetition.
+  llvm::SmallString<32> Prologue;
+  // One repetition of the snippet.
+  llvm::SmallString<64> Body;
+  // The number of values left on the stack after the last repetition.
+  unsigned NumExtraValues = 0;
+};
+
+// Runs a pair of benchmark modules that only differ by their number of
+// iterations, and measures the time taken by the extra iterations. Start-up
+// and compilation times are the same for both and cancel out.
+class ModuleExecutor : public BenchmarkRunner::FunctionExecutor {
+public:
+  ModuleExecutor(llvm::StringRef ShortModule, llvm::StringRef LongModule)
+      : ShortModule(ShortModule), LongModule(LongModule) {}
+
+private:
+  // Returns the time in nanoseconds. `Counters` is unused.
+  llvm::Expected<int64_t> runAndMeasure(const char *Counters) const override;
+
+  llvm::Expected<int64_t> runFastest(llvm::StringRef Module) const;
+
+  const std::string ShortModule;
+  const std::string LongModule;
+};
+
+llvm::Expected<int64_t>
+ModuleExecutor::runFastest(llvm::StringRef Module) const {
+  llvm::SmallVector<llvm::StringRef, 4> Args;
+  llvm::StringRef(WasmRunner).split(Args, ' ', /*MaxSplit=*/-1,
+                                    /*KeepEmpty=*/false);
+  if (Args.empty())
+    return llvm::make_error<BenchmarkFailure>(
+        "-wasm-runner must give the command that runs the benchmark module");
+  auto Program = llvm::sys::findProgramByName(Args[0]);
+  if (!Program)
+    return llvm::make_error<BenchmarkFailure>(
+        llvm::Twine("cannot find ").concat(Args[0]));
+  Args.push_back(Module);
+  // The output of the runtime would get mixed with the benchmark results.
+  const llvm::Optional<llvm::StringRef> Redirects[] = {
+      llvm::None, llvm::StringRef(""), llvm::None};
+
+  int64_t Fastest = INT64_MAX;
+  for (unsigned Run = 0; Run < std::max(1u, WasmRuns.getValue()); ++Run) {
+    std::string ErrMsg;
+    const auto Start = std::chrono::steady_clock::now();
+    const int Ret = llvm::sys::ExecuteAndWait(*Program, Args, llvm::None,
+                                              Redirects, 0, 0, &ErrMsg);
+    const auto End = std::chrono::steady_clock::now();
+    if (Ret != 0) {
+      if (ErrMsg.empty())
+        ErrMsg = "exit code " + std::to_string(Ret);
+      return llvm::make_error<BenchmarkFailure>(
+          "'" + llvm::Twine(WasmRunner) + "' failed on " + Module + ": " +
+          ErrMsg);
+    }
+    Fastest = std::min<int64_t>(
+        Fastest, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     End - Start)
+                     .count());
+  }
+  return Fastest;
+}
+
+llvm::Expected<int64_t>
+ModuleExecutor::runAndMeasure(const char *Counters) const {
+  auto Short = runFastest(ShortModule);
+  if (!Short)
+    return Short.takeError();
+  auto Long = runFastest(LongModule);
+  if (!Long)
+    return Long.takeError();
+  if (*Long <= *Short)
+    return llvm::make_error<BenchmarkFailure>(
+        "the measurement is below the noise level, increase -wasm-iterations "
+        "or -num-repetitions");
+  return *Long - *Short;
+}
+
+class WebAssemblyBenchmarkRunner : public BenchmarkRunner {
+public:
+  WebAssemblyBenchmarkRunner(const LLVMState &State,
+                             InstructionBenchmark::ModeE Mode)
+      : BenchmarkRunner(State, Mode) {}
+
+  InstructionBenchmark runConfiguration(const BenchmarkCode &Configuration,
+                                        unsigned NumRepetitions,
+                                        bool DumpObjectToDisk) const override;
+
+private:
+  llvm::Expected<std::vector<BenchmarkMeasure>>
+  runMeasurements(const FunctionExecutor &Executor) const override;
+
+  llvm::Expected<EncodedSnippet>
+  encodeSnippet(llvm::ArrayRef<llvm::MCInst> Instructions) const;
+
+  llvm::Expected<std::string> writeModule(const EncodedSnippet &Snippet,
+                                          unsigned NumRepetitions,
+                                          unsigned NumIterations) const;
+};
+
+llvm::Expected<EncodedSnippet> WebAssemblyBenchmarkRunner::encodeSnippet(
+    llvm::ArrayRef<llvm::MCInst> Instructions) const {
+  const llvm::TargetMachine &TM = State.getTargetMachine();
+  llvm::MCObjectFileInfo ObjectFileInfo;
+  llvm::MCContext Context(TM.getMCAsmInfo(), TM.getMCRegisterInfo(),
+                          &ObjectFileInfo);
+  std::unique_ptr<const llvm::MCCodeEmitter> CodeEmitter(
+      TM.getTarget().createMCCodeEmitter(*TM.getMCInstrInfo(),
+                                         *TM.getMCRegisterInfo(), Context));
+  std::unique_ptr<const llvm::MCInstrAnalysis> InstrAnalysis(
+      TM.getTarget().createMCInstrAnalysis(TM.getMCInstrInfo()));
+
+  // Encode each instruction, and track the stack depth before it.
+  std::vector<llvm::SmallString<8>> Encodings(Instructions.size());
+  std::vector<int> Depths(Instructions.size() + 1);
+  for (size_t I = 0, E = Instructions.size(); I != E; ++I) {
+    const llvm::MCInst &Inst = Instructions[I];
+    unsigned Pops, Pushes;
+    if (!InstrAnalysis->getStackEffect(Inst, Pops, Pushes))
+      return llvm::make_error<BenchmarkFailure>(
+          llvm::Twine("cannot tell the stack effect of ")
+              .concat(State.getInstrInfo().getName(Inst.getOpcode())));
+    Depths[I + 1] = Depths[I] - Pops + Pushes;
+    llvm::raw_svector_ostream OS(Encodings[I]);
+    llvm::SmallVector<llvm::MCFixup, 4> Fixups;
+    CodeEmitter->encodeInstruction(Inst, OS, Fixups, *TM.getMCSubtargetInfo());
+    if (!Fixups.empty())
+      return llvm::make_error<BenchmarkFailure>(
+          "snippets cannot refer to symbols");
+  }
+  if (Depths.back() != 0)
+    return llvm::make_error<BenchmarkFailure>(
+        "the snippet must leave the stack as it found it");
+
+  // The prologue is the tail of the snippet that pushes the values its head
+  // pops, i.e. what follows its last point of minimal stack depth.
+  const auto Min = std::min_element(Depths.rbegin(), Depths.rend());
+  const size_t PrologueStart = Depths.rend() - Min - 1;
+  EncodedSnippet Result;
+  Result.NumExtraValues = -*Min;
+  for (size_t I = 0, E = Instructions.size(); I != E; ++I) {
+    Result.Body += Encodings[I];
+    if (I >= PrologueStart)
+      Result.Prologue += Encodings[I];
+  }
+
+  // Check that neither the prologue nor the snippet pop more than was pushed.
+  int Depth = 0;
+  for (size_t I = PrologueStart, E = Instructions.size() * 2; I != E; ++I) {
+    const llvm::MCInst &Inst = Instructions[I % Instructions.size()];
+    unsigned Pops, Pushes;
+    InstrAnalysis->getStackEffect(Inst, Pops, Pushes);
+    if (Depth < static_cast<int>(Pops))
+      return llvm::make_error<BenchmarkFailure>(
+          "the snippet pops values that it does not push");
+    Depth += Pushes - Pops;
+  }
+  return std::move(Result);
+}
+
+static void writeSection(llvm::raw_ostream &OS, unsigned ID,
+                         llvm::StringRef Content) {
+  OS << static_cast<char>(ID);
+  llvm::encodeULEB128(Content.size(), OS);
+  OS << Content;
+}
+
+static void writeI32Const(llvm::raw_ostream &OS, int32_t Value) {
+  OS << static_cast<char>(llvm::wasm::WASM_OPCODE_I32_CONST);
+  llvm::encodeSLEB128(Value, OS);
+}
+
+// Writes a module that exports, as both "run" and "_start", a function that
+// runs NumIterations times a loop of NumRepetitions repetitions of Snippet.
+llvm::Expected<std::string>
+WebAssemblyBenchmarkRunner::writeModule(const EncodedSnippet &Snippet,
+                                        unsigned NumRepetitions,
+                                        unsigned NumIterations) const {
+  static const uint8_t ValueTypes[] = {
+      llvm::wasm::WASM_TYPE_I32, llvm::wasm::WASM_TYPE_I64,
+      llvm::wasm::WASM_TYPE_F32, llvm::wasm::WASM_TYPE_F64};
+  // The binary opcodes of the loads and stores of each value type.
+  static const uint8_t Loads[] = {0x28, 0x29, 0x2a, 0x2b};
+  static const uint8_t Stores[] = {0x36, 0x37, 0x38, 0x39};
+  constexpr uint8_t kBlockTypeEmpty = 0x40;
+  constexpr uint8_t kLoop = 0x03, kBrIf = 0x0d, kDrop = 0x1a;
+  constexpr uint8_t kEnd = llvm::wasm::WASM_OPCODE_END;
+  constexpr uint8_t kLocalGet = llvm::wasm::WASM_OPCODE_LOCAL_GET;
+  constexpr uint8_t kLocalSet = 0x21, kLocalTee = 0x22;
+  constexpr uint8_t kI32Sub = 0x6b;
+
+  std::string Function;
+  llvm::raw_string_ostream FOS(Function);
+  // Locals.
+  llvm::encodeULEB128(VT_Count + 1, FOS);
+  for (const uint8_t Type : ValueTypes)
+    FOS << static_cast<char>(kLocalsPerType) << static_cast<char>(Type);
+  FOS << '\x01' << static_cast<char>(llvm::wasm::WASM_TYPE_I32);
+  // Load the inputs into all the locals of their type.
+  for (unsigned VT = 0; VT != VT_Count; ++VT) {
+    for (unsigned I = 0; I != kLocalsPerType; ++I) {
+      writeI32Const(FOS, kInputAddress + 8 * VT);
+      FOS << static_cast<char>(Loads[VT]) << '\0' << '\0';
+      FOS << static_cast<char>(kLocalSet);
+      llvm::encodeULEB128(VT * kLocalsPerType + I, FOS);
+    }
+  }
+  writeI32Const(FOS, NumIterations);
+  FOS << static_cast<char>(kLocalSet);
+  llvm::encodeULEB128(kCounterLocal, FOS);
+  // The loop.
+  FOS << static_cast<char>(kLoop) << static_cast<char>(kBlockTypeEmpty);
+  FOS << Snippet.Prologue;
+  for (unsigned I = 0; I != NumRepetitions; ++I)
+    FOS << Snippet.Body;
+  for (unsigned I = 0; I != Snippet.NumExtraValues; ++I)
+    FOS << static_cast<char>(kDrop);
+  FOS << static_cast<char>(kLocalGet);
+  llvm::encodeULEB128(kCounterLocal, FOS);
+  writeI32Const(FOS, 1);
+  FOS << static_cast<char>(kI32Sub) << static_cast<char>(kLocalTee);
+  llvm::encodeULEB128(kCounterLocal, FOS);
+  FOS << static_cast<char>(kBrIf) << '\0' << static_cast<char>(kEnd);
+  // Store the results.
+  for (unsigned VT = 0; VT != VT_Count; ++VT) {
+    for (unsigned I = 0; I != kLocalsPerType; ++I) {
+      const unsigned Local = VT * kLocalsPerType + I;
+      writeI32Const(FOS, kResultAddress + 8 * Local);
+      FOS << static_cast<char>(kLocalGet);
+      llvm::encodeULEB128(Local, FOS);
+      FOS << static_cast<char>(Stores[VT]) << '\0' << '\0';
+    }
+  }
+  FOS << static_cast<char>(kEnd);
+  FOS.flush();
+
+  std::string Code;
+  llvm::raw_string_ostream COS(Code);
+  COS << '\x01';
+  llvm::encodeULEB128(Function.size(), COS);
+  COS << Function;
+  COS.flush();
+
+  // The inputs, see kInputAddress.
+  std::string Data;
+  llvm::raw_string_ostream DOS(Data);
+  DOS << '\x01' << '\0';
+  writeI32Const(DOS, kInputAddress);
+  DOS << static_cast<char>(kEnd) << '\x20';
+  const uint32_t I32Input = kInputAddress;
+  const uint64_t I64Input = 1;
+  const float F32Input = 1.0f;
+  const double F64Input = 1.0;
+  char Inputs[32] = {};
+  llvm::support::endian::write32le(Inputs, I32Input);
+  llvm::support::endian::write64le(Inputs + 8, I64Input);
+  llvm::support::endian::write32le(Inputs + 16, llvm::FloatToBits(F32Input));
+  llvm::support::endian::write64le(Inputs + 24, llvm::DoubleToBits(F64Input));
+  DOS.write(Inputs, sizeof(Inputs));
+  DOS.flush();
+
+  int ResultFD = 0;
+  llvm::SmallString<256> ResultPath;
+  if (llvm::Error E = llvm::errorCodeToError(llvm::sys::fs::createTemporaryFile(
+          "snippet", "wasm", ResultFD, ResultPath)))
+    return std::move(E);
+  llvm::raw_fd_ostream OS(ResultFD, true /*ShouldClose*/);
+  OS.write(llvm::wasm::WasmMagic, sizeof(llvm::wasm::WasmMagic));
+  OS << '\x01' << '\0' << '\0' << '\0';
+  // A single () -> () function.
+  writeSection(OS, llvm::wasm::WASM_SEC_TYPE,
+               llvm::StringRef("\x01\x60\x00\x00", 4));
+  writeSection(OS, llvm::wasm::WASM_SEC_FUNCTION,
+               llvm::StringRef("\x01\x00", 2));
+  // One page of memory.
+  writeSection(OS, llvm::wasm::WASM_SEC_MEMORY,
+               llvm::StringRef("\x01\x00\x01", 3));
+  writeSection(OS, llvm::wasm::WASM_SEC_EXPORT,
+               llvm::StringRef("\x02"
+                               "\x03run\x00\x00"
+                               "\x06_start\x00\x00",
+                               16));
+  writeSection(OS, llvm::wasm::WASM_SEC_CODE, Code);
+  writeSection(OS, llvm::wasm::WASM_SEC_DATA, Data);
+  return ResultPath.str();
+}
+
+InstructionBenchmark WebAssemblyBenchmarkRunner::runConfiguration(
+    const BenchmarkCode &BC, unsigned NumRepetitions,
+    bool DumpObjectToDisk) const {
+  InstructionBenchmark InstrBenchmark;
+  InstrBenchmark.Mode = Mode;
+  InstrBenchmark.CpuName = State.getTargetMachine().getTargetCPU();
+  InstrBenchmark.LLVMTriple =
+      State.getTargetMachine().getTargetTriple().normalize();
+  InstrBenchmark.NumRepetitions = NumRepetitions;
+  InstrBenchmark.Info = BC.Info;
+  InstrBenchmark.Key.Instructions = BC.Instructions;
+  InstrBenchmark.Key.RegisterInitialValues = BC.RegisterInitialValues;
+
+  if (BC.Instructions.empty()) {
+    InstrBenchmark.Error = "empty snippet";
+    return InstrBenchmark;
+  }
+  auto Snippet = encodeSnippet(BC.Instructions);
+  if (llvm::Error E = Snippet.takeError()) {
+    InstrBenchmark.Error = llvm::toString(std::move(E));
+    return InstrBenchmark;
+  }
+  InstrBenchmark.AssembledSnippet.assign(Snippet->Body.begin(),
+                                         Snippet->Body.end());
+
+  // Repeat the snippet until there are at least NumRepetitions instructions,
+  // and run the loop once with WasmIterations and once with twice as many.
+  const unsigned NumSnippets =
+      llvm::divideCeil(NumRepetitions, BC.Instructions.size());
+  const unsigned NumIterations = std::max(1u, WasmIterations.getValue());
+  std::string Modules[2];
+  for (unsigned I = 0; I != 2; ++I) {
+    auto ModulePath =
+        writeModule(*Snippet, NumSnippets, NumIterations << I);
+    if (llvm::Error E = ModulePath.takeError()) {
+      InstrBenchmark.Error = llvm::toString(std::move(E));
+      return InstrBenchmark;
+    }
+    Modules[I] = std::move(*ModulePath);
+  }
+  llvm::FileRemover ShortRemover(Modules[0], !DumpObjectToDisk);
+  llvm::FileRemover LongRemover(Modules[1], !DumpObjectToDisk);
+  if (DumpObjectToDisk)
+    llvm::outs() << "Check generated module with: llvm-objdump -d "
+                 << Modules[0] << "\n";
+
+  const ModuleExecutor Executor(Modules[0], Modules[1]);
+  auto Measurements = runMeasurements(Executor);
+  if (llvm::Error E = Measurements.takeError()) {
+    InstrBenchmark.Error = llvm::toString(std::move(E));
+    return InstrBenchmark;
+  }
+  InstrBenchmark.Measurements = std::move(*Measurements);
+  // The extra iterations ran NumSnippets snippets each, and every snippet runs
+  // the key instruction once per chain.
+  const unsigned NumKeyInstructions = llvm::count_if(
+      BC.Instructions, [&BC](const llvm::MCInst &Inst) {
+        return Inst.getOpcode() == BC.Instructions[0].getOpcode();
+      });
+  const double NumExtraSnippets =
+      static_cast<double>(NumSnippets) * NumIterations;
+  for (BenchmarkMeasure &BM : InstrBenchmark.Measurements) {
+    BM.PerInstructionValue /= NumExtraSnippets * NumKeyInstructions;
+    BM.PerSnippetValue /= NumExtraSnippets;
+  }
+  return InstrBenchmark;
+}
+
+llvm::Expected<std::vector<BenchmarkMeasure>>
+WebAssemblyBenchmarkRunner::runMeasurements(
+    const FunctionExecutor &Executor) const {
+  auto ExpectedNanoseconds = Executor.runAndMeasure(nullptr);
+  if (!ExpectedNanoseconds)
+    return ExpectedNanoseconds.takeError();
+  const double Cycles = *ExpectedNanoseconds * WasmHostGHz;
+  switch (Mode) {
+  case InstructionBenchmark::Latency:
+    return std::vector<BenchmarkMeasure>{
+        BenchmarkMeasure::Create("latency", Cycles)};
+  case InstructionBenchmark::InverseThroughput:
+    return std::vector<BenchmarkMeasure>{
+        BenchmarkMeasure::Create("inverse_throughput", Cycles)};
+  default:
+    break;
+  }
+  return llvm::make_error<BenchmarkFailure>(
+      "unexpected benchmark mode for the WebAssembly runner");
+}
+
+class ExegesisWebAssemblyTarget : public ExegesisTarget {
+public:
+  ExegesisWebAssemblyTarget() : ExegesisTarget({}) {}
+
+private:
+  // Snippets keep their values in locals, there are no registers to set.
+  std::vector<llvm::MCInst> setRegTo(const llvm::MCSubtargetInfo &STI,
+                                     unsigned Reg,
+                                     const llvm::APInt &Value) const override {
+    return {};
+  }
+
+  bool matchesArch(llvm::Triple::ArchType Arch) const override {
+    return Arch == llvm::Triple::wasm32 || Arch == llvm::Triple::wasm64;
+  }
+
+  std::unique_ptr<SnippetGenerator>
+  createLatencySnippetGenerator(const LLVMState &State) const override {
+    return llvm::make_unique<WebAssemblySnippetGenerator>(State, 1);
+  }
+
+  std::unique_ptr<SnippetGenerator>
+  createUopsSnippetGenerator(const LLVMState &State) const override {
+    return llvm::make_unique<WebAssemblySnippetGenerator>(State,
+                                                          kNumParallelChains);
+  }
+
+  std::unique_ptr<BenchmarkRunner>
+  createLatencyBenchmarkRunner(const LLVMState &State,
+                               InstructionBenchmark::ModeE Mode) const override {
+    return llvm::make_unique<WebAssemblyBenchmarkRunner>(State, Mode);
+  }
+
+  // There are no micro-ops to count under a runtime.
+  std::unique_ptr<BenchmarkRunner>
+  createUopsBenchmarkRunner(const LLVMState &State) const override {
+    return nullptr;
+  }
+};
+
+} // end anonymous namespace
+
+static ExegesisTarget *getTheExegesisWebAssemblyTarget() {
+  static ExegesisWebAssemblyTarget Target;
+  return &Target;
+}
+
+void InitializeWebAssemblyExegesisTarget() {
+  ExegesisTarget::registerTarget(getTheExegesisWebAssemblyTarget());
+}
+
+} // namespace exegesis
+} // namespace llvm
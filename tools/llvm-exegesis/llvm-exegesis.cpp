@@ -20,6 +20,7 @@
 #include "lib/Target.h"
 #include "lib/TargetSelect.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/Triple.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/MC/MCInstBuilder.h"
 #include "llvm/MC/MCObjectFileInfo.h"
@@ -138,6 +139,12 @@ static cl::opt<std::string> CpuName(
     cl::desc("cpu name to use for pfm counters, leave empty to autodetect"),
     cl::cat(Options), cl::init(""));
 
+static cl::opt<std::string>
+    TripleName("mtriple",
+               cl::desc("target triple, leave empty to use the host. wasm32 "
+                        "snippets are run with -wasm-runner"),
+               cl::cat(Options), cl::init(""));
+
 static cl::opt<bool>
     DumpObjectToDisk("dump-object-to-disk",
                      cl::desc("dumps the generated benchmark object to disk "
@@ -355,21 +362,37 @@ readSnippets(const LLVMState &State, llvm::StringRef Filename) {
   return std::vector<BenchmarkCode>{std::move(Result)};
 }
 
+// Returns the state for -mtriple, after initializing its target.
+static LLVMState createTargetState() {
+  if (!InitializeWebAssemblyExegesisTargets())
+    llvm::report_fatal_error("llvm-exegesis was built without a target for " +
+                             TripleName);
+  const llvm::Triple TheTriple(llvm::Triple::normalize(TripleName));
+  if (TheTriple.getArch() != llvm::Triple::wasm32 &&
+      TheTriple.getArch() != llvm::Triple::wasm64)
+    llvm::report_fatal_error("cannot benchmark " + TripleName +
+                             " on this host");
+  return LLVMState(TheTriple.str(), CpuName, "");
+}
+
 void benchmarkMain() {
+  const bool OnHost = TripleName.empty();
+  if (OnHost) {
 #ifndef HAVE_LIBPFM
-  llvm::report_fatal_error(
-      "benchmarking unavailable, LLVM was built without libpfm.");
+    llvm::report_fatal_error(
+        "benchmarking unavailable, LLVM was built without libpfm.");
 #endif
 
-  if (exegesis::pfm::pfmInitialize())
-    llvm::report_fatal_error("cannot initialize libpfm");
+    if (exegesis::pfm::pfmInitialize())
+      llvm::report_fatal_error("cannot initialize libpfm");
 
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
-  llvm::InitializeNativeTargetAsmParser();
-  InitializeNativeExegesisTarget();
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+    InitializeNativeExegesisTarget();
+  }
 
-  const LLVMState State(CpuName);
+  const LLVMState State = OnHost ? LLVMState(CpuName) : createTargetState();
   const auto Opcodes = getOpcodesOrDie(State.getInstrInfo());
 
   std::vector<BenchmarkCode> Configurations;
@@ -415,7 +438,8 @@ void benchmarkMain() {
         Runner->runConfiguration(Conf, NumRepetitions, DumpObjectToDisk);
     ExitOnErr(Result.writeYaml(State, BenchmarkFile));
   }
-  exegesis::pfm::pfmTerminate();
+  if (OnHost)
+    exegesis::pfm::pfmTerminate();
 }
 
 // Prints the results of running analysis pass `Pass` to file `OutputFilename`
@@ -450,11 +474,15 @@ static void analysisMain() {
         "--analysis-inconsistencies-output-file must be specified.");
   }
 
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
-  llvm::InitializeNativeTargetDisassembler();
   // Read benchmarks.
-  const LLVMState State("");
+  const LLVMState State = [] {
+    if (!TripleName.empty())
+      return createTargetState();
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetDisassembler();
+    return LLVMState("");
+  }();
   const std::vector<InstructionBenchmark> Points =
       ExitOnErr(InstructionBenchmark::readYamls(State, BenchmarkFile));
   llvm::outs() << "Parsed " << Points.size() << " benchmark points\n";
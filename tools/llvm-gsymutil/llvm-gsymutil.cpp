@@ -0,0 +1,221 @@
+//===-- llvm-gsymutil.cpp - GSYM dumping and creation utility for llvm ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This program converts the DWARF and symbol table of an object file into a
+// GSYM file, and looks up addresses in or dumps existing GSYM files.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/LookupResult.h"
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/Object/MachOUniversal.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace gsym;
+using namespace object;
+
+namespace {
+using namespace cl;
+
+OptionCategory GeneralOptions("Options");
+OptionCategory ConversionOptions("Conversion Options");
+OptionCategory LookupOptions("Lookup Options");
+
+static list<std::string>
+    InputFilenames(Positional, desc("<input GSYM files>"), ZeroOrMore,
+                   cat(GeneralOptions));
+
+static opt<std::string>
+    ConvertFilename("convert", cl::init(""),
+                    cl::desc("Convert the specified file to the GSYM format.\n"
+                             "Supported files include ELF and mach-o files "
+                             "that will have their debug info (DWARF) and "
+                             "symbol table converted."),
+                    cl::value_desc("path"), cat(ConversionOptions));
+
+static opt<std::string>
+    OutputFilename("out-file", cl::init(""),
+                   cl::desc("Specify the path where the converted GSYM file "
+                            "will be saved.\nWhen not specified, a '.gsym' "
+                            "extension will be appended to the file name "
+                            "specified in the --convert option."),
+                   cl::value_desc("path"), cat(ConversionOptions));
+static alias OutputFilenameAlias("o", desc("Alias for -out-file."),
+                                 aliasopt(OutputFilename),
+                                 cat(ConversionOptions));
+
+static opt<unsigned>
+    NumThreads("num-threads",
+               desc("Specify the maximum number (n) of simultaneous threads "
+                    "to use when converting files to GSYM.\nDefaults to the "
+                    "number of cores on the current machine."),
+               cl::value_desc("n"), cat(ConversionOptions));
+
+static opt<bool> Verify("verify",
+                        desc("Verify the generated GSYM file against the "
+                             "information in the file that was converted."),
+                        cat(ConversionOptions));
+
+static list<uint64_t> LookupAddresses("address",
+                                      desc("Lookup an address in a GSYM file"),
+                                      cl::value_desc("addr"),
+                                      cat(LookupOptions));
+} // namespace
+
+static void error(StringRef Prefix, llvm::Error Err) {
+  if (!Err)
+    return;
+  WithColor::error() << Prefix << ": " << Err << "\n";
+  exit(1);
+}
+
+static llvm::Error handleObjectFile(ObjectFile &Obj,
+                                    const std::string &OutFile) {
+  auto ThreadCount =
+      NumThreads > 0 ? NumThreads : llvm::hardware_concurrency();
+  auto &OS = outs();
+
+  GsymCreator Gsym;
+
+  // Convert the DWARF first so that the symbol table only fills in the
+  // functions that have no debug info.
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(Obj);
+  DwarfTransformer DT(*DICtx, OS, Gsym);
+  if (auto Err = DT.convert(ThreadCount))
+    return Err;
+
+  // Get the UUID and convert symbol table to GSYM.
+  if (auto Err = ObjectFileTransformer::convert(Obj, OS, Gsym))
+    return Err;
+
+  // Finalize the GSYM to make it ready to save to disk. This will remove
+  // duplicate FunctionInfo entries where we might have found an entry from
+  // debug info and also a symbol table entry from the object file.
+  if (auto Err = Gsym.finalize(OS))
+    return Err;
+
+  // Save the GSYM file to disk.
+  support::endianness Endian =
+      Obj.isLittleEndian() ? support::little : support::big;
+  if (auto Err = Gsym.save(OutFile, Endian))
+    return Err;
+
+  // Verify the GSYM file if requested. This will ensure all the info in the
+  // DWARF can be looked up in the GSYM and that all lookups get matching data.
+  if (Verify) {
+    if (auto Err = DT.verify(OutFile))
+      return Err;
+    OS << "Verified " << OutFile << ".\n";
+  }
+
+  return Error::success();
+}
+
+static llvm::Error handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
+                                const std::string &OutFile) {
+  Expected<std::unique_ptr<Binary>> BinOrErr = object::createBinary(Buffer);
+  error(Filename, BinOrErr.takeError());
+
+  if (auto *Obj = dyn_cast<ObjectFile>(BinOrErr->get()))
+    return handleObjectFile(*Obj, OutFile);
+
+  if (auto *Fat = dyn_cast<MachOUniversalBinary>(BinOrErr->get())) {
+    // Convert each slice into its own GSYM file named after its
+    // architecture.
+    for (auto &ObjForArch : Fat->objects()) {
+      std::string ArchName = ObjForArch.getArchFlagName();
+      auto MachOOrErr = ObjForArch.getAsObjectFile();
+      error(Filename, MachOOrErr.takeError());
+      std::string ArchOutFile = OutFile + "." + ArchName;
+      if (auto Err = handleObjectFile(**MachOOrErr, ArchOutFile))
+        return Err;
+    }
+    return Error::success();
+  }
+
+  return createStringError(std::errc::invalid_argument,
+                           "unsupported file format");
+}
+
+static llvm::Error convertFileToGSYM(raw_ostream &OS) {
+  std::string OutFile = OutputFilename;
+  if (OutFile.empty())
+    OutFile = ConvertFilename + ".gsym";
+
+  OS << "Input file: " << ConvertFilename << "\n";
+  OS << "Output file: " << OutFile << "\n";
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+      MemoryBuffer::getFileOrSTDIN(ConvertFilename);
+  if (std::error_code EC = BuffOrErr.getError())
+    return createFileError(ConvertFilename, errorCodeToError(EC));
+  return handleBuffer(ConvertFilename, **BuffOrErr, OutFile);
+}
+
+int main(int argc, char const *argv[]) {
+  InitLLVM X(argc, argv);
+
+  const char *Overview =
+      "A tool for dumping, searching and creating GSYM files.\n\n"
+      "Specify one or more GSYM paths as arguments to dump all of the "
+      "information in each GSYM file.\n"
+      "Specify a single GSYM file along with one or more --address options "
+      "to lookup addresses within that GSYM file.\n"
+      "Use the --convert option to specify a file, and optionally the "
+      "--out-file option, to convert a file to the GSYM format.\n";
+  HideUnrelatedOptions({&GeneralOptions, &ConversionOptions, &LookupOptions});
+  cl::ParseCommandLineOptions(argc, argv, Overview);
+
+  raw_ostream &OS = outs();
+
+  if (!ConvertFilename.empty()) {
+    error("gsymutil", convertFileToGSYM(OS));
+    return EXIT_SUCCESS;
+  }
+
+  // Dump or access data inside GSYM files.
+  for (const auto &GSYMPath : InputFilenames) {
+    auto Gsym = GsymReader::openFile(GSYMPath);
+    if (!Gsym)
+      error(GSYMPath, Gsym.takeError());
+
+    if (LookupAddresses.empty()) {
+      Gsym->dump(outs());
+      continue;
+    }
+
+    // Lookup an address in a GSYM file and print any matches.
+    OS << "Looking up addresses in \"" << GSYMPath << "\":\n";
+    for (auto Addr : LookupAddresses) {
+      if (auto Result = Gsym->lookup(Addr)) {
+        OS << Result.get();
+      } else {
+        OS << format_hex(Addr, 18) << ": ";
+        logAllUnhandledErrors(Result.takeError(), OS, "error: ");
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
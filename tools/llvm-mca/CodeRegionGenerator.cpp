@@ -111,6 +111,10 @@ Expected<const CodeRegions &> AsmCodeRegionGenerator::parseCodeRegions() {
   Opts.PreserveAsmComments = false;
   MCStreamerWrapper Str(Ctx, Regions);
 
+  // Some targets handle their directives through the target streamer, so give
+  // them one that ignores them.
+  TheTarget.createNullTargetStreamer(Str);
+
   // Create a MCAsmParser and setup the lexer to recognize llvm-mca ASM
   // comments.
   std::unique_ptr<MCAsmParser> Parser(
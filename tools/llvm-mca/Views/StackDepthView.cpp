@@ -0,0 +1,74 @@
+//===--------------------- StackDepthView.cpp -------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file implements the StackDepthView API.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Views/StackDepthView.h"
+#include "llvm/Support/Format.h"
+#include <algorithm>
+
+namespace llvm {
+namespace mca {
+
+void StackDepthView::printView(raw_ostream &OS) const {
+  if (!MCIA)
+    return;
+
+  // Don't print anything for targets that are not stack machines.
+  unsigned Pops, Pushes;
+  if (none_of(Source, [&](const MCInst &Inst) {
+        return MCIA->getStackEffect(Inst, Pops, Pushes);
+      }))
+    return;
+
+  std::string Buffer;
+  raw_string_ostream TempStream(Buffer);
+
+  std::string Instruction;
+  raw_string_ostream InstrStream(Instruction);
+
+  TempStream << "\n\nStack Depth:\n";
+  TempStream << "[1]: Depth\n[2]: Pops\n[3]: Pushes\n\n";
+
+  TempStream << "[1]    [2]    [3]    Instructions:\n";
+  int Depth = 0;
+  int MaxDepth = 0;
+  int MinDepth = 0;
+  for (const MCInst &Inst : Source) {
+    TempStream << format(" %-6d", Depth);
+    if (MCIA->getStackEffect(Inst, Pops, Pushes)) {
+      TempStream << format("%-7u%-7u", Pops, Pushes);
+      Depth -= Pops;
+      MinDepth = std::min(MinDepth, Depth);
+      Depth += Pushes;
+      MaxDepth = std::max(MaxDepth, Depth);
+    } else {
+      TempStream << "-      -      ";
+    }
+
+    MCIP.printInst(&Inst, InstrStream, "", STI);
+    InstrStream.flush();
+
+    // Consume any tabs or spaces at the beginning of the string.
+    StringRef Str(Instruction);
+    Str = Str.ltrim();
+    TempStream << Str << '\n';
+    Instruction = "";
+  }
+
+  TempStream << "\nMax Depth:        " << MaxDepth;
+  TempStream << "\nValues Consumed:  " << -MinDepth;
+  TempStream << "\nNet Effect:       " << Depth << '\n';
+  TempStream.flush();
+  OS << Buffer;
+}
+} // namespace mca.
+} // namespace llvm
@@ -0,0 +1,74 @@
+//===--------------------- StackDepthView.h ---------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file implements the stack depth view.
+///
+/// The stack depth view is only meaningful for stack machines, like
+/// WebAssembly, where instructions implicitly take their operands from an
+/// operand stack. It prints the depth of the operand stack before every
+/// instruction of the code region, relative to the depth at the start of the
+/// region, together with the number of values each instruction pops and
+/// pushes.
+///
+/// Example:
+///
+/// Stack Depth:
+/// [1]: Depth
+/// [2]: Pops
+/// [3]: Pushes
+///
+/// [1]    [2]    [3]    Instructions:
+///  0      0      1     local.get	0
+///  1      0      1     i32.const	1
+///  2      2      1     i32.add
+///  1      1      0     local.set	0
+///
+/// Max Depth:        2
+/// Values Consumed:  0
+/// Net Effect:       0
+///
+/// "Values Consumed" is the number of values the region takes from the stack
+/// that were pushed before the region started. "Net Effect" is how much the
+/// stack grows (or shrinks) with every iteration of the region.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_MCA_STACKDEPTHVIEW_H
+#define LLVM_TOOLS_LLVM_MCA_STACKDEPTHVIEW_H
+
+#include "Views/View.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstPrinter.h"
+#include "llvm/MC/MCInstrAnalysis.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace mca {
+
+/// A view that prints the operand stack depth of stack machine code.
+class StackDepthView : public View {
+  const llvm::MCSubtargetInfo &STI;
+  const llvm::MCInstrAnalysis *MCIA;
+  llvm::ArrayRef<llvm::MCInst> Source;
+  llvm::MCInstPrinter &MCIP;
+
+public:
+  StackDepthView(const llvm::MCSubtargetInfo &sti,
+                 const llvm::MCInstrAnalysis *mcia,
+                 llvm::ArrayRef<llvm::MCInst> S, llvm::MCInstPrinter &IP)
+      : STI(sti), MCIA(mcia), Source(S), MCIP(IP) {}
+
+  void printView(llvm::raw_ostream &OS) const override;
+};
+} // namespace mca
+} // namespace llvm
+
+#endif
@@ -30,6 +30,7 @@
 #include "Views/ResourcePressureView.h"
 #include "Views/RetireControlUnitStatistics.h"
 #include "Views/SchedulerStatistics.h"
+#include "Views/StackDepthView.h"
 #include "Views/SummaryView.h"
 #include "Views/TimelineView.h"
 #include "llvm/MC/MCAsmInfo.h"
@@ -188,6 +189,11 @@ static cl::opt<bool>
                    cl::desc("Print all views including hardware statistics"),
                    cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<bool> PrintStackDepthView(
+    "stack-depth",
+    cl::desc("Print the operand stack depth view (stack machines only)"),
+    cl::cat(ViewOptions), cl::init(false));
+
 static cl::opt<bool> EnableBottleneckAnalysis(
     "bottleneck-analysis",
     cl::desc("Enable bottleneck analysis (disabled by default)"),
@@ -241,6 +247,7 @@ static void processViewOptions() {
     processOptionImpl(PrintResourcePressureView, EnableAllViews);
     processOptionImpl(PrintTimelineView, EnableAllViews);
     processOptionImpl(PrintInstructionInfoView, EnableAllViews);
+    processOptionImpl(PrintStackDepthView, EnableAllViews);
   }
 
   const cl::opt<bool> &Default =
@@ -469,6 +476,9 @@ int main(int argc, char **argv) {
         Printer.addView(llvm::make_unique<mca::InstructionInfoView>(
             *STI, *MCII, Insts, *IP));
       }
+      if (PrintStackDepthView)
+        Printer.addView(llvm::make_unique<mca::StackDepthView>(
+            *STI, MCIA.get(), Insts, *IP));
       Printer.addView(
           llvm::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
 
@@ -496,6 +506,10 @@ int main(int argc, char **argv) {
       Printer.addView(
           llvm::make_unique<mca::InstructionInfoView>(*STI, *MCII, Insts, *IP));
 
+    if (PrintStackDepthView)
+      Printer.addView(
+          llvm::make_unique<mca::StackDepthView>(*STI, MCIA.get(), Insts, *IP));
+
     if (PrintDispatchStats)
       Printer.addView(llvm::make_unique<mca::DispatchStatistics>());
 
@@ -92,61 +92,61 @@ static unsigned getNumUsedSlots(const UnwindCode &UnwindCode) {
 // slots is provided.
 static void printUnwindCode(ArrayRef<UnwindCode> UCs) {
   assert(UCs.size() >= getNumUsedSlots(UCs[0]));
-  outs() <<  format("      0x%02x: ", unsigned(UCs[0].u.CodeOffset))
-         << getUnwindCodeTypeName(UCs[0].getUnwindOp());
+  dumpOS() <<  format("      0x%02x: ", unsigned(UCs[0].u.CodeOffset))
+           << getUnwindCodeTypeName(UCs[0].getUnwindOp());
   switch (UCs[0].getUnwindOp()) {
   case UOP_PushNonVol:
-    outs() << " " << getUnwindRegisterName(UCs[0].getOpInfo());
+    dumpOS() << " " << getUnwindRegisterName(UCs[0].getOpInfo());
     break;
   case UOP_AllocLarge:
     if (UCs[0].getOpInfo() == 0) {
-      outs() << " " << UCs[1].FrameOffset;
+      dumpOS() << " " << UCs[1].FrameOffset;
     } else {
-      outs() << " " << UCs[1].FrameOffset
-                       + (static_cast<uint32_t>(UCs[2].FrameOffset) << 16);
+      dumpOS() << " " << UCs[1].FrameOffset
+                         + (static_cast<uint32_t>(UCs[2].FrameOffset) << 16);
     }
     break;
   case UOP_AllocSmall:
-    outs() << " " << ((UCs[0].getOpInfo() + 1) * 8);
+    dumpOS() << " " << ((UCs[0].getOpInfo() + 1) * 8);
     break;
   case UOP_SetFPReg:
-    outs() << " ";
+    dumpOS() << " ";
     break;
   case UOP_SaveNonVol:
-    outs() << " " << getUnwindRegisterName(UCs[0].getOpInfo())
-           << format(" [0x%04x]", 8 * UCs[1].FrameOffset);
+    dumpOS() << " " << getUnwindRegisterName(UCs[0].getOpInfo())
+             << format(" [0x%04x]", 8 * UCs[1].FrameOffset);
     break;
   case UOP_SaveNonVolBig:
-    outs() << " " << getUnwindRegisterName(UCs[0].getOpInfo())
-           << format(" [0x%08x]", UCs[1].FrameOffset
-                    + (static_cast<uint32_t>(UCs[2].FrameOffset) << 16));
+    dumpOS() << " " << getUnwindRegisterName(UCs[0].getOpInfo())
+             << format(" [0x%08x]", UCs[1].FrameOffset
+                      + (static_cast<uint32_t>(UCs[2].FrameOffset) << 16));
     break;
   case UOP_SaveXMM128:
-    outs() << " XMM" << static_cast<uint32_t>(UCs[0].getOpInfo())
-           << format(" [0x%04x]", 16 * UCs[1].FrameOffset);
+    dumpOS() << " XMM" << static_cast<uint32_t>(UCs[0].getOpInfo())
+             << format(" [0x%04x]", 16 * UCs[1].FrameOffset);
     break;
   case UOP_SaveXMM128Big:
-    outs() << " XMM" << UCs[0].getOpInfo()
-           << format(" [0x%08x]", UCs[1].FrameOffset
-                           + (static_cast<uint32_t>(UCs[2].FrameOffset) << 16));
+    dumpOS() << " XMM" << UCs[0].getOpInfo()
+             << format(" [0x%08x]", UCs[1].FrameOffset
+                      + (static_cast<uint32_t>(UCs[2].FrameOffset) << 16));
     break;
   case UOP_PushMachFrame:
-    outs() << " " << (UCs[0].getOpInfo() ? "w/o" : "w")
-           << " error code";
+    dumpOS() << " " << (UCs[0].getOpInfo() ? "w/o" : "w")
+             << " error code";
     break;
   }
-  outs() << "\n";
+  dumpOS() << "\n";
 }
 
 static void printAllUnwindCodes(ArrayRef<UnwindCode> UCs) {
   for (const UnwindCode *I = UCs.begin(), *E = UCs.end(); I < E; ) {
     unsigned UsedSlots = getNumUsedSlots(*I);
     if (UsedSlots > UCs.size()) {
-      outs() << "Unwind data corrupted: Encountered unwind op "
-             << getUnwindCodeTypeName((*I).getUnwindOp())
-             << " which requires " << UsedSlots
-             << " slots, but only " << UCs.size()
-             << " remaining in buffer";
+      dumpOS() << "Unwind data corrupted: Encountered unwind op "
+               << getUnwindCodeTypeName((*I).getUnwindOp())
+               << " which requires " << UsedSlots
+               << " slots, but only " << UCs.size()
+               << " remaining in buffer";
       return ;
     }
     printUnwindCode(makeArrayRef(I, E));
@@ -240,31 +240,31 @@ printSEHTable(const COFFObjectFile *Obj, uint32_t TableVA, int Count) {
   uintptr_t IntPtr = 0;
   error(Obj->getVaPtr(TableVA, IntPtr));
   const support::ulittle32_t *P = (const support::ulittle32_t *)IntPtr;
-  outs() << "SEH Table:";
+  dumpOS() << "SEH Table:";
   for (int I = 0; I < Count; ++I)
-    outs() << format(" 0x%x", P[I] + ImageBase);
-  outs() << "\n\n";
+    dumpOS() << format(" 0x%x", P[I] + ImageBase);
+  dumpOS() << "\n\n";
 }
 
 template <typename T>
 static void printTLSDirectoryT(const coff_tls_directory<T> *TLSDir) {
   size_t FormatWidth = sizeof(T) * 2;
-  outs() << "TLS directory:"
-         << "\n  StartAddressOfRawData: "
-         << format_hex(TLSDir->StartAddressOfRawData, FormatWidth)
-         << "\n  EndAddressOfRawData: "
-         << format_hex(TLSDir->EndAddressOfRawData, FormatWidth)
-         << "\n  AddressOfIndex: "
-         << format_hex(TLSDir->AddressOfIndex, FormatWidth)
-         << "\n  AddressOfCallBacks: "
-         << format_hex(TLSDir->AddressOfCallBacks, FormatWidth)
-         << "\n  SizeOfZeroFill: "
-         << TLSDir->SizeOfZeroFill
-         << "\n  Characteristics: "
-         << TLSDir->Characteristics
-         << "\n  Alignment: "
-         << TLSDir->getAlignment()
-         << "\n\n";
+  dumpOS() << "TLS directory:"
+           << "\n  StartAddressOfRawData: "
+           << format_hex(TLSDir->StartAddressOfRawData, FormatWidth)
+           << "\n  EndAddressOfRawData: "
+           << format_hex(TLSDir->EndAddressOfRawData, FormatWidth)
+           << "\n  AddressOfIndex: "
+           << format_hex(TLSDir->AddressOfIndex, FormatWidth)
+           << "\n  AddressOfCallBacks: "
+           << format_hex(TLSDir->AddressOfCallBacks, FormatWidth)
+           << "\n  SizeOfZeroFill: "
+           << TLSDir->SizeOfZeroFill
+           << "\n  Characteristics: "
+           << TLSDir->Characteristics
+           << "\n  Alignment: "
+           << TLSDir->getAlignment()
+           << "\n\n";
 }
 
 static void printTLSDirectory(const COFFObjectFile *Obj) {
@@ -293,7 +293,7 @@ static void printTLSDirectory(const COFFObjectFile *Obj) {
     printTLSDirectoryT(TLSDir);
   }
 
-  outs() << "\n";
+  dumpOS() << "\n";
 }
 
 static void printLoadConfiguration(const COFFObjectFile *Obj) {
@@ -315,27 +315,28 @@ static void printLoadConfiguration(const COFFObjectFile *Obj) {
   error(Obj->getRvaPtr(DataDir->RelativeVirtualAddress, IntPtr));
 
   auto *LoadConf = reinterpret_cast<const coff_load_configuration32 *>(IntPtr);
-  outs() << "Load configuration:"
-         << "\n  Timestamp: " << LoadConf->TimeDateStamp
-         << "\n  Major Version: " << LoadConf->MajorVersion
-         << "\n  Minor Version: " << LoadConf->MinorVersion
-         << "\n  GlobalFlags Clear: " << LoadConf->GlobalFlagsClear
-         << "\n  GlobalFlags Set: " << LoadConf->GlobalFlagsSet
-         << "\n  Critical Section Default Timeout: " << LoadConf->CriticalSectionDefaultTimeout
-         << "\n  Decommit Free Block Threshold: " << LoadConf->DeCommitFreeBlockThreshold
-         << "\n  Decommit Total Free Threshold: " << LoadConf->DeCommitTotalFreeThreshold
-         << "\n  Lock Prefix Table: " << LoadConf->LockPrefixTable
-         << "\n  Maximum Allocation Size: " << LoadConf->MaximumAllocationSize
-         << "\n  Virtual Memory Threshold: " << LoadConf->VirtualMemoryThreshold
-         << "\n  Process Affinity Mask: " << LoadConf->ProcessAffinityMask
-         << "\n  Process Heap Flags: " << LoadConf->ProcessHeapFlags
-         << "\n  CSD Version: " << LoadConf->CSDVersion
-         << "\n  Security Cookie: " << LoadConf->SecurityCookie
-         << "\n  SEH Table: " << LoadConf->SEHandlerTable
-         << "\n  SEH Count: " << LoadConf->SEHandlerCount
-         << "\n\n";
+  dumpOS() << "Load configuration:"
+           << "\n  Timestamp: " << LoadConf->TimeDateStamp
+           << "\n  Major Version: " << LoadConf->MajorVersion
+           << "\n  Minor Version: " << LoadConf->MinorVersion
+           << "\n  GlobalFlags Clear: " << LoadConf->GlobalFlagsClear
+           << "\n  GlobalFlags Set: " << LoadConf->GlobalFlagsSet
+           << "\n  Critical Section Default Timeout: " << LoadConf->CriticalSectionDefaultTimeout
+           << "\n  Decommit Free Block Threshold: " << LoadConf->DeCommitFreeBlockThreshold
+           << "\n  Decommit Total Free Threshold: " << LoadConf->DeCommitTotalFreeThreshold
+           << "\n  Lock Prefix Table: " << LoadConf->LockPrefixTable
+           << "\n  Maximum Allocation Size: " << LoadConf->MaximumAllocationSize
+           << "\n  Virtual Memory Threshold: "
+           << LoadConf->VirtualMemoryThreshold
+           << "\n  Process Affinity Mask: " << LoadConf->ProcessAffinityMask
+           << "\n  Process Heap Flags: " << LoadConf->ProcessHeapFlags
+           << "\n  CSD Version: " << LoadConf->CSDVersion
+           << "\n  Security Cookie: " << LoadConf->SecurityCookie
+           << "\n  SEH Table: " << LoadConf->SEHandlerTable
+           << "\n  SEH Count: " << LoadConf->SEHandlerCount
+           << "\n\n";
   printSEHTable(Obj, LoadConf->SEHandlerTable, LoadConf->SEHandlerCount);
-  outs() << "\n";
+  dumpOS() << "\n";
 }
 
 // Prints import tables. The import table is a table containing the list of
@@ -345,21 +346,22 @@ static void printImportTables(const COFFObjectFile *Obj) {
   import_directory_iterator E = Obj->import_directory_end();
   if (I == E)
     return;
-  outs() << "The Import Tables:\n";
+  dumpOS() << "The Import Tables:\n";
   for (const ImportDirectoryEntryRef &DirRef : Obj->import_directories()) {
     const coff_import_directory_table_entry *Dir;
     StringRef Name;
     if (DirRef.getImportTableEntry(Dir)) return;
     if (DirRef.getName(Name)) return;
 
-    outs() << format("  lookup %08x time %08x fwd %08x name %08x addr %08x\n\n",
-                     static_cast<uint32_t>(Dir->ImportLookupTableRVA),
-                     static_cast<uint32_t>(Dir->TimeDateStamp),
-                     static_cast<uint32_t>(Dir->ForwarderChain),
-                     static_cast<uint32_t>(Dir->NameRVA),
-                     static_cast<uint32_t>(Dir->ImportAddressTableRVA));
-    outs() << "    DLL Name: " << Name << "\n";
-    outs() << "    Hint/Ord  Name\n";
+    dumpOS() << format(
+        "  lookup %08x time %08x fwd %08x name %08x addr %08x\n\n",
+        static_cast<uint32_t>(Dir->ImportLookupTableRVA),
+        static_cast<uint32_t>(Dir->TimeDateStamp),
+        static_cast<uint32_t>(Dir->ForwarderChain),
+        static_cast<uint32_t>(Dir->NameRVA),
+        static_cast<uint32_t>(Dir->ImportAddressTableRVA));
+    dumpOS() << "    DLL Name: " << Name << "\n";
+    dumpOS() << "    Hint/Ord  Name\n";
     for (const ImportedSymbolRef &Entry : DirRef.imported_symbols()) {
       bool IsOrdinal;
       if (Entry.isOrdinal(IsOrdinal))
@@ -368,7 +370,7 @@ static void printImportTables(const COFFObjectFile *Obj) {
         uint16_t Ordinal;
         if (Entry.getOrdinal(Ordinal))
           return;
-        outs() << format("      % 6d\n", Ordinal);
+        dumpOS() << format("      % 6d\n", Ordinal);
         continue;
       }
       uint32_t HintNameRVA;
@@ -378,16 +380,16 @@ static void printImportTables(const COFFObjectFile *Obj) {
       StringRef Name;
       if (Obj->getHintName(HintNameRVA, Hint, Name))
         return;
-      outs() << format("      % 6d  ", Hint) << Name << "\n";
+      dumpOS() << format("      % 6d  ", Hint) << Name << "\n";
     }
-    outs() << "\n";
+    dumpOS() << "\n";
   }
 }
 
 // Prints export tables. The export table is a table containing the list of
 // exported symbol from the DLL.
 static void printExportTable(const COFFObjectFile *Obj) {
-  outs() << "Export Table:\n";
+  dumpOS() << "Export Table:\n";
   export_directory_iterator I = Obj->export_directory_begin();
   export_directory_iterator E = Obj->export_directory_end();
   if (I == E)
@@ -398,9 +400,9 @@ static void printExportTable(const COFFObjectFile *Obj) {
     return;
   if (I->getOrdinalBase(OrdinalBase))
     return;
-  outs() << " DLL name: " << DllName << "\n";
-  outs() << " Ordinal base: " << OrdinalBase << "\n";
-  outs() << " Ordinal      RVA  Name\n";
+  dumpOS() << " DLL name: " << DllName << "\n";
+  dumpOS() << " Ordinal base: " << OrdinalBase << "\n";
+  dumpOS() << " Ordinal      RVA  Name\n";
   for (; I != E; I = ++I) {
     uint32_t Ordinal;
     if (I->getOrdinal(Ordinal))
@@ -416,23 +418,23 @@ static void printExportTable(const COFFObjectFile *Obj) {
       // Export table entries can be used to re-export symbols that
       // this COFF file is imported from some DLLs. This is rare.
       // In most cases IsForwarder is false.
-      outs() << format("    % 4d         ", Ordinal);
+      dumpOS() << format("    % 4d         ", Ordinal);
     } else {
-      outs() << format("    % 4d %# 8x", Ordinal, RVA);
+      dumpOS() << format("    % 4d %# 8x", Ordinal, RVA);
     }
 
     StringRef Name;
     if (I->getSymbolName(Name))
       continue;
     if (!Name.empty())
-      outs() << "  " << Name;
+      dumpOS() << "  " << Name;
     if (IsForwarder) {
       StringRef S;
       if (I->getForwardTo(S))
         return;
-      outs() << " (forwarded to " << S << ")";
+      dumpOS() << " (forwarded to " << S << ")";
     }
-    outs() << "\n";
+    dumpOS() << "\n";
   }
 }
 
@@ -482,26 +484,27 @@ static void printWin64EHUnwindInfo(const Win64EH::UnwindInfo *UI) {
   // The casts to int are required in order to output the value as number.
   // Without the casts the value would be interpreted as char data (which
   // results in garbage output).
-  outs() << "    Version: " << static_cast<int>(UI->getVersion()) << "\n";
-  outs() << "    Flags: " << static_cast<int>(UI->getFlags());
+  dumpOS() << "    Version: " << static_cast<int>(UI->getVersion()) << "\n";
+  dumpOS() << "    Flags: " << static_cast<int>(UI->getFlags());
   if (UI->getFlags()) {
     if (UI->getFlags() & UNW_ExceptionHandler)
-      outs() << " UNW_ExceptionHandler";
+      dumpOS() << " UNW_ExceptionHandler";
     if (UI->getFlags() & UNW_TerminateHandler)
-      outs() << " UNW_TerminateHandler";
+      dumpOS() << " UNW_TerminateHandler";
     if (UI->getFlags() & UNW_ChainInfo)
-      outs() << " UNW_ChainInfo";
+      dumpOS() << " UNW_ChainInfo";
   }
-  outs() << "\n";
-  outs() << "    Size of prolog: " << static_cast<int>(UI->PrologSize) << "\n";
-  outs() << "    Number of Codes: " << static_cast<int>(UI->NumCodes) << "\n";
+  dumpOS() << "\n";
+  dumpOS() << "    Size of prolog: " << static_cast<int>(UI->PrologSize)
+           << "\n";
+  dumpOS() << "    Number of Codes: " << static_cast<int>(UI->NumCodes) << "\n";
   // Maybe this should move to output of UOP_SetFPReg?
   if (UI->getFrameRegister()) {
-    outs() << "    Frame register: "
-           << getUnwindRegisterName(UI->getFrameRegister()) << "\n";
-    outs() << "    Frame offset: " << 16 * UI->getFrameOffset() << "\n";
+    dumpOS() << "    Frame register: "
+             << getUnwindRegisterName(UI->getFrameRegister()) << "\n";
+    dumpOS() << "    Frame offset: " << 16 * UI->getFrameOffset() << "\n";
   } else {
-    outs() << "    No frame pointer used\n";
+    dumpOS() << "    No frame pointer used\n";
   }
   if (UI->getFlags() & (UNW_ExceptionHandler | UNW_TerminateHandler)) {
     // FIXME: Output exception handler data
@@ -510,12 +513,12 @@ static void printWin64EHUnwindInfo(const Win64EH::UnwindInfo *UI) {
   }
 
   if (UI->NumCodes)
-    outs() << "    Unwind Codes:\n";
+    dumpOS() << "    Unwind Codes:\n";
 
   printAllUnwindCodes(makeArrayRef(&UI->UnwindCodes[0], UI->NumCodes));
 
-  outs() << "\n";
-  outs().flush();
+  dumpOS() << "\n";
+  dumpOS().flush();
 }
 
 /// Prints out the given RuntimeFunction struct for x64, assuming that Obj is
@@ -524,13 +527,13 @@ static void printRuntimeFunction(const COFFObjectFile *Obj,
                                  const RuntimeFunction &RF) {
   if (!RF.StartAddress)
     return;
-  outs() << "Function Table:\n"
-         << format("  Start Address: 0x%04x\n",
-                   static_cast<uint32_t>(RF.StartAddress))
-         << format("  End Address: 0x%04x\n",
-                   static_cast<uint32_t>(RF.EndAddress))
-         << format("  Unwind Info Address: 0x%04x\n",
-                   static_cast<uint32_t>(RF.UnwindInfoOffset));
+  dumpOS() << "Function Table:\n"
+           << format("  Start Address: 0x%04x\n",
+                     static_cast<uint32_t>(RF.StartAddress))
+           << format("  End Address: 0x%04x\n",
+                     static_cast<uint32_t>(RF.EndAddress))
+           << format("  Unwind Info Address: 0x%04x\n",
+                     static_cast<uint32_t>(RF.UnwindInfoOffset));
   uintptr_t addr;
   if (Obj->getRvaPtr(RF.UnwindInfoOffset, addr))
     return;
@@ -547,27 +550,27 @@ static void printRuntimeFunctionRels(const COFFObjectFile *Obj,
                                      const RuntimeFunction &RF,
                                      uint64_t SectionOffset,
                                      const std::vector<RelocationRef> &Rels) {
-  outs() << "Function Table:\n";
-  outs() << "  Start Address: ";
-  printCOFFSymbolAddress(outs(), Rels,
+  dumpOS() << "Function Table:\n";
+  dumpOS() << "  Start Address: ";
+  printCOFFSymbolAddress(dumpOS(), Rels,
                          SectionOffset +
                              /*offsetof(RuntimeFunction, StartAddress)*/ 0,
                          RF.StartAddress);
-  outs() << "\n";
+  dumpOS() << "\n";
 
-  outs() << "  End Address: ";
-  printCOFFSymbolAddress(outs(), Rels,
+  dumpOS() << "  End Address: ";
+  printCOFFSymbolAddress(dumpOS(), Rels,
                          SectionOffset +
                              /*offsetof(RuntimeFunction, EndAddress)*/ 4,
                          RF.EndAddress);
-  outs() << "\n";
+  dumpOS() << "\n";
 
-  outs() << "  Unwind Info Address: ";
-  printCOFFSymbolAddress(outs(), Rels,
+  dumpOS() << "  Unwind Info Address: ";
+  printCOFFSymbolAddress(dumpOS(), Rels,
                          SectionOffset +
                              /*offsetof(RuntimeFunction, UnwindInfoOffset)*/ 8,
                          RF.UnwindInfoOffset);
-  outs() << "\n";
+  dumpOS() << "\n";
 
   ArrayRef<uint8_t> XContents;
   uint64_t UnwindInfoOffset = 0;
@@ -635,13 +638,13 @@ void printCOFFSymbolTable(const object::COFFImportFile *i) {
     cantFail(Sym.printName(NS));
     NS.flush();
 
-    outs() << "[" << format("%2d", Index) << "]"
-           << "(sec " << format("%2d", 0) << ")"
-           << "(fl 0x00)" // Flag bits, which COFF doesn't have.
-           << "(ty " << format("%3x", (IsCode && Index) ? 32 : 0) << ")"
-           << "(scl " << format("%3x", 0) << ") "
-           << "(nx " << 0 << ") "
-           << "0x" << format("%08x", 0) << " " << Name << '\n';
+    dumpOS() << "[" << format("%2d", Index) << "]"
+             << "(sec " << format("%2d", 0) << ")"
+             << "(fl 0x00)" // Flag bits, which COFF doesn't have.
+             << "(ty " << format("%3x", (IsCode && Index) ? 32 : 0) << ")"
+             << "(scl " << format("%3x", 0) << ") "
+             << "(nx " << 0 << ") "
+             << "0x" << format("%08x", 0) << " " << Name << '\n';
 
     ++Index;
   }
@@ -654,15 +657,15 @@ void printCOFFSymbolTable(const COFFObjectFile *coff) {
     error(Symbol.takeError());
     error(coff->getSymbolName(*Symbol, Name));
 
-    outs() << "[" << format("%2d", SI) << "]"
-           << "(sec " << format("%2d", int(Symbol->getSectionNumber())) << ")"
-           << "(fl 0x00)" // Flag bits, which COFF doesn't have.
-           << "(ty " << format("%3x", unsigned(Symbol->getType())) << ")"
-           << "(scl " << format("%3x", unsigned(Symbol->getStorageClass()))
-           << ") "
-           << "(nx " << unsigned(Symbol->getNumberOfAuxSymbols()) << ") "
-           << "0x" << format("%08x", unsigned(Symbol->getValue())) << " "
-           << Name;
+    dumpOS() << "[" << format("%2d", SI) << "]"
+             << "(sec " << format("%2d", int(Symbol->getSectionNumber())) << ")"
+             << "(fl 0x00)" // Flag bits, which COFF doesn't have.
+             << "(ty " << format("%3x", unsigned(Symbol->getType())) << ")"
+             << "(scl " << format("%3x", unsigned(Symbol->getStorageClass()))
+             << ") "
+             << "(nx " << unsigned(Symbol->getNumberOfAuxSymbols()) << ") "
+             << "0x" << format("%08x", unsigned(Symbol->getValue())) << " "
+             << Name;
     if (Demangle && Name.startswith("?")) {
       char *DemangledSymbol = nullptr;
       size_t Size = 0;
@@ -671,13 +674,13 @@ void printCOFFSymbolTable(const COFFObjectFile *coff) {
           microsoftDemangle(Name.data(), DemangledSymbol, &Size, &Status);
 
       if (Status == 0 && DemangledSymbol) {
-        outs() << " (" << StringRef(DemangledSymbol) << ")";
+        dumpOS() << " (" << StringRef(DemangledSymbol) << ")";
         std::free(DemangledSymbol);
       } else {
-        outs() << " (invalid mangled name)";
+        dumpOS() << " (invalid mangled name)";
       }
     }
-    outs() << "\n";
+    dumpOS() << "\n";
 
     for (unsigned AI = 0, AE = Symbol->getNumberOfAuxSymbols(); AI < AE; ++AI, ++SI) {
       if (Symbol->isSectionDefinition()) {
@@ -686,22 +689,22 @@ void printCOFFSymbolTable(const COFFObjectFile *coff) {
 
         int32_t AuxNumber = asd->getNumber(Symbol->isBigObj());
 
-        outs() << "AUX "
-               << format("scnlen 0x%x nreloc %d nlnno %d checksum 0x%x "
-                         , unsigned(asd->Length)
-                         , unsigned(asd->NumberOfRelocations)
-                         , unsigned(asd->NumberOfLinenumbers)
-                         , unsigned(asd->CheckSum))
-               << format("assoc %d comdat %d\n"
-                         , unsigned(AuxNumber)
-                         , unsigned(asd->Selection));
+        dumpOS() << "AUX "
+                 << format("scnlen 0x%x nreloc %d nlnno %d checksum 0x%x "
+                           , unsigned(asd->Length)
+                           , unsigned(asd->NumberOfRelocations)
+                           , unsigned(asd->NumberOfLinenumbers)
+                           , unsigned(asd->CheckSum))
+                 << format("assoc %d comdat %d\n"
+                           , unsigned(AuxNumber)
+                           , unsigned(asd->Selection));
       } else if (Symbol->isFileRecord()) {
         const char *FileName;
         error(coff->getAuxSymbol<char>(SI + 1, FileName));
 
         StringRef Name(FileName, Symbol->getNumberOfAuxSymbols() *
                                      coff->getSymbolTableEntrySize());
-        outs() << "AUX " << Name.rtrim(StringRef("\0", 1))  << '\n';
+        dumpOS() << "AUX " << Name.rtrim(StringRef("\0", 1))  << '\n';
 
         SI = SI + Symbol->getNumberOfAuxSymbols();
         break;
@@ -709,11 +712,12 @@ void printCOFFSymbolTable(const COFFObjectFile *coff) {
         const coff_aux_weak_external *awe;
         error(coff->getAuxSymbol<coff_aux_weak_external>(SI + 1, awe));
 
-        outs() << "AUX " << format("indx %d srch %d\n",
-                                   static_cast<uint32_t>(awe->TagIndex),
-                                   static_cast<uint32_t>(awe->Characteristics));
+        dumpOS() << "AUX "
+                 << format("indx %d srch %d\n",
+                           static_cast<uint32_t>(awe->TagIndex),
+                           static_cast<uint32_t>(awe->Characteristics));
       } else {
-        outs() << "AUX Unknown\n";
+        dumpOS() << "AUX Unknown\n";
       }
     }
   }
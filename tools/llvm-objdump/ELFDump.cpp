@@ -159,13 +159,13 @@ template <class ELFT>
 void printDynamicSection(const ELFFile<ELFT> *Elf, StringRef Filename) {
   ArrayRef<typename ELFT::Dyn> DynamicEntries =
       unwrapOrError(Elf->dynamicEntries(), Filename);
-  outs() << "Dynamic Section:\n";
+  dumpOS() << "Dynamic Section:\n";
   for (const typename ELFT::Dyn &Dyn : DynamicEntries) {
     if (Dyn.d_tag == ELF::DT_NULL)
       continue;
 
     std::string Str = Elf->getDynamicTagAsString(Dyn.d_tag);
-    outs() << format("  %-21s", Str.c_str());
+    dumpOS() << format("  %-21s", Str.c_str());
 
     const char *Fmt =
         ELFT::Is64Bits ? "0x%016" PRIx64 "\n" : "0x%08" PRIx64 "\n";
@@ -175,98 +175,99 @@ void printDynamicSection(const ELFFile<ELFT> *Elf, StringRef Filename) {
       Expected<StringRef> StrTabOrErr = getDynamicStrTab(Elf);
       if (StrTabOrErr) {
         const char *Data = StrTabOrErr.get().data();
-        outs() << (Data + Dyn.d_un.d_val) << "\n";
+        dumpOS() << (Data + Dyn.d_un.d_val) << "\n";
         continue;
       }
       warn(toString(StrTabOrErr.takeError()));
       consumeError(StrTabOrErr.takeError());
     }
-    outs() << format(Fmt, (uint64_t)Dyn.d_un.d_val);
+    dumpOS() << format(Fmt, (uint64_t)Dyn.d_un.d_val);
   }
 }
 
 template <class ELFT> void printProgramHeaders(const ELFFile<ELFT> *o) {
-  outs() << "Program Header:\n";
+  dumpOS() << "Program Header:\n";
   auto ProgramHeaderOrError = o->program_headers();
   if (!ProgramHeaderOrError)
     report_fatal_error(toString(ProgramHeaderOrError.takeError()));
   for (const typename ELFT::Phdr &Phdr : *ProgramHeaderOrError) {
     switch (Phdr.p_type) {
     case ELF::PT_DYNAMIC:
-      outs() << " DYNAMIC ";
+      dumpOS() << " DYNAMIC ";
       break;
     case ELF::PT_GNU_EH_FRAME:
-      outs() << "EH_FRAME ";
+      dumpOS() << "EH_FRAME ";
       break;
     case ELF::PT_GNU_RELRO:
-      outs() << "   RELRO ";
+      dumpOS() << "   RELRO ";
       break;
     case ELF::PT_GNU_STACK:
-      outs() << "   STACK ";
+      dumpOS() << "   STACK ";
       break;
     case ELF::PT_INTERP:
-      outs() << "  INTERP ";
+      dumpOS() << "  INTERP ";
       break;
     case ELF::PT_LOAD:
-      outs() << "    LOAD ";
+      dumpOS() << "    LOAD ";
       break;
     case ELF::PT_NOTE:
-      outs() << "    NOTE ";
+      dumpOS() << "    NOTE ";
       break;
     case ELF::PT_OPENBSD_BOOTDATA:
-      outs() << "    OPENBSD_BOOTDATA ";
+      dumpOS() << "    OPENBSD_BOOTDATA ";
       break;
     case ELF::PT_OPENBSD_RANDOMIZE:
-      outs() << "    OPENBSD_RANDOMIZE ";
+      dumpOS() << "    OPENBSD_RANDOMIZE ";
       break;
     case ELF::PT_OPENBSD_WXNEEDED:
-      outs() << "    OPENBSD_WXNEEDED ";
+      dumpOS() << "    OPENBSD_WXNEEDED ";
       break;
     case ELF::PT_PHDR:
-      outs() << "    PHDR ";
+      dumpOS() << "    PHDR ";
       break;
     case ELF::PT_TLS:
-      outs() << "    TLS ";
+      dumpOS() << "    TLS ";
       break;
     default:
-      outs() << " UNKNOWN ";
+      dumpOS() << " UNKNOWN ";
     }
 
     const char *Fmt = ELFT::Is64Bits ? "0x%016" PRIx64 " " : "0x%08" PRIx64 " ";
 
-    outs() << "off    " << format(Fmt, (uint64_t)Phdr.p_offset) << "vaddr "
-           << format(Fmt, (uint64_t)Phdr.p_vaddr) << "paddr "
-           << format(Fmt, (uint64_t)Phdr.p_paddr)
-           << format("align 2**%u\n",
-                     countTrailingZeros<uint64_t>(Phdr.p_align))
-           << "         filesz " << format(Fmt, (uint64_t)Phdr.p_filesz)
-           << "memsz " << format(Fmt, (uint64_t)Phdr.p_memsz) << "flags "
-           << ((Phdr.p_flags & ELF::PF_R) ? "r" : "-")
-           << ((Phdr.p_flags & ELF::PF_W) ? "w" : "-")
-           << ((Phdr.p_flags & ELF::PF_X) ? "x" : "-") << "\n";
+    dumpOS() << "off    " << format(Fmt, (uint64_t)Phdr.p_offset) << "vaddr "
+             << format(Fmt, (uint64_t)Phdr.p_vaddr) << "paddr "
+             << format(Fmt, (uint64_t)Phdr.p_paddr)
+             << format("align 2**%u\n",
+                       countTrailingZeros<uint64_t>(Phdr.p_align))
+             << "         filesz " << format(Fmt, (uint64_t)Phdr.p_filesz)
+             << "memsz " << format(Fmt, (uint64_t)Phdr.p_memsz) << "flags "
+             << ((Phdr.p_flags & ELF::PF_R) ? "r" : "-")
+             << ((Phdr.p_flags & ELF::PF_W) ? "w" : "-")
+             << ((Phdr.p_flags & ELF::PF_X) ? "x" : "-") << "\n";
   }
-  outs() << "\n";
+  dumpOS() << "\n";
 }
 
 template <class ELFT>
 void printSymbolVersionDependency(ArrayRef<uint8_t> Contents,
                                   StringRef StrTab) {
-  outs() << "Version References:\n";
+  dumpOS() << "Version References:\n";
 
   const uint8_t *Buf = Contents.data();
   while (Buf) {
     auto *Verneed = reinterpret_cast<const typename ELFT::Verneed *>(Buf);
-    outs() << "  required from "
-           << StringRef(StrTab.drop_front(Verneed->vn_file).data()) << ":\n";
+    dumpOS() << "  required from "
+             << StringRef(StrTab.drop_front(Verneed->vn_file).data()) << ":\n";
 
     const uint8_t *BufAux = Buf + Verneed->vn_aux;
     while (BufAux) {
       auto *Vernaux = reinterpret_cast<const typename ELFT::Vernaux *>(BufAux);
-      outs() << "    "
-             << format("0x%08" PRIx32 " ", (uint32_t)Vernaux->vna_hash)
-             << format("0x%02" PRIx16 " ", (uint16_t)Vernaux->vna_flags)
-             << format("%02" PRIu16 " ", (uint16_t)Vernaux->vna_other)
-             << StringRef(StrTab.drop_front(Vernaux->vna_name).data()) << '\n';
+      dumpOS() << "    "
+               << format("0x%08" PRIx32 " ", (uint32_t)Vernaux->vna_hash)
+               << format("0x%02" PRIx16 " ", (uint16_t)Vernaux->vna_flags)
+               << format("%02" PRIu16 " ", (uint16_t)Vernaux->vna_other)
+               << StringRef(StrTab.drop_front(Vernaux->vna_name).data())
+               << '\n';
       BufAux = Vernaux->vna_next ? BufAux + Vernaux->vna_next : nullptr;
     }
     Buf = Verneed->vn_next ? Buf + Verneed->vn_next : nullptr;
@@ -277,7 +278,7 @@ template <class ELFT>
 void printSymbolVersionDefinition(const typename ELFT::Shdr &Shdr,
                                   ArrayRef<uint8_t> Contents,
                                   StringRef StrTab) {
-  outs() << "Version definitions:\n";
+  dumpOS() << "Version definitions:\n";
 
   const uint8_t *Buf = Contents.data();
   uint32_t VerdefIndex = 1;
@@ -287,17 +288,18 @@ void printSymbolVersionDefinition(const typename ELFT::Shdr &Shdr,
   uint16_t VerdefIndexWidth = std::to_string(Shdr.sh_info).size();
   while (Buf) {
     auto *Verdef = reinterpret_cast<const typename ELFT::Verdef *>(Buf);
-    outs() << format_decimal(VerdefIndex++, VerdefIndexWidth) << " "
-           << format("0x%02" PRIx16 " ", (uint16_t)Verdef->vd_flags)
-           << format("0x%08" PRIx32 " ", (uint32_t)Verdef->vd_hash);
+    dumpOS() << format_decimal(VerdefIndex++, VerdefIndexWidth) << " "
+             << format("0x%02" PRIx16 " ", (uint16_t)Verdef->vd_flags)
+             << format("0x%08" PRIx32 " ", (uint32_t)Verdef->vd_hash);
 
     const uint8_t *BufAux = Buf + Verdef->vd_aux;
     uint16_t VerdauxIndex = 0;
     while (BufAux) {
       auto *Verdaux = reinterpret_cast<const typename ELFT::Verdaux *>(BufAux);
       if (VerdauxIndex)
-        outs() << std::string(VerdefIndexWidth + 17, ' ');
-      outs() << StringRef(StrTab.drop_front(Verdaux->vda_name).data()) << '\n';
+        dumpOS() << std::string(VerdefIndexWidth + 17, ' ');
+      dumpOS() << StringRef(StrTab.drop_front(Verdaux->vda_name).data())
+               << '\n';
       BufAux = Verdaux->vda_next ? BufAux + Verdaux->vda_next : nullptr;
       ++VerdauxIndex;
     }
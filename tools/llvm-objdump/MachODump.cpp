@@ -192,6 +192,9 @@ static cl::list<std::string>
 
 bool ArchAll = false;
 
+// The triple of the file being disassembled, from --triple or the file itself.
+// The option is only read, since other inputs may be dumped on other threads.
+static std::string MachOTripleName;
 static std::string ThumbTripleName;
 
 static const Target *GetTarget(const MachOObjectFile *MachOObj,
@@ -199,10 +202,9 @@ static const Target *GetTarget(const MachOObjectFile *MachOObj,
                                const Target **ThumbTarget) {
   // Figure out the target triple.
   Triple TT(TripleName);
-  if (TripleName.empty()) {
+  if (TripleName.empty())
     TT = MachOObj->getArchTriple(McpuDefault);
-    TripleName = TT.str();
-  }
+  MachOTripleName = TT.str();
 
   if (TT.getArch() == Triple::arm) {
     // We've inferred a 32-bit ARM target from the object file. All MachO CPUs
@@ -215,7 +217,8 @@ static const Target *GetTarget(const MachOObjectFile *MachOObj,
 
   // Get the target specific parser.
   std::string Error;
-  const Target *TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+  const Target *TheTarget =
+      TargetRegistry::lookupTarget(MachOTripleName, Error);
   if (TheTarget && ThumbTripleName.empty())
     return TheTarget;
 
@@ -225,7 +228,7 @@ static const Target *GetTarget(const MachOObjectFile *MachOObj,
 
   WithColor::error(errs(), "llvm-objdump") << "unable to get target for '";
   if (!TheTarget)
-    errs() << TripleName;
+    errs() << MachOTripleName;
   else
     errs() << ThumbTripleName;
   errs() << "', see --version and --triple.\n";
@@ -7112,27 +7115,29 @@ static void DisassembleMachO(StringRef Filename, MachOObjectFile *MachOOF,
 
   // Set up disassembler.
   std::unique_ptr<const MCRegisterInfo> MRI(
-      TheTarget->createMCRegInfo(TripleName));
+      TheTarget->createMCRegInfo(MachOTripleName));
   std::unique_ptr<const MCAsmInfo> AsmInfo(
-      TheTarget->createMCAsmInfo(*MRI, TripleName));
+      TheTarget->createMCAsmInfo(*MRI, MachOTripleName));
   std::unique_ptr<const MCSubtargetInfo> STI(
-      TheTarget->createMCSubtargetInfo(TripleName, MachOMCPU, FeaturesStr));
+      TheTarget->createMCSubtargetInfo(MachOTripleName, MachOMCPU,
+                                       FeaturesStr));
   MCContext Ctx(AsmInfo.get(), MRI.get(), nullptr);
   std::unique_ptr<MCDisassembler> DisAsm(
       TheTarget->createMCDisassembler(*STI, Ctx));
   std::unique_ptr<MCSymbolizer> Symbolizer;
   struct DisassembleInfo SymbolizerInfo(nullptr, nullptr, nullptr, false);
   std::unique_ptr<MCRelocationInfo> RelInfo(
-      TheTarget->createMCRelocationInfo(TripleName, Ctx));
+      TheTarget->createMCRelocationInfo(MachOTripleName, Ctx));
   if (RelInfo) {
     Symbolizer.reset(TheTarget->createMCSymbolizer(
-        TripleName, SymbolizerGetOpInfo, SymbolizerSymbolLookUp,
+        MachOTripleName, SymbolizerGetOpInfo, SymbolizerSymbolLookUp,
         &SymbolizerInfo, &Ctx, std::move(RelInfo)));
     DisAsm->setSymbolizer(std::move(Symbolizer));
   }
   int AsmPrinterVariant = AsmInfo->getAssemblerDialect();
   std::unique_ptr<MCInstPrinter> IP(TheTarget->createMCInstPrinter(
-      Triple(TripleName), AsmPrinterVariant, *AsmInfo, *InstrInfo, *MRI));
+      Triple(MachOTripleName), AsmPrinterVariant, *AsmInfo, *InstrInfo,
+      *MRI));
   // Set the display preference for hex vs. decimal immediates.
   IP->setPrintImmHex(PrintImmHex);
   // Comment stream and backing vector.
@@ -7147,7 +7152,8 @@ static void DisassembleMachO(StringRef Filename, MachOObjectFile *MachOOF,
 
   if (!AsmInfo || !STI || !DisAsm || !IP) {
     WithColor::error(errs(), "llvm-objdump")
-        << "couldn't initialize disassembler for target " << TripleName << '\n';
+        << "couldn't initialize disassembler for target " << MachOTripleName
+        << '\n';
     return;
   }
 
@@ -7626,7 +7632,7 @@ static void DisassembleMachO(StringRef Filename, MachOObjectFile *MachOOF,
     }
     // The TripleName's need to be reset if we are called again for a different
     // archtecture.
-    TripleName = "";
+    MachOTripleName = "";
     ThumbTripleName = "";
 
     if (SymbolizerInfo.demangled_name != nullptr)
@@ -20,10 +20,10 @@ namespace llvm {
 void printWasmFileHeader(const object::ObjectFile *Obj) {
   const auto *File = dyn_cast<const WasmObjectFile>(Obj);
 
-  outs() << "Program Header:\n";
-  outs() << "Version: 0x";
-  outs().write_hex(File->getHeader().Version);
-  outs() << "\n";
+  dumpOS() << "Program Header:\n";
+  dumpOS() << "Version: 0x";
+  dumpOS().write_hex(File->getHeader().Version);
+  dumpOS() << "\n";
 }
 
 Error getWasmRelocationValueString(const WasmObjectFile *Obj,
@@ -59,11 +59,16 @@
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cctype>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <system_error>
 #include <unordered_map>
 #include <utility>
@@ -208,6 +213,12 @@ static cl::list<std::string> InputFilenames(cl::Positional,
                                             cl::ZeroOrMore,
                                             cl::cat(ObjdumpCat));
 
+static cl::opt<unsigned>
+    Jobs("jobs",
+         cl::desc("Dump up to N inputs in parallel. The output is still "
+                  "printed in input order. 0 uses all hardware threads"),
+         cl::value_desc("N"), cl::init(1), cl::cat(ObjdumpCat));
+
 static cl::opt<bool>
     PrintLines("line-numbers",
                cl::desc("Display source line numbers with "
@@ -337,8 +348,32 @@ static cl::extrahelp
 
 static StringSet<> DisasmFuncsSet;
 static StringSet<> FoundSectionSet;
+static std::mutex FoundSectionSetMutex;
 static StringRef ToolName;
 
+namespace {
+/// The dump of one input with --jobs, printed once the inputs before it are.
+struct InputDump {
+  std::string Output;
+  /// Warnings, and an error that ended the dump, to print after Output.
+  std::vector<std::pair<bool, std::string>> Diagnostics;
+  bool Failed = false;
+  /// Set if the input has to be dumped on the main thread instead.
+  bool Deferred = false;
+  bool Done = false;
+};
+} // namespace
+
+static LLVM_THREAD_LOCAL InputDump *CurrentDump = nullptr;
+static LLVM_THREAD_LOCAL raw_ostream *CurrentOS = nullptr;
+static std::mutex DumpMutex;
+static std::condition_variable DumpDone;
+/// Set while --jobs threads are running, which must not see the static
+/// destructors run under them.
+static bool DumpingInParallel = false;
+
+raw_ostream &dumpOS() { return CurrentOS ? *CurrentOS : outs(); }
+
 typedef std::vector<std::tuple<uint64_t, StringRef, uint8_t>> SectionSymbolsTy;
 
 static bool shouldKeep(object::SectionRef S) {
@@ -350,8 +385,10 @@ static bool shouldKeep(object::SectionRef S) {
     return false;
   // StringSet does not allow empty key so avoid adding sections with
   // no name (such as the section with index 0) here.
-  if (!SecName.empty())
+  if (!SecName.empty()) {
+    std::lock_guard<std::mutex> Lock(FoundSectionSetMutex);
     FoundSectionSet.insert(SecName);
+  }
   return is_contained(FilterSections, SecName);
 }
 
@@ -359,45 +396,65 @@ SectionFilter ToolSectionFilter(object::ObjectFile const &O) {
   return SectionFilter([](object::SectionRef S) { return shouldKeep(S); }, O);
 }
 
+/// Prints the error \p Message, which includes its trailing punctuation, and
+/// exits. With --jobs, it is printed after the output of the input instead.
+LLVM_ATTRIBUTE_NORETURN static void exitWithError(const Twine &Message) {
+  if (InputDump *Dump = CurrentDump) {
+    // Dumping cannot recover from errors, so this thread stops here and
+    // leaves it to the main thread to print the inputs before this one and
+    // exit.
+    std::unique_lock<std::mutex> Lock(DumpMutex);
+    Dump->Diagnostics.emplace_back(true, Message.str());
+    Dump->Failed = true;
+    Dump->Done = true;
+    DumpDone.notify_all();
+    DumpDone.wait(Lock, [] { return false; });
+  }
+  WithColor::error(errs(), ToolName) << Message;
+  errs().flush();
+  if (DumpingInParallel) {
+    outs().flush();
+    std::_Exit(1);
+  }
+  exit(1);
+}
+
+static void reportWarning(const Twine &Message) {
+  if (InputDump *Dump = CurrentDump) {
+    Dump->Diagnostics.emplace_back(false, Message.str());
+    return;
+  }
+  WithColor::warning(errs(), ToolName) << Message;
+  errs().flush();
+}
+
 void error(std::error_code EC) {
   if (!EC)
     return;
-  WithColor::error(errs(), ToolName)
-      << "reading file: " << EC.message() << ".\n";
-  errs().flush();
-  exit(1);
+  exitWithError("reading file: " + EC.message() + ".\n");
 }
 
 void error(Error E) {
   if (!E)
     return;
-  WithColor::error(errs(), ToolName) << toString(std::move(E));
-  exit(1);
+  exitWithError(toString(std::move(E)));
 }
 
 LLVM_ATTRIBUTE_NORETURN void error(Twine Message) {
-  WithColor::error(errs(), ToolName) << Message << ".\n";
-  errs().flush();
-  exit(1);
+  exitWithError(Message + ".\n");
 }
 
-void warn(StringRef Message) {
-  WithColor::warning(errs(), ToolName) << Message << ".\n";
-  errs().flush();
-}
+void warn(StringRef Message) { reportWarning(Message + ".\n"); }
 
 static void warn(Twine Message) {
   // Output order between errs() and outs() matters especially for archive
   // files where the output is per member object.
-  outs().flush();
-  WithColor::warning(errs(), ToolName) << Message << "\n";
-  errs().flush();
+  dumpOS().flush();
+  reportWarning(Message + "\n");
 }
 
 LLVM_ATTRIBUTE_NORETURN void report_error(StringRef File, Twine Message) {
-  WithColor::error(errs(), ToolName)
-      << "'" << File << "': " << Message << ".\n";
-  exit(1);
+  exitWithError("'" + File + "': " + Message + ".\n");
 }
 
 LLVM_ATTRIBUTE_NORETURN void report_error(Error E, StringRef File) {
@@ -406,27 +463,25 @@ LLVM_ATTRIBUTE_NORETURN void report_error(Error E, StringRef File) {
   raw_string_ostream OS(Buf);
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
-  WithColor::error(errs(), ToolName) << "'" << File << "': " << Buf;
-  exit(1);
+  exitWithError("'" + File + "': " + Buf);
 }
 
 LLVM_ATTRIBUTE_NORETURN void report_error(Error E, StringRef ArchiveName,
                                           StringRef FileName,
                                           StringRef ArchitectureName) {
   assert(E);
-  WithColor::error(errs(), ToolName);
+  std::string Buf;
+  raw_string_ostream OS(Buf);
   if (ArchiveName != "")
-    errs() << ArchiveName << "(" << FileName << ")";
+    OS << ArchiveName << "(" << FileName << ")";
   else
-    errs() << "'" << FileName << "'";
+    OS << "'" << FileName << "'";
   if (!ArchitectureName.empty())
-    errs() << " (for architecture " << ArchitectureName << ")";
-  std::string Buf;
-  raw_string_ostream OS(Buf);
+    OS << " (for architecture " << ArchitectureName << ")";
+  OS << ": ";
   logAllUnhandledErrors(std::move(E), OS);
   OS.flush();
-  errs() << ": " << Buf;
-  exit(1);
+  exitWithError(Buf);
 }
 
 LLVM_ATTRIBUTE_NORETURN void report_error(Error E, StringRef ArchiveName,
@@ -459,7 +514,9 @@ static void warnOnNoMatchForSections() {
          "found in any input file");
 }
 
-static const Target *getTarget(const ObjectFile *Obj = nullptr) {
+/// Returns the target for \p Obj and sets \p TripleStr to its triple. The
+/// --triple option is left alone, since the inputs may be dumped in parallel.
+static const Target *getTarget(const ObjectFile *Obj, std::string &TripleStr) {
   // Figure out the target triple.
   Triple TheTriple("unknown-unknown-unknown");
   if (TripleName.empty()) {
@@ -487,8 +544,7 @@ static const Target *getTarget(const ObjectFile *Obj = nullptr) {
       error("can't find target: " + Error);
   }
 
-  // Update the triple name and return the found target.
-  TripleName = TheTriple.getTriple();
+  TripleStr = TheTriple.getTriple();
   return TheTarget;
 }
 
@@ -653,7 +709,7 @@ static void printRelocation(const RelocationRef &Rel, uint64_t Address,
   SmallString<32> Val;
   Rel.getTypeName(Name);
   error(getRelocationValueString(Rel, Val));
-  outs() << format(Fmt.data(), Address) << Name << "\t" << Val << "\n";
+  dumpOS() << format(Fmt.data(), Address) << Name << "\t" << Val << "\n";
 }
 
 class PrettyPrinter {
@@ -1015,26 +1071,27 @@ dumpARMELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
   support::endianness Endian =
       Obj->isLittleEndian() ? support::little : support::big;
   while (Index < End) {
-    outs() << format("%8" PRIx64 ":", SectionAddr + Index);
-    outs() << "\t";
+    dumpOS() << format("%8" PRIx64 ":", SectionAddr + Index);
+    dumpOS() << "\t";
     if (Index + 4 <= End) {
-      dumpBytes(Bytes.slice(Index, 4), outs());
-      outs() << "\t.word\t"
-             << format_hex(
-                    support::endian::read32(Bytes.data() + Index, Endian), 10);
+      dumpBytes(Bytes.slice(Index, 4), dumpOS());
+      dumpOS() << "\t.word\t"
+               << format_hex(
+                      support::endian::read32(Bytes.data() + Index, Endian),
+                      10);
       Index += 4;
     } else if (Index + 2 <= End) {
-      dumpBytes(Bytes.slice(Index, 2), outs());
-      outs() << "\t\t.short\t"
-             << format_hex(
-                    support::endian::read16(Bytes.data() + Index, Endian), 6);
+      dumpBytes(Bytes.slice(Index, 2), dumpOS());
+      dumpOS() << "\t\t.short\t"
+               << format_hex(
+                      support::endian::read16(Bytes.data() + Index, Endian), 6);
       Index += 2;
     } else {
-      dumpBytes(Bytes.slice(Index, 1), outs());
-      outs() << "\t\t.byte\t" << format_hex(Bytes[0], 4);
+      dumpBytes(Bytes.slice(Index, 1), dumpOS());
+      dumpOS() << "\t\t.byte\t" << format_hex(Bytes[0], 4);
       ++Index;
     }
-    outs() << "\n";
+    dumpOS() << "\n";
     if (getMappingSymbolKind(MappingSymbols, Index) != 'd')
       break;
   }
@@ -1050,9 +1107,9 @@ static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
 
   for (; Index < End; ++Index) {
     if (NumBytes == 0)
-      outs() << format("%8" PRIx64 ":", SectionAddr + Index);
+      dumpOS() << format("%8" PRIx64 ":", SectionAddr + Index);
     Byte = Bytes.slice(Index)[0];
-    outs() << format(" %02x", Byte);
+    dumpOS() << format(" %02x", Byte);
     AsciiData[NumBytes] = isPrint(Byte) ? Byte : '.';
 
     uint8_t IndentOffset = 0;
@@ -1067,16 +1124,17 @@ static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
     }
     if (NumBytes == 8) {
       AsciiData[8] = '\0';
-      outs() << std::string(IndentOffset, ' ') << "         ";
-      outs() << reinterpret_cast<char *>(AsciiData);
-      outs() << '\n';
+      dumpOS() << std::string(IndentOffset, ' ') << "         ";
+      dumpOS() << reinterpret_cast<char *>(AsciiData);
+      dumpOS() << '\n';
       NumBytes = 0;
     }
   }
 }
 
-static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
-                              MCContext &Ctx, MCDisassembler *PrimaryDisAsm,
+static void disassembleObject(const Target *TheTarget, StringRef TripleStr,
+                              const ObjectFile *Obj, MCContext &Ctx,
+                              MCDisassembler *PrimaryDisAsm,
                               MCDisassembler *SecondaryDisAsm,
                               const MCInstrAnalysis *MIA, MCInstPrinter *IP,
                               const MCSubtargetInfo *PrimarySTI,
@@ -1196,11 +1254,11 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
     if (Obj->isELF() && Obj->getArch() == Triple::amdgcn) {
       // AMDGPU disassembler uses symbolizer for printing labels
       std::unique_ptr<MCRelocationInfo> RelInfo(
-        TheTarget->createMCRelocationInfo(TripleName, Ctx));
+        TheTarget->createMCRelocationInfo(TripleStr, Ctx));
       if (RelInfo) {
         std::unique_ptr<MCSymbolizer> Symbolizer(
           TheTarget->createMCSymbolizer(
-            TripleName, nullptr, nullptr, &Symbols, &Ctx, std::move(RelInfo)));
+            TripleStr, nullptr, nullptr, &Symbols, &Ctx, std::move(RelInfo)));
         DisAsm->setSymbolizer(std::move(Symbolizer));
       }
     }
@@ -1266,10 +1324,10 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
 
       if (!PrintedSection) {
         PrintedSection = true;
-        outs() << "\nDisassembly of section ";
+        dumpOS() << "\nDisassembly of section ";
         if (!SegmentName.empty())
-          outs() << SegmentName << ",";
-        outs() << SectionName << ":\n";
+          dumpOS() << SegmentName << ",";
+        dumpOS() << SectionName << ":\n";
       }
 
       if (Obj->isELF() && Obj->getArch() == Triple::amdgcn) {
@@ -1289,17 +1347,17 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
         }
       }
 
-      outs() << '\n';
+      dumpOS() << '\n';
       if (!NoLeadingAddr)
-        outs() << format(Is64Bits ? "%016" PRIx64 " " : "%08" PRIx64 " ",
-                         SectionAddr + Start + VMAAdjustment);
+        dumpOS() << format(Is64Bits ? "%016" PRIx64 " " : "%08" PRIx64 " ",
+                           SectionAddr + Start + VMAAdjustment);
 
-      outs() << SymbolName << ":\n";
+      dumpOS() << SymbolName << ":\n";
 
       // Don't print raw contents of a virtual section. A virtual section
       // doesn't have any contents in the file.
       if (Section.isVirtual()) {
-        outs() << "...\n";
+        dumpOS() << "...\n";
         continue;
       }
 
@@ -1313,6 +1371,8 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
       // of each symbol.
       DisAsm->onSymbolStart(SymbolName, Size, Bytes.slice(Start, End - Start),
                             SectionAddr + Start, DebugOut, CommentStream);
+      dumpOS() << CommentStream.str();
+      Comments.clear();
       Start += Size;
 
       Index = Start;
@@ -1356,7 +1416,7 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
 
           if (size_t N =
                   countSkippableZeroBytes(Bytes.slice(Index, MaxOffset))) {
-            outs() << "\t\t..." << '\n';
+            dumpOS() << "\t\t..." << '\n';
             Index += N;
             continue;
           }
@@ -1383,9 +1443,9 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
 
         PIP.printInst(
             *IP, Disassembled ? &Inst : nullptr, Bytes.slice(Index, Size),
-            {SectionAddr + Index + VMAAdjustment, Section.getIndex()}, outs(),
+            {SectionAddr + Index + VMAAdjustment, Section.getIndex()}, dumpOS(),
             "", *STI, &SP, &Rels);
-        outs() << CommentStream.str();
+        dumpOS() << CommentStream.str();
         Comments.clear();
 
         // Try to resolve the target of a call, tail call, etc. to a specific
@@ -1436,15 +1496,15 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
               --TargetSym;
               uint64_t TargetAddress = std::get<0>(*TargetSym);
               StringRef TargetName = std::get<1>(*TargetSym);
-              outs() << " <" << TargetName;
+              dumpOS() << " <" << TargetName;
               uint64_t Disp = Target - TargetAddress;
               if (Disp)
-                outs() << "+0x" << Twine::utohexstr(Disp);
-              outs() << '>';
+                dumpOS() << "+0x" << Twine::utohexstr(Disp);
+              dumpOS() << '>';
             }
           }
         }
-        outs() << "\n";
+        dumpOS() << "\n";
 
         // Hexagon does this in pretty printer
         if (Obj->getArch() != Triple::hexagon) {
@@ -1486,7 +1546,8 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
 }
 
 static void disassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
-  const Target *TheTarget = getTarget(Obj);
+  std::string TripleStr;
+  const Target *TheTarget = getTarget(Obj, TripleStr);
 
   // Package up features to be passed to target/subtarget
   SubtargetFeatures Features = Obj->getFeatures();
@@ -1495,36 +1556,36 @@ static void disassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
       Features.AddFeature(MAttrs[I]);
 
   std::unique_ptr<const MCRegisterInfo> MRI(
-      TheTarget->createMCRegInfo(TripleName));
+      TheTarget->createMCRegInfo(TripleStr));
   if (!MRI)
     report_error(Obj->getFileName(),
-                 "no register info for target " + TripleName);
+                 "no register info for target " + TripleStr);
 
   // Set up disassembler.
   std::unique_ptr<const MCAsmInfo> AsmInfo(
-      TheTarget->createMCAsmInfo(*MRI, TripleName));
+      TheTarget->createMCAsmInfo(*MRI, TripleStr));
   if (!AsmInfo)
     report_error(Obj->getFileName(),
-                 "no assembly info for target " + TripleName);
+                 "no assembly info for target " + TripleStr);
   std::unique_ptr<const MCSubtargetInfo> STI(
-      TheTarget->createMCSubtargetInfo(TripleName, MCPU, Features.getString()));
+      TheTarget->createMCSubtargetInfo(TripleStr, MCPU, Features.getString()));
   if (!STI)
     report_error(Obj->getFileName(),
-                 "no subtarget info for target " + TripleName);
+                 "no subtarget info for target " + TripleStr);
   std::unique_ptr<const MCInstrInfo> MII(TheTarget->createMCInstrInfo());
   if (!MII)
     report_error(Obj->getFileName(),
-                 "no instruction info for target " + TripleName);
+                 "no instruction info for target " + TripleStr);
   MCObjectFileInfo MOFI;
   MCContext Ctx(AsmInfo.get(), MRI.get(), &MOFI);
   // FIXME: for now initialize MCObjectFileInfo with default values
-  MOFI.InitMCObjectFileInfo(Triple(TripleName), false, Ctx);
+  MOFI.InitMCObjectFileInfo(Triple(TripleStr), false, Ctx);
 
   std::unique_ptr<MCDisassembler> DisAsm(
       TheTarget->createMCDisassembler(*STI, Ctx));
   if (!DisAsm)
     report_error(Obj->getFileName(),
-                 "no disassembler for target " + TripleName);
+                 "no disassembler for target " + TripleStr);
 
   // If we have an ARM object file, we need a second disassembler, because
   // ARM CPUs have two different instruction sets: ARM mode, and Thumb mode.
@@ -1537,7 +1598,7 @@ static void disassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
       Features.AddFeature("-thumb-mode");
     else
       Features.AddFeature("+thumb-mode");
-    SecondarySTI.reset(TheTarget->createMCSubtargetInfo(TripleName, MCPU,
+    SecondarySTI.reset(TheTarget->createMCSubtargetInfo(TripleStr, MCPU,
                                                         Features.getString()));
     SecondaryDisAsm.reset(TheTarget->createMCDisassembler(*SecondarySTI, Ctx));
   }
@@ -1547,22 +1608,22 @@ static void disassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
 
   int AsmPrinterVariant = AsmInfo->getAssemblerDialect();
   std::unique_ptr<MCInstPrinter> IP(TheTarget->createMCInstPrinter(
-      Triple(TripleName), AsmPrinterVariant, *AsmInfo, *MII, *MRI));
+      Triple(TripleStr), AsmPrinterVariant, *AsmInfo, *MII, *MRI));
   if (!IP)
     report_error(Obj->getFileName(),
-                 "no instruction printer for target " + TripleName);
+                 "no instruction printer for target " + TripleStr);
   IP->setPrintImmHex(PrintImmHex);
 
-  PrettyPrinter &PIP = selectPrettyPrinter(Triple(TripleName));
+  PrettyPrinter &PIP = selectPrettyPrinter(Triple(TripleStr));
   SourcePrinter SP(Obj, TheTarget->getName());
 
   for (StringRef Opt : DisassemblerOptions)
     if (!IP->applyTargetSpecificCLOption(Opt))
       error("Unrecognized disassembler option: " + Opt);
 
-  disassembleObject(TheTarget, Obj, Ctx, DisAsm.get(), SecondaryDisAsm.get(),
-                    MIA.get(), IP.get(), STI.get(), SecondarySTI.get(), PIP,
-                    SP, InlineRelocs);
+  disassembleObject(TheTarget, TripleStr, Obj, Ctx, DisAsm.get(),
+                    SecondaryDisAsm.get(), MIA.get(), IP.get(), STI.get(),
+                    SecondarySTI.get(), PIP, SP, InlineRelocs);
 }
 
 void printRelocations(const ObjectFile *Obj) {
@@ -1587,7 +1648,7 @@ void printRelocations(const ObjectFile *Obj) {
   for (std::pair<SectionRef, std::vector<SectionRef>> &P : SecToRelSec) {
     StringRef SecName;
     error(P.first.getName(SecName));
-    outs() << "RELOCATION RECORDS FOR [" << SecName << "]:\n";
+    dumpOS() << "RELOCATION RECORDS FOR [" << SecName << "]:\n";
 
     for (SectionRef Section : P.second) {
       for (const RelocationRef &Reloc : Section.relocations()) {
@@ -1598,11 +1659,11 @@ void printRelocations(const ObjectFile *Obj) {
           continue;
         Reloc.getTypeName(RelocName);
         error(getRelocationValueString(Reloc, ValueStr));
-        outs() << format(Fmt.data(), Address) << " " << RelocName << " "
-               << ValueStr << "\n";
+        dumpOS() << format(Fmt.data(), Address) << " " << RelocName << " "
+                 << ValueStr << "\n";
       }
     }
-    outs() << "\n";
+    dumpOS() << "\n";
   }
 }
 
@@ -1621,7 +1682,7 @@ void printDynamicRelocations(const ObjectFile *Obj) {
   if (DynRelSec.empty())
     return;
 
-  outs() << "DYNAMIC RELOCATION RECORDS\n";
+  dumpOS() << "DYNAMIC RELOCATION RECORDS\n";
   StringRef Fmt = Obj->getBytesInAddress() > 4 ? "%016" PRIx64 : "%08" PRIx64;
   for (const SectionRef &Section : DynRelSec)
     for (const RelocationRef &Reloc : Section.relocations()) {
@@ -1630,8 +1691,8 @@ void printDynamicRelocations(const ObjectFile *Obj) {
       SmallString<32> ValueStr;
       Reloc.getTypeName(RelocName);
       error(getRelocationValueString(Reloc, ValueStr));
-      outs() << format(Fmt.data(), Address) << " " << RelocName << " "
-             << ValueStr << "\n";
+      dumpOS() << format(Fmt.data(), Address) << " " << RelocName << " "
+               << ValueStr << "\n";
     }
 }
 
@@ -1650,12 +1711,12 @@ static bool shouldDisplayLMA(const ObjectFile *Obj) {
 void printSectionHeaders(const ObjectFile *Obj) {
   bool HasLMAColumn = shouldDisplayLMA(Obj);
   if (HasLMAColumn)
-    outs() << "Sections:\n"
-              "Idx Name          Size     VMA              LMA              "
-              "Type\n";
+    dumpOS() << "Sections:\n"
+                "Idx Name          Size     VMA              LMA              "
+                "Type\n";
   else
-    outs() << "Sections:\n"
-              "Idx Name          Size     VMA          Type\n";
+    dumpOS() << "Sections:\n"
+                "Idx Name          Size     VMA          Type\n";
 
   for (const SectionRef &Section : ToolSectionFilter(*Obj)) {
     StringRef Name;
@@ -1672,16 +1733,16 @@ void printSectionHeaders(const ObjectFile *Obj) {
                         (Data ? "DATA " : "") + (BSS ? "BSS" : ""));
 
     if (HasLMAColumn)
-      outs() << format("%3d %-13s %08" PRIx64 " %016" PRIx64 " %016" PRIx64
-                       " %s\n",
-                       (unsigned)Section.getIndex(), Name.str().c_str(), Size,
-                       VMA, getELFSectionLMA(Section), Type.c_str());
+      dumpOS() << format("%3d %-13s %08" PRIx64 " %016" PRIx64 " %016" PRIx64
+                         " %s\n",
+                         (unsigned)Section.getIndex(), Name.str().c_str(), Size,
+                         VMA, getELFSectionLMA(Section), Type.c_str());
     else
-      outs() << format("%3d %-13s %08" PRIx64 " %016" PRIx64 " %s\n",
-                       (unsigned)Section.getIndex(), Name.str().c_str(), Size,
-                       VMA, Type.c_str());
+      dumpOS() << format("%3d %-13s %08" PRIx64 " %016" PRIx64 " %s\n",
+                         (unsigned)Section.getIndex(), Name.str().c_str(), Size,
+                         VMA, Type.c_str());
   }
-  outs() << "\n";
+  dumpOS() << "\n";
 }
 
 void printSectionContents(const ObjectFile *Obj) {
@@ -1693,11 +1754,11 @@ void printSectionContents(const ObjectFile *Obj) {
     if (!Size)
       continue;
 
-    outs() << "Contents of section " << Name << ":\n";
+    dumpOS() << "Contents of section " << Name << ":\n";
     if (Section.isBSS()) {
-      outs() << format("<skipping contents of bss section at [%04" PRIx64
-                       ", %04" PRIx64 ")>\n",
-                       BaseAddr, BaseAddr + Size);
+      dumpOS() << format("<skipping contents of bss section at [%04" PRIx64
+                         ", %04" PRIx64 ")>\n",
+                         BaseAddr, BaseAddr + Size);
       continue;
     }
 
@@ -1705,33 +1766,33 @@ void printSectionContents(const ObjectFile *Obj) {
 
     // Dump out the content as hex and printable ascii characters.
     for (std::size_t Addr = 0, End = Contents.size(); Addr < End; Addr += 16) {
-      outs() << format(" %04" PRIx64 " ", BaseAddr + Addr);
+      dumpOS() << format(" %04" PRIx64 " ", BaseAddr + Addr);
       // Dump line of hex.
       for (std::size_t I = 0; I < 16; ++I) {
         if (I != 0 && I % 4 == 0)
-          outs() << ' ';
+          dumpOS() << ' ';
         if (Addr + I < End)
-          outs() << hexdigit((Contents[Addr + I] >> 4) & 0xF, true)
-                 << hexdigit(Contents[Addr + I] & 0xF, true);
+          dumpOS() << hexdigit((Contents[Addr + I] >> 4) & 0xF, true)
+                   << hexdigit(Contents[Addr + I] & 0xF, true);
         else
-          outs() << "  ";
+          dumpOS() << "  ";
       }
       // Print ascii.
-      outs() << "  ";
+      dumpOS() << "  ";
       for (std::size_t I = 0; I < 16 && Addr + I < End; ++I) {
         if (isPrint(static_cast<unsigned char>(Contents[Addr + I]) & 0xFF))
-          outs() << Contents[Addr + I];
+          dumpOS() << Contents[Addr + I];
         else
-          outs() << ".";
+          dumpOS() << ".";
       }
-      outs() << "\n";
+      dumpOS() << "\n";
     }
   }
 }
 
 void printSymbolTable(const ObjectFile *O, StringRef ArchiveName,
                       StringRef ArchitectureName) {
-  outs() << "SYMBOL TABLE:\n";
+  dumpOS() << "SYMBOL TABLE:\n";
 
   if (const COFFObjectFile *Coff = dyn_cast<const COFFObjectFile>(O)) {
     printCOFFSymbolTable(Coff);
@@ -1779,37 +1840,37 @@ void printSymbolTable(const ObjectFile *O, StringRef ArchiveName,
     const char *Fmt = O->getBytesInAddress() > 4 ? "%016" PRIx64 :
                                                    "%08" PRIx64;
 
-    outs() << format(Fmt, Address) << " "
-           << GlobLoc // Local -> 'l', Global -> 'g', Neither -> ' '
-           << (Weak ? 'w' : ' ') // Weak?
-           << ' ' // Constructor. Not supported yet.
-           << ' ' // Warning. Not supported yet.
-           << ' ' // Indirect reference to another symbol.
-           << Debug // Debugging (d) or dynamic (D) symbol.
-           << FileFunc // Name of function (F), file (f) or object (O).
-           << ' ';
+    dumpOS() << format(Fmt, Address) << " "
+             << GlobLoc // Local -> 'l', Global -> 'g', Neither -> ' '
+             << (Weak ? 'w' : ' ') // Weak?
+             << ' ' // Constructor. Not supported yet.
+             << ' ' // Warning. Not supported yet.
+             << ' ' // Indirect reference to another symbol.
+             << Debug // Debugging (d) or dynamic (D) symbol.
+             << FileFunc // Name of function (F), file (f) or object (O).
+             << ' ';
     if (Absolute) {
-      outs() << "*ABS*";
+      dumpOS() << "*ABS*";
     } else if (Common) {
-      outs() << "*COM*";
+      dumpOS() << "*COM*";
     } else if (Section == O->section_end()) {
-      outs() << "*UND*";
+      dumpOS() << "*UND*";
     } else {
       if (const MachOObjectFile *MachO =
           dyn_cast<const MachOObjectFile>(O)) {
         DataRefImpl DR = Section->getRawDataRefImpl();
         StringRef SegmentName = MachO->getSectionFinalSegmentName(DR);
-        outs() << SegmentName << ",";
+        dumpOS() << SegmentName << ",";
       }
       StringRef SectionName;
       error(Section->getName(SectionName));
-      outs() << SectionName;
+      dumpOS() << SectionName;
     }
 
     if (Common || isa<ELFObjectFileBase>(O)) {
       uint64_t Val =
           Common ? Symbol.getAlignment() : ELFSymbolRef(Symbol).getSize();
-      outs() << format("\t%08" PRIx64, Val);
+      dumpOS() << format("\t%08" PRIx64, Val);
     }
 
     if (isa<ELFObjectFileBase>(O)) {
@@ -1818,31 +1879,31 @@ void printSymbolTable(const ObjectFile *O, StringRef ArchiveName,
       case ELF::STV_DEFAULT:
         break;
       case ELF::STV_INTERNAL:
-        outs() << " .internal";
+        dumpOS() << " .internal";
         break;
       case ELF::STV_HIDDEN:
-        outs() << " .hidden";
+        dumpOS() << " .hidden";
         break;
       case ELF::STV_PROTECTED:
-        outs() << " .protected";
+        dumpOS() << " .protected";
         break;
       default:
-        outs() << format(" 0x%02x", Other);
+        dumpOS() << format(" 0x%02x", Other);
         break;
       }
     } else if (Hidden) {
-      outs() << " .hidden";
+      dumpOS() << " .hidden";
     }
 
     if (Demangle)
-      outs() << ' ' << demangle(Name) << '\n';
+      dumpOS() << ' ' << demangle(Name) << '\n';
     else
-      outs() << ' ' << Name << '\n';
+      dumpOS() << ' ' << Name << '\n';
   }
 }
 
 static void printUnwindInfo(const ObjectFile *O) {
-  outs() << "Unwind info:\n\n";
+  dumpOS() << "Unwind info:\n\n";
 
   if (const COFFObjectFile *Coff = dyn_cast<COFFObjectFile>(O))
     printCOFFUnwindInfo(Coff);
@@ -1886,7 +1947,7 @@ void printRawClangAST(const ObjectFile *Obj) {
 
   StringRef ClangASTContents = unwrapOrError(
       ClangASTSection.getValue().getContents(), Obj->getFileName());
-  outs().write(ClangASTContents.data(), ClangASTContents.size());
+  dumpOS().write(ClangASTContents.data(), ClangASTContents.size());
 }
 
 static void printFaultMaps(const ObjectFile *Obj) {
@@ -1914,10 +1975,10 @@ static void printFaultMaps(const ObjectFile *Obj) {
     }
   }
 
-  outs() << "FaultMap table:\n";
+  dumpOS() << "FaultMap table:\n";
 
   if (!FaultMapSection.hasValue()) {
-    outs() << "<not found>\n";
+    dumpOS() << "<not found>\n";
     return;
   }
 
@@ -1926,7 +1987,7 @@ static void printFaultMaps(const ObjectFile *Obj) {
   FaultMapParser FMP(FaultMapContents.bytes_begin(),
                      FaultMapContents.bytes_end());
 
-  outs() << FMP;
+  dumpOS() << FMP;
 }
 
 static void printPrivateFileHeaders(const ObjectFile *O, bool OnlyFirst) {
@@ -1954,12 +2015,12 @@ static void printFileHeaders(const ObjectFile *O) {
     report_error(O->getFileName(), "Invalid/Unsupported object file format");
 
   Triple::ArchType AT = O->getArch();
-  outs() << "architecture: " << Triple::getArchTypeName(AT) << "\n";
+  dumpOS() << "architecture: " << Triple::getArchTypeName(AT) << "\n";
   uint64_t Address = unwrapOrError(O->getStartAddress(), O->getFileName());
 
   StringRef Fmt = O->getBytesInAddress() > 4 ? "%016" PRIx64 : "%08" PRIx64;
-  outs() << "start address: "
-         << "0x" << format(Fmt.data(), Address) << "\n\n";
+  dumpOS() << "start address: "
+           << "0x" << format(Fmt.data(), Address) << "\n\n";
 }
 
 static void printArchiveChild(StringRef Filename, const Archive::Child &C) {
@@ -1970,33 +2031,33 @@ static void printArchiveChild(StringRef Filename, const Archive::Child &C) {
     return;
   }
   sys::fs::perms Mode = ModeOrErr.get();
-  outs() << ((Mode & sys::fs::owner_read) ? "r" : "-");
-  outs() << ((Mode & sys::fs::owner_write) ? "w" : "-");
-  outs() << ((Mode & sys::fs::owner_exe) ? "x" : "-");
-  outs() << ((Mode & sys::fs::group_read) ? "r" : "-");
-  outs() << ((Mode & sys::fs::group_write) ? "w" : "-");
-  outs() << ((Mode & sys::fs::group_exe) ? "x" : "-");
-  outs() << ((Mode & sys::fs::others_read) ? "r" : "-");
-  outs() << ((Mode & sys::fs::others_write) ? "w" : "-");
-  outs() << ((Mode & sys::fs::others_exe) ? "x" : "-");
-
-  outs() << " ";
-
-  outs() << format("%d/%d %6" PRId64 " ", unwrapOrError(C.getUID(), Filename),
-                   unwrapOrError(C.getGID(), Filename),
-                   unwrapOrError(C.getRawSize(), Filename));
+  dumpOS() << ((Mode & sys::fs::owner_read) ? "r" : "-");
+  dumpOS() << ((Mode & sys::fs::owner_write) ? "w" : "-");
+  dumpOS() << ((Mode & sys::fs::owner_exe) ? "x" : "-");
+  dumpOS() << ((Mode & sys::fs::group_read) ? "r" : "-");
+  dumpOS() << ((Mode & sys::fs::group_write) ? "w" : "-");
+  dumpOS() << ((Mode & sys::fs::group_exe) ? "x" : "-");
+  dumpOS() << ((Mode & sys::fs::others_read) ? "r" : "-");
+  dumpOS() << ((Mode & sys::fs::others_write) ? "w" : "-");
+  dumpOS() << ((Mode & sys::fs::others_exe) ? "x" : "-");
+
+  dumpOS() << " ";
+
+  dumpOS() << format("%d/%d %6" PRId64 " ", unwrapOrError(C.getUID(), Filename),
+                     unwrapOrError(C.getGID(), Filename),
+                     unwrapOrError(C.getRawSize(), Filename));
 
   StringRef RawLastModified = C.getRawLastModified();
   unsigned Seconds;
   if (RawLastModified.getAsInteger(10, Seconds))
-    outs() << "(date: \"" << RawLastModified
-           << "\" contains non-decimal chars) ";
+    dumpOS() << "(date: \"" << RawLastModified
+             << "\" contains non-decimal chars) ";
   else {
     // Since ctime(3) returns a 26 character string of the form:
     // "Sun Sep 16 01:03:52 1973\n\0"
     // just print 24 characters.
     time_t t = Seconds;
-    outs() << format("%.24s ", ctime(&t));
+    dumpOS() << format("%.24s ", ctime(&t));
   }
 
   StringRef Name = "";
@@ -2007,19 +2068,19 @@ static void printArchiveChild(StringRef Filename, const Archive::Child &C) {
   } else {
     Name = NameOrErr.get();
   }
-  outs() << Name << "\n";
+  dumpOS() << Name << "\n";
 }
 
 static void dumpObject(ObjectFile *O, const Archive *A = nullptr,
                        const Archive::Child *C = nullptr) {
   // Avoid other output when using a raw option.
   if (!RawClangAST) {
-    outs() << '\n';
+    dumpOS() << '\n';
     if (A)
-      outs() << A->getFileName() << "(" << O->getFileName() << ")";
+      dumpOS() << A->getFileName() << "(" << O->getFileName() << ")";
     else
-      outs() << O->getFileName();
-    outs() << ":\tfile format " << O->getFileFormatName() << "\n\n";
+      dumpOS() << O->getFileName();
+    dumpOS() << ":\tfile format " << O->getFileFormatName() << "\n\n";
   }
 
   StringRef ArchiveName = A ? A->getFileName() : "";
@@ -2062,7 +2123,7 @@ static void dumpObject(ObjectFile *O, const Archive *A = nullptr,
     // Dump the complete DWARF structure.
     DIDumpOptions DumpOpts;
     DumpOpts.DumpType = DwarfDumpType;
-    DICtx->dump(outs(), DumpOpts);
+    DICtx->dump(dumpOS(), DumpOpts);
   }
 }
 
@@ -2072,10 +2133,10 @@ static void dumpObject(const COFFImportFile *I, const Archive *A,
 
   // Avoid other output when using a raw option.
   if (!RawClangAST)
-    outs() << '\n'
-           << ArchiveName << "(" << I->getFileName() << ")"
-           << ":\tfile format COFF-import-file"
-           << "\n\n";
+    dumpOS() << '\n'
+             << ArchiveName << "(" << I->getFileName() << ")"
+             << ":\tfile format COFF-import-file"
+             << "\n\n";
 
   if (ArchiveHeaders && !MachOOpt && C)
     printArchiveChild(ArchiveName, *C);
@@ -2105,6 +2166,32 @@ static void dumpArchive(const Archive *A) {
     report_error(std::move(Err), A->getFileName());
 }
 
+/// Returns true if \p B is or contains a Mach-O object, which are dumped
+/// straight to outs().
+static bool containsMachO(Binary &B) {
+  if (isa<MachOObjectFile>(B) || isa<MachOUniversalBinary>(B))
+    return true;
+  Archive *A = dyn_cast<Archive>(&B);
+  if (!A)
+    return false;
+  Error Err = Error::success();
+  bool Found = false;
+  for (auto &C : A->children(Err)) {
+    Expected<std::unique_ptr<Binary>> ChildOrErr = C.getAsBinary();
+    if (!ChildOrErr) {
+      // Reported when the archive is dumped.
+      consumeError(ChildOrErr.takeError());
+      continue;
+    }
+    if (isa<MachOObjectFile>(**ChildOrErr)) {
+      Found = true;
+      break;
+    }
+  }
+  consumeError(std::move(Err));
+  return Found;
+}
+
 /// Open file and figure out how to dump it.
 static void dumpInput(StringRef file) {
   // If we are using the Mach-O specific object file parser, then let it parse
@@ -2119,6 +2206,11 @@ static void dumpInput(StringRef file) {
   OwningBinary<Binary> OBinary = unwrapOrError(createBinary(file), file);
   Binary &Binary = *OBinary.getBinary();
 
+  if (CurrentDump && containsMachO(Binary)) {
+    CurrentDump->Deferred = true;
+    return;
+  }
+
   if (Archive *A = dyn_cast<Archive>(&Binary))
     dumpArchive(A);
   else if (ObjectFile *O = dyn_cast<ObjectFile>(&Binary))
@@ -2128,6 +2220,61 @@ static void dumpInput(StringRef file) {
   else
     report_error(errorCodeToError(object_error::invalid_file_type), file);
 }
+
+/// Dumps the inputs on \p NumJobs threads into per-input buffers and prints
+/// them in input order, each as soon as the ones before it are printed.
+static void dumpInputsInParallel(unsigned NumJobs) {
+  std::vector<InputDump> Dumps(InputFilenames.size());
+  DumpingInParallel = true;
+  ThreadPool Pool(NumJobs);
+  for (size_t I = 0, E = Dumps.size(); I != E; ++I) {
+    Pool.async([I, &Dumps] {
+      InputDump &Dump = Dumps[I];
+      CurrentDump = &Dump;
+      {
+        raw_string_ostream OS(Dump.Output);
+        CurrentOS = &OS;
+        dumpInput(InputFilenames[I]);
+        CurrentOS = nullptr;
+      }
+      CurrentDump = nullptr;
+      std::lock_guard<std::mutex> Lock(DumpMutex);
+      Dump.Done = true;
+      DumpDone.notify_all();
+    });
+  }
+
+  for (size_t I = 0, E = Dumps.size(); I != E; ++I) {
+    InputDump &Dump = Dumps[I];
+    {
+      std::unique_lock<std::mutex> Lock(DumpMutex);
+      DumpDone.wait(Lock, [&] { return Dump.Done; });
+    }
+    // The Mach-O dumper writes to outs() directly, so those inputs are dumped
+    // here, in order, while the threads carry on with the inputs after them.
+    if (Dump.Deferred) {
+      dumpInput(InputFilenames[I]);
+      continue;
+    }
+    outs() << Dump.Output;
+    std::string().swap(Dump.Output);
+    for (const auto &Diag : Dump.Diagnostics) {
+      outs().flush();
+      (Diag.first ? WithColor::error(errs(), ToolName)
+                  : WithColor::warning(errs(), ToolName))
+          << Diag.second;
+    }
+    if (Dump.Failed) {
+      // The thread that failed is still blocked in exitWithError, and others
+      // may still be dumping, so exit without running destructors.
+      outs().flush();
+      errs().flush();
+      std::_Exit(1);
+    }
+  }
+  Pool.wait();
+  DumpingInParallel = false;
+}
 } // namespace llvm
 
 int main(int argc, char **argv) {
@@ -2179,7 +2326,14 @@ int main(int argc, char **argv) {
   DisasmFuncsSet.insert(DisassembleFunctions.begin(),
                         DisassembleFunctions.end());
 
-  llvm::for_each(InputFilenames, dumpInput);
+  unsigned NumJobs =
+      Jobs ? Jobs.getValue() : heavyweight_hardware_concurrency();
+  // The Mach-O specific parser keeps its own state and writes to outs().
+  if (llvm_is_multithreaded() && NumJobs > 1 && InputFilenames.size() > 1 &&
+      !MachOOpt)
+    dumpInputsInParallel(std::min<size_t>(NumJobs, InputFilenames.size()));
+  else
+    llvm::for_each(InputFilenames, dumpInput);
 
   warnOnNoMatchForSections();
 
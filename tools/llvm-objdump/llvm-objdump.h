@@ -16,6 +16,7 @@
 
 namespace llvm {
 class StringRef;
+class raw_ostream;
 
 namespace object {
 class COFFObjectFile;
@@ -96,6 +97,10 @@ Error getMachORelocationValueString(const object::MachOObjectFile *Obj,
 
 uint64_t getELFSectionLMA(const object::ELFSectionRef& Sec);
 
+/// The stream the dump of the current input goes to: outs(), or the buffer
+/// of the input with --jobs.
+raw_ostream &dumpOS();
+
 void error(std::error_code ec);
 void error(Error E);
 bool isRelocAddressLess(object::RelocationRef A, object::RelocationRef B);
@@ -10,16 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Object/Wasm.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/ProfileData/InstrProfWriter.h"
 #include "llvm/ProfileData/ProfileCommon.h"
 #include "llvm/ProfileData/SampleProfReader.h"
 #include "llvm/ProfileData/SampleProfWriter.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Format.h"
@@ -226,85 +231,109 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
-/// Load an input into a writer context.
-static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
-                      WriterContext *WC) {
-  std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+/// Select the writer context a function is merged into. Each function is
+/// merged into exactly one context, so that no context holds a copy of all the
+/// functions of the merged profile.
+static unsigned getShard(StringRef FuncName, unsigned NumShards) {
+  return hash_value(FuncName) % NumShards;
+}
 
-  // If there's a pending hard error, don't do more work.
-  if (WC->Err)
-    return;
+/// Load an input into the writer contexts, sharding its records by function
+/// name. The profile kind and any hard error are kept in the first context.
+static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
+                      ArrayRef<WriterContext *> Contexts) {
+  WriterContext *WC = Contexts[0];
+  {
+    std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+    // If there's a pending hard error, don't do more work.
+    if (WC->Err)
+      return;
+  }
 
-  // Copy the filename, because llvm::ThreadPool copied the input "const
-  // WeightedFile &" by value, making a reference to the filename within it
-  // invalid outside of this packaged task.
-  WC->ErrWhence = Input.Filename;
+  auto SetError = [&](Error E) {
+    std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+    if (WC->Err) {
+      consumeError(std::move(E));
+      return;
+    }
+    WC->Err = std::move(E);
+    // Copy the filename, because llvm::ThreadPool copied the input "const
+    // WeightedFile &" by value, making a reference to the filename within it
+    // invalid outside of this packaged task.
+    WC->ErrWhence = Input.Filename;
+  };
 
   auto ReaderOrErr = InstrProfReader::create(Input.Filename);
   if (Error E = ReaderOrErr.takeError()) {
     // Skip the empty profiles by returning sliently.
     instrprof_error IPE = InstrProfError::take(std::move(E));
     if (IPE != instrprof_error::empty_raw_profile)
-      WC->Err = make_error<InstrProfError>(IPE);
+      SetError(make_error<InstrProfError>(IPE));
     return;
   }
 
   auto Reader = std::move(ReaderOrErr.get());
   bool IsIRProfile = Reader->isIRLevelProfile();
   bool HasCSIRProfile = Reader->hasCSIRLevelProfile();
-  if (WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
-    WC->Err = make_error<StringError>(
+  std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+  Error KindErr = WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile);
+  CtxGuard.unlock();
+  if (KindErr) {
+    consumeError(std::move(KindErr));
+    SetError(make_error<StringError>(
         "Merge IR generated profile with Clang generated profile.",
-        std::error_code());
+        std::error_code()));
     return;
   }
 
+  // Records are read one at a time and handed to their context in batches,
+  // so that the lock of a context is not taken for every record.
+  const size_t BatchSize = 256;
+  std::vector<std::vector<NamedInstrProfRecord>> Batches(Contexts.size());
+  auto FlushBatch = [&](unsigned Shard) {
+    std::vector<NamedInstrProfRecord> &Batch = Batches[Shard];
+    std::unique_lock<std::mutex> CtxGuard{Contexts[Shard]->Lock};
+    for (NamedInstrProfRecord &I : Batch) {
+      const StringRef FuncName = I.Name;
+      bool Reported = false;
+      Contexts[Shard]->Writer.addRecord(
+          std::move(I), Input.Weight, [&](Error E) {
+            if (Reported) {
+              consumeError(std::move(E));
+              return;
+            }
+            Reported = true;
+            // Only show hint the first time an error occurs.
+            instrprof_error IPE = InstrProfError::take(std::move(E));
+            std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+            bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
+            handleMergeWriterError(make_error<InstrProfError>(IPE),
+                                   Input.Filename, FuncName, firstTime);
+          });
+    }
+    Batch.clear();
+  };
+
   for (auto &I : *Reader) {
     if (Remapper)
       I.Name = (*Remapper)(I.Name);
-    const StringRef FuncName = I.Name;
-    bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
-      if (Reported) {
-        consumeError(std::move(E));
-        return;
-      }
-      Reported = true;
-      // Only show hint the first time an error occurs.
-      instrprof_error IPE = InstrProfError::take(std::move(E));
-      std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
-      bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
-      handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
-                             FuncName, firstTime);
-    });
+    unsigned Shard = getShard(I.Name, Contexts.size());
+    Batches[Shard].push_back(std::move(I));
+    if (Batches[Shard].size() == BatchSize)
+      FlushBatch(Shard);
   }
+  for (unsigned Shard = 0; Shard < Contexts.size(); ++Shard)
+    FlushBatch(Shard);
+
   if (Reader->hasError()) {
     if (Error E = Reader->getError()) {
       instrprof_error IPE = InstrProfError::take(std::move(E));
       if (isFatalError(IPE))
-        WC->Err = make_error<InstrProfError>(IPE);
+        SetError(make_error<InstrProfError>(IPE));
     }
   }
 }
 
-/// Merge the \p Src writer context into \p Dst.
-static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
-  // If we've already seen a hard error, continuing with the merge would
-  // clobber it.
-  if (Dst->Err || Src->Err)
-    return;
-
-  bool Reported = false;
-  Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
-    if (Reported) {
-      consumeError(std::move(E));
-      return;
-    }
-    Reported = true;
-    Dst->Err = std::move(E);
-  });
-}
-
 static void mergeInstrProfile(const WeightedFileVector &Inputs,
                               SymbolRemapper *Remapper,
                               StringRef OutputFilename,
@@ -325,46 +354,42 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     NumThreads =
         std::min(hardware_concurrency(), unsigned((Inputs.size() + 1) / 2));
 
-  // Initialize the writer contexts.
+  // Initialize the writer contexts, one shard of the functions per thread.
   SmallVector<std::unique_ptr<WriterContext>, 4> Contexts;
-  for (unsigned I = 0; I < NumThreads; ++I)
+  SmallVector<WriterContext *, 4> Shards;
+  for (unsigned I = 0; I < NumThreads; ++I) {
     Contexts.emplace_back(llvm::make_unique<WriterContext>(
         OutputSparse, ErrorLock, WriterErrorCodes));
+    Shards.push_back(Contexts.back().get());
+  }
 
   if (NumThreads == 1) {
     for (const auto &Input : Inputs)
-      loadInput(Input, Remapper, Contexts[0].get());
+      loadInput(Input, Remapper, Shards);
   } else {
+    // Load the inputs in parallel. Every thread reads a whole input and adds
+    // each of its functions to the context of the function's shard.
     ThreadPool Pool(NumThreads);
-
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Remapper, Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    for (const auto &Input : Inputs)
+      Pool.async(loadInput, Input, Remapper,
+                 ArrayRef<WriterContext *>(Shards));
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    // The shards have no function in common, so gathering them into the
+    // first context only moves records and cannot fail. Each shard is freed
+    // as soon as it has been gathered.
+    for (unsigned I = 1; I < NumThreads; ++I) {
+      Contexts[0]->Writer.mergeRecordsFromWriter(
+          std::move(Contexts[I]->Writer),
+          [](Error E) { consumeError(std::move(E)); });
+      // Only the first context records errors.
+      consumeError(std::move(Contexts[I]->Err));
+      Contexts[I].reset();
+    }
+    Contexts.resize(1);
   }
 
-  // Handle deferred hard errors encountered during merging.
+  // Handle deferred hard errors encountered while loading the inputs.
   for (std::unique_ptr<WriterContext> &WC : Contexts) {
     if (!WC->Err)
       continue;
@@ -693,6 +718,178 @@ static int overlap_main(int argc, const char *argv[]) {
   return 0;
 }
 
+namespace {
+/// An instrumented function of a WebAssembly module, as described by its
+/// layout section.
+struct WasmFunctionCounters {
+  uint64_t NameRef;
+  uint64_t FuncHash;
+  uint32_t CounterAddr;
+  uint32_t NumCounters;
+};
+} // end anonymous namespace
+
+/// Read the functions described by the layout section of the WebAssembly
+/// module \p Filename, and add their names to \p Symtab.
+static std::vector<WasmFunctionCounters>
+readWasmLayout(StringRef Filename, InstrProfSymtab &Symtab, bool &IsIRLevel,
+               bool &IsCS) {
+  auto BinaryOrErr = object::createBinary(Filename);
+  if (!BinaryOrErr)
+    exitWithError(BinaryOrErr.takeError(), Filename);
+  auto *Obj = dyn_cast<object::WasmObjectFile>(BinaryOrErr->getBinary());
+  if (!Obj)
+    exitWithError("not a WebAssembly module", Filename);
+
+  std::vector<WasmFunctionCounters> Functions;
+  // Functions in COMDATs are described by every object file that defined
+  // them, but the linker only kept one copy of their counters.
+  DenseSet<uint32_t> SeenCounters;
+  bool FoundLayout = false;
+  for (const object::SectionRef &Section : Obj->sections()) {
+    const object::WasmSection &WS = Obj->getWasmSection(Section);
+    if (WS.Type != wasm::WASM_SEC_CUSTOM ||
+        WS.Name != getInstrProfWasmLayoutSectionName())
+      continue;
+    FoundLayout = true;
+
+    StringRef Contents(reinterpret_cast<const char *>(WS.Content.data()),
+                       WS.Content.size());
+    DataExtractor Data(Contents, /*IsLittleEndian=*/true, /*AddressSize=*/4);
+    uint32_t Offset = 0;
+    // The linker concatenated one block per object file.
+    while (Offset < Contents.size()) {
+      if (!Data.isValidOffsetForDataOfSize(Offset, 16))
+        exitWithError("truncated profile layout section", Filename);
+      uint64_t Version = Data.getU64(&Offset);
+      uint32_t NumFunctions = Data.getU32(&Offset);
+      uint32_t NamesSize = Data.getU32(&Offset);
+      if (GET_VERSION(Version) != WasmInstrProf::Version)
+        exitWithError("unsupported profile layout version " +
+                          Twine(GET_VERSION(Version)),
+                      Filename);
+      IsIRLevel |= (Version & VARIANT_MASK_IR_PROF) != 0;
+      IsCS |= (Version & VARIANT_MASK_CSIR_PROF) != 0;
+
+      if (!Data.isValidOffsetForDataOfSize(
+              Offset, uint64_t(NumFunctions) * 24 + NamesSize))
+        exitWithError("truncated profile layout section", Filename);
+      for (uint32_t I = 0; I < NumFunctions; ++I) {
+        WasmFunctionCounters F;
+        F.NameRef = Data.getU64(&Offset);
+        F.FuncHash = Data.getU64(&Offset);
+        F.CounterAddr = Data.getU32(&Offset);
+        F.NumCounters = Data.getU32(&Offset);
+        // The counters of functions that were not linked in are at 0.
+        if (F.CounterAddr && SeenCounters.insert(F.CounterAddr).second)
+          Functions.push_back(F);
+      }
+      if (Error E = Symtab.create(Contents.substr(Offset, NamesSize)))
+        exitWithError(std::move(E), Filename);
+      Offset += NamesSize;
+    }
+  }
+  if (!FoundLayout)
+    exitWithError("no " + getInstrProfWasmLayoutSectionName() +
+                      " section; was the module built with -fprofile-generate "
+                      "or -fprofile-instr-generate?",
+                  Filename);
+  return Functions;
+}
+
+static void importWasmProfile(StringRef ModuleFilename,
+                              ArrayRef<std::string> DumpFilenames,
+                              uint64_t DumpBase, StringRef OutputFilename,
+                              ProfileFormat OutputFormat, bool OutputSparse) {
+  if (OutputFilename.compare("-") == 0 && OutputFormat != PF_Text)
+    exitWithError("Cannot write indexed profdata format to stdout.");
+
+  InstrProfSymtab Symtab;
+  bool IsIRLevel = false, IsCS = false;
+  std::vector<WasmFunctionCounters> Functions =
+      readWasmLayout(ModuleFilename, Symtab, IsIRLevel, IsCS);
+
+  InstrProfWriter Writer(OutputSparse);
+  if (Error E = Writer.setIsIRLevelProfile(IsIRLevel, IsCS))
+    exitWithError(std::move(E), ModuleFilename);
+
+  for (const std::string &DumpFilename : DumpFilenames) {
+    auto BufOrErr = MemoryBuffer::getFile(DumpFilename, /*FileSize=*/-1,
+                                          /*RequiresNullTerminator=*/false);
+    if (!BufOrErr)
+      exitWithErrorCode(BufOrErr.getError(), DumpFilename);
+    StringRef Dump = (*BufOrErr)->getBuffer();
+
+    // Each dump is the memory of one run; the counts of all the runs add up.
+    for (const WasmFunctionCounters &F : Functions) {
+      StringRef Name = Symtab.getFuncName(F.NameRef);
+      if (Name.empty())
+        exitWithError("no name for function with MD5 " +
+                          Twine::utohexstr(F.NameRef),
+                      ModuleFilename);
+      uint64_t Begin = uint64_t(F.CounterAddr) - DumpBase;
+      uint64_t Size = uint64_t(F.NumCounters) * sizeof(uint64_t);
+      if (F.CounterAddr < DumpBase || Begin + Size > Dump.size())
+        exitWithError("the counters of " + Name + " at 0x" +
+                          Twine::utohexstr(F.CounterAddr) +
+                          " are outside of the dump",
+                      DumpFilename);
+
+      std::vector<uint64_t> Counts(F.NumCounters);
+      for (uint32_t I = 0; I < F.NumCounters; ++I)
+        Counts[I] = support::endian::read64le(Dump.data() + Begin +
+                                              I * sizeof(uint64_t));
+      Writer.addRecord(
+          NamedInstrProfRecord(Name, F.FuncHash, std::move(Counts)), 1,
+          [&](Error E) {
+            handleMergeWriterError(std::move(E), DumpFilename, Name);
+          });
+    }
+  }
+
+  std::error_code EC;
+  raw_fd_ostream Output(OutputFilename.data(), EC, sys::fs::F_None);
+  if (EC)
+    exitWithErrorCode(EC, OutputFilename);
+
+  if (OutputFormat == PF_Text) {
+    if (Error E = Writer.writeText(Output))
+      exitWithError(std::move(E));
+  } else {
+    Writer.write(Output);
+  }
+}
+
+static int import_wasm_main(int argc, const char *argv[]) {
+  cl::opt<std::string> ModuleFilename(cl::Positional, cl::Required,
+                                      cl::desc("<module>"));
+  cl::list<std::string> DumpFilenames(cl::Positional, cl::OneOrMore,
+                                      cl::desc("<memory dump...>"));
+  cl::opt<unsigned long long> DumpBase(
+      "dump-base", cl::init(0),
+      cl::desc("Linear memory address of the first byte of the dumps"));
+  cl::opt<std::string> OutputFilename("output", cl::value_desc("output"),
+                                      cl::init("-"), cl::Required,
+                                      cl::desc("Output file"));
+  cl::alias OutputFilenameA("o", cl::desc("Alias for --output"),
+                            cl::aliasopt(OutputFilename));
+  cl::opt<ProfileFormat> OutputFormat(
+      cl::desc("Format of output profile"), cl::init(PF_Binary),
+      cl::values(clEnumValN(PF_Binary, "binary", "Binary encoding (default)"),
+                 clEnumValN(PF_Text, "text", "Text encoding")));
+  cl::opt<bool> OutputSparse("sparse", cl::init(false),
+                             cl::desc("Generate a sparse profile"));
+
+  cl::ParseCommandLineOptions(
+      argc, argv, "LLVM WebAssembly profile importer\n\n"
+                  "  Reads the profile counters of an instrumented WebAssembly "
+                  "module from\n  dumps of its linear memory.\n");
+
+  importWasmProfile(ModuleFilename, DumpFilenames, DumpBase, OutputFilename,
+                    OutputFormat, OutputSparse);
+  return 0;
+}
+
 typedef struct ValueSitesStats {
   ValueSitesStats()
       : TotalNumValueSites(0), TotalNumValueSitesWithValueProfile(0),
@@ -1058,6 +1255,8 @@ int main(int argc, const char *argv[]) {
       func = show_main;
     else if (strcmp(argv[1], "overlap") == 0)
       func = overlap_main;
+    else if (strcmp(argv[1], "import-wasm") == 0)
+      func = import_wasm_main;
 
     if (func) {
       std::string Invocation(ProgName.str() + " " + argv[1]);
@@ -1072,7 +1271,7 @@ int main(int argc, const char *argv[]) {
              << "USAGE: " << ProgName << " <command> [args...]\n"
              << "USAGE: " << ProgName << " <command> -help\n\n"
              << "See each individual command --help for more details.\n"
-             << "Available commands: merge, show, overlap\n";
+             << "Available commands: merge, show, overlap, import-wasm\n";
       return 0;
     }
   }
@@ -1082,6 +1281,7 @@ int main(int argc, const char *argv[]) {
   else
     errs() << ProgName << ": Unknown command!\n";
 
-  errs() << "USAGE: " << ProgName << " <merge|show|overlap> [args...]\n";
+  errs() << "USAGE: " << ProgName
+         << " <merge|show|overlap|import-wasm> [args...]\n";
   return 1;
 }
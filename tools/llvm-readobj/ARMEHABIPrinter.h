@@ -15,6 +15,7 @@
 #include "llvm/Object/ELF.h"
 #include "llvm/Object/ELFTypes.h"
 #include "llvm/Support/ARMEHABI.h"
+#include "llvm/Support/Casting.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Format.h"
@@ -492,8 +493,25 @@ void PrinterContext<ET>::PrintExceptionTable(const Elf_Shdr *IT,
 template <typename ET>
 void PrinterContext<ET>::PrintOpcodes(const uint8_t *Entry,
                                       size_t Length, off_t Offset) const {
-  ListScope OCC(SW, "Opcodes");
-  OpcodeDecoder(OCC.W).Decode(Entry, Offset, Length);
+  if (!isa<JSONScopedPrinter>(SW)) {
+    ListScope OCC(SW, "Opcodes");
+    OpcodeDecoder(OCC.W).Decode(Entry, Offset, Length);
+    return;
+  }
+
+  // The decoder prints free-form text, so decode into a string and print each
+  // opcode as an item of a list.
+  std::string Str;
+  raw_string_ostream OS(Str);
+  ScopedPrinter TextW(OS);
+  OpcodeDecoder(TextW).Decode(Entry, Offset, Length);
+  SmallVector<StringRef, 8> Lines;
+  StringRef(OS.str()).split(Lines, '\n', /*MaxSplit=*/-1,
+                            /*KeepEmpty=*/false);
+  std::vector<std::string> Items;
+  for (StringRef Line : Lines)
+    Items.push_back(Line.trim().str());
+  SW.printList("Opcodes", Items);
 }
 
 template <typename ET>
@@ -11,6 +11,7 @@
 
 #include "Error.h"
 #include "llvm-readobj.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/Object/ELF.h"
@@ -37,6 +38,10 @@ class PrinterContext {
 
   void printEHFrame(const typename ELFT::Shdr *EHFrameShdr) const;
 
+  void printHexField(StringRef Label, uint64_t Value) const;
+
+  void printProgram(const dwarf::CFIProgram &Program) const;
+
 public:
   PrinterContext(ScopedPrinter &W, const object::ELFObjectFile<ELFT> *ObjF)
       : W(W), ObjF(ObjF) {}
@@ -93,14 +98,49 @@ void PrinterContext<ELFT>::printUnwindInformation() const {
   }
 }
 
+template <typename ELFT>
+void PrinterContext<ELFT>::printHexField(StringRef Label,
+                                         uint64_t Value) const {
+  if (isa<JSONScopedPrinter>(W))
+    W.printHex(Label, Value);
+  else
+    W.startLine() << Label << format(": 0x%" PRIx64 "\n", Value);
+}
+
+template <typename ELFT>
+void PrinterContext<ELFT>::printProgram(
+    const dwarf::CFIProgram &Program) const {
+  if (!isa<JSONScopedPrinter>(W)) {
+    W.getOStream() << "\n";
+    W.startLine() << "Program:\n";
+    W.indent();
+    Program.dump(W.getOStream(), nullptr, W.getIndentLevel());
+    W.unindent();
+    return;
+  }
+
+  // The JSON printer has no free-form text, so print each instruction as an
+  // item of a list.
+  std::string Str;
+  raw_string_ostream OS(Str);
+  Program.dump(OS, nullptr, /*IsEH=*/true, /*IndentLevel=*/0);
+  SmallVector<StringRef, 16> Lines;
+  StringRef(OS.str()).split(Lines, '\n', /*MaxSplit=*/-1,
+                            /*KeepEmpty=*/false);
+  std::vector<std::string> Items;
+  for (StringRef Line : Lines)
+    Items.push_back(Line.trim().str());
+  W.printList("Program", Items);
+}
+
 template <typename ELFT>
 void PrinterContext<ELFT>::printEHFrameHdr(uint64_t EHFrameHdrOffset,
                                            uint64_t EHFrameHdrAddress,
                                            uint64_t EHFrameHdrSize) const {
   ListScope L(W, "EH_FRAME Header");
-  W.startLine() << format("Address: 0x%" PRIx64 "\n", EHFrameHdrAddress);
-  W.startLine() << format("Offset: 0x%" PRIx64 "\n", EHFrameHdrOffset);
-  W.startLine() << format("Size: 0x%" PRIx64 "\n", EHFrameHdrSize);
+  printHexField("Address", EHFrameHdrAddress);
+  printHexField("Offset", EHFrameHdrOffset);
+  printHexField("Size", EHFrameHdrSize);
 
   const object::ELFFile<ELFT> *Obj = ObjF->getELFFile();
   const auto *EHFrameHdrShdr = findSectionByAddress(Obj, EHFrameHdrAddress);
@@ -127,22 +167,22 @@ void PrinterContext<ELFT>::printEHFrameHdr(uint64_t EHFrameHdrOffset,
     reportError("only version 1 of .eh_frame_hdr is supported");
 
   uint64_t EHFramePtrEnc = DE.getU8(&Offset);
-  W.startLine() << format("eh_frame_ptr_enc: 0x%" PRIx64 "\n", EHFramePtrEnc);
+  printHexField("eh_frame_ptr_enc", EHFramePtrEnc);
   if (EHFramePtrEnc != (dwarf::DW_EH_PE_pcrel | dwarf::DW_EH_PE_sdata4))
     reportError("unexpected encoding eh_frame_ptr_enc");
 
   uint64_t FDECountEnc = DE.getU8(&Offset);
-  W.startLine() << format("fde_count_enc: 0x%" PRIx64 "\n", FDECountEnc);
+  printHexField("fde_count_enc", FDECountEnc);
   if (FDECountEnc != dwarf::DW_EH_PE_udata4)
     reportError("unexpected encoding fde_count_enc");
 
   uint64_t TableEnc = DE.getU8(&Offset);
-  W.startLine() << format("table_enc: 0x%" PRIx64 "\n", TableEnc);
+  printHexField("table_enc", TableEnc);
   if (TableEnc != (dwarf::DW_EH_PE_datarel | dwarf::DW_EH_PE_sdata4))
     reportError("unexpected encoding table_enc");
 
   auto EHFramePtr = DE.getSigned(&Offset, 4) + EHFrameHdrAddress + 4;
-  W.startLine() << format("eh_frame_ptr: 0x%" PRIx64 "\n", EHFramePtr);
+  printHexField("eh_frame_ptr", EHFramePtr);
 
   auto FDECount = DE.getUnsigned(&Offset, 4);
   W.printNumber("fde_count", FDECount);
@@ -153,9 +193,9 @@ void PrinterContext<ELFT>::printEHFrameHdr(uint64_t EHFrameHdrOffset,
     DictScope D(W, std::string("entry ")  + std::to_string(NumEntries));
 
     auto InitialPC = DE.getSigned(&Offset, 4) + EHFrameHdrAddress;
-    W.startLine() << format("initial_location: 0x%" PRIx64 "\n", InitialPC);
+    printHexField("initial_location", InitialPC);
     auto Address = DE.getSigned(&Offset, 4) + EHFrameHdrAddress;
-    W.startLine() << format("address: 0x%" PRIx64 "\n", Address);
+    printHexField("address", Address);
 
     if (InitialPC < PrevPC)
       reportError("initial_location is out of order");
@@ -170,10 +210,20 @@ void PrinterContext<ELFT>::printEHFrame(
     const typename ELFT::Shdr *EHFrameShdr) const {
   uint64_t Address = EHFrameShdr->sh_addr;
   uint64_t ShOffset = EHFrameShdr->sh_offset;
-  W.startLine() << format(".eh_frame section at offset 0x%" PRIx64
-                          " address 0x%" PRIx64 ":\n",
-                          ShOffset, Address);
-  W.indent();
+  bool IsJSON = isa<JSONScopedPrinter>(W);
+  Optional<DictScope> Section;
+  Optional<ListScope> Entries;
+  if (IsJSON) {
+    Section.emplace(W, ".eh_frame");
+    W.printHex("Offset", ShOffset);
+    W.printHex("Address", Address);
+    Entries.emplace(W, "Entries");
+  } else {
+    W.startLine() << format(".eh_frame section at offset 0x%" PRIx64
+                            " address 0x%" PRIx64 ":\n",
+                            ShOffset, Address);
+    W.indent();
+  }
 
   const object::ELFFile<ELFT> *Obj = ObjF->getELFFile();
   auto Result = Obj->getSectionContents(EHFrameShdr);
@@ -192,10 +242,17 @@ void PrinterContext<ELFT>::printEHFrame(
 
   for (const auto &Entry : EHFrame) {
     if (const auto *CIE = dyn_cast<dwarf::CIE>(&Entry)) {
-      W.startLine() << format("[0x%" PRIx64 "] CIE length=%" PRIu64 "\n",
-                              Address + CIE->getOffset(),
-                              CIE->getLength());
-      W.indent();
+      Optional<DictScope> D;
+      if (IsJSON) {
+        D.emplace(W, "CIE");
+        W.printHex("Address", Address + CIE->getOffset());
+        W.printNumber("length", CIE->getLength());
+      } else {
+        W.startLine() << format("[0x%" PRIx64 "] CIE length=%" PRIu64 "\n",
+                                Address + CIE->getOffset(),
+                                CIE->getLength());
+        W.indent();
+      }
 
       W.printNumber("version", CIE->getVersion());
       W.printString("augmentation", CIE->getAugmentationString());
@@ -203,16 +260,25 @@ void PrinterContext<ELFT>::printEHFrame(
       W.printNumber("data_alignment_factor", CIE->getDataAlignmentFactor());
       W.printNumber("return_address_register", CIE->getReturnAddressRegister());
 
-      W.getOStream() << "\n";
-      W.startLine() << "Program:\n";
-      W.indent();
-      CIE->cfis().dump(W.getOStream(), nullptr, W.getIndentLevel());
-      W.unindent();
-
-      W.unindent();
-      W.getOStream() << "\n";
+      printProgram(CIE->cfis());
+      if (!IsJSON) {
+        W.unindent();
+        W.getOStream() << "\n";
+      }
 
     } else if (const auto *FDE = dyn_cast<dwarf::FDE>(&Entry)) {
+      if (IsJSON) {
+        DictScope D(W, "FDE");
+        W.printHex("Address", Address + FDE->getOffset());
+        W.printNumber("length", FDE->getLength());
+        W.printHex("cie", Address + FDE->getLinkedCIE()->getOffset());
+        W.printHex("initial_location", FDE->getInitialLocation());
+        W.printHex("address_range", FDE->getAddressRange());
+        W.printHex("end", FDE->getInitialLocation() + FDE->getAddressRange());
+        printProgram(FDE->cfis());
+        continue;
+      }
+
       W.startLine() << format("[0x%" PRIx64 "] FDE length=%" PRIu64
                               " cie=[0x%" PRIx64 "]\n",
                               Address + FDE->getOffset(),
@@ -227,11 +293,7 @@ void PrinterContext<ELFT>::printEHFrame(
                   FDE->getAddressRange(),
                   FDE->getInitialLocation() + FDE->getAddressRange());
 
-      W.getOStream() << "\n";
-      W.startLine() << "Program:\n";
-      W.indent();
-      FDE->cfis().dump(W.getOStream(), nullptr, W.getIndentLevel());
-      W.unindent();
+      printProgram(FDE->cfis());
 
       W.unindent();
       W.getOStream() << "\n";
@@ -240,7 +302,8 @@ void PrinterContext<ELFT>::printEHFrame(
     }
   }
 
-  W.unindent();
+  if (!IsJSON)
+    W.unindent();
 }
 
 }
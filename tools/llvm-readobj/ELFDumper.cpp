@@ -394,9 +394,8 @@ public:
 
   GNUStyle(ScopedPrinter &W, ELFDumper<ELFT> *Dumper)
       : DumpStyle<ELFT>(Dumper),
-        OS(static_cast<formatted_raw_ostream&>(W.getOStream())) {
-    assert (&W.getOStream() == &llvm::fouts());
-  }
+        // fouts(), or a formatted buffer with --jobs.
+        OS(static_cast<formatted_raw_ostream&>(W.getOStream())) {}
 
   void printFileHeaders(const ELFO *Obj) override;
   void printGroupSections(const ELFFile<ELFT> *Obj) override;
@@ -2016,7 +2015,7 @@ template <class ELFT> void ELFDumper<ELFT>::printNeededLibraries() {
   llvm::stable_sort(Libs);
 
   for (const auto &L : Libs)
-    W.startLine() << L << "\n";
+    W.printString(L);
 }
 
 template <typename ELFT> void ELFDumper<ELFT>::printHashTable() {
@@ -2051,7 +2050,7 @@ template <typename ELFT> void ELFDumper<ELFT>::printLoadName() {
 }
 
 template <class ELFT> void ELFDumper<ELFT>::printAttributes() {
-  W.startLine() << "Attributes not implemented.\n";
+  W.printString("Attributes not implemented.");
 }
 
 namespace {
@@ -2059,7 +2058,7 @@ namespace {
 template <> void ELFDumper<ELF32LE>::printAttributes() {
   const ELFFile<ELF32LE> *Obj = ObjF->getELFFile();
   if (Obj->getHeader()->e_machine != EM_ARM) {
-    W.startLine() << "Attributes not implemented.\n";
+    W.printString("Attributes not implemented.");
     return;
   }
 
@@ -2431,27 +2430,25 @@ template <class ELFT> void ELFDumper<ELFT>::printMipsABIFlags() {
   const ELFFile<ELFT> *Obj = ObjF->getELFFile();
   const Elf_Shdr *Shdr = findSectionByName(*Obj, ".MIPS.abiflags");
   if (!Shdr) {
-    W.startLine() << "There is no .MIPS.abiflags section in the file.\n";
+    W.printString("There is no .MIPS.abiflags section in the file.");
     return;
   }
   ArrayRef<uint8_t> Sec = unwrapOrError(Obj->getSectionContents(Shdr));
   if (Sec.size() != sizeof(Elf_Mips_ABIFlags<ELFT>)) {
-    W.startLine() << "The .MIPS.abiflags section has a wrong size.\n";
+    W.printString("The .MIPS.abiflags section has a wrong size.");
     return;
   }
 
   auto *Flags = reinterpret_cast<const Elf_Mips_ABIFlags<ELFT> *>(Sec.data());
 
-  raw_ostream &OS = W.getOStream();
   DictScope GS(W, "MIPS ABI Flags");
 
   W.printNumber("Version", Flags->version);
-  W.startLine() << "ISA: ";
   if (Flags->isa_rev <= 1)
-    OS << format("MIPS%u", Flags->isa_level);
+    W.printString("ISA", to_string(format("MIPS%u", Flags->isa_level)));
   else
-    OS << format("MIPS%ur%u", Flags->isa_level, Flags->isa_rev);
-  OS << "\n";
+    W.printString("ISA", to_string(format("MIPS%ur%u", Flags->isa_level,
+                                          Flags->isa_rev)));
   W.printEnum("ISA Extension", Flags->isa_ext, makeArrayRef(ElfMipsISAExtType));
   W.printFlags("ASEs", Flags->ases, makeArrayRef(ElfMipsASEFlags));
   W.printEnum("FP ABI", Flags->fp_abi, makeArrayRef(ElfMipsFpABIType));
@@ -2477,12 +2474,12 @@ template <class ELFT> void ELFDumper<ELFT>::printMipsReginfo() {
   const ELFFile<ELFT> *Obj = ObjF->getELFFile();
   const Elf_Shdr *Shdr = findSectionByName(*Obj, ".reginfo");
   if (!Shdr) {
-    W.startLine() << "There is no .reginfo section in the file.\n";
+    W.printString("There is no .reginfo section in the file.");
     return;
   }
   ArrayRef<uint8_t> Sec = unwrapOrError(Obj->getSectionContents(Shdr));
   if (Sec.size() != sizeof(Elf_Mips_RegInfo<ELFT>)) {
-    W.startLine() << "The .reginfo section has a wrong size.\n";
+    W.printString("The .reginfo section has a wrong size.");
     return;
   }
 
@@ -2495,7 +2492,7 @@ template <class ELFT> void ELFDumper<ELFT>::printMipsOptions() {
   const ELFFile<ELFT> *Obj = ObjF->getELFFile();
   const Elf_Shdr *Shdr = findSectionByName(*Obj, ".MIPS.options");
   if (!Shdr) {
-    W.startLine() << "There is no .MIPS.options section in the file.\n";
+    W.printString("There is no .MIPS.options section in the file.");
     return;
   }
 
@@ -2504,7 +2501,7 @@ template <class ELFT> void ELFDumper<ELFT>::printMipsOptions() {
   ArrayRef<uint8_t> Sec = unwrapOrError(Obj->getSectionContents(Shdr));
   while (!Sec.empty()) {
     if (Sec.size() < sizeof(Elf_Mips_Options<ELFT>)) {
-      W.startLine() << "The .MIPS.options section has a wrong size.\n";
+      W.printString("The .MIPS.options section has a wrong size.");
       return;
     }
     auto *O = reinterpret_cast<const Elf_Mips_Options<ELFT> *>(Sec.data());
@@ -2514,7 +2511,7 @@ template <class ELFT> void ELFDumper<ELFT>::printMipsOptions() {
       printMipsReginfoData(W, O->getRegInfo());
       break;
     default:
-      W.startLine() << "Unsupported MIPS options tag.\n";
+      W.printString("Unsupported MIPS options tag.");
       break;
     }
     Sec = Sec.slice(O->size);
@@ -4463,7 +4460,15 @@ template <class ELFT> void LLVMStyle<ELFT>::printFileHeaders(const ELFO *Obj) {
 
 template <class ELFT>
 void LLVMStyle<ELFT>::printGroupSections(const ELFO *Obj) {
-  DictScope Lists(W, "Groups");
+  // Every group is labeled "Group", which a JSON object can't hold more than
+  // once, so the JSON output lists them instead.
+  bool IsJSON = isa<JSONScopedPrinter>(W);
+  Optional<DictScope> Lists;
+  Optional<ListScope> JSONLists;
+  if (IsJSON)
+    JSONLists.emplace(W, "Groups");
+  else
+    Lists.emplace(W, "Groups");
   std::vector<GroupSection> V = getGroups<ELFT>(Obj);
   DenseMap<uint64_t, const GroupSection *> Map = mapSectionsToGroups(V);
   for (const GroupSection &G : V) {
@@ -4473,7 +4478,10 @@ void LLVMStyle<ELFT>::printGroupSections(const ELFO *Obj) {
     W.printNumber("Link", G.Link);
     W.printNumber("Info", G.Info);
     W.printHex("Type", getGroupType(G.Type), G.Type);
-    W.startLine() << "Signature: " << G.Signature << "\n";
+    if (IsJSON)
+      W.printString("Signature", G.Signature);
+    else
+      W.startLine() << "Signature: " << G.Signature << "\n";
 
     ListScope L(W, "Section(s) in group");
     for (const GroupMember &GM : G.Members) {
@@ -4487,11 +4495,17 @@ void LLVMStyle<ELFT>::printGroupSections(const ELFO *Obj) {
         errs().flush();
         continue;
       }
-      W.startLine() << GM.Name << " (" << GM.Index << ")\n";
+      if (IsJSON) {
+        DictScope M(W);
+        W.printString("Name", GM.Name);
+        W.printNumber("Index", GM.Index);
+      } else {
+        W.startLine() << GM.Name << " (" << GM.Index << ")\n";
+      }
     }
   }
 
-  if (V.empty())
+  if (V.empty() && !IsJSON)
     W.startLine() << "There are no group sections in the file.\n";
 }
 
@@ -4510,6 +4524,15 @@ template <class ELFT> void LLVMStyle<ELFT>::printRelocations(const ELFO *Obj) {
 
     StringRef Name = unwrapOrError(Obj->getSectionName(&Sec));
 
+    if (isa<JSONScopedPrinter>(W)) {
+      DictScope Group(W, "Section");
+      W.printNumber("Index", SectionNumber);
+      W.printString("Name", Name);
+      ListScope Relocs(W, "Relocations");
+      printRelocations(&Sec, Obj);
+      continue;
+    }
+
     W.startLine() << "Section (" << SectionNumber << ") " << Name << " {\n";
     W.indent();
 
@@ -4543,7 +4566,10 @@ void LLVMStyle<ELFT>::printRelocations(const Elf_Shdr *Sec, const ELFO *Obj) {
     Elf_Relr_Range Relrs = unwrapOrError(Obj->relrs(Sec));
     if (opts::RawRelr) {
       for (const Elf_Relr &R : Relrs)
-        W.startLine() << W.hex(R) << "\n";
+        if (isa<JSONScopedPrinter>(W))
+          W.printHex("Relr", R);
+        else
+          W.startLine() << W.hex(R) << "\n";
     } else {
       std::vector<Elf_Rela> RelrRelas = unwrapOrError(Obj->decode_relrs(Relrs));
       for (const Elf_Rela &R : RelrRelas)
@@ -4576,7 +4602,7 @@ void LLVMStyle<ELFT>::printRelocation(const ELFO *Obj, Elf_Rela Rel,
         Sym, StrTable, SymTab->sh_type == SHT_DYNSYM /* IsDynamic */);
   }
 
-  if (opts::ExpandRelocs) {
+  if (opts::ExpandRelocs || isa<JSONScopedPrinter>(W)) {
     DictScope Group(W, "Relocation");
     W.printHex("Offset", Rel.r_offset);
     W.printNumber("Type", RelocName, (int)Rel.getType(Obj->isMips64EL()));
@@ -4743,6 +4769,21 @@ template <class ELFT> void LLVMStyle<ELFT>::printDynamic(const ELFFile<ELFT> *Ob
   if (Table.empty())
     return;
 
+  if (isa<JSONScopedPrinter>(W)) {
+    ListScope D(W, "DynamicSection");
+    for (auto Entry : Table) {
+      DictScope E(W, "Entry");
+      uintX_t Tag = Entry.getTag();
+      W.printHex("Tag", Tag);
+      W.printString("Type", getTypeString(Obj->getHeader()->e_machine, Tag));
+      std::string Value;
+      raw_string_ostream ValueOS(Value);
+      this->dumper()->printDynamicEntry(ValueOS, Tag, Entry.getVal());
+      W.printString("Value", ValueOS.str());
+    }
+    return;
+  }
+
   raw_ostream &OS = W.getOStream();
   W.startLine() << "DynamicSection [ (" << Table.size() << " entries)\n";
 
@@ -4771,8 +4812,13 @@ void LLVMStyle<ELFT>::printDynamicRelocations(const ELFO *Obj) {
   const DynRegionInfo &DynPLTRelRegion = this->dumper()->getDynPLTRelRegion();
   if (DynRelRegion.Size && DynRelaRegion.Size)
     report_fatal_error("There are both REL and RELA dynamic relocations");
-  W.startLine() << "Dynamic Relocations {\n";
-  W.indent();
+  Optional<ListScope> Relocs;
+  if (isa<JSONScopedPrinter>(W)) {
+    Relocs.emplace(W, "DynamicRelocations");
+  } else {
+    W.startLine() << "Dynamic Relocations {\n";
+    W.indent();
+  }
   if (DynRelaRegion.Size > 0)
     for (const Elf_Rela &Rela : this->dumper()->dyn_relas())
       printDynamicRelocation(Obj, Rela);
@@ -4801,8 +4847,10 @@ void LLVMStyle<ELFT>::printDynamicRelocations(const ELFO *Obj) {
       Rela.r_addend = 0;
       printDynamicRelocation(Obj, Rela);
     }
-  W.unindent();
-  W.startLine() << "}\n";
+  if (!Relocs) {
+    W.unindent();
+    W.startLine() << "}\n";
+  }
 }
 
 template <class ELFT>
@@ -4814,7 +4862,7 @@ void LLVMStyle<ELFT>::printDynamicRelocation(const ELFO *Obj, Elf_Rela Rel) {
   const Elf_Sym *Sym = this->dumper()->dynamic_symbols().begin() + SymIndex;
   SymbolName = maybeDemangle(
       unwrapOrError(Sym->getName(this->dumper()->getDynamicStringTable())));
-  if (opts::ExpandRelocs) {
+  if (opts::ExpandRelocs || isa<JSONScopedPrinter>(W)) {
     DictScope Group(W, "Relocation");
     W.printHex("Offset", Rel.r_offset);
     W.printNumber("Type", RelocName, (int)Rel.getType(Obj->isMips64EL()));
@@ -4978,7 +5026,7 @@ void LLVMStyle<ELFT>::printVersionDependencySection(const ELFFile<ELFT> *Obj,
 
 template <class ELFT>
 void LLVMStyle<ELFT>::printHashHistogram(const ELFFile<ELFT> *Obj) {
-  W.startLine() << "Hash Histogram not implemented!\n";
+  W.printString("Hash Histogram not implemented!");
 }
 
 template <class ELFT>
@@ -104,7 +104,7 @@ void WasmDumper::printRelocation(const SectionRef &Section,
   default:
     break;
   }
-  if (opts::ExpandRelocs) {
+  if (opts::ExpandRelocs || isa<JSONScopedPrinter>(W)) {
     DictScope Group(W, "Relocation");
     W.printNumber("Type", RelocTypeName, RelocType);
     W.printHex("Offset", Reloc.getOffset());
@@ -139,8 +139,16 @@ void WasmDumper::printRelocations() {
 
     for (const RelocationRef &Reloc : Section.relocations()) {
       if (!PrintedGroup) {
-        W.startLine() << "Section (" << SectionNumber << ") " << Name << " {\n";
-        W.indent();
+        if (isa<JSONScopedPrinter>(W)) {
+          W.objectBegin("Section");
+          W.printNumber("Index", SectionNumber);
+          W.printString("Name", Name);
+          W.arrayBegin("Relocations");
+        } else {
+          W.startLine() << "Section (" << SectionNumber << ") " << Name
+                        << " {\n";
+          W.indent();
+        }
         PrintedGroup = true;
       }
 
@@ -148,8 +156,13 @@ void WasmDumper::printRelocations() {
     }
 
     if (PrintedGroup) {
-      W.unindent();
-      W.startLine() << "}\n";
+      if (isa<JSONScopedPrinter>(W)) {
+        W.arrayEnd();
+        W.objectEnd();
+      } else {
+        W.unindent();
+        W.startLine() << "}\n";
+      }
     }
   }
 }
@@ -176,8 +189,16 @@ void WasmDumper::printSectionHeaders() {
         const wasm::WasmLinkingData &LinkingData = Obj->linkingData();
         if (!LinkingData.InitFunctions.empty()) {
           ListScope Group(W, "InitFunctions");
-          for (const wasm::WasmInitFunc &F : LinkingData.InitFunctions)
-            W.startLine() << F.Symbol << " (priority=" << F.Priority << ")\n";
+          for (const wasm::WasmInitFunc &F : LinkingData.InitFunctions) {
+            if (isa<JSONScopedPrinter>(W)) {
+              DictScope D(W, "InitFunction");
+              W.printNumber("Symbol", F.Symbol);
+              W.printNumber("Priority", F.Priority);
+            } else {
+              W.startLine() << F.Symbol << " (priority=" << F.Priority
+                            << ")\n";
+            }
+          }
         }
       }
       break;
@@ -33,13 +33,20 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
 
 using namespace llvm;
 using namespace llvm::object;
@@ -361,16 +368,57 @@ namespace opts {
   cl::opt<OutputStyleTy>
       Output("elf-output-style", cl::desc("Specify ELF dump style"),
              cl::values(clEnumVal(LLVM, "LLVM default style"),
-                        clEnumVal(GNU, "GNU readelf style")),
+                        clEnumVal(GNU, "GNU readelf style"),
+                        clEnumVal(JSON, "LLVM style as JSON, one document "
+                                        "per object file")),
              cl::init(LLVM));
 
+  // --pretty-print
+  cl::opt<bool>
+      PrettyPrint("pretty-print",
+                  cl::desc("Indent JSON output instead of printing each "
+                           "document on a single line"));
+
+  // --jobs
+  cl::opt<unsigned>
+      Jobs("jobs",
+           cl::desc("Dump up to N inputs in parallel. The output is still "
+                    "printed in input order. 0 uses all hardware threads"),
+           cl::value_desc("N"), cl::init(1));
+
   cl::extrahelp
       HelpResponse("\nPass @FILE as argument to read options from FILE.\n");
 } // namespace opts
 
+namespace {
+/// The dump of one input with --jobs, printed once the inputs before it are.
+struct InputDump {
+  std::string Output;
+  /// Warnings, and an error that ended the dump, to print after Output.
+  std::vector<std::pair<bool, std::string>> Diagnostics;
+  bool Failed = false;
+  bool Done = false;
+};
+} // namespace
+
+static LLVM_THREAD_LOCAL InputDump *CurrentDump = nullptr;
+static std::mutex DumpMutex;
+static std::condition_variable DumpDone;
+
 namespace llvm {
 
 LLVM_ATTRIBUTE_NORETURN void reportError(Twine Msg) {
+  if (InputDump *Dump = CurrentDump) {
+    // Dumpers cannot recover from errors, so this thread stops here and
+    // leaves it to the main thread to print the inputs before this one and
+    // exit.
+    std::unique_lock<std::mutex> Lock(DumpMutex);
+    Dump->Diagnostics.emplace_back(true, Msg.str());
+    Dump->Failed = true;
+    Dump->Done = true;
+    DumpDone.notify_all();
+    DumpDone.wait(Lock, [] { return false; });
+  }
   fouts().flush();
   errs() << "\n";
   WithColor::error(errs()) << Msg << "\n";
@@ -384,6 +432,10 @@ void reportError(StringRef Input, Error Err) {
 }
 
 void reportWarning(Twine Msg) {
+  if (InputDump *Dump = CurrentDump) {
+    Dump->Diagnostics.emplace_back(false, Msg.str());
+    return;
+  }
   fouts().flush();
   errs() << "\n";
   WithColor::warning(errs()) << Msg << "\n";
@@ -462,6 +514,15 @@ static std::error_code createDumper(const ObjectFile *Obj,
   return readobj_error::unsupported_obj_file_format;
 }
 
+static void reportJSONUnsupported(StringRef File) {
+  reportError(File, createStringError(errc::not_supported,
+                                      "JSON output is only supported for ELF "
+                                      "and WebAssembly object files"));
+}
+
+static void dumpObjectContents(const ObjectFile *Obj, ScopedPrinter &Writer,
+                               StringRef FileStr, const Archive *A);
+
 /// Dumps the specified object file.
 static void dumpObject(const ObjectFile *Obj, ScopedPrinter &Writer,
                        const Archive *A = nullptr) {
@@ -469,12 +530,32 @@ static void dumpObject(const ObjectFile *Obj, ScopedPrinter &Writer,
           A ? Twine(A->getFileName() + "(" + Obj->getFileName() + ")").str()
             : Obj->getFileName().str();
 
+  if (opts::Output != opts::JSON) {
+    dumpObjectContents(Obj, Writer, FileStr, A);
+    return;
+  }
+
+  // The other dumpers print free-form text in places.
+  if (!Obj->isELF() && !Obj->isWasm())
+    reportJSONUnsupported(FileStr);
+
+  JSONScopedPrinter JSONWriter(Writer.getOStream(), opts::PrettyPrint ? 2 : 0);
+  {
+    DictScope D(JSONWriter);
+    dumpObjectContents(Obj, JSONWriter, FileStr, A);
+  }
+  Writer.getOStream() << "\n";
+}
+
+static void dumpObjectContents(const ObjectFile *Obj, ScopedPrinter &Writer,
+                               StringRef FileStr, const Archive *A) {
   std::unique_ptr<ObjDumper> Dumper;
   if (std::error_code EC = createDumper(Obj, Writer, Dumper))
     reportError(FileStr, EC);
 
-  Writer.startLine() << "\n";
-  if (opts::Output == opts::LLVM) {
+  if (opts::Output != opts::JSON)
+    Writer.startLine() << "\n";
+  if (opts::Output == opts::LLVM || opts::Output == opts::JSON) {
     Writer.printString("File", FileStr);
     Writer.printString("Format", Obj->getFileFormatName());
     Writer.printString("Arch", Triple::getArchTypeName(
@@ -598,9 +679,12 @@ static void dumpArchive(const Archive *Arc, ScopedPrinter &Writer) {
     }
     if (ObjectFile *Obj = dyn_cast<ObjectFile>(&*ChildOrErr.get()))
       dumpObject(Obj, Writer, Arc);
-    else if (COFFImportFile *Imp = dyn_cast<COFFImportFile>(&*ChildOrErr.get()))
+    else if (COFFImportFile *Imp =
+                 dyn_cast<COFFImportFile>(&*ChildOrErr.get())) {
+      if (opts::Output == opts::JSON)
+        reportJSONUnsupported(Arc->getFileName());
       dumpCOFFImportFile(Imp, Writer);
-    else
+    } else
       reportError(Arc->getFileName(), readobj_error::unrecognized_file_format);
   }
   if (Err)
@@ -639,6 +723,10 @@ static void dumpInput(StringRef File, ScopedPrinter &Writer) {
     reportError(File, BinaryOrErr.takeError());
   Binary &Binary = *BinaryOrErr.get().getBinary();
 
+  if (opts::Output == opts::JSON &&
+      (isa<COFFImportFile>(&Binary) || isa<WindowsResource>(&Binary)))
+    reportJSONUnsupported(File);
+
   if (Archive *Arc = dyn_cast<Archive>(&Binary))
     dumpArchive(Arc, Writer);
   else if (MachOUniversalBinary *UBinary =
@@ -653,7 +741,56 @@ static void dumpInput(StringRef File, ScopedPrinter &Writer) {
   else
     reportError(File, readobj_error::unrecognized_file_format);
 
-  CVTypes.Binaries.push_back(std::move(*BinaryOrErr));
+  // The merged CodeView types refer to the contents of the inputs.
+  if (opts::CodeViewMergedTypes)
+    CVTypes.Binaries.push_back(std::move(*BinaryOrErr));
+}
+
+/// Dumps the inputs on \p Jobs threads into per-input buffers and prints
+/// them in input order, each as soon as the ones before it are printed.
+static void dumpInputsInParallel(unsigned Jobs) {
+  std::vector<InputDump> Dumps(opts::InputFilenames.size());
+  ThreadPool Pool(Jobs);
+  for (size_t I = 0, E = Dumps.size(); I != E; ++I) {
+    Pool.async([I, &Dumps] {
+      InputDump &Dump = Dumps[I];
+      CurrentDump = &Dump;
+      {
+        raw_string_ostream StrOS(Dump.Output);
+        // GNU style needs a formatted stream to align its columns.
+        formatted_raw_ostream OS(StrOS);
+        ScopedPrinter Writer(OS);
+        dumpInput(opts::InputFilenames[I], Writer);
+      }
+      CurrentDump = nullptr;
+      std::lock_guard<std::mutex> Lock(DumpMutex);
+      Dump.Done = true;
+      DumpDone.notify_all();
+    });
+  }
+
+  for (InputDump &Dump : Dumps) {
+    {
+      std::unique_lock<std::mutex> Lock(DumpMutex);
+      DumpDone.wait(Lock, [&] { return Dump.Done; });
+    }
+    fouts() << Dump.Output;
+    std::string().swap(Dump.Output);
+    for (const auto &Diag : Dump.Diagnostics) {
+      fouts().flush();
+      errs() << "\n";
+      (Diag.first ? WithColor::error(errs()) : WithColor::warning(errs()))
+          << Diag.second << "\n";
+    }
+    if (Dump.Failed) {
+      // The thread that failed is still blocked in reportError, and others
+      // may still be dumping, so exit without running destructors.
+      fouts().flush();
+      errs().flush();
+      std::_Exit(1);
+    }
+  }
+  Pool.wait();
 }
 
 /// Registers aliases that should only be allowed by readobj.
@@ -739,6 +876,20 @@ int main(int argc, const char *argv[]) {
   if (opts::InputFilenames.empty())
     opts::InputFilenames.push_back("-");
 
+  if (opts::Output == opts::JSON &&
+      (!opts::StringDump.empty() || !opts::HexDump.empty()))
+    reportError("--string-dump and --hex-dump are not supported with "
+                "--elf-output-style=JSON");
+
+  unsigned Jobs = opts::Jobs ? opts::Jobs.getValue()
+                             : llvm::heavyweight_hardware_concurrency();
+  // Merging CodeView types collects the types of all the inputs in order.
+  if (llvm_is_multithreaded() && Jobs > 1 &&
+      opts::InputFilenames.size() > 1 && !opts::CodeViewMergedTypes) {
+    dumpInputsInParallel(std::min<size_t>(Jobs, opts::InputFilenames.size()));
+    return 0;
+  }
+
   ScopedPrinter Writer(fouts());
   for (const std::string &I : opts::InputFilenames)
     dumpInput(I, Writer);
@@ -56,7 +56,7 @@ namespace opts {
   extern llvm::cl::opt<bool> RawRelr;
   extern llvm::cl::opt<bool> CodeViewSubsectionBytes;
   extern llvm::cl::opt<bool> Demangle;
-  enum OutputStyleTy { LLVM, GNU };
+  enum OutputStyleTy { LLVM, GNU, JSON };
   extern llvm::cl::opt<OutputStyleTy> Output;
 } // namespace opts
 
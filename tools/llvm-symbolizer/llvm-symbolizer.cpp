@@ -14,6 +14,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/DebugInfo/Symbolize/DIPrinter.h"
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
@@ -50,6 +51,11 @@ static cl::alias ClPrintFunctionsShort("f", cl::desc("Alias for -functions"),
                                        cl::NotHidden, cl::Grouping,
                                        cl::aliasopt(ClPrintFunctions));
 
+static cl::opt<bool>
+    ClUseGsym("use-gsym", cl::init(false),
+              cl::desc("Use <binary>.gsym instead of the debug info when "
+                       "it exists"));
+
 static cl::opt<bool>
     ClUseRelativeAddress("relative-address", cl::init(false),
                          cl::desc("Interpret addresses as relative addresses"),
@@ -173,9 +179,11 @@ enum class Command {
 };
 
 static bool parseCommand(StringRef InputString, Command &Cmd,
-                         std::string &ModuleName, uint64_t &ModuleOffset) {
+                         std::string &ModuleName, uint64_t &ModuleOffset,
+                         Optional<uint32_t> &WasmFuncIndex) {
   const char kDelimiters[] = " \n\r";
   ModuleName = "";
+  WasmFuncIndex = None;
   if (InputString.consume_front("CODE ")) {
     Cmd = Command::Code;
   } else if (InputString.consume_front("DATA ")) {
@@ -209,7 +217,20 @@ static bool parseCommand(StringRef InputString, Command &Cmd,
   // Skip delimiters and parse module offset.
   pos += strspn(pos, kDelimiters);
   int offset_length = strcspn(pos, kDelimiters);
-  return !StringRef(pos, offset_length).getAsInteger(0, ModuleOffset);
+  StringRef Offset(pos, offset_length);
+  // A WebAssembly function index and an offset into its body, in the form
+  // "<funcidx>+<offset>".
+  StringRef FuncIndex;
+  std::tie(FuncIndex, Offset) = Offset.split('+');
+  if (!Offset.empty()) {
+    uint32_t Index;
+    if (FuncIndex.getAsInteger(0, Index))
+      return false;
+    WasmFuncIndex = Index;
+  } else {
+    Offset = FuncIndex;
+  }
+  return !Offset.getAsInteger(0, ModuleOffset);
 }
 
 static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
@@ -217,10 +238,21 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
   Command Cmd;
   std::string ModuleName;
   uint64_t Offset = 0;
-  if (!parseCommand(StringRef(InputString), Cmd, ModuleName, Offset)) {
+  Optional<uint32_t> WasmFuncIndex;
+  if (!parseCommand(StringRef(InputString), Cmd, ModuleName, Offset,
+                    WasmFuncIndex)) {
     outs() << InputString;
     return;
   }
+  if (WasmFuncIndex) {
+    auto CodeOffsetOrErr =
+        Symbolizer.getWasmCodeOffset(ModuleName, *WasmFuncIndex, Offset);
+    if (error(CodeOffsetOrErr)) {
+      outs() << InputString;
+      return;
+    }
+    Offset = *CodeOffsetOrErr;
+  }
 
   if (ClPrintAddress) {
     outs() << "0x";
@@ -228,7 +260,9 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
     StringRef Delimiter = ClPrettyPrint ? ": " : "\n";
     outs() << Delimiter;
   }
-  Offset -= ClAdjustVMA;
+  // Code section offsets of Wasm functions are already module relative.
+  if (!WasmFuncIndex)
+    Offset -= ClAdjustVMA;
   if (Cmd == Command::Data) {
     auto ResOrErr = Symbolizer.symbolizeData(
         ModuleName, {Offset, object::SectionedAddress::UndefSection});
@@ -290,6 +324,7 @@ int main(int argc, char **argv) {
   Opts.UseSymbolTable = ClUseSymbolTable;
   Opts.Demangle = ClDemangle;
   Opts.RelativeAddresses = ClUseRelativeAddress;
+  Opts.UseGsym = ClUseGsym;
   Opts.DefaultArch = ClDefaultArch;
   Opts.FallbackDebugPath = ClFallbackDebugPath;
   Opts.DWPName = ClDwpName;
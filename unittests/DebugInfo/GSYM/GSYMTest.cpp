@@ -8,11 +8,19 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/DebugInfo/GSYM/FileEntry.h"
+#include "llvm/DebugInfo/GSYM/FileWriter.h"
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/InlineInfo.h"
+#include "llvm/DebugInfo/GSYM/LookupResult.h"
 #include "llvm/DebugInfo/GSYM/Range.h"
 #include "llvm/DebugInfo/GSYM/StringTable.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Testing/Support/Error.h"
 
 #include "gtest/gtest.h"
@@ -379,3 +387,189 @@ TEST(GSYMTest, TestStringTable) {
   // Test pointing to past end gets empty string.
   EXPECT_EQ(StrTab.getString(13), "");
 }
+
+TEST(GSYMTest, TestFileWriter) {
+  for (auto Endian : {llvm::support::little, llvm::support::big}) {
+    SmallString<64> Str;
+    raw_svector_ostream OutStrm(Str);
+    FileWriter FW(OutStrm, Endian);
+    FW.writeU8(0x11);
+    FW.writeU16(0x2233);
+    FW.writeU32(0x44556677);
+    FW.writeU64(0x8899aabbccddeeffULL);
+    FW.writeSLEB(-1);
+    FW.writeULEB(0x1234);
+    FW.writeNullTerminated("hello");
+    FW.alignTo(4);
+    const uint64_t FixupOffset = FW.tell();
+    FW.writeU32(0);
+    FW.fixup32(0x12345678, FixupOffset);
+    EXPECT_EQ(FW.tell() % 4, 0u);
+
+    DataExtractor Data(OutStrm.str(), Endian == llvm::support::little, 8);
+    uint32_t Offset = 0;
+    EXPECT_EQ(Data.getU8(&Offset), 0x11u);
+    EXPECT_EQ(Data.getU16(&Offset), 0x2233u);
+    EXPECT_EQ(Data.getU32(&Offset), 0x44556677u);
+    EXPECT_EQ(Data.getU64(&Offset), 0x8899aabbccddeeffULL);
+    EXPECT_EQ(Data.getSLEB128(&Offset), -1);
+    EXPECT_EQ(Data.getULEB128(&Offset), 0x1234u);
+    EXPECT_EQ(StringRef(Data.getCStr(&Offset)), "hello");
+    EXPECT_EQ(FixupOffset, (uint64_t)alignTo(Offset, 4));
+    Offset = FixupOffset;
+    EXPECT_EQ(Data.getU32(&Offset), 0x12345678u);
+  }
+}
+
+TEST(GSYMTest, TestHeaderEncodeDecode) {
+  Header H;
+  memset(&H, 0, sizeof(H));
+  H.Magic = GSYM_MAGIC;
+  H.Version = GSYM_VERSION;
+  H.AddrOffSize = 4;
+  H.UUIDSize = 16;
+  H.BaseAddress = 0x1000;
+  H.NumAddresses = 1;
+  H.StrtabOffset = 0x2000;
+  H.StrtabSize = 0x3000;
+  for (size_t I = 0; I < GSYM_MAX_UUID_SIZE; ++I)
+    H.UUID[I] = I;
+  for (auto Endian : {llvm::support::little, llvm::support::big}) {
+    SmallString<64> Str;
+    raw_svector_ostream OutStrm(Str);
+    FileWriter FW(OutStrm, Endian);
+    ASSERT_THAT_ERROR(H.encode(FW), Succeeded());
+    EXPECT_EQ(OutStrm.str().size(), sizeof(Header));
+    DataExtractor Data(OutStrm.str(), Endian == llvm::support::little, 8);
+    Expected<Header> Decoded = Header::decode(Data);
+    ASSERT_THAT_EXPECTED(Decoded, Succeeded());
+    EXPECT_EQ(H, *Decoded);
+  }
+  // An invalid address offset size must be rejected.
+  H.AddrOffSize = 3;
+  EXPECT_THAT_ERROR(H.checkForError(), Failed());
+}
+
+TEST(GSYMTest, TestFunctionInfoEncodeDecode) {
+  FunctionInfo FI(0x1000, 0x100, 1);
+  FI.Lines.push_back(LineEntry(0x1000, 1, 10));
+  FI.Lines.push_back(LineEntry(0x1010, 1, 12));
+  FI.Lines.push_back(LineEntry(0x1020, 2, 5));
+  FI.Inline.Ranges.insert(AddressRange(0x1000, 0x1100));
+  InlineInfo Inline1;
+  Inline1.Name = 2;
+  Inline1.CallFile = 1;
+  Inline1.CallLine = 11;
+  Inline1.Ranges.insert(AddressRange(0x1010, 0x1020));
+  InlineInfo Inline2;
+  Inline2.Name = 3;
+  Inline2.CallFile = 2;
+  Inline2.CallLine = 20;
+  Inline2.Ranges.insert(AddressRange(0x1014, 0x1018));
+  Inline1.Children.push_back(Inline2);
+  FI.Inline.Children.push_back(Inline1);
+
+  for (auto Endian : {llvm::support::little, llvm::support::big}) {
+    SmallString<512> Str;
+    raw_svector_ostream OutStrm(Str);
+    FileWriter FW(OutStrm, Endian);
+    Expected<uint64_t> Offset = FI.encode(FW);
+    ASSERT_THAT_EXPECTED(Offset, Succeeded());
+    DataExtractor Data(OutStrm.str().drop_front(*Offset),
+                       Endian == llvm::support::little, 8);
+    Expected<FunctionInfo> Decoded = FunctionInfo::decode(Data, 0x1000);
+    ASSERT_THAT_EXPECTED(Decoded, Succeeded());
+    EXPECT_EQ(FI, *Decoded);
+  }
+
+  // Children that are not contained within their parent can't be encoded.
+  FI.Inline.Children[0].Ranges.insert(AddressRange(0x2000, 0x2010));
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, llvm::support::little);
+  EXPECT_THAT_EXPECTED(FI.encode(FW), Failed());
+}
+
+static void TestGsymCreatorAndReader(llvm::support::endianness Endian) {
+  GsymCreator GC;
+  std::string Log;
+  raw_string_ostream LogStrm(Log);
+  const uint32_t MainName = GC.insertString("main");
+  const uint32_t FooName = GC.insertString("foo");
+  const uint32_t BarName = GC.insertString("bar");
+  const uint32_t MainFile = GC.insertFile("/tmp/main.c");
+  const uint32_t FooFile = GC.insertFile("/tmp/foo.h");
+  EXPECT_EQ(GC.insertFile("/tmp/main.c"), MainFile);
+
+  // A function with a line table and an inlined function.
+  FunctionInfo Main(0x1000, 0x100, MainName);
+  Main.Lines.push_back(LineEntry(0x1000, MainFile, 5));
+  Main.Lines.push_back(LineEntry(0x1010, FooFile, 20));
+  Main.Lines.push_back(LineEntry(0x1020, MainFile, 7));
+  Main.Inline.Ranges.insert(AddressRange(0x1000, 0x1100));
+  InlineInfo Foo;
+  Foo.Name = FooName;
+  Foo.CallFile = MainFile;
+  Foo.CallLine = 6;
+  Foo.Ranges.insert(AddressRange(0x1010, 0x1020));
+  Main.Inline.Children.push_back(Foo);
+  GC.addFunctionInfo(std::move(Main));
+  // A symbol with no size that must be extended to the next function, and
+  // a duplicate of "main" from the symbol table that must be pruned.
+  GC.addFunctionInfo(FunctionInfo(0x1100, 0, BarName));
+  GC.addFunctionInfo(FunctionInfo(0x1000, 0x100, MainName));
+  GC.addFunctionInfo(FunctionInfo(0x1200, 0x10, FooName));
+  ASSERT_THAT_ERROR(GC.finalize(LogStrm), Succeeded());
+  EXPECT_EQ(GC.getNumFunctionInfos(), 3u);
+
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, Endian);
+  ASSERT_THAT_ERROR(GC.encode(FW), Succeeded());
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_THAT_EXPECTED(GR, Succeeded());
+  EXPECT_EQ(GR->getNumAddresses(), 3u);
+  EXPECT_EQ(GR->getHeader().AddrOffSize, 2u);
+  EXPECT_EQ(GR->getHeader().BaseAddress, 0x1000u);
+
+  // Lookups before the first function and after the last one fail.
+  EXPECT_THAT_EXPECTED(GR->lookup(0xfff), Failed());
+  EXPECT_THAT_EXPECTED(GR->lookup(0x1210), Failed());
+
+  Expected<LookupResult> LR = GR->lookup(0x1004);
+  ASSERT_THAT_EXPECTED(LR, Succeeded());
+  EXPECT_EQ(LR->FuncName, "main");
+  EXPECT_EQ(LR->FuncRange, AddressRange(0x1000, 0x1100));
+  ASSERT_EQ(LR->Locations.size(), 1u);
+  EXPECT_EQ(LR->Locations[0].getPath(), "/tmp/main.c");
+  EXPECT_EQ(LR->Locations[0].Line, 5u);
+
+  // The inlined function is reported first, followed by its call site.
+  LR = GR->lookup(0x1014);
+  ASSERT_THAT_EXPECTED(LR, Succeeded());
+  ASSERT_EQ(LR->Locations.size(), 2u);
+  EXPECT_EQ(LR->Locations[0].Name, "foo");
+  EXPECT_EQ(LR->Locations[0].Base, "foo.h");
+  EXPECT_EQ(LR->Locations[0].Line, 20u);
+  EXPECT_EQ(LR->Locations[1].Name, "main");
+  EXPECT_EQ(LR->Locations[1].Base, "main.c");
+  EXPECT_EQ(LR->Locations[1].Line, 6u);
+
+  // Symbols without line tables only have a name.
+  LR = GR->lookup(0x11f0);
+  ASSERT_THAT_EXPECTED(LR, Succeeded());
+  EXPECT_EQ(LR->FuncName, "bar");
+  EXPECT_EQ(LR->FuncRange, AddressRange(0x1100, 0x1200));
+  ASSERT_EQ(LR->Locations.size(), 1u);
+  EXPECT_TRUE(LR->Locations[0].Base.empty());
+
+  Expected<FunctionInfo> FI = GR->getFunctionInfo(0x1208);
+  ASSERT_THAT_EXPECTED(FI, Succeeded());
+  EXPECT_EQ(FI->Range, AddressRange(0x1200, 0x1210));
+  EXPECT_EQ(GR->getString(FI->Name), "foo");
+}
+
+TEST(GSYMTest, TestGsymCreatorAndReader) {
+  TestGsymCreatorAndReader(llvm::support::little);
+  TestGsymCreatorAndReader(llvm::support::big);
+}